@@ -0,0 +1,271 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "benchutils.h"
+
+#include <core/trackmetadatastore.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+using namespace Qt::StringLiterals;
+
+#ifndef FOOYIN_BENCH_VERSION
+#define FOOYIN_BENCH_VERSION "unknown"
+#endif
+
+namespace {
+const QStringList Words
+    = {u"love"_s,  u"night"_s,  u"café"_s,  u"ocean"_s,  u"blue"_s,  u"fire"_s,    u"dream"_s, u"heart"_s,
+       u"city"_s,  u"sunset"_s, u"rain"_s,  u"électro"_s, u"storm"_s, u"shadow"_s, u"river"_s, u"gold"_s,
+       u"echo"_s,  u"winter"_s, u"lights"_s, u"road"_s,   u"señor"_s, u"glass"_s,   u"north"_s, u"static"_s};
+
+const QStringList Genres = {u"Rock"_s,       u"Pop"_s,   u"Jazz"_s,       u"Electronic"_s, u"Classical"_s,
+                            u"Hip-Hop"_s,    u"Folk"_s,  u"Metal"_s,      u"Ambient"_s,    u"Soul"_s,
+                            u"Soundtrack"_s, u"Blues"_s, u"Country"_s,    u"Reggae"_s,     u"Punk"_s};
+
+const QStringList Moods = {u"Calm"_s, u"Energetic"_s, u"Dark"_s, u"Happy"_s, u"Melancholic"_s};
+
+QString randomPhrase(std::mt19937& rng, int wordCount)
+{
+    std::uniform_int_distribution<qsizetype> dist{0, Words.size() - 1};
+
+    QStringList words;
+    for(int i{0}; i < wordCount; ++i) {
+        words.push_back(Words.at(dist(rng)));
+    }
+    return words.join(u' ');
+}
+} // namespace
+
+namespace Fooyin::Benchmarks {
+TrackList makeLibrary(int count, const std::shared_ptr<TrackMetadataStore>& store, uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> albumsPerArtistDist{1, 8};
+    std::uniform_int_distribution<int> tracksPerAlbumDist{6, 18};
+    std::uniform_int_distribution<int> yearDist{1960, 2025};
+    std::uniform_int_distribution<int> dayDist{1, 28};
+    std::uniform_int_distribution<int> monthDist{1, 12};
+    std::uniform_int_distribution<qsizetype> genreDist{0, Genres.size() - 1};
+    std::uniform_int_distribution<qsizetype> moodDist{0, Moods.size() - 1};
+    std::uniform_int_distribution<int> durationDist{90000, 480000};
+    std::uniform_real_distribution<float> gainDist{-12.0F, 2.0F};
+    std::uniform_int_distribution<int> percentDist{0, 99};
+
+    TrackList tracks;
+    tracks.reserve(static_cast<size_t>(count));
+
+    const auto size = [&tracks]() {
+        return static_cast<int>(tracks.size());
+    };
+
+    for(int artistIndex{0}; size() < count; ++artistIndex) {
+        const QString artist = u"%1 %2"_s.arg(randomPhrase(rng, 2)).arg(artistIndex);
+        const int albumCount = albumsPerArtistDist(rng);
+
+        for(int albumIndex{0}; albumIndex < albumCount && size() < count; ++albumIndex) {
+            const QString album     = u"%1 %2"_s.arg(randomPhrase(rng, 2)).arg(albumIndex + 1);
+            const QString date      = u"%1-%2-%3"_s.arg(yearDist(rng))
+                                     .arg(monthDist(rng), 2, 10, QChar{u'0'})
+                                     .arg(dayDist(rng), 2, 10, QChar{u'0'});
+            const bool compilation  = percentDist(rng) < 5;
+            const bool lossy        = percentDist(rng) < 40;
+            const int discCount     = percentDist(rng) < 10 ? 2 : 1;
+            const int trackCount    = tracksPerAlbumDist(rng);
+            const float albumGain   = gainDist(rng);
+            const QString albumPath = u"/music/%1/%2 (%3)"_s.arg(artist, album, date.left(4));
+
+            QStringList genres{Genres.at(genreDist(rng))};
+            if(percentDist(rng) < 30) {
+                genres.push_back(Genres.at(genreDist(rng)));
+            }
+
+            for(int disc{1}; disc <= discCount && size() < count; ++disc) {
+                for(int number{1}; number <= trackCount && size() < count; ++number) {
+                    const int id        = size();
+                    const QString title = randomPhrase(rng, 3);
+                    const QString path  = u"%1/%2%3 - %4.%5"_s.arg(albumPath)
+                                             .arg(discCount > 1 ? u"%1-"_s.arg(disc) : QString{})
+                                             .arg(number, 2, 10, QChar{u'0'})
+                                             .arg(title, lossy ? u"mp3"_s : u"flac"_s);
+
+                    Track track = store ? Track{path, store} : Track{path};
+                    track.setId(id);
+                    track.setLibraryId(0);
+                    track.setTitle(title);
+                    if(compilation) {
+                        track.setArtists({u"Guest %1"_s.arg(id % 997)});
+                        track.setAlbumArtists({u"Various Artists"_s});
+                    }
+                    else if(percentDist(rng) < 10) {
+                        track.setArtists({artist, u"Guest %1"_s.arg(id % 997)});
+                        track.setAlbumArtists({artist});
+                    }
+                    else {
+                        track.setArtists({artist});
+                        track.setAlbumArtists({artist});
+                    }
+                    track.setAlbum(album);
+                    track.setTrackNumber(QString::number(number));
+                    track.setTrackTotal(QString::number(trackCount));
+                    track.setDiscNumber(QString::number(disc));
+                    track.setDiscTotal(QString::number(discCount));
+                    track.setDate(date);
+                    track.setGenres(genres);
+                    if(percentDist(rng) < 20) {
+                        track.setComposers({randomPhrase(rng, 2)});
+                    }
+                    track.setDuration(static_cast<uint64_t>(durationDist(rng)));
+                    track.setFileSize(track.duration() * (lossy ? 40 : 110));
+                    track.setCodec(lossy ? u"MP3"_s : u"FLAC"_s);
+                    track.setBitrate(lossy ? 320 : 900 + (id % 300));
+                    track.setSampleRate(lossy || percentDist(rng) < 80 ? 44100 : 96000);
+                    track.setBitDepth(lossy ? -1 : 16);
+                    track.setChannels(2);
+                    track.setRGTrackGain(gainDist(rng));
+                    track.setRGAlbumGain(albumGain);
+                    if(percentDist(rng) < 25) {
+                        track.addExtraTag(u"MOOD"_s, Moods.at(moodDist(rng)));
+                    }
+                    track.setPlayCount(percentDist(rng) < 60 ? percentDist(rng) : 0);
+                    if(percentDist(rng) < 30) {
+                        track.setRatingStars((percentDist(rng) % 10) + 1);
+                    }
+                    track.setAddedTime(1600000000000ULL + static_cast<uint64_t>(id) * 60000);
+                    track.generateHash();
+                    tracks.push_back(std::move(track));
+                }
+            }
+        }
+    }
+
+    return tracks;
+}
+
+int intArg(int argc, char** argv, int index, int defaultValue)
+{
+    return argc > index ? std::max(1, std::atoi(argv[index])) : defaultValue;
+}
+
+QString stringArg(int argc, char** argv, int index)
+{
+    return argc > index ? QString::fromLocal8Bit(argv[index]) : QString{};
+}
+
+BenchReport::BenchReport(QString benchmark, int tracks, int iterations)
+    : m_benchmark{std::move(benchmark)}
+    , m_tracks{tracks}
+    , m_iterations{iterations}
+{ }
+
+void BenchReport::add(const QString& name, double msPerRun, qint64 items)
+{
+    m_results.emplace_back(name, msPerRun, items);
+}
+
+void BenchReport::addMetric(const QString& name, qint64 value, const QString& unit)
+{
+    m_metrics.emplace_back(name, value, unit);
+}
+
+void BenchReport::print() const
+{
+    std::printf("%s: tracks: %d, iterations: %d\n", m_benchmark.toUtf8().constData(), m_tracks, m_iterations);
+    std::printf("%-32s %12s %14s\n", "case", "ms/run", "items/s");
+
+    for(const auto& [name, msPerRun, items] : m_results) {
+        const double perSecond = items > 0 && msPerRun > 0.0 ? static_cast<double>(items) * 1000.0 / msPerRun : 0.0;
+        std::printf("%-32s %12.2f %14.0f\n", name.toUtf8().constData(), msPerRun, perSecond);
+    }
+
+    if(m_metrics.empty()) {
+        return;
+    }
+
+    std::printf("\n%-44s %14s %s\n", "metric", "value", "unit");
+    for(const auto& [name, value, unit] : m_metrics) {
+        std::printf("%-44s %14lld %s\n", name.toUtf8().constData(), static_cast<long long>(value),
+                    unit.toUtf8().constData());
+    }
+}
+
+bool BenchReport::writeJson(const QString& filepath) const
+{
+    QJsonArray results;
+    for(const auto& [name, msPerRun, items] : m_results) {
+        QJsonObject result;
+        result[u"name"_s]     = name;
+        result[u"msPerRun"_s] = msPerRun;
+        result[u"items"_s]    = items;
+        if(items > 0 && msPerRun > 0.0) {
+            result[u"itemsPerSecond"_s] = static_cast<double>(items) * 1000.0 / msPerRun;
+        }
+        results.append(result);
+    }
+
+    QJsonArray metrics;
+    for(const auto& [name, value, unit] : m_metrics) {
+        QJsonObject metric;
+        metric[u"name"_s]  = name;
+        metric[u"value"_s] = value;
+        metric[u"unit"_s]  = unit;
+        metrics.append(metric);
+    }
+
+    QJsonObject report;
+    report[u"benchmark"_s]  = m_benchmark;
+    report[u"version"_s]    = QString::fromLatin1(FOOYIN_BENCH_VERSION);
+    report[u"qtVersion"_s]  = QString::fromLatin1(qVersion());
+    report[u"timestamp"_s]  = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report[u"tracks"_s]     = m_tracks;
+    report[u"iterations"_s] = m_iterations;
+    report[u"results"_s]    = results;
+    report[u"metrics"_s]    = metrics;
+
+    QFile file{filepath};
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    return file.write(QJsonDocument{report}.toJson()) >= 0;
+}
+
+int BenchReport::finish(const QString& outputPath) const
+{
+    print();
+
+    if(!outputPath.isEmpty() && !writeJson(outputPath)) {
+        std::fprintf(stderr, "failed to write results to %s\n", outputPath.toUtf8().constData());
+        return 1;
+    }
+
+    return 0;
+}
+} // namespace Fooyin::Benchmarks
@@ -0,0 +1,102 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/track.h>
+
+#include <QString>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace Fooyin {
+class TrackMetadataStore;
+
+namespace Benchmarks {
+/*!
+ * Generates a deterministic library shaped like a real collection.
+ *
+ * Artists own several albums of numbered tracks with multi-value genres, dates, ReplayGain, technical
+ * properties and a few extra tags. Tracks get sequential ids and hashes and belong to library 0.
+ */
+[[nodiscard]] TrackList makeLibrary(int count, const std::shared_ptr<TrackMetadataStore>& store = {},
+                                    uint32_t seed = 1);
+
+//! Returns the positional argument at @p index as a positive integer, or @p defaultValue if missing.
+[[nodiscard]] int intArg(int argc, char** argv, int index, int defaultValue);
+//! Returns the positional argument at @p index, or an empty string if missing.
+[[nodiscard]] QString stringArg(int argc, char** argv, int index);
+
+template <typename Func>
+double millisecondsPerRun(int iterations, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i{0}; i < iterations; ++i) {
+        func();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/*!
+ * Collects timings for one benchmark executable.
+ *
+ * Results are printed as a table and can also be written as JSON, so runs can be compared across releases.
+ */
+class BenchReport
+{
+public:
+    BenchReport(QString benchmark, int tracks, int iterations);
+
+    //! Records a case; @p items is the number of items processed per run, used to derive throughput.
+    void add(const QString& name, double msPerRun, qint64 items = 0);
+    //! Records a non-timing measurement such as a count or size, reported alongside the timings.
+    void addMetric(const QString& name, qint64 value, const QString& unit);
+
+    void print() const;
+    bool writeJson(const QString& filepath) const;
+
+    //! Prints the results and writes them to @p outputPath if set, returning the process exit code.
+    [[nodiscard]] int finish(const QString& outputPath) const;
+
+private:
+    struct Result
+    {
+        QString name;
+        double msPerRun{0.0};
+        qint64 items{0};
+    };
+
+    struct Metric
+    {
+        QString name;
+        qint64 value{0};
+        QString unit;
+    };
+
+    QString m_benchmark;
+    int m_tracks;
+    int m_iterations;
+    std::vector<Result> m_results;
+    std::vector<Metric> m_metrics;
+};
+} // namespace Benchmarks
+} // namespace Fooyin
@@ -0,0 +1,142 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Reports sample conversion throughput (samples/sec) for each format pair and SIMD level.
+// Usage: bench_audioconverter [frames-per-buffer] [iterations]
+
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioformat.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Fooyin;
+
+namespace {
+constexpr int SampleRate = 48000;
+constexpr int Channels   = 2;
+
+struct FormatInfo
+{
+    SampleFormat format;
+    const char* name;
+};
+
+constexpr std::array<FormatInfo, 6> Formats = {{{SampleFormat::U8, "U8"},
+                                                {SampleFormat::S16, "S16"},
+                                                {SampleFormat::S24In32, "S24In32"},
+                                                {SampleFormat::S32, "S32"},
+                                                {SampleFormat::F32, "F32"},
+                                                {SampleFormat::F64, "F64"}}};
+
+const char* levelName(Audio::SimdLevel level)
+{
+    switch(level) {
+        case Audio::SimdLevel::Scalar:
+            return "scalar";
+        case Audio::SimdLevel::SSE2:
+            return "sse2";
+        case Audio::SimdLevel::AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+std::vector<std::byte> makeInput(const AudioFormat& format, int frames)
+{
+    std::vector<std::byte> raw(static_cast<size_t>(format.bytesForFrames(frames)));
+
+    // Normalised F64 samples converted to the input format
+    const AudioFormat f64Format{SampleFormat::F64, SampleRate, Channels};
+    std::vector<double> samples(static_cast<size_t>(frames) * Channels);
+
+    std::mt19937 rng{1};
+    std::uniform_real_distribution<double> dist{-1.0, 1.0};
+    for(double& sample : samples) {
+        sample = dist(rng);
+    }
+
+    Audio::convert(f64Format, reinterpret_cast<const std::byte*>(samples.data()), format, raw.data(), frames);
+    return raw;
+}
+
+double samplesPerSecond(const AudioFormat& inFormat, const std::vector<std::byte>& input, const AudioFormat& outFormat,
+                        std::vector<std::byte>& output, int frames, int iterations, bool dither)
+{
+    // Warm up caches and the dispatch table
+    Audio::convert(inFormat, input.data(), outFormat, output.data(), frames, dither);
+
+    const auto start = std::chrono::steady_clock::now();
+    for(int i{0}; i < iterations; ++i) {
+        Audio::convert(inFormat, input.data(), outFormat, output.data(), frames, dither);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double samples = static_cast<double>(frames) * Channels * iterations;
+    return elapsed.count() > 0.0 ? samples / elapsed.count() : 0.0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int frames     = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4096;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+
+    const Audio::SimdLevel supported = Audio::supportedSimdLevel();
+
+    std::printf("frames/buffer: %d, channels: %d, iterations: %d, supported: %s\n", frames, Channels, iterations,
+                levelName(supported));
+    std::printf("%-8s %-8s %-7s %-7s %14s\n", "input", "output", "dither", "level", "Msamples/s");
+
+    for(const auto& in : Formats) {
+        const AudioFormat inFormat{in.format, SampleRate, Channels};
+        const std::vector<std::byte> input = makeInput(inFormat, frames);
+
+        for(const auto& out : Formats) {
+            const AudioFormat outFormat{out.format, SampleRate, Channels};
+            std::vector<std::byte> output(static_cast<size_t>(outFormat.bytesForFrames(frames)));
+
+            const bool canDither = out.format == SampleFormat::S16
+                                && (in.format == SampleFormat::F32 || in.format == SampleFormat::F64);
+
+            for(const bool dither : {false, true}) {
+                if(dither && !canDither) {
+                    continue;
+                }
+
+                for(auto level{Audio::SimdLevel::Scalar}; level <= supported;
+                    level = static_cast<Audio::SimdLevel>(static_cast<int>(level) + 1)) {
+                    Audio::setSimdLevel(level);
+                    const double rate
+                        = samplesPerSecond(inFormat, input, outFormat, output, frames, iterations, dither);
+                    std::printf("%-8s %-8s %-7s %-7s %14.1f\n", in.name, out.name, dither ? "yes" : "no",
+                                levelName(level), rate / 1e6);
+                }
+            }
+        }
+    }
+
+    Audio::setSimdLevel(supported);
+    return 0;
+}
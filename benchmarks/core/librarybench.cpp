@@ -0,0 +1,242 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures library-scale core operations on a synthetic library: loading from the database, sorting, filtering and
+// string interning and resolving.
+// Usage: bench_library [tracks] [iterations] [json output]
+
+#include "benchutils.h"
+#include "core/database/dbschema.h"
+#include "core/database/trackdatabase.h"
+
+#include <core/library/tracksort.h>
+#include <core/scripting/scriptparser.h>
+#include <core/stringpool.h>
+#include <core/trackmetadatastore.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace Fooyin;
+using namespace Fooyin::Benchmarks;
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto SchemaVersion = 18;
+
+void benchStringPool(BenchReport& report, const TrackList& tracks, int iterations)
+{
+    std::vector<QStringList> artists;
+    std::vector<QString> albums;
+    std::vector<QStringList> genres;
+    artists.reserve(tracks.size());
+    albums.reserve(tracks.size());
+    genres.reserve(tracks.size());
+
+    for(const Track& track : tracks) {
+        artists.push_back(track.artists());
+        albums.push_back(track.album());
+        genres.push_back(track.genres());
+    }
+
+    const auto internAll = [&](StringPool& pool) {
+        for(size_t i{0}; i < tracks.size(); ++i) {
+            std::ignore = pool.internList(StringPool::Domain::Artist, artists.at(i));
+            std::ignore = pool.internId(StringPool::Domain::Album, albums.at(i));
+            std::ignore = pool.internList(StringPool::Domain::Genre, genres.at(i));
+        }
+    };
+
+    const auto count = static_cast<qint64>(tracks.size());
+
+    report.add(u"StringPool intern (cold)"_s, millisecondsPerRun(iterations, [&]() {
+                   StringPool pool;
+                   internAll(pool);
+               }),
+               count);
+
+    StringPool warmPool;
+    internAll(warmPool);
+    report.add(u"StringPool intern (warm)"_s, millisecondsPerRun(iterations, [&]() { internAll(warmPool); }), count);
+
+    // Resolves don't take the domain lock, so total throughput should grow with the number of reader threads
+    std::vector<StringPool::StringListRef> refs;
+    refs.reserve(tracks.size());
+    for(const QStringList& trackArtists : artists) {
+        refs.push_back(warmPool.internList(StringPool::Domain::Artist, trackArtists));
+    }
+
+    const unsigned maxThreads = std::clamp(std::thread::hardware_concurrency(), 1U, 8U);
+    for(unsigned threads{1}; threads <= maxThreads; threads *= 2) {
+        std::atomic<qsizetype> totalLength{0};
+        report.add(u"StringPool resolve (%1 threads)"_s.arg(threads), millisecondsPerRun(iterations, [&]() {
+                       std::vector<std::jthread> workers;
+                       for(unsigned t{0}; t < threads; ++t) {
+                           workers.emplace_back([&warmPool, &refs, &totalLength, t]() {
+                               qsizetype length{0};
+                               for(size_t i{0}; i < refs.size(); ++i) {
+                                   const auto& ref = refs[(i + (t * 7919)) % refs.size()];
+                                   length += warmPool.valueAt(StringPool::Domain::Artist, ref, 0).size();
+                               }
+                               totalLength += length;
+                           });
+                       }
+                   }),
+                   count * threads);
+    }
+}
+
+bool benchDatabase(BenchReport& report, const TrackList& tracks, int iterations)
+{
+    const QTemporaryDir dir;
+    if(!dir.isValid()) {
+        std::fprintf(stderr, "failed to create temporary directory\n");
+        return false;
+    }
+
+    DbConnection::DbParams params;
+    params.type           = u"QSQLITE"_s;
+    params.connectOptions = u"QSQLITE_OPEN_URI"_s;
+    params.filePath       = dir.filePath(u"bench.db"_s);
+
+    auto dbPool = DbConnectionPool::create(params, u"bench-library"_s);
+    const DbConnectionHandler handler{dbPool};
+    const DbConnectionProvider provider{dbPool};
+
+    DbSchema schema{provider};
+    const auto upgradeResult = schema.upgradeDatabase(SchemaVersion, u"://dbschema.xml"_s);
+    if(upgradeResult != DbSchema::UpgradeResult::Success && upgradeResult != DbSchema::UpgradeResult::IsCurrent) {
+        std::fprintf(stderr, "failed to create database schema\n");
+        return false;
+    }
+
+    TrackDatabase trackDb;
+    trackDb.initialise(provider);
+
+    TrackList newTracks{tracks};
+    for(Track& track : newTracks) {
+        track.setId(-1);
+    }
+
+    bool stored{false};
+    report.add(u"TrackDatabase::storeTracks"_s,
+               millisecondsPerRun(1, [&]() { stored = trackDb.storeTracks(newTracks); }),
+               static_cast<qint64>(tracks.size()));
+    if(!stored) {
+        std::fprintf(stderr, "storeTracks failed\n");
+        return false;
+    }
+
+    size_t loaded{0};
+    report.add(u"TrackDatabase::getAllTracks"_s, millisecondsPerRun(iterations, [&]() {
+                   trackDb.setMetadataStore(std::make_shared<TrackMetadataStore>());
+                   loaded = trackDb.getAllTracks().size();
+               }),
+               static_cast<qint64>(tracks.size()));
+    if(loaded != tracks.size()) {
+        std::fprintf(stderr, "getAllTracks returned %zu of %zu tracks\n", loaded, tracks.size());
+        return false;
+    }
+
+    return true;
+}
+
+void benchSorting(BenchReport& report, const TrackList& tracks, int iterations)
+{
+    TrackSorter sorter;
+
+    const std::vector<std::pair<QString, QString>> sorts{
+        {u"sort: title"_s, u"%title%"_s},
+        {u"sort: album artist/album/track"_s,
+         u"%albumartist% - %date% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%"_s},
+    };
+
+    for(const auto& [name, script] : sorts) {
+        report.add(name, millisecondsPerRun(iterations, [&]() { std::ignore = sorter.calcSortTracks(script, tracks); }),
+                   static_cast<qint64>(tracks.size()));
+    }
+
+    // Sort key evaluation and merging are split across the global thread pool
+    auto* threadPool          = QThreadPool::globalInstance();
+    const int defaultThreads  = threadPool->maxThreadCount();
+    const ParsedScript script = sorter.parseSortScript(sorts.back().second);
+
+    for(int threads{1}; threads <= defaultThreads; threads *= 2) {
+        threadPool->setMaxThreadCount(threads);
+        report.add(u"sort: album artist/album/track (%1 threads)"_s.arg(threads),
+                   millisecondsPerRun(iterations, [&]() { std::ignore = sorter.calcSortTracks(script, tracks); }),
+                   static_cast<qint64>(tracks.size()));
+    }
+    threadPool->setMaxThreadCount(defaultThreads);
+}
+
+void benchFiltering(BenchReport& report, const TrackList& tracks, int iterations)
+{
+    ScriptParser parser;
+
+    const std::vector<std::pair<QString, QString>> queries{
+        {u"filter: plain text"_s, u"ocean"_s},
+        {u"filter: field contains"_s, u"artist:night"_s},
+        {u"filter: numeric compare"_s, u"playcount>10 AND genre:rock"_s},
+    };
+
+    for(const auto& [name, query] : queries) {
+        report.add(name, millisecondsPerRun(iterations, [&]() { std::ignore = parser.filter(query, tracks); }),
+                   static_cast<qint64>(tracks.size()));
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const QCoreApplication app{argc, argv};
+
+    const int trackCount     = intArg(argc, argv, 1, 100000);
+    const int iterations     = intArg(argc, argv, 2, 3);
+    const QString outputPath = stringArg(argc, argv, 3);
+
+    BenchReport report{u"bench_library"_s, trackCount, iterations};
+
+    TrackList tracks;
+    report.add(u"generate library"_s,
+               millisecondsPerRun(1, [&]() { tracks = makeLibrary(trackCount, std::make_shared<TrackMetadataStore>()); }),
+               trackCount);
+
+    benchStringPool(report, tracks, iterations);
+    if(!benchDatabase(report, tracks, iterations)) {
+        return 1;
+    }
+    benchSorting(report, tracks, iterations);
+    benchFiltering(report, tracks, iterations);
+
+    return report.finish(outputPath);
+}
@@ -0,0 +1,141 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Compares saving a small edit to a large playlist with rewriting every PlaylistTracks row.
+// Usage: bench_playlistdatabase [tracks] [iterations] [json output]
+
+#include "benchutils.h"
+#include "core/database/playlistdatabase.h"
+
+#include <core/track.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+#include <utils/database/dbquery.h>
+#include <utils/database/dbtransaction.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#include <cstdio>
+
+using namespace Fooyin;
+using namespace Fooyin::Benchmarks;
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr int PlaylistId = 1;
+
+Track makeTrack(int id)
+{
+    Track track{u"/music/%1.flac"_s.arg(id), 0};
+    track.setId(id);
+    return track;
+}
+
+// Alternates between appending a track and removing one near the end
+void editPlaylist(TrackList& tracks, int edit, int nextId)
+{
+    if(edit % 2 == 0) {
+        tracks.push_back(makeTrack(nextId));
+    }
+    else {
+        tracks.erase(tracks.end() - 10);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const QCoreApplication app{argc, argv};
+
+    const int trackCount     = intArg(argc, argv, 1, 50000);
+    const int iterations     = intArg(argc, argv, 2, 20);
+    const QString outputPath = stringArg(argc, argv, 3);
+
+    const QTemporaryDir dir;
+    if(!dir.isValid()) {
+        std::fprintf(stderr, "failed to create temporary directory\n");
+        return 1;
+    }
+
+    DbConnection::DbParams params;
+    params.type     = u"QSQLITE"_s;
+    params.filePath = dir.filePath(u"bench.db"_s);
+
+    auto dbPool = DbConnectionPool::create(params, u"bench-playlistdatabase"_s);
+    const DbConnectionHandler handler{dbPool};
+    const DbConnectionProvider provider{dbPool};
+
+    DbQuery create{provider.db(), u"CREATE TABLE IF NOT EXISTS PlaylistTracks ("
+                                  "PlaylistID INTEGER NOT NULL, "
+                                  "TrackID INTEGER NOT NULL, "
+                                  "TrackIndex INTEGER NOT NULL);"_s};
+    if(!create.exec()) {
+        std::fprintf(stderr, "failed to create PlaylistTracks table\n");
+        return 1;
+    }
+
+    PlaylistDatabase playlistDb;
+    playlistDb.initialise(provider);
+
+    BenchReport report{u"bench_playlistdatabase"_s, trackCount, iterations};
+
+    TrackList tracks;
+    tracks.reserve(static_cast<size_t>(trackCount) + iterations);
+    for(int i{1}; i <= trackCount; ++i) {
+        tracks.push_back(makeTrack(i));
+    }
+
+    // Clearing the rows first makes the save insert the whole playlist, as saves did before range diffing
+    const auto save = [&](bool fullRewrite) {
+        DbTransaction transaction{provider.db()};
+        if(fullRewrite) {
+            DbQuery clear{provider.db(), u"DELETE FROM PlaylistTracks WHERE PlaylistID = :id;"_s};
+            clear.bindValue(u":id"_s, PlaylistId);
+            if(!clear.exec()) {
+                return false;
+            }
+        }
+        return playlistDb.savePlaylistTracks(PlaylistId, tracks) && transaction.commit();
+    };
+
+    bool saved{true};
+    report.add(u"initial save"_s, millisecondsPerRun(1, [&]() { saved = save(false); }), trackCount);
+
+    int edit{0};
+    int nextId{trackCount + 1};
+
+    report.add(u"small edit: changed range"_s, millisecondsPerRun(iterations, [&]() {
+                   editPlaylist(tracks, edit++, nextId++);
+                   saved = saved && save(false);
+               }));
+    report.add(u"small edit: full rewrite"_s, millisecondsPerRun(iterations, [&]() {
+                   editPlaylist(tracks, edit++, nextId++);
+                   saved = saved && save(true);
+               }));
+
+    if(!saved) {
+        std::fprintf(stderr, "savePlaylistTracks failed\n");
+        return 1;
+    }
+
+    return report.finish(outputPath);
+}
@@ -0,0 +1,150 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares compiled title-formatting scripts with the tree-walking interpreter, one script per opcode family.
+// Usage: bench_scriptprogram [tracks] [iterations]
+
+#include <core/scripting/scriptparser.h>
+#include <core/track.h>
+
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace Fooyin;
+using namespace Qt::StringLiterals;
+
+namespace {
+struct Case
+{
+    const char* name;
+    QString script;
+};
+
+TrackList makeTracks(int count)
+{
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<int> numberDist{0, 9999};
+
+    TrackList tracks;
+    tracks.reserve(static_cast<size_t>(count));
+
+    for(int i{0}; i < count; ++i) {
+        Track track{u"/music/Artist %1/Album %2/%3.flac"_s.arg(i % 200).arg(i % 1000).arg(i)};
+        track.setId(i);
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.setArtists({u"Artist %1"_s.arg(i % 200)});
+        track.setAlbum(i % 3 == 0 ? QString{} : u"Album %1"_s.arg(i % 1000));
+        track.setGenres({u"Pop"_s, u"Rock"_s});
+        track.setTrackNumber(QString::number((i % 20) + 1));
+        track.setYear(1960 + (numberDist(rng) % 60));
+        track.setPlayCount(numberDist(rng) % 100);
+        track.setDuration(static_cast<uint64_t>(60000 + (numberDist(rng) * 37)));
+        track.setFileSize(static_cast<uint64_t>(1000000 + (numberDist(rng) * 1000)));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+template <typename Func>
+double nanosecondsPerEval(int evaluations, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / evaluations;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int trackCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20000;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    const TrackList tracks = makeTracks(trackCount);
+    const int evaluations  = trackCount * iterations;
+
+    const std::vector<Case> cases{
+        {"literal", u"Some literal text"_s},
+        {"variable", u"%title%"_s},
+        {"variable list", u"%<genre>%"_s},
+        {"field", u"%playcount%"_s},
+        {"call", u"$upper(%title%)"_s},
+        {"get/put", u"$puts(x,%title%)$get(x)"_s},
+        {"if", u"$if(%album%,%album%,%title%)"_s},
+        {"if3", u"$if3(%album%,%comment%,%title%)"_s},
+        {"ifgreater", u"$ifgreater(%playcount%,50,often,rarely)"_s},
+        {"iflonger", u"$iflonger(%title%,8,long,short)"_s},
+        {"arithmetic", u"$div($add(%playcount%,%year%),2)"_s},
+        {"mod", u"$mod(%year%,10)"_s},
+        {"num", u"$num(%track%,2)"_s},
+        {"pad", u"$pad(%playcount%,4,0)"_s},
+        {"concat", u"$upper(%track%. %title%)"_s},
+        {"conditional", u"[%album% - ]%title%"_s},
+        {"folded", u"$add(1,2)[$num(7,3)]$if(1,a,b)"_s},
+        {"mixed", u"[$num(%track%,2). ]%title%[ ($div(%duration_s%,60) min)][ - %playcount% plays]"_s},
+    };
+
+    std::printf("tracks: %d, iterations: %d\n", trackCount, iterations);
+    std::printf("%-14s %14s %14s %9s\n", "case", "interp ns", "compiled ns", "speedup");
+
+    ScriptParser parser;
+
+    for(const auto& [name, script] : cases) {
+        QStringList interpreted;
+        QStringList compiled;
+        interpreted.reserve(trackCount);
+        compiled.reserve(trackCount);
+
+        parser.setCompilationEnabled(false);
+        const double interpNs = nanosecondsPerEval(evaluations, [&]() {
+            for(int i{0}; i < iterations; ++i) {
+                interpreted.clear();
+                for(const Track& track : tracks) {
+                    interpreted.push_back(parser.evaluate(script, track));
+                }
+            }
+        });
+
+        parser.setCompilationEnabled(true);
+        const double compiledNs = nanosecondsPerEval(evaluations, [&]() {
+            for(int i{0}; i < iterations; ++i) {
+                compiled.clear();
+                for(const Track& track : tracks) {
+                    compiled.push_back(parser.evaluate(script, track));
+                }
+            }
+        });
+
+        if(interpreted != compiled) {
+            std::fprintf(stderr, "mismatch for '%s'\n", script.toUtf8().constData());
+            return 1;
+        }
+
+        std::printf("%-14s %14.1f %14.1f %8.2fx\n", name, interpNs, compiledNs,
+                    compiledNs > 0.0 ? interpNs / compiledNs : 0.0);
+    }
+
+    return 0;
+}
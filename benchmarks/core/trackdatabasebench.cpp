@@ -0,0 +1,158 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures TrackDatabase::storeTracks and updateTracks throughput against a temporary database.
+// Usage: bench_trackdatabase [tracks] [batch size]
+
+#include "core/database/dbschema.h"
+#include "core/database/trackdatabase.h"
+
+#include <core/track.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Fooyin;
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto SchemaVersion = 18;
+
+TrackList makeTracks(int count)
+{
+    TrackList tracks;
+    tracks.reserve(static_cast<size_t>(count));
+
+    for(int i{0}; i < count; ++i) {
+        const QString artist = u"Artist %1"_s.arg(i % 500);
+        const QString album  = u"Album %1"_s.arg(i % 5000);
+
+        Track track{u"/music/%1/%2/%3.flac"_s.arg(artist, album).arg(i)};
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.setArtists({artist});
+        track.setAlbumArtists({artist});
+        track.setAlbum(album);
+        track.setTrackNumber(QString::number(i % 20 + 1));
+        track.setGenres({u"Genre %1"_s.arg(i % 40)});
+        track.setDuration(180000 + (i % 1000));
+        track.setSampleRate(44100);
+        track.setBitDepth(16);
+        track.setChannels(2);
+        track.setCodec(u"FLAC"_s);
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+template <typename Func>
+double elapsedSeconds(Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+bool runBatches(TrackList& tracks, int batchSize, Func&& func)
+{
+    for(size_t first{0}; first < tracks.size(); first += static_cast<size_t>(batchSize)) {
+        const auto last = std::min(tracks.size(), first + static_cast<size_t>(batchSize));
+        TrackList batch{tracks.begin() + static_cast<std::ptrdiff_t>(first),
+                        tracks.begin() + static_cast<std::ptrdiff_t>(last)};
+        if(!func(batch)) {
+            return false;
+        }
+        std::ranges::copy(batch, tracks.begin() + static_cast<std::ptrdiff_t>(first));
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const QCoreApplication app{argc, argv};
+
+    const int trackCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const int batchSize  = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+
+    const QTemporaryDir dir;
+    if(!dir.isValid()) {
+        std::fprintf(stderr, "failed to create temporary directory\n");
+        return 1;
+    }
+
+    DbConnection::DbParams params;
+    params.type           = u"QSQLITE"_s;
+    params.connectOptions = u"QSQLITE_OPEN_URI"_s;
+    params.filePath       = dir.filePath(u"bench.db"_s);
+
+    auto dbPool = DbConnectionPool::create(params, u"bench-trackdatabase"_s);
+    const DbConnectionHandler handler{dbPool};
+    const DbConnectionProvider provider{dbPool};
+
+    DbSchema schema{provider};
+    const auto upgradeResult = schema.upgradeDatabase(SchemaVersion, u"://dbschema.xml"_s);
+    if(upgradeResult != DbSchema::UpgradeResult::Success && upgradeResult != DbSchema::UpgradeResult::IsCurrent) {
+        std::fprintf(stderr, "failed to create database schema\n");
+        return 1;
+    }
+
+    TrackDatabase trackDb;
+    trackDb.initialise(provider);
+
+    TrackList tracks = makeTracks(trackCount);
+
+    bool success{true};
+    const double storeSecs = elapsedSeconds([&]() {
+        success = runBatches(tracks, batchSize, [&trackDb](TrackList& batch) { return trackDb.storeTracks(batch); });
+    });
+    if(!success) {
+        std::fprintf(stderr, "storeTracks failed\n");
+        return 1;
+    }
+
+    for(Track& track : tracks) {
+        track.setTitle(track.title() + u" (Remastered)"_s);
+    }
+
+    const double updateSecs = elapsedSeconds([&]() {
+        success = runBatches(tracks, batchSize, [&trackDb](TrackList& batch) { return trackDb.updateTracks(batch); });
+    });
+    if(!success) {
+        std::fprintf(stderr, "updateTracks failed\n");
+        return 1;
+    }
+
+    std::printf("tracks: %d, batch size: %d, stored: %d\n", trackCount, batchSize, trackDb.trackCount());
+    std::printf("%-14s %10.1f ms %12.0f rows/s\n", "storeTracks", storeSecs * 1000.0, trackCount / storeSecs);
+    std::printf("%-14s %10.1f ms %12.0f rows/s\n", "updateTracks", updateSecs * 1000.0, trackCount / updateSecs);
+
+    return 0;
+}
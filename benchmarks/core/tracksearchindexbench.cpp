@@ -0,0 +1,135 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares plain-term search through the track search index with a full scan using Track::hasMatch.
+// Usage: bench_tracksearchindex [tracks] [iterations]
+
+#include <core/track.h>
+#include <core/trackmetadatastore.h>
+#include <core/tracksearchindex.h>
+
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+using namespace Fooyin;
+using namespace Qt::StringLiterals;
+
+namespace {
+const QStringList Words = {u"love"_s,  u"night"_s, u"café"_s,   u"ocean"_s, u"blue"_s,   u"fire"_s,  u"dream"_s,
+                           u"heart"_s, u"city"_s,  u"sunset"_s, u"rain"_s,  u"électro"_s, u"storm"_s, u"shadow"_s,
+                           u"river"_s, u"gold"_s,  u"echo"_s,   u"winter"_s, u"lights"_s, u"road"_s,  u"señor"_s};
+
+QString randomPhrase(std::mt19937& rng, int wordCount)
+{
+    std::uniform_int_distribution<qsizetype> dist{0, Words.size() - 1};
+
+    QStringList words;
+    for(int i{0}; i < wordCount; ++i) {
+        words.push_back(Words.at(dist(rng)));
+    }
+    return words.join(u' ');
+}
+
+TrackList makeTracks(const std::shared_ptr<TrackMetadataStore>& store, int count)
+{
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<int> numberDist{0, 9999};
+
+    TrackList tracks;
+    tracks.reserve(static_cast<size_t>(count));
+
+    for(int i{0}; i < count; ++i) {
+        const QString artist = u"%1 %2"_s.arg(randomPhrase(rng, 2)).arg(numberDist(rng) % 500);
+        const QString album  = u"%1 %2"_s.arg(randomPhrase(rng, 2)).arg(numberDist(rng) % 2000);
+        const QString title  = randomPhrase(rng, 3);
+
+        Track track{u"/music/%1/%2/%3 %4.flac"_s.arg(artist, album).arg(i % 20).arg(title), store};
+        track.setId(i);
+        track.setTitle(title);
+        track.setArtists({artist});
+        track.setAlbum(album);
+        track.setAlbumArtists({artist});
+        track.setGenres({randomPhrase(rng, 1)});
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+template <typename Func>
+double millisecondsPerRun(int iterations, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i{0}; i < iterations; ++i) {
+        func();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int trackCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    auto store             = std::make_shared<TrackMetadataStore>();
+    const TrackList tracks = makeTracks(store, trackCount);
+
+    TrackSearchIndex& index = store->searchIndex();
+    const double buildMs    = millisecondsPerRun(1, [&]() { index.rebuild(tracks); });
+
+    std::printf("tracks: %d, iterations: %d, index build: %.1f ms\n", trackCount, iterations, buildMs);
+    std::printf("%-16s %10s %12s %12s %9s\n", "term", "matches", "scan ms", "index ms", "speedup");
+
+    const QStringList terms
+        = {u"c"_s, u"ca"_s, u"cafe"_s, u"ocean"_s, u"night 42"_s, u"electro storm"_s, u"senor"_s, u"missing"_s};
+
+    for(const QString& term : terms) {
+        size_t scanMatches{0};
+        const double scanMs = millisecondsPerRun(iterations, [&]() {
+            scanMatches = static_cast<size_t>(
+                std::ranges::count_if(tracks, [&term](const Track& track) { return track.hasMatch(term); }));
+        });
+
+        size_t indexMatches{0};
+        const double indexMs = millisecondsPerRun(iterations, [&]() {
+            const auto query = index.prepare({term});
+            indexMatches     = static_cast<size_t>(
+                std::ranges::count_if(tracks, [&query](const Track& track) { return query.matches(track) == true; }));
+        });
+
+        if(scanMatches != indexMatches) {
+            std::fprintf(stderr, "mismatch for '%s': scan %zu, index %zu\n", term.toUtf8().constData(), scanMatches,
+                         indexMatches);
+            return 1;
+        }
+
+        std::printf("%-16s %10zu %12.2f %12.2f %8.1fx\n", term.toUtf8().constData(), scanMatches, scanMs, indexMs,
+                    indexMs > 0.0 ? scanMs / indexMs : 0.0);
+    }
+
+    return 0;
+}
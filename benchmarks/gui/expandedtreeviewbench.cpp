@@ -0,0 +1,215 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Scrolls, resizes header rows and expands groups in an ExpandedTreeView showing a large synthetic model.
+// Usage: bench_expandedtreeview [rows] [rows per group] [iterations]
+
+#include <gui/widgets/expandedtreeview.h>
+
+#include <QAbstractItemModel>
+#include <QApplication>
+#include <QScrollBar>
+#include <QSize>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+
+using namespace Fooyin;
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto ColumnCount  = 3;
+constexpr auto HeaderHeight = 40;
+
+// Two-level model of group headers and track rows; the last few groups start collapsed
+class SyntheticTreeModel : public QAbstractItemModel
+{
+public:
+    SyntheticTreeModel(int groups, int rowsPerGroup, int collapsedGroups)
+        : m_rowsPerGroup{rowsPerGroup}
+        , m_expanded(groups, true)
+        , m_headerHeights(groups, HeaderHeight)
+    {
+        std::fill(m_expanded.end() - std::min(groups, collapsedGroups), m_expanded.end(), false);
+    }
+
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex& parent) const override
+    {
+        if(!hasIndex(row, column, parent)) {
+            return {};
+        }
+        return createIndex(row, column, parent.isValid() ? static_cast<quintptr>(parent.row()) + 1 : 0);
+    }
+
+    [[nodiscard]] QModelIndex parent(const QModelIndex& child) const override
+    {
+        if(!child.isValid() || child.internalId() == 0) {
+            return {};
+        }
+        return createIndex(static_cast<int>(child.internalId() - 1), 0, quintptr{0});
+    }
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent) const override
+    {
+        if(!parent.isValid()) {
+            return static_cast<int>(m_expanded.size());
+        }
+        if(parent.internalId() != 0 || parent.column() != 0) {
+            return 0;
+        }
+        return m_expanded.at(parent.row()) ? m_rowsPerGroup : 0;
+    }
+
+    [[nodiscard]] int columnCount(const QModelIndex& /*parent*/) const override
+    {
+        return ColumnCount;
+    }
+
+    [[nodiscard]] Qt::ItemFlags flags(const QModelIndex& index) const override
+    {
+        Qt::ItemFlags flags = QAbstractItemModel::flags(index);
+        if(index.internalId() != 0) {
+            flags |= Qt::ItemNeverHasChildren;
+        }
+        return flags;
+    }
+
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role) const override
+    {
+        if(!index.isValid()) {
+            return {};
+        }
+
+        const bool isHeader = index.internalId() == 0;
+
+        if(role == Qt::SizeHintRole && isHeader) {
+            return QSize{-1, m_headerHeights.at(index.row())};
+        }
+        if(role != Qt::DisplayRole) {
+            return {};
+        }
+        if(isHeader) {
+            return index.column() == 0 ? u"Group %1"_s.arg(index.row()) : QString{};
+        }
+        return u"Track %1.%2"_s.arg(index.internalId() - 1).arg(index.row());
+    }
+
+    [[nodiscard]] int firstCollapsedGroup() const
+    {
+        const auto it = std::ranges::find(m_expanded, false);
+        return it == m_expanded.cend() ? -1 : static_cast<int>(std::ranges::distance(m_expanded.cbegin(), it));
+    }
+
+    void expand(int group)
+    {
+        beginInsertRows(index(group, 0, {}), 0, m_rowsPerGroup - 1);
+        m_expanded[group] = true;
+        endInsertRows();
+    }
+
+    void setHeaderHeight(int group, int height)
+    {
+        m_headerHeights[group] = height;
+        emit dataChanged(index(group, 0, {}), index(group, ColumnCount - 1, {}), {Qt::SizeHintRole});
+    }
+
+private:
+    int m_rowsPerGroup;
+    std::vector<bool> m_expanded;
+    std::vector<int> m_headerHeights;
+};
+
+template <typename Func>
+double millisecondsPerRun(int iterations, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i{0}; i < iterations; ++i) {
+        func();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    const QApplication app{argc, argv};
+
+    const int rowCount     = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000000;
+    const int rowsPerGroup = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+    const int iterations   = argc > 3 ? std::max(1, std::atoi(argv[3])) : 200;
+    const int groups       = std::max(1, rowCount / rowsPerGroup);
+
+    SyntheticTreeModel model{groups, rowsPerGroup, std::max(1, groups / 100)};
+
+    ExpandedTreeView view;
+    view.resize(800, 600);
+    view.show();
+
+    const double layoutMs = millisecondsPerRun(1, [&]() {
+        view.setModel(&model);
+        view.doItemsLayout();
+        // The first lookup builds the row offsets
+        std::ignore = view.indexAt({10, 10});
+    });
+
+    std::mt19937 rng{1};
+    QScrollBar* scrollBar = view.verticalScrollBar();
+    const QPoint centre   = view.viewport()->rect().center();
+
+    const double scrollMs = millisecondsPerRun(iterations, [&]() {
+        std::uniform_int_distribution<int> valueDist{scrollBar->minimum(), scrollBar->maximum()};
+        scrollBar->setValue(valueDist(rng));
+        std::ignore = view.indexAt(centre);
+        view.viewport()->repaint();
+    });
+
+    const double resizeMs = millisecondsPerRun(iterations, [&]() {
+        std::uniform_int_distribution<int> groupDist{0, groups - 1};
+        std::uniform_int_distribution<int> heightDist{HeaderHeight / 2, HeaderHeight * 2};
+        model.setHeaderHeight(groupDist(rng), heightDist(rng));
+        std::ignore = view.indexAt(centre);
+    });
+
+    int expanded{0};
+    const double expandMs = millisecondsPerRun(1, [&]() {
+        for(int group = model.firstCollapsedGroup(); group >= 0; group = model.firstCollapsedGroup()) {
+            model.expand(group);
+            QApplication::processEvents();
+            std::ignore = view.indexAt(centre);
+            ++expanded;
+        }
+    });
+
+    std::printf("rows: %d, groups: %d, iterations: %d\n", groups * rowsPerGroup, groups, iterations);
+    std::printf("%-24s %12.2f ms\n", "initial layout", layoutMs);
+    std::printf("%-24s %12.3f ms\n", "scroll step", scrollMs);
+    std::printf("%-24s %12.3f ms\n", "header height change", resizeMs);
+    std::printf("%-24s %12.2f ms\n", "expand group", expanded > 0 ? expandMs / expanded : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures populating the library tree and playlist views from a synthetic library.
+// Usage: bench_libraryviews [tracks] [iterations] [json output]
+
+#include "benchutils.h"
+#include "gui/librarytree/librarytreegroup.h"
+#include "gui/librarytree/librarytreepopulator.h"
+#include "gui/playlist/playlistcolumn.h"
+#include "gui/playlist/playlistpopulator.h"
+#include "gui/playlist/playlistpreset.h"
+
+#include <core/coresettings.h>
+#include <core/player/playercontroller.h>
+#include <core/playlist/playlist.h>
+#include <core/ratingsymbols.h>
+#include <core/trackmetadatastore.h>
+#include <gui/guisettings.h>
+#include <utils/id.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QApplication>
+#include <QTemporaryDir>
+
+#include <memory>
+
+using namespace Fooyin;
+using namespace Fooyin::Benchmarks;
+using namespace Qt::StringLiterals;
+
+namespace {
+void registerSettings(SettingsManager& settings)
+{
+    settings.createSetting<Settings::Gui::RatingFullStarSymbol>(defaultRatingFullStarSymbol(),
+                                                                u"Interface/RatingFullStarSymbol"_s);
+    settings.createSetting<Settings::Gui::RatingHalfStarSymbol>(defaultRatingHalfStarSymbol(),
+                                                                u"Interface/RatingHalfStarSymbol"_s);
+    settings.createSetting<Settings::Gui::RatingEmptyStarSymbol>(defaultRatingEmptyStarSymbol(),
+                                                                 u"Interface/RatingEmptyStarSymbol"_s);
+
+    settings.createSetting<Settings::Core::PlayMode>(0, QString::fromLatin1(Settings::Core::PlayModeKey));
+    settings.createSetting<Settings::Core::StopAfterCurrent>(false, u"Playback/StopAfterCurrent"_s);
+    settings.createSetting<Settings::Core::ResetStopAfterCurrent>(false, u"Playback/ResetStopAfterCurrent"_s);
+    settings.createSetting<Settings::Core::PlayedThreshold>(0.5, u"Playback/PlayedThreshold"_s);
+    settings.createSetting<Settings::Core::RewindPreviousTrack>(false, u"Playlist/RewindPreviousTrack"_s);
+    settings.createSetting<Settings::Core::PlaybackQueueStopWhenFinished>(false,
+                                                                          u"Playback/PlaybackQueueStopWhenFinished"_s);
+    settings.createSetting<Settings::Core::FollowPlaybackQueue>(false, u"Playback/FollowPlaybackQueue"_s);
+    settings.createSetting<Settings::Core::ShuffleAlbumsGroupScript>(u"%album%"_s,
+                                                                     u"Playback/ShuffleAlbumsGroupScript"_s);
+    settings.createSetting<Settings::Core::ShuffleAlbumsSortScript>(u"%track%"_s,
+                                                                    u"Playback/ShuffleAlbumsSortScript"_s);
+    settings.createTempSetting<Settings::Core::ActiveTrack>(QVariant{});
+    settings.createTempSetting<Settings::Core::ActiveTrackId>(-2);
+}
+
+// Mirrors the default "Album/Disc" preset and track columns
+PlaylistPreset albumPreset()
+{
+    PlaylistPreset preset;
+    preset.name = u"Album/Disc"_s;
+
+    preset.header.title.script    = u"<b><sized=2>$if2(%albumartist%,Unknown Artist)"_s;
+    preset.header.subtitle.script = u"<sized=1>$if2(%album%,Unknown Album)"_s;
+    preset.header.sideText.script = u"<b><sized=2>%year%</sized></b>"_s;
+    preset.header.info.script
+        = u"<sized=-1>[%genres% | ]%trackcount% $ifgreater(%trackcount%,1,Tracks,Track) | %playtime%"_s;
+
+    SubheaderRow subheader;
+    subheader.leftText.script  = u"$ifgreater(%disctotal%,1,Disc #%disc%)"_s;
+    subheader.rightText.script = u"$ifgreater(%disctotal%,1,%playtime%)"_s;
+    preset.subHeaders.push_back(subheader);
+
+    preset.track.leftText.script  = u"[$num(%track%,2).  ]%title%[<alpha=180>  ▪  %uniqueartist%]"_s;
+    preset.track.rightText.script = u"$ifgreater(%playcount%,0,%playcount% |)      %duration% "_s;
+
+    return preset;
+}
+
+PlaylistColumnList trackColumns()
+{
+    return {
+        {.id = 0, .name = u"Track"_s, .field = u"[%disc%.]$num(%track%,2)"_s},
+        {.id = 1, .name = u"Title"_s, .field = u"%title%"_s},
+        {.id = 2, .name = u"Artist"_s, .field = u"%artist%"_s},
+        {.id = 5, .name = u"Album"_s, .field = u"%album%"_s},
+        {.id = 7, .name = u"Duration"_s, .field = u"%duration%"_s},
+    };
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    const QApplication app{argc, argv};
+
+    const int trackCount     = intArg(argc, argv, 1, 100000);
+    const int iterations     = intArg(argc, argv, 2, 3);
+    const QString outputPath = stringArg(argc, argv, 3);
+
+    const QTemporaryDir settingsDir;
+    SettingsManager settings{settingsDir.filePath(u"settings.ini"_s)};
+    registerSettings(settings);
+
+    BenchReport report{u"bench_libraryviews"_s, trackCount, iterations};
+
+    const TrackList tracks = makeLibrary(trackCount, std::make_shared<TrackMetadataStore>());
+    const auto count       = static_cast<qint64>(tracks.size());
+
+    {
+        LibraryTreePopulator populator{nullptr, &settings};
+
+        const LibraryTreeGrouping artistAlbum{
+            .id     = 0,
+            .name   = u"Artist/Album"_s,
+            .script = u"[%albumartist%]||[%album%][ (%year%)]||[%disc%.][$num(%track%,2). ]%title%"_s};
+        const LibraryTreeGrouping folders{
+            .id = 2, .name = u"Folder Structure"_s, .script = u"$replace(%relativepath%,/,||)"_s};
+
+        // Tracks copied into emitted batches; the model keeps these, so they dominate the tree's memory use
+        qint64 batchTracks{0};
+        qint64 batchNodes{0};
+        QObject::connect(&populator, &LibraryTreePopulator::populated, [&](const PendingTreeDataPtr& data) {
+            for(const auto* items : {&data->items, &data->updatedItems}) {
+                batchNodes += static_cast<qint64>(items->size());
+                for(const auto& [key, item] : *items) {
+                    batchTracks += item.trackCount();
+                }
+            }
+        });
+
+        for(const auto& grouping : {artistAlbum, folders}) {
+            report.add(u"LibraryTreePopulator: %1"_s.arg(grouping.name),
+                       millisecondsPerRun(iterations, [&]() { populator.run(grouping, tracks, true); }), count);
+
+            batchTracks = 0;
+            batchNodes  = 0;
+            populator.run(grouping, tracks, true);
+            report.addMetric(u"LibraryTreePopulator: %1 batch nodes"_s.arg(grouping.name), batchNodes, u"nodes"_s);
+            report.addMetric(u"LibraryTreePopulator: %1 batch tracks"_s.arg(grouping.name), batchTracks, u"tracks"_s);
+            report.addMetric(u"LibraryTreePopulator: %1 batch track bytes"_s.arg(grouping.name),
+                             batchTracks * static_cast<qint64>(sizeof(Track)), u"bytes"_s);
+        }
+    }
+
+    {
+        PlayerController playerController{&settings, nullptr};
+        PlaylistPopulator populator{&playerController, &settings};
+        populator.setUseVarious(true);
+
+        const PlaylistTrackList playlistTracks = PlaylistTrack::fromTracks(tracks, UId::create());
+        const PlaylistPreset preset            = albumPreset();
+
+        report.add(u"PlaylistPopulator: preset"_s,
+                   millisecondsPerRun(iterations, [&]() { populator.run(nullptr, preset, {}, playlistTracks); }),
+                   count);
+        report.add(u"PlaylistPopulator: columns"_s, millisecondsPerRun(iterations, [&]() {
+                       populator.run(nullptr, preset, trackColumns(), playlistTracks);
+                   }),
+                   count);
+
+        populator.setLazyRows(true);
+        report.add(u"PlaylistPopulator: lazy rows"_s, millisecondsPerRun(iterations, [&]() {
+                       populator.run(nullptr, preset, trackColumns(), playlistTracks);
+                   }),
+                   count);
+    }
+
+    return report.finish(outputPath);
+}
@@ -0,0 +1,91 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures building and patching filter rows for a synthetic library with the default filter columns.
+// Usage: bench_filterrows [tracks] [iterations] [json output]
+
+#include "benchutils.h"
+#include "plugins/filters/filterrows.h"
+
+#include <core/trackmetadatastore.h>
+
+#include <QApplication>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace Fooyin;
+using namespace Fooyin::Benchmarks;
+using namespace Qt::StringLiterals;
+
+int main(int argc, char** argv)
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    const QApplication app{argc, argv};
+
+    const int trackCount     = intArg(argc, argv, 1, 100000);
+    const int iterations     = intArg(argc, argv, 2, 3);
+    const QString outputPath = stringArg(argc, argv, 3);
+
+    BenchReport report{u"bench_filterrows"_s, trackCount, iterations};
+
+    const TrackList tracks = makeLibrary(trackCount, std::make_shared<TrackMetadataStore>());
+    const auto count       = static_cast<qint64>(tracks.size());
+
+    const Filters::FilterRowBuildContext context{.font = QApplication::font(), .ratingSymbols = {}, .useVarious = true};
+
+    const std::vector<std::pair<QString, Filters::FilterColumnList>> cases{
+        {u"buildFilterRows: genre"_s, {{.id = 0, .name = u"Genre"_s, .field = u"%<genre>%"_s}}},
+        {u"buildFilterRows: album artist"_s, {{.id = 1, .name = u"Album Artist"_s, .field = u"%<albumartist>%"_s}}},
+        {u"buildFilterRows: album + date"_s,
+         {{.id = 3, .name = u"Album"_s, .field = u"%album%"_s}, {.id = 4, .name = u"Date"_s, .field = u"%date%"_s}}},
+    };
+
+    for(const auto& [name, columns] : cases) {
+        report.add(name, millisecondsPerRun(iterations, [&]() {
+                       std::ignore = Filters::buildFilterRows(nullptr, columns, tracks, context);
+                   }),
+                   count);
+    }
+
+    // Retag a handful of tracks and patch the previous rows rather than rebuilding them
+    const Filters::FilterColumnList columns = cases.at(1).second;
+    const Filters::FilterRowList rows       = Filters::buildFilterRows(nullptr, columns, tracks, context);
+
+    TrackList changedTracks{tracks};
+    TrackIds changedIds;
+    for(size_t i{0}; i < changedTracks.size(); i += std::max<size_t>(1, changedTracks.size() / 100)) {
+        changedTracks.at(i).setAlbumArtists({u"Retagged Artist"_s});
+        changedIds.push_back(changedTracks.at(i).id());
+    }
+
+    report.add(u"patchFilterRows: 100 changed"_s, millisecondsPerRun(iterations, [&]() {
+                   std::ignore
+                       = Filters::patchFilterRows(nullptr, columns, rows, tracks, changedTracks, changedIds, context);
+               }),
+               static_cast<qint64>(changedIds.size()));
+
+    return report.finish(outputPath);
+}
@@ -21,6 +21,7 @@ function (fooyin_print_summary)
   message(STATUS "  BUILD_SHARED_LIBS       : ${BUILD_SHARED_LIBS}")
   message(STATUS "  BUILD_TESTING           : ${BUILD_TESTING}")
   message(STATUS "  BUILD_SENSITIVE_TESTING : ${BUILD_SENSITIVE_TESTING}")
+  message(STATUS "  BUILD_BENCHMARKS        : ${BUILD_BENCHMARKS}")
   message(STATUS "  BUILD_PLUGINS           : ${BUILD_PLUGINS}")
   message(STATUS "  PLUGIN_SELECTION        : ${PLUGIN_SELECTION}")
   message(STATUS "  BUILD_ALSA              : ${BUILD_ALSA}")
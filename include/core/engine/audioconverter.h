@@ -45,5 +45,25 @@ FYCORE_EXPORT AudioBuffer convert(const AudioBuffer& buffer, const AudioFormat&
 FYCORE_EXPORT bool convert(const AudioFormat& inputFormat, const std::byte* input, const AudioFormat& outputFormat,
                            std::byte* output, int frameCount, bool dither = false);
 
+/*!
+ * Instruction sets used by the sample conversion kernels.
+ *
+ * Conversions between interleaved buffers with matching channel layouts run through
+ * vectorised kernels; all levels produce identical output for non-dithered conversions.
+ */
+enum class SimdLevel : uint8_t
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+};
+
+//! Returns the highest SimdLevel supported by this build and the running CPU.
+FYCORE_EXPORT SimdLevel supportedSimdLevel();
+//! Returns the SimdLevel currently used for conversions.
+FYCORE_EXPORT SimdLevel simdLevel();
+//! Limits conversions to @p level, clamped to supportedSimdLevel(). Intended for tests and benchmarks.
+FYCORE_EXPORT void setSimdLevel(SimdLevel level);
+
 } // namespace Audio
 } // namespace Fooyin
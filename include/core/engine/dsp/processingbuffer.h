@@ -44,6 +44,8 @@ public:
     [[nodiscard]] bool isValid() const;
 
     void reset();
+    //! Reinitialise for reuse, keeping the allocated sample capacity.
+    void reset(const AudioFormat& format, uint64_t startTimeNs);
 
     [[nodiscard]] AudioFormat format() const;
     [[nodiscard]] int frameCount() const;
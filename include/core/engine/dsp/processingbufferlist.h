@@ -28,6 +28,11 @@
 namespace Fooyin {
 /*!
  * Mutable list of ProcessingBuffer chunks used across engine processing stages.
+ *
+ * Chunk slots are recycled: `clear` and `removeByIdx` keep removed buffers (and their
+ * sample storage) as spares which later `addItem`/`insertItem`/`addChunk` calls reuse.
+ * Once a list has grown to the working size of a render cycle, refilling it does not
+ * touch the heap.
  */
 class FYCORE_EXPORT ProcessingBufferList
 {
@@ -37,9 +42,14 @@ public:
     ProcessingBuffer* item(size_t index);
     [[nodiscard]] const ProcessingBuffer* item(size_t index) const;
 
-    void reserve(size_t count);
+    //! Ensure at least @p count slots exist, each with room for @p samplesPerChunk samples.
+    void reserve(size_t count, size_t samplesPerChunk = 0);
     void clear();
     void removeByIdx(size_t index);
+    //! Remove chunks which are not valid, preserving the order of the rest.
+    void removeInvalid();
+    //! Exchange contents, including spare slots, with @p other.
+    void swap(ProcessingBufferList& other) noexcept;
 
     ProcessingBuffer* insertItem(size_t index, const AudioFormat& format, uint64_t startTimeNs, size_t sampleCount);
     ProcessingBuffer* addItem(const AudioFormat& format, uint64_t startTimeNs, size_t sampleCount);
@@ -48,6 +58,10 @@ public:
     void setToSingle(const ProcessingBuffer& buffer);
 
 private:
+    ProcessingBuffer* acquireSlot(size_t index);
+
+    //! Live chunks occupy [0, m_count); the remainder are spare slots.
     std::vector<ProcessingBuffer> m_chunks;
+    size_t m_count{0};
 };
 } // namespace Fooyin
@@ -85,6 +85,8 @@ Q_SIGNALS:
     void engineError(const QString& error);
     //! Playback state transitions.
     void engineStateChanged(Fooyin::Engine::PlaybackState state);
+    //! Output starved of rendered audio during playback (true), or recovered (false).
+    void bufferUnderrunChanged(bool underrun);
     //! Track-status transitions with stable generation identifier.
     void trackStatusContextChanged(const Fooyin::Engine::TrackStatusContext& context);
 
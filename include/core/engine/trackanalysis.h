@@ -0,0 +1,105 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+#include <core/track.h>
+
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Fooyin {
+class AudioBuffer;
+class AudioLoader;
+class TrackAnalysisPipelinePrivate;
+
+/*!
+ * Consumes the decoded audio of a single track as part of a shared analysis pass.
+ *
+ * A new analyser is created for each track. The pipeline calls start() with the decoder's format, process() for
+ * each decoded buffer converted to sampleFormat(), and finish() once the whole track has been decoded.
+ * All calls for one track happen on the same thread, but different tracks may be analysed concurrently.
+ */
+class FYCORE_EXPORT TrackAnalyser
+{
+public:
+    virtual ~TrackAnalyser() = default;
+
+    //! Sample format buffers are converted to before being passed to process().
+    [[nodiscard]] virtual SampleFormat sampleFormat() const = 0;
+
+    //! Returns false to skip @p track, e.g. if results are already available.
+    virtual bool start(const Track& track, const AudioFormat& format) = 0;
+    //! Returns false once no more data is needed for the current track.
+    virtual bool process(const AudioBuffer& buffer) = 0;
+    //! Called once decoding completes; results may be written to @p track.
+    virtual void finish(Track& track) = 0;
+};
+
+using TrackAnalyserPtr     = std::unique_ptr<TrackAnalyser>;
+using TrackAnalyserFactory = std::function<TrackAnalyserPtr()>;
+
+/*!
+ * Decodes each track once and fans the audio out to every analyser interested in it.
+ *
+ * Callers pass the analysers they need for a run, and any analysers registered by plugins
+ * (e.g. waveform summaries) can ride along, so a library-wide pass reads each file once.
+ * Buffers are converted once per distinct sample format requested.
+ *
+ * The pipeline does no scheduling of its own. analyse() is safe to call from several threads at once, and
+ * sortForLocality() orders tracks so a thread pool works through files and directories in order.
+ */
+class FYCORE_EXPORT TrackAnalysisPipeline
+{
+public:
+    explicit TrackAnalysisPipeline(std::shared_ptr<AudioLoader> audioLoader);
+    ~TrackAnalysisPipeline();
+
+    TrackAnalysisPipeline(const TrackAnalysisPipeline&)            = delete;
+    TrackAnalysisPipeline& operator=(const TrackAnalysisPipeline&) = delete;
+
+    //! Registers an analyser to run alongside every analysis pass.
+    void registerAnalyser(const QString& id, TrackAnalyserFactory factory);
+    void unregisterAnalyser(const QString& id);
+    [[nodiscard]] QStringList registeredAnalysers() const;
+
+    //! Creates one instance of each registered analyser for a single track.
+    [[nodiscard]] std::vector<TrackAnalyserPtr> createRegisteredAnalysers() const;
+
+    /*!
+     * Decodes @p track once, passing the audio to each of @p analysers.
+     * @param mayContinue polled between buffers; returning false abandons the track without finishing analysers.
+     * @returns false if the track couldn't be decoded or was abandoned.
+     */
+    bool analyse(Track& track, const std::vector<TrackAnalyser*>& analysers,
+                 const std::function<bool()>& mayContinue = {}) const;
+
+    //! Orders @p tracks by file, keeping tracks which share a file (e.g. cue sheets) adjacent and in offset order.
+    static void sortForLocality(TrackList& tracks);
+
+private:
+    std::unique_ptr<TrackAnalysisPipelinePrivate> p;
+};
+} // namespace Fooyin
@@ -26,8 +26,12 @@
 #include <core/track.h>
 #include <utils/stringcollator.h>
 
+#include <QHash>
 #include <QString>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <ranges>
 #include <vector>
@@ -39,6 +43,10 @@ class TrackSorterPrivate;
 
 /*!
  * Evaluates sort scripts against tracks and returns a stably sorted result.
+ *
+ * Large inputs are split across the global thread pool: each task evaluates its
+ * range of sort keys with its own `ScriptParser`, and the keyed ranges are then
+ * stable sorted and merged in parallel. The result is identical to a serial sort.
  */
 class FYCORE_EXPORT TrackSorter
 {
@@ -48,6 +56,8 @@ public:
     {
         Item item;
         QString sortKey;
+        //! Binary collation key for `sortKey`, compared bytewise when sorting.
+        QByteArray collationKey;
     };
 
     TrackSorter();
@@ -103,6 +113,11 @@ public:
     TrackList calcSortTracks(const ParsedScript& sortScript, TrackList tracks, const std::vector<int>& indexes,
                              Qt::SortOrder order = Qt::AscendingOrder);
 
+    //! Sets the case sensitivity used to compare sort keys; case sensitive by default.
+    void setCaseSensitivity(Qt::CaseSensitivity sensitivity);
+    //! Sets whether digits in sort keys are compared by numeric value; enabled by default.
+    void setNumericMode(bool enabled);
+
     /*!
      * Parses a sort script once for reuse across later sort operations.
      * @param sort Sort script string.
@@ -124,16 +139,11 @@ public:
         std::vector<SortEntry<Item>> entries;
         entries.reserve(items.size());
 
-        const std::scoped_lock lock{m_parserGuard};
-
-        ScriptContext context;
-        context.environment = &m_scriptEnvironment;
-
         for(const auto& item : items) {
-            const Track& track = extractor(item);
-            entries.push_back({item, m_parser.evaluate(sort, track, context)});
+            entries.push_back({item, {}});
         }
 
+        evaluateSortKeys(sort, entries, extractor);
         return entries;
     }
 
@@ -150,16 +160,11 @@ public:
         std::vector<SortEntry<Item>> entries;
         entries.reserve(items.size());
 
-        const std::scoped_lock lock{m_parserGuard};
-
-        ScriptContext context;
-        context.environment = &m_scriptEnvironment;
-
         for(auto& item : items) {
-            const Track& track = extractor(item);
-            entries.push_back({std::move(item), m_parser.evaluate(sort, track, context)});
+            entries.push_back({std::move(item), {}});
         }
 
+        evaluateSortKeys(sort, entries, extractor);
         return entries;
     }
 
@@ -224,24 +229,156 @@ private:
         return items;
     }
 
+    //! Minimum number of items handled by each task when splitting work across threads.
+    static constexpr size_t MinItemsPerTask = 2048;
+
+    //! Number of tasks to split @p count items into, limited by the global thread pool size.
+    static size_t taskCount(size_t count);
+    //! Runs @p task for each index in [0, @p count), using the calling thread and the global thread pool.
+    static void runTasks(size_t count, const std::function<void(size_t)>& task);
+
+    //! Ensures a parser exists for each of @p count tasks. Must be called with `m_parserGuard` held.
+    void prepareTaskParsers(size_t count);
+    ScriptParser& taskParser(size_t task);
+
+    //! Upper bound on cached collation keys; the cache is dropped rather than grown past this.
+    static constexpr qsizetype MaxCachedCollationKeys = 1 << 19;
+
+    //! Collator settings that cached collation keys were computed with.
+    struct CollationConfig
+    {
+        QString locale;
+        Qt::CaseSensitivity caseSensitivity{Qt::CaseSensitive};
+        bool numericMode{true};
+
+        bool operator==(const CollationConfig& other) const = default;
+    };
+
+    /*!
+     * Returns the current collation settings (the default locale plus the configured case sensitivity and
+     * numeric mode), first dropping cached collation keys if they differ from those the keys were computed
+     * with. Must be called with `m_parserGuard` held.
+     */
+    CollationConfig syncCollationConfig();
+
+    //! Adds the collation keys of @p entries at @p indexes to the cache. Must be called with `m_parserGuard` held.
     template <typename Item>
-    static void sortSortEntries(std::vector<SortEntry<Item>>& sortEntries, Qt::SortOrder order = Qt::AscendingOrder)
+    void cacheCollationKeys(const std::vector<SortEntry<Item>>& entries,
+                            const std::vector<std::vector<size_t>>& indexes)
+    {
+        size_t count{0};
+        for(const auto& taskIndexes : indexes) {
+            count += taskIndexes.size();
+        }
+
+        if(m_collationKeys.size() + static_cast<qsizetype>(count) > MaxCachedCollationKeys) {
+            m_collationKeys.clear();
+        }
+
+        for(const auto& taskIndexes : indexes) {
+            for(const size_t index : taskIndexes) {
+                if(m_collationKeys.size() >= MaxCachedCollationKeys) {
+                    return;
+                }
+                m_collationKeys.emplace(entries[index].sortKey, entries[index].collationKey);
+            }
+        }
+    }
+
+    template <typename SortScript, typename Item, typename Extractor>
+    void evaluateSortKeys(const SortScript& sort, std::vector<SortEntry<Item>>& entries, const Extractor& extractor)
     {
-        StringCollator collator;
-        std::ranges::stable_sort(sortEntries, [order, &collator](const auto& lhs, const auto& rhs) {
-            const auto cmp = collator.compare(lhs.sortKey, rhs.sortKey);
-            if(cmp == 0) {
-                return false;
+        const std::scoped_lock lock{m_parserGuard};
+
+        const size_t tasks     = taskCount(entries.size());
+        const size_t chunkSize = (entries.size() + tasks - 1) / tasks;
+        prepareTaskParsers(tasks);
+
+        const CollationConfig config = syncCollationConfig();
+
+        // Indexes of entries whose collation key was not cached, per task
+        std::vector<std::vector<size_t>> uncached(tasks);
+
+        runTasks(tasks, [this, &sort, &entries, &extractor, &uncached, &config, chunkSize](size_t task) {
+            ScriptParser& parser = taskParser(task);
+            StringCollator collator;
+            collator.setCaseSensitivity(config.caseSensitivity);
+            collator.setNumericMode(config.numericMode);
+            const auto& cachedKeys = std::as_const(m_collationKeys);
+
+            ScriptContext context;
+            context.environment = &m_scriptEnvironment;
+
+            const size_t end = std::min(entries.size(), (task + 1) * chunkSize);
+            for(size_t i{task * chunkSize}; i < end; ++i) {
+                auto& entry        = entries[i];
+                const Track& track = extractor(entry.item);
+                entry.sortKey      = parser.evaluate(sort, track, context);
+
+                if(const auto keyIt = cachedKeys.constFind(entry.sortKey); keyIt != cachedKeys.cend()) {
+                    entry.collationKey = keyIt.value();
+                }
+                else {
+                    entry.collationKey = collator.sortKey(entry.sortKey);
+                    uncached[task].push_back(i);
+                }
             }
+        });
 
+        cacheCollationKeys(entries, uncached);
+    }
+
+    static auto sortEntryComparator(Qt::SortOrder order)
+    {
+        return [order](const auto& lhs, const auto& rhs) {
             if(order == Qt::AscendingOrder) {
-                return cmp < 0;
+                return lhs.collationKey < rhs.collationKey;
             }
-            return cmp > 0;
+            return rhs.collationKey < lhs.collationKey;
+        };
+    }
+
+    template <typename Item>
+    static void sortSortEntries(std::vector<SortEntry<Item>>& sortEntries, Qt::SortOrder order = Qt::AscendingOrder)
+    {
+        const size_t tasks = taskCount(sortEntries.size());
+
+        if(tasks == 1) {
+            std::ranges::stable_sort(sortEntries, sortEntryComparator(order));
+            return;
+        }
+
+        // Stable sort equal-sized runs, then merge adjacent runs pairwise; merges keep
+        // left-run entries first, so the result matches a single stable sort
+        const size_t runSize = (sortEntries.size() + tasks - 1) / tasks;
+        const auto runBound  = [&sortEntries, runSize](size_t run) {
+            return sortEntries.begin() + static_cast<std::ptrdiff_t>(std::min(sortEntries.size(), run * runSize));
+        };
+
+        runTasks(tasks, [&runBound, order](size_t run) {
+            std::stable_sort(runBound(run), runBound(run + 1), sortEntryComparator(order));
         });
+
+        for(size_t width{1}; width < tasks; width *= 2) {
+            const size_t merges = (tasks + (2 * width) - 1) / (2 * width);
+            runTasks(merges, [&runBound, order, tasks, width](size_t merge) {
+                const size_t first  = merge * 2 * width;
+                const size_t middle = std::min(tasks, first + width);
+                const size_t last   = std::min(tasks, first + (2 * width));
+                if(middle < last) {
+                    std::inplace_merge(runBound(first), runBound(middle), runBound(last), sortEntryComparator(order));
+                }
+            });
+        }
     }
 
     ScriptParser m_parser;
+    std::vector<std::unique_ptr<ScriptParser>> m_taskParsers;
+    //! Collation keys of previously evaluated sort keys, so unchanged tracks skip ICU on re-sort.
+    QHash<QString, QByteArray> m_collationKeys;
+    CollationConfig m_collationConfig;
+    Qt::CaseSensitivity m_caseSensitivity{Qt::CaseSensitive};
+    bool m_numericMode{true};
     LibraryScriptEnvironment m_scriptEnvironment;
     std::mutex m_parserGuard;
 };
@@ -27,6 +27,10 @@
 #include <QObject>
 #include <QVariant>
 
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
 namespace Fooyin {
 class PlaylistPrivate;
 class PlaylistNavigator;
@@ -37,6 +41,8 @@ struct PlaylistTrack;
 class SettingsManager;
 
 using PlaylistTrackList = std::vector<PlaylistTrack>;
+//! Position of each track in the library, keyed by Track::uniqueFilepath().
+using TrackPositionMap = std::unordered_map<QString, int>;
 
 struct FYCORE_EXPORT PlaylistTrack
 {
@@ -137,6 +143,18 @@ public:
     [[nodiscard]] bool forceSorted() const;
     /** Returns the tracks this autoplaylist would contain after regeneration with @p tracks. */
     [[nodiscard]] TrackList autoPlaylistTracks(const TrackList& tracks) const;
+    /**
+     * Returns the tracks this autoplaylist would contain after re-evaluating only @p changedTracks
+     * against its query and dropping @p removedTracks.
+     *
+     * Returns std::nullopt if the query depends on other tracks (LIMIT) or on the current time
+     * (BEFORE/AFTER/SINCE/DURING), in which case autoPlaylistTracks() must be used with the full library.
+     * @p libraryPositions is only invoked when new or changed tracks need ordering as a full
+     * regeneration would order them.
+     */
+    [[nodiscard]] std::optional<TrackList>
+    patchedAutoPlaylistTracks(const TrackList& changedTracks, const TrackList& removedTracks,
+                              const std::function<const TrackPositionMap&()>& libraryPositions) const;
 
     /** Regenerates this autoplaylist using the tracks @p tracks. */
     bool regenerateTracks(const TrackList& tracks);
@@ -31,6 +31,7 @@ class PlayerController;
 class PlaylistHandler;
 class SettingsManager;
 class SortingRegistry;
+class TrackAnalysisPipeline;
 
 /*!
  * Passed to core plugins in CorePlugin::initialise.
@@ -40,7 +41,8 @@ struct CorePluginContext
     CorePluginContext(EngineController* engine_, PlayerController* playerController_, LibraryManager* libraryManager_,
                       MusicLibrary* library_, PlaylistHandler* playlistHandler_, SettingsManager* settingsManager_,
                       std::shared_ptr<AudioLoader> audioLoader_, SortingRegistry* sortingRegistry_,
-                      std::shared_ptr<NetworkAccessManager> networkAccess_)
+                      std::shared_ptr<NetworkAccessManager> networkAccess_,
+                      std::shared_ptr<TrackAnalysisPipeline> analysisPipeline_)
         : playerController{playerController_}
         , libraryManager{libraryManager_}
         , library{library_}
@@ -50,6 +52,7 @@ struct CorePluginContext
         , audioLoader{std::move(audioLoader_)}
         , sortingRegistry{sortingRegistry_}
         , networkAccess{std::move(networkAccess_)}
+        , analysisPipeline{std::move(analysisPipeline_)}
     { }
 
     PlayerController* playerController;
@@ -61,5 +64,6 @@ struct CorePluginContext
     std::shared_ptr<AudioLoader> audioLoader;
     SortingRegistry* sortingRegistry;
     std::shared_ptr<NetworkAccessManager> networkAccess;
+    std::shared_ptr<TrackAnalysisPipeline> analysisPipeline;
 };
 } // namespace Fooyin
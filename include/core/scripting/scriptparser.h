@@ -123,6 +123,11 @@ public:
     TrackList filter(const ParsedScript& input, const TrackList& tracks);
     PlaylistTrackList filter(const QString& input, const PlaylistTrackList& tracks);
     PlaylistTrackList filter(const ParsedScript& input, const PlaylistTrackList& tracks);
+    /*!
+     * Describes how @p input would be filtered: which predicates are answered from
+     * field indexes and which are evaluated per track.
+     */
+    QString explainQuery(const QString& input);
 
     /*!
      * Returns the maximum number of cached parsed and bound scripts.
@@ -137,6 +142,16 @@ public:
      */
     void clearCache();
 
+    /*!
+     * Returns true if bound scripts are run as compiled programs where possible.
+     * Enabled by default; scripts which can't be compiled are always interpreted.
+     */
+    [[nodiscard]] bool compilationEnabled() const;
+    /*!
+     * Enables or disables running compiled programs in place of the interpreter.
+     */
+    void setCompilationEnabled(bool enabled);
+
 private:
     std::unique_ptr<ScriptParserPrivate> p;
 };
@@ -38,8 +38,9 @@ class StringPoolPrivate;
  * such as a library metadata store.
  *
  * Thread safety:
- * All public methods are internally synchronized. Returned ids and list refs
- * remain valid for the process lifetime.
+ * All public methods are internally synchronized. Interning takes a per-domain
+ * lock, while resolving ids and list refs never locks and can run concurrently
+ * with interning. Returned ids and list refs remain valid for the process lifetime.
  */
 class FYCORE_EXPORT StringPool
 {
@@ -30,6 +30,7 @@
 #include <QSharedDataPointer>
 #include <QString>
 
+#include <bitset>
 #include <map>
 #include <memory>
 
@@ -82,6 +83,51 @@ public:
     using ExtraTags       = FlatStringMap<QStringList>;
     using ExtraProperties = FlatStringMap<QString>;
 
+    //! Fields persisted in the Tracks table, in database column order.
+    enum class Field : uint8_t
+    {
+        FilePath = 0,
+        Subsong,
+        Title,
+        TrackNumber,
+        TrackTotal,
+        Artists,
+        AlbumArtists,
+        Album,
+        DiscNumber,
+        DiscTotal,
+        Date,
+        Composers,
+        Performers,
+        Genres,
+        Comment,
+        CuePath,
+        Offset,
+        Duration,
+        FileSize,
+        Bitrate,
+        SampleRate,
+        Channels,
+        BitDepth,
+        Codec,
+        CodecProfile,
+        Tool,
+        TagTypes,
+        Encoding,
+        ExtraTags,
+        ExtraProperties,
+        ModifiedTime,
+        Hash,
+        LibraryId,
+        RGTrackGain,
+        RGAlbumGain,
+        RGTrackPeak,
+        RGAlbumPeak,
+        CreatedTime,
+        Count
+    };
+    using Fields = std::bitset<static_cast<size_t>(Field::Count)>;
+
     Track();
     explicit Track(std::shared_ptr<TrackMetadataStore> store);
     explicit Track(const QString& filepath);
@@ -108,6 +154,13 @@ public:
      * This is stricter than operator==(), which only compares unique filepath, duration and generated hash.
      */
     [[nodiscard]] bool sameDataAs(const Track& other) const;
+    /*!
+     * Returns whether this track and @p other share the same underlying data.
+     *
+     * Copies share data until either is modified, so this cheaply tells that a copy hasn't been edited since it
+     * was taken. Tracks with equal but separately stored data don't share it; use `sameDataAs()` to compare them.
+     */
+    [[nodiscard]] bool sharesDataWith(const Track& other) const;
 
     /*!
      * Generates and stores the library matching hash.
@@ -124,6 +177,13 @@ public:
     [[nodiscard]] bool metadataWasRead() const;
     //! True when user-editable metadata has been changed since the flag was last cleared.
     [[nodiscard]] bool metadataWasModified() const;
+    /*!
+     * Returns the persisted fields changed since the track was loaded from or saved to the database.
+     *
+     * Tracks which have never been synced with the database report every field as dirty.
+     */
+    [[nodiscard]] Fields dirtyFields() const;
+    [[nodiscard]] bool isDirty(Field field) const;
     [[nodiscard]] bool exists() const;
     [[nodiscard]] int libraryId() const;
 
@@ -403,6 +463,10 @@ public:
 
     //! Clears metadataWasModified() after changes have been saved or accepted.
     void clearWasModified();
+    //! Clears dirtyFields() once the track matches its database row.
+    void clearDirtyFields();
+    //! Marks every persisted field as dirty, forcing the next database update to write the full row.
+    void markAllDirty();
 
     static QString findCommonField(const TrackList& tracks);
     static TrackIds trackIdsForTracks(const TrackList& tracks);
@@ -22,6 +22,9 @@
 #include "fycore_export.h"
 
 #include <core/stringpool.h>
+#include <core/tracksearchindex.h>
+
+#include <atomic>
 
 namespace Fooyin {
 /*!
@@ -30,6 +33,11 @@ namespace Fooyin {
  * A library can keep one `TrackMetadataStore` and let all resident `Track`
  * instances intern repeated strings through it. Standalone tracks may also own
  * their own store when no library is involved.
+ *
+ * The owning library also maintains the store's search index, so plain-term
+ * searches over its tracks can skip folding every field per query, and bumps
+ * the store's revision whenever its tracks change so derived caches can be
+ * invalidated.
  */
 class FYCORE_EXPORT TrackMetadataStore
 {
@@ -49,7 +57,34 @@ public:
         return m_stringPool.values(domain);
     }
 
+    [[nodiscard]] TrackSearchIndex& searchIndex()
+    {
+        return m_searchIndex;
+    }
+
+    [[nodiscard]] const TrackSearchIndex& searchIndex() const
+    {
+        return m_searchIndex;
+    }
+
+    /*!
+     * Returns the revision of the owning library's tracks.
+     * Zero for stores which aren't maintained by a library.
+     */
+    [[nodiscard]] uint64_t revision() const
+    {
+        return m_revision.load(std::memory_order_acquire);
+    }
+
+    //! Called by the owning library after its tracks have changed.
+    void markChanged()
+    {
+        m_revision.fetch_add(1, std::memory_order_acq_rel);
+    }
+
 private:
     StringPool m_stringPool;
+    TrackSearchIndex m_searchIndex;
+    std::atomic<uint64_t> m_revision{0};
 };
 } // namespace Fooyin
@@ -0,0 +1,101 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <QStringList>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace Fooyin {
+class TrackSearchIndexPrivate;
+
+/*!
+ * Pre-folded text index for plain-term track searches.
+ *
+ * Holds the search-folded text of every indexed track (the fields checked by
+ * `Track::hasMatch`) along with an inverted index from whitespace-separated
+ * tokens to track ids. A term is matched by scanning the token vocabulary,
+ * which is much smaller than the track list, to narrow the candidate tracks
+ * before checking their folded text.
+ *
+ * The index is keyed by track id; tracks without a database id are not indexed.
+ * Each entry keeps the track copy it was built from, so edited copies which
+ * haven't been re-indexed yet are left to the caller.
+ *
+ * Thread safety:
+ * All public methods are internally synchronized. Folding happens outside the
+ * lock, so updates only block readers while the postings are merged.
+ */
+class FYCORE_EXPORT TrackSearchIndex
+{
+public:
+    /*!
+     * A prepared search for one or more terms which must all match.
+     */
+    class FYCORE_EXPORT Query
+    {
+    public:
+        /*!
+         * Returns whether @p track matches every term, or `std::nullopt` if the
+         * track isn't indexed, or was edited since it was, and the caller should
+         * fall back to `Track::hasMatch`.
+         */
+        [[nodiscard]] std::optional<bool> matches(const Track& track) const;
+
+    private:
+        friend class TrackSearchIndex;
+
+        const TrackSearchIndex* m_index{nullptr};
+        QStringList m_terms;
+        std::vector<bool> m_candidates;
+        uint64_t m_generation{0};
+        bool m_filtered{false};
+    };
+
+    TrackSearchIndex();
+    ~TrackSearchIndex();
+
+    TrackSearchIndex(const TrackSearchIndex&)            = delete;
+    TrackSearchIndex& operator=(const TrackSearchIndex&) = delete;
+
+    //! Replaces the index contents with @p tracks.
+    void rebuild(const TrackList& tracks);
+    //! Adds @p tracks, replacing any existing entries with the same id.
+    void update(const TrackList& tracks);
+    //! Removes @p tracks from the index.
+    void remove(const TrackList& tracks);
+    void clear();
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] size_t size() const;
+
+    //! Prepares a search where every term in @p terms must match.
+    [[nodiscard]] Query prepare(const QStringList& terms) const;
+
+private:
+    std::unique_ptr<TrackSearchIndexPrivate> p;
+};
+} // namespace Fooyin
@@ -66,6 +66,21 @@ public:
         Full        = 1024
     };
 
+    //! Counters for thumbnail requests across all providers.
+    struct ThumbnailStats
+    {
+        //! Requests which queued a decode.
+        uint64_t queued{0};
+        //! Requests merged into a decode which was already queued or running.
+        uint64_t coalesced{0};
+        uint64_t decoded{0};
+        //! Decodes dropped before they started, as their covers were no longer needed.
+        uint64_t cancelled{0};
+        //! Requests served from the pixmap cache.
+        uint64_t hits{0};
+        double hitRate{0.0};
+    };
+
     explicit CoverProvider(std::shared_ptr<AudioLoader> audioLoader, SettingsManager* settings,
                            QObject* parent = nullptr);
     ~CoverProvider() override;
@@ -135,12 +150,33 @@ public:
     [[nodiscard]] QPixmap trackCoverThumbnail(const Track& track, const QSize& size,
                                               Track::Cover type = Track::Cover::Front) const;
 
+    /*!
+     * Queues the thumbnails of @p tracks so the covers of items about to be shown are ready
+     * before they're requested. Thumbnails already in the on-disk store are read in one batch
+     * on a worker thread, and only the rest are queued to be decoded. @p tracks should be
+     * ordered by their distance from the visible area of the view, as covers are decoded in
+     * that order.
+     *
+     * Thumbnails this provider has queued which aren't in @p tracks are cancelled if they haven't
+     * started, as they're no longer close to being shown. Requests made with
+     * @fn trackCoverThumbnailAsync are never cancelled.
+     *
+     * The coverAdded signal is emitted for each track once its cover has been cached.
+     */
+    void prefetchThumbnails(const TrackList& tracks, ThumbnailSize size, Track::Cover type = Track::Cover::Front) const;
+    /*!
+     * This is an overloaded function.
+     */
+    void prefetchThumbnails(const TrackList& tracks, const QSize& size, Track::Cover type = Track::Cover::Front) const;
+
     // Returns the placeholder cover used if a track doesn't have any artwork
     [[nodiscard]] QPixmap placeholderCover() const;
 
+    /** Returns counters for thumbnail requests, for diagnostics. */
+    static ThumbnailStats thumbnailStats();
     /** Returns an equivalent thumbnail size for the given @p size */
     static ThumbnailSize findThumbnailSize(const QSize& size);
-    /** Clears the QPixmapCache as well as the on-disk cache. */
+    /** Clears the QPixmapCache as well as the on-disk thumbnail store. */
     static void clearCache();
     /** Removes all covers of the @p track from the cache. */
     static void removeFromCache(const Track& track);
@@ -0,0 +1,38 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <cstdint>
+
+namespace Fooyin::AllocationCounter {
+/*!
+ * Per-thread heap allocation counter used to verify allocation-free code paths.
+ *
+ * Nothing in fooyin calls `recordAllocation` itself; a test binary that replaces the
+ * global `operator new` forwards to it. Code under test can then compare
+ * `threadAllocations` before and after a section (e.g. a render cycle) to report how
+ * many allocations it made. Without such a hook the counter stays at zero.
+ */
+FYUTILS_EXPORT void recordAllocation() noexcept;
+//! Number of allocations recorded on the calling thread.
+[[nodiscard]] FYUTILS_EXPORT uint64_t threadAllocations() noexcept;
+} // namespace Fooyin::AllocationCounter
@@ -23,6 +23,12 @@
 
 #include <QSqlDatabase>
 
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+class QSqlQuery;
+
 namespace Fooyin {
 class FYUTILS_EXPORT DbConnection
 {
@@ -51,7 +57,27 @@ public:
 
     [[nodiscard]] QSqlDatabase db() const;
 
+    //! Maximum number of prepared statements kept per connection; the least recently used is dropped first.
+    static constexpr size_t CachedQueryLimit = 64;
+
+    /*!
+     * Returns a query prepared for @p statement on this connection, reusing the
+     * statement prepared by an earlier call.
+     * Returns nullptr if the statement fails to prepare or the cached query is still in use.
+     */
+    [[nodiscard]] std::shared_ptr<QSqlQuery> cachedQuery(const QString& statement);
+    [[nodiscard]] size_t cachedQueryCount() const;
+    void clearCachedQueries();
+
 private:
+    struct CachedQuery
+    {
+        std::shared_ptr<QSqlQuery> query;
+        std::list<QString>::iterator orderIt;
+    };
+
     QString m_name;
+    std::unordered_map<QString, CachedQuery> m_cachedQueries;
+    std::list<QString> m_cachedQueryOrder;
 };
 } // namespace Fooyin
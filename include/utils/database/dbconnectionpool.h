@@ -25,8 +25,12 @@
 
 #include <QThreadStorage>
 
+#include <memory>
+#include <mutex>
+
 namespace Fooyin {
 class DbConnectionPool;
+class DbWriter;
 using DbConnectionPoolPtr = std::shared_ptr<DbConnectionPool>;
 
 class FYUTILS_EXPORT DbConnectionPool
@@ -35,6 +39,7 @@ class FYUTILS_EXPORT DbConnectionPool
 
 public:
     DbConnectionPool(PrivateKey, const DbConnection::DbParams& params, const QString& connectionName);
+    ~DbConnectionPool();
 
     DbConnectionPool(const DbConnectionPool& other)  = delete;
     DbConnectionPool(const DbConnectionPool&& other) = delete;
@@ -43,9 +48,13 @@ public:
 
     [[nodiscard]] bool hasThreadConnection() const;
 
+    //! Returns the pool's writer thread, starting it on first use.
+    [[nodiscard]] DbWriter* writer();
+
 private:
     friend class DbConnectionProvider;
     friend class DbConnectionHandler;
+    friend class DbWriter;
 
     [[nodiscard]] DbConnection* threadConnection() const;
     bool createThreadConnection();
@@ -54,5 +63,9 @@ private:
     QThreadStorage<DbConnection*> m_threadConnections;
     std::atomic_int m_connectionCount;
     DbConnection m_prototype;
+
+    std::mutex m_writerMutex;
+    // Declared last so the writer stops before any connections are torn down
+    std::unique_ptr<DbWriter> m_writer;
 };
 } // namespace Fooyin
@@ -31,6 +31,9 @@ public:
     explicit DbConnectionProvider(DbConnectionPoolPtr pool);
 
     [[nodiscard]] QSqlDatabase db() const;
+    //! Returns the open connection owned by the calling thread, or nullptr if there is none.
+    [[nodiscard]] DbConnection* connection() const;
+    [[nodiscard]] DbWriter* writer() const;
 
 private:
     DbConnectionPoolPtr m_connectionPool;
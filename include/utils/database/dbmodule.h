@@ -20,6 +20,7 @@
 #pragma once
 
 #include "dbconnectionprovider.h"
+#include "dbwriter.h"
 
 namespace Fooyin {
 class DbModule
@@ -37,6 +38,24 @@ public:
         return m_dbProvider.db();
     }
 
+    [[nodiscard]] DbConnection* connection() const
+    {
+        return m_dbProvider.connection();
+    }
+
+    /*!
+     * Runs @p write on the pool's writer thread as part of its next group commit,
+     * waiting for the result. Queries made by @p write use the writer's connection.
+     */
+    template <typename Func>
+    bool runWrite(Func&& write, DbWriter::Priority priority = DbWriter::Priority::Normal) const
+    {
+        if(DbWriter* writer = m_dbProvider.writer()) {
+            return writer->write([&write](const QSqlDatabase& /*db*/) { return write(); }, priority);
+        }
+        return write();
+    }
+
 private:
     DbConnectionProvider m_dbProvider;
 };
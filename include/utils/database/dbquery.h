@@ -23,7 +23,11 @@
 
 #include <QSqlQuery>
 
+#include <memory>
+
 namespace Fooyin {
+class DbConnection;
+
 class FYUTILS_EXPORT DbQuery
 {
 public:
@@ -38,15 +42,22 @@ public:
 
     DbQuery();
     DbQuery(const QSqlDatabase& database, const QString& statement);
+    /*!
+     * Uses the prepared statement cached by @p connection for @p statement, so
+     * repeated queries skip re-preparing. Prefer positional binding with these.
+     */
+    DbQuery(DbConnection* connection, const QString& statement);
+    ~DbQuery();
 
-    DbQuery(const DbQuery& other)       = delete;
-    DbQuery(DbQuery&& other)            = default;
-    DbQuery& operator=(DbQuery&& other) = default;
+    DbQuery(const DbQuery& other) = delete;
+    DbQuery(DbQuery&& other) noexcept;
+    DbQuery& operator=(DbQuery&& other) noexcept;
 
     [[nodiscard]] Status status() const;
     [[nodiscard]] QSqlError lastError() const;
 
     void bindValue(const QString& placeholder, const QVariant& value);
+    void bindValue(int pos, const QVariant& value);
     [[nodiscard]] QString executedQuery() const;
     bool exec();
 
@@ -55,8 +66,14 @@ public:
     [[nodiscard]] bool next();
     [[nodiscard]] QVariant value(int index) const;
 
+    //! Prepares @p query for @p statement as a forward-only query. Fails if @p query is still active.
+    static bool prepareQuery(QSqlQuery& query, const QString& statement);
+
 private:
-    QSqlQuery m_query;
+    void prepare(const QSqlDatabase& database, const QString& statement);
+
+    std::shared_ptr<QSqlQuery> m_query;
+    bool m_cached;
     Status m_status;
 };
 } // namespace Fooyin
@@ -24,6 +24,11 @@
 #include <QSqlDatabase>
 
 namespace Fooyin {
+/*!
+ * RAII transaction on a connection, rolled back on destruction unless committed.
+ * Transactions opened while another is active on the same connection in this
+ * thread become savepoints, so they can be nested (e.g. inside a DbWriter batch).
+ */
 class FYUTILS_EXPORT DbTransaction
 {
 public:
@@ -43,7 +48,10 @@ public:
     void release();
 
 private:
+    void finish();
+
     QSqlDatabase m_database;
+    QString m_savepoint;
     bool m_isActive;
 };
 } // namespace Fooyin
@@ -0,0 +1,110 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QSqlDatabase>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fooyin {
+class DbConnectionPool;
+
+/*!
+ * Single writer thread for a connection pool. Writes submitted from any thread
+ * are queued and run on the writer's own connection, with everything queued at
+ * the time sharing one transaction (group commit). Each write runs inside its
+ * own savepoint, so a failing write doesn't roll back the rest of the batch.
+ *
+ * Write functions may use DbModule instances bound to the same pool; their
+ * queries resolve to the writer thread's connection while running.
+ */
+class FYUTILS_EXPORT DbWriter
+{
+public:
+    using WriteFunc = std::function<bool(const QSqlDatabase& db)>;
+
+    enum class Priority : uint8_t
+    {
+        Normal = 0,
+        //! Queued ahead of normal writes and committed in a batch of its own, for latency-sensitive callers.
+        High,
+    };
+
+    struct Metrics
+    {
+        size_t queueDepth{0};
+        size_t maxQueueDepth{0};
+        uint64_t commits{0};
+        uint64_t writes{0};
+        uint64_t failedWrites{0};
+        std::chrono::microseconds lastCommitLatency{0};
+        std::chrono::microseconds maxCommitLatency{0};
+        std::chrono::microseconds totalCommitLatency{0};
+        //! Longest time a write waited in the queue before its batch started
+        std::chrono::microseconds maxQueueWait{0};
+    };
+
+    explicit DbWriter(DbConnectionPool* pool, size_t maxBatchSize = 512);
+    //! Commits any queued writes before stopping the thread.
+    ~DbWriter();
+
+    DbWriter(const DbWriter&)            = delete;
+    DbWriter& operator=(const DbWriter&) = delete;
+
+    //! Queues @p write, returning whether it succeeded and its batch was committed.
+    std::future<bool> submit(WriteFunc write, Priority priority = Priority::Normal);
+    //! Queues @p write and waits for its batch to commit. Runs inline when called from the writer thread.
+    bool write(const WriteFunc& write, Priority priority = Priority::Normal);
+
+    [[nodiscard]] Metrics metrics() const;
+
+private:
+    struct Request
+    {
+        WriteFunc write;
+        std::promise<bool> result;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    void run(const std::stop_token& stopToken);
+    void commitBatch(std::vector<Request>& batch);
+
+    DbConnectionPool* m_pool;
+    size_t m_maxBatchSize;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_queueCv;
+    std::deque<Request> m_queue;
+    //! Number of high priority requests at the front of the queue
+    size_t m_priorityCount{0};
+    Metrics m_metrics;
+
+    std::jthread m_thread;
+};
+} // namespace Fooyin
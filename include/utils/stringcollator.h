@@ -21,6 +21,8 @@
 
 #include "fyutils_export.h"
 
+#include <QByteArray>
+#include <QLocale>
 #include <QString>
 
 namespace Fooyin {
@@ -32,6 +34,9 @@ public:
     StringCollator();
     ~StringCollator();
 
+    //! The locale the collator was created for; the default locale at construction.
+    [[nodiscard]] QLocale locale() const;
+
     [[nodiscard]] Qt::CaseSensitivity caseSensitivity() const;
     void setCaseSensitivity(Qt::CaseSensitivity sensitivity);
 
@@ -40,6 +45,13 @@ public:
 
     [[nodiscard]] int compare(QStringView s1, QStringView s2) const;
 
+    /*!
+     * Returns a binary collation key for @p str using the current case sensitivity and numeric mode.
+     * Comparing two keys bytewise (as QByteArray does) gives the same order as `compare()`,
+     * so a key can be computed once per string and reused across many comparisons.
+     */
+    [[nodiscard]] QByteArray sortKey(QStringView str) const;
+
 private:
     std::unique_ptr<StringCollatorPrivate> p;
 };
@@ -46,6 +46,7 @@
 #include <core/engine/audioloader.h>
 #include <core/engine/dsp/dspplugin.h>
 #include <core/engine/outputplugin.h>
+#include <core/engine/trackanalysis.h>
 #include <core/network/networkaccessmanager.h>
 #include <core/player/playercontroller.h>
 #include <core/playlist/playlisthandler.h>
@@ -118,6 +119,7 @@ public:
     TranslationLoader m_translations;
     Database* m_database;
     std::shared_ptr<AudioLoader> m_audioLoader;
+    std::shared_ptr<TrackAnalysisPipeline> m_analysisPipeline;
     DspRegistry m_dspRegistry;
     DspChainStore m_dspChainStore;
     LibraryManager* m_libraryManager;
@@ -143,6 +145,7 @@ ApplicationPrivate::ApplicationPrivate(Application* self_)
     , m_coreSettings{m_settings}
     , m_database{new Database(m_self)}
     , m_audioLoader{std::make_shared<AudioLoader>()}
+    , m_analysisPipeline{std::make_shared<TrackAnalysisPipeline>(m_audioLoader)}
     , m_dspChainStore{m_settings, &m_dspRegistry}
     , m_libraryManager{new LibraryManager(m_database->connectionPool(), m_settings, m_self)}
     , m_playlistLoader{std::make_shared<PlaylistLoader>()}
@@ -155,8 +158,9 @@ ApplicationPrivate::ApplicationPrivate(Application* self_)
     , m_sortingRegistry{new SortingRegistry(m_settings, m_self)}
     , m_networkManager{new NetworkAccessManager(m_settings, m_self)}
     , m_pluginManager{m_settings}
-    , m_corePluginContext{&m_engine,  m_playerController, m_libraryManager,  m_library,       m_playlistHandler,
-                          m_settings, m_audioLoader,      m_sortingRegistry, m_networkManager}
+    , m_corePluginContext{&m_engine,         m_playerController, m_libraryManager, m_library,
+                          m_playlistHandler, m_settings,         m_audioLoader,    m_sortingRegistry,
+                          m_networkManager,  m_analysisPipeline}
 {
     m_translations.initialiseTranslations(m_settings->value<Settings::Core::Language>());
     loadDatabaseSettings();
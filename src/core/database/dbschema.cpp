@@ -137,6 +137,7 @@ DbSchema::UpgradeResult DbSchema::upgradeDatabase(int targetVersion, const QStri
 
     // Update views before migrations in case we've dropped columns
     TrackDatabase::dropViews(db());
+    TrackDatabase::dropTriggers(db());
 
     int nextVersion = lastVer;
     while(nextVersion < targetVersion) {
@@ -173,6 +174,7 @@ DbSchema::UpgradeResult DbSchema::upgradeDatabase(int targetVersion, const QStri
     if(targetVersion != lastVer) {
         m_settingsDb.set(QString::fromLatin1(LastVersionKey), targetVersion);
         TrackDatabase::insertViews(db());
+        TrackDatabase::insertTriggers(db());
     }
 
     if(targetVersion < currentVer) {
@@ -53,16 +53,23 @@ int LibraryDatabase::insertLibrary(const QString& path, const QString& name)
 
     static const QString statement = u"INSERT INTO Libraries (Name, Path) VALUES (:name, :path);"_s;
 
-    DbQuery query{db(), statement};
+    int id{-1};
 
-    query.bindValue(u":name"_s, name);
-    query.bindValue(u":path"_s, path);
+    runWrite([&]() {
+        DbQuery query{db(), statement};
 
-    if(!query.exec()) {
-        return -1;
-    }
+        query.bindValue(u":name"_s, name);
+        query.bindValue(u":path"_s, path);
 
-    return query.lastInsertId().toInt();
+        if(!query.exec()) {
+            return false;
+        }
+
+        id = query.lastInsertId().toInt();
+        return true;
+    });
+
+    return id;
 }
 
 bool LibraryDatabase::removeLibrary(int id)
@@ -73,11 +80,13 @@ bool LibraryDatabase::removeLibrary(int id)
 
     static const QString statement = u"DELETE FROM Libraries WHERE LibraryID = :id;"_s;
 
-    DbQuery query{db(), statement};
+    return runWrite([this, id]() {
+        DbQuery query{db(), statement};
 
-    query.bindValue(u":id"_s, id);
+        query.bindValue(u":id"_s, id);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool LibraryDatabase::renameLibrary(int id, const QString& name)
@@ -88,11 +97,13 @@ bool LibraryDatabase::renameLibrary(int id, const QString& name)
 
     static const QString statement = u"UPDATE Libraries SET Name = :name WHERE LibraryId = :id;"_s;
 
-    DbQuery query{db(), statement};
+    return runWrite([this, id, &name]() {
+        DbQuery query{db(), statement};
 
-    query.bindValue(u":name"_s, name);
-    query.bindValue(u":id"_s, id);
+        query.bindValue(u":name"_s, name);
+        query.bindValue(u":id"_s, id);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 } // namespace Fooyin
@@ -50,38 +50,42 @@ std::vector<PlaybackQueueInfo> PlaybackQueueDatabase::queue() const
 
 bool PlaybackQueueDatabase::replaceQueue(const std::vector<PlaybackQueueInfo>& queue) const
 {
-    DbTransaction transaction{db()};
-    if(!transaction) {
-        return false;
-    }
-
-    if(!clearQueue()) {
-        return false;
-    }
-
     static const QString statement = u"INSERT INTO PlaybackQueue (QueueIndex, TrackID, PlaylistID, PlaylistTrackIndex) "
                                      "VALUES (:queueIndex, :trackId, :playlistId, :playlistTrackIndex);"_s;
 
-    for(int i{0}; const auto& item : queue) {
-        DbQuery query{db(), statement};
-        query.bindValue(u":queueIndex"_s, i++);
-        query.bindValue(u":trackId"_s, item.trackId);
-        query.bindValue(u":playlistId"_s, item.playlistDbId >= 0 ? item.playlistDbId : QVariant{});
-        query.bindValue(u":playlistTrackIndex"_s, item.playlistTrackIndex);
+    return runWrite([this, &queue]() {
+        DbTransaction transaction{db()};
+        if(!transaction) {
+            return false;
+        }
 
-        if(!query.exec()) {
+        if(!clearQueue()) {
             return false;
         }
-    }
 
-    return transaction.commit();
+        for(int i{0}; const auto& item : queue) {
+            DbQuery query{db(), statement};
+            query.bindValue(u":queueIndex"_s, i++);
+            query.bindValue(u":trackId"_s, item.trackId);
+            query.bindValue(u":playlistId"_s, item.playlistDbId >= 0 ? item.playlistDbId : QVariant{});
+            query.bindValue(u":playlistTrackIndex"_s, item.playlistTrackIndex);
+
+            if(!query.exec()) {
+                return false;
+            }
+        }
+
+        return transaction.commit();
+    });
 }
 
 bool PlaybackQueueDatabase::clearQueue() const
 {
     static const QString statement = u"DELETE FROM PlaybackQueue;"_s;
 
-    DbQuery query{db(), statement};
-    return query.exec();
+    return runWrite([this]() {
+        DbQuery query{db(), statement};
+        return query.exec();
+    });
 }
 } // namespace Fooyin
@@ -22,6 +22,9 @@
 #include <utils/database/dbquery.h>
 #include <utils/database/dbtransaction.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace Qt::StringLiterals;
 
 namespace Fooyin {
@@ -72,22 +75,34 @@ int PlaylistDatabase::insertPlaylist(const QString& name, int index, bool isAuto
                                      "ForceSorted) VALUES (:name, :index, :isAutoPlaylist, :query, :sortQuery, "
                                      ":forceSorted);"_s;
 
-    DbQuery query{db(), statement};
-    query.bindValue(u":name"_s, name);
-    query.bindValue(u":index"_s, index);
-    query.bindValue(u":isAutoPlaylist"_s, isAutoPlaylist);
-    query.bindValue(u":query"_s, autoQuery);
-    query.bindValue(u":sortQuery"_s, autoSortQuery);
-    query.bindValue(u":forceSorted"_s, forceSorted);
+    int id{-1};
 
-    if(!query.exec()) {
-        return -1;
-    }
+    runWrite([&]() {
+        DbQuery query{db(), statement};
+        query.bindValue(u":name"_s, name);
+        query.bindValue(u":index"_s, index);
+        query.bindValue(u":isAutoPlaylist"_s, isAutoPlaylist);
+        query.bindValue(u":query"_s, autoQuery);
+        query.bindValue(u":sortQuery"_s, autoSortQuery);
+        query.bindValue(u":forceSorted"_s, forceSorted);
+
+        if(!query.exec()) {
+            return false;
+        }
+
+        id = query.lastInsertId().toInt();
+        return true;
+    });
 
-    return query.lastInsertId().toInt();
+    return id;
 }
 
 bool PlaylistDatabase::savePlaylist(Playlist& playlist)
+{
+    return runWrite([this, &playlist]() { return writePlaylist(playlist); });
+}
+
+bool PlaylistDatabase::writePlaylist(Playlist& playlist)
 {
     bool updated{false};
 
@@ -110,7 +125,7 @@ bool PlaylistDatabase::savePlaylist(Playlist& playlist)
     }
 
     if(playlist.tracksModified()) {
-        updated = insertPlaylistTracks(playlist.dbId(), playlist.tracks());
+        updated = writePlaylistTracks(playlist.dbId(), playlist.tracks());
     }
 
     if(updated) {
@@ -123,23 +138,30 @@ bool PlaylistDatabase::savePlaylist(Playlist& playlist)
 
 bool PlaylistDatabase::saveModifiedPlaylists(const PlaylistList& playlists)
 {
-    DbTransaction transaction{db()};
+    // Called from the main thread, so don't queue behind library writes
+    return runWrite(
+        [this, &playlists]() {
+            DbTransaction transaction{db()};
 
-    for(const auto& playlist : playlists) {
-        savePlaylist(*playlist);
-    }
+            for(const auto& playlist : playlists) {
+                writePlaylist(*playlist);
+            }
 
-    return transaction.commit();
+            return transaction.commit();
+        },
+        DbWriter::Priority::High);
 }
 
 bool PlaylistDatabase::removePlaylist(int id)
 {
     static const QString statement = u"DELETE FROM Playlists WHERE PlaylistID = :id;"_s;
 
-    DbQuery query{db(), statement};
-    query.bindValue(u":id"_s, id);
+    return runWrite([this, id]() {
+        DbQuery query{db(), statement};
+        query.bindValue(u":id"_s, id);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool PlaylistDatabase::renamePlaylist(int id, const QString& name)
@@ -150,47 +172,194 @@ bool PlaylistDatabase::renamePlaylist(int id, const QString& name)
 
     static const QString statement = u"UPDATE Playlists SET Name = :name WHERE PlaylistID = :id;"_s;
 
-    DbQuery query{db(), statement};
-    query.bindValue(u":name"_s, name);
-    query.bindValue(u":id"_s, id);
+    return runWrite([this, id, &name]() {
+        DbQuery query{db(), statement};
+        query.bindValue(u":name"_s, name);
+        query.bindValue(u":id"_s, id);
 
-    return query.exec();
+        return query.exec();
+    });
+}
+
+bool PlaylistDatabase::savePlaylistTracks(int playlistId, const TrackList& tracks)
+{
+    return runWrite([this, playlistId, &tracks]() { return writePlaylistTracks(playlistId, tracks); });
+}
+
+bool PlaylistDatabase::writePlaylistTracks(int playlistId, const TrackList& tracks)
+{
+    if(playlistId < 0) {
+        return false;
+    }
+
+    std::vector<int> trackIds;
+    trackIds.reserve(tracks.size());
+    for(const auto& track : tracks) {
+        if(track.isValid() && track.isInDatabase()) {
+            trackIds.push_back(track.id());
+        }
+    }
+
+    auto storedIds = storedPlaylistTrackIds(playlistId);
+    if(!storedIds) {
+        // Stored rows aren't contiguous (e.g. tracks were removed by cascade), so rewrite them all
+        return removePlaylistTracks(playlistId, 0, std::numeric_limits<int>::max())
+            && insertPlaylistTracks(playlistId, trackIds, 0, static_cast<int>(trackIds.size()));
+    }
+
+    const auto storedCount = static_cast<int>(storedIds->size());
+    const auto newCount    = static_cast<int>(trackIds.size());
+
+    int prefix{0};
+    while(prefix < storedCount && prefix < newCount && storedIds->at(prefix) == trackIds.at(prefix)) {
+        ++prefix;
+    }
+
+    int suffix{0};
+    while(suffix < storedCount - prefix && suffix < newCount - prefix
+          && storedIds->at(storedCount - suffix - 1) == trackIds.at(newCount - suffix - 1)) {
+        ++suffix;
+    }
+
+    const int storedEnd = storedCount - suffix;
+    const int newEnd    = newCount - suffix;
+
+    if(prefix == storedEnd && prefix == newEnd) {
+        return true;
+    }
+
+    if(storedEnd == newEnd) {
+        // A block moved within the window leaves it rotated, so only the indexes of its rows need shifting
+        const auto windowBegin = storedIds->cbegin() + prefix;
+        const auto windowEnd   = storedIds->cbegin() + storedEnd;
+        const auto newBegin    = trackIds.cbegin() + prefix;
+
+        auto middle = std::find(windowBegin + 1, windowEnd, *newBegin);
+        while(middle != windowEnd) {
+            const auto movedHead = newBegin + std::distance(middle, windowEnd);
+            if(std::equal(middle, windowEnd, newBegin) && std::equal(windowBegin, middle, movedHead)) {
+                const auto middleIndex = static_cast<int>(std::distance(storedIds->cbegin(), middle));
+                return rotatePlaylistTracks(playlistId, prefix, middleIndex, storedEnd);
+            }
+            middle = std::find(middle + 1, windowEnd, *newBegin);
+        }
+    }
+
+    return removePlaylistTracks(playlistId, prefix, storedEnd)
+        && shiftPlaylistTracks(playlistId, storedEnd, newEnd - storedEnd)
+        && insertPlaylistTracks(playlistId, trackIds, prefix, newEnd);
 }
 
-bool PlaylistDatabase::insertPlaylistTrack(int playlistId, const Track& track, int index)
+std::optional<std::vector<int>> PlaylistDatabase::storedPlaylistTrackIds(int playlistId)
 {
     static const QString statement
-        = u"INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES (:playlistId, :trackId, :index);"_s;
+        = u"SELECT TrackID, TrackIndex FROM PlaylistTracks WHERE PlaylistID = :playlistId ORDER BY TrackIndex;"_s;
 
     DbQuery query{db(), statement};
     query.bindValue(u":playlistId"_s, playlistId);
-    query.bindValue(u":trackId"_s, track.id());
-    query.bindValue(u":index"_s, index);
 
-    return query.exec();
+    if(!query.exec()) {
+        return {};
+    }
+
+    std::vector<int> trackIds;
+
+    while(query.next()) {
+        if(query.value(1).toInt() != static_cast<int>(trackIds.size())) {
+            return {};
+        }
+        trackIds.push_back(query.value(0).toInt());
+    }
+
+    return trackIds;
 }
 
-bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tracks)
+bool PlaylistDatabase::removePlaylistTracks(int playlistId, int fromIndex, int toIndex)
 {
-    if(playlistId < 0) {
-        return false;
+    if(fromIndex >= toIndex) {
+        return true;
     }
 
-    // Remove current playlist tracks
-    static const QString statement = u"DELETE FROM PlaylistTracks WHERE PlaylistID = :id;"_s;
+    static const QString statement = u"DELETE FROM PlaylistTracks WHERE PlaylistID = :playlistId AND TrackIndex >= "
+                                     ":fromIndex AND TrackIndex < :toIndex;"_s;
 
     DbQuery query{db(), statement};
-    query.bindValue(u":id"_s, playlistId);
+    query.bindValue(u":playlistId"_s, playlistId);
+    query.bindValue(u":fromIndex"_s, fromIndex);
+    query.bindValue(u":toIndex"_s, toIndex);
 
-    if(!query.exec()) {
-        return false;
+    return query.exec();
+}
+
+bool PlaylistDatabase::shiftPlaylistTracks(int playlistId, int fromIndex, int offset)
+{
+    if(offset == 0) {
+        return true;
     }
 
-    for(int i{0}; const auto& track : tracks) {
-        if(track.isValid() && track.isInDatabase()) {
-            if(!insertPlaylistTrack(playlistId, track, i++)) {
-                return false;
+    static const QString statement = u"UPDATE PlaylistTracks SET TrackIndex = TrackIndex + :offset "
+                                     "WHERE PlaylistID = :playlistId AND TrackIndex >= :fromIndex;"_s;
+
+    DbQuery query{db(), statement};
+    query.bindValue(u":offset"_s, offset);
+    query.bindValue(u":playlistId"_s, playlistId);
+    query.bindValue(u":fromIndex"_s, fromIndex);
+
+    return query.exec();
+}
+
+bool PlaylistDatabase::rotatePlaylistTracks(int playlistId, int fromIndex, int middleIndex, int toIndex)
+{
+    static const QString statement
+        = u"UPDATE PlaylistTracks SET TrackIndex = CASE WHEN TrackIndex < :middleIndex THEN TrackIndex + :tailSize "
+          "ELSE TrackIndex - :headSize END WHERE PlaylistID = :playlistId AND TrackIndex >= :fromIndex AND "
+          "TrackIndex < :toIndex;"_s;
+
+    DbQuery query{db(), statement};
+    query.bindValue(u":middleIndex"_s, middleIndex);
+    query.bindValue(u":tailSize"_s, toIndex - middleIndex);
+    query.bindValue(u":headSize"_s, middleIndex - fromIndex);
+    query.bindValue(u":playlistId"_s, playlistId);
+    query.bindValue(u":fromIndex"_s, fromIndex);
+    query.bindValue(u":toIndex"_s, toIndex);
+
+    return query.exec();
+}
+
+bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const std::vector<int>& trackIds, int fromIndex,
+                                            int toIndex)
+{
+    // Three parameters per row keeps each batch under SQLite's default limit of 999 host parameters
+    static constexpr int BatchSize = 300;
+
+    QString batchStatement;
+    int batchStatementRows{0};
+
+    for(int batchStart{fromIndex}; batchStart < toIndex; batchStart += BatchSize) {
+        const int rows = std::min(BatchSize, toIndex - batchStart);
+
+        if(rows != batchStatementRows) {
+            QStringList values;
+            values.reserve(rows);
+            for(int row{0}; row < rows; ++row) {
+                values.push_back(u"(:playlistId, :trackId%1, :index%1)"_s.arg(row));
             }
+            batchStatement = u"INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES "_s
+                           + values.join(u", "_s) + u";"_s;
+            batchStatementRows = rows;
+        }
+
+        DbQuery query{db(), batchStatement};
+        query.bindValue(u":playlistId"_s, playlistId);
+
+        for(int row{0}; row < rows; ++row) {
+            const int index = batchStart + row;
+            query.bindValue(u":trackId%1"_s.arg(row), trackIds.at(index));
+            query.bindValue(u":index%1"_s.arg(row), index);
+        }
+
+        if(!query.exec()) {
+            return false;
         }
     }
 
@@ -19,10 +19,14 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include <core/playlist/playlist.h>
 #include <core/track.h>
 #include <utils/database/dbmodule.h>
 
+#include <optional>
+
 namespace Fooyin {
 struct PlaylistInfo
 {
@@ -35,7 +39,7 @@ struct PlaylistInfo
     bool forceSorted{true};
 };
 
-class PlaylistDatabase : public DbModule
+class FYCORE_EXPORT PlaylistDatabase : public DbModule
 {
 public:
     std::vector<PlaylistInfo> getAllPlaylists();
@@ -49,9 +53,22 @@ public:
     bool removePlaylist(int id);
     bool renamePlaylist(int id, const QString& name);
 
+    /*!
+     * Stores @p tracks as the contents of playlist @p playlistId.
+     * Only rows between the longest unchanged prefix and suffix of the stored playlist are rewritten,
+     * and a single moved block is applied by shifting indexes rather than rewriting its rows.
+     */
+    bool savePlaylistTracks(int playlistId, const TrackList& tracks);
+
 private:
-    bool insertPlaylistTrack(int playlistId, const Fooyin::Track& track, int index);
-    bool insertPlaylistTracks(int playlistId, const TrackList& tracks);
+    bool writePlaylist(Playlist& playlist);
+    bool writePlaylistTracks(int playlistId, const TrackList& tracks);
+    [[nodiscard]] std::optional<std::vector<int>> storedPlaylistTrackIds(int playlistId);
+    bool removePlaylistTracks(int playlistId, int fromIndex, int toIndex);
+    bool shiftPlaylistTracks(int playlistId, int fromIndex, int offset);
+    //! Moves the rows in [@p middleIndex, @p toIndex) ahead of those in [@p fromIndex, @p middleIndex).
+    bool rotatePlaylistTracks(int playlistId, int fromIndex, int middleIndex, int toIndex);
+    bool insertPlaylistTracks(int playlistId, const std::vector<int>& trackIds, int fromIndex, int toIndex);
     TrackList populatePlaylistTracks(const Playlist& playlist, const std::unordered_map<int, Track>& tracks);
 };
 } // namespace Fooyin
@@ -59,15 +59,17 @@ bool SettingsDatabase::set(const QString& name, const QVariant& value) const
 
     static const QString statement = u"INSERT OR REPLACE INTO Settings (Name, Value) VALUES (:name, :value)"_s;
 
-    QSqlQuery query{db()};
+    return runWrite([this, &name, &value]() {
+        QSqlQuery query{db()};
 
-    if(!query.prepare(statement)) {
-        return false;
-    }
+        if(!query.prepare(statement)) {
+            return false;
+        }
 
-    query.bindValue(u":name"_s, name);
-    query.bindValue(u":value"_s, value.toString());
+        query.bindValue(u":name"_s, name);
+        query.bindValue(u":value"_s, value.toString());
 
-    return query.exec();
+        return query.exec();
+    });
 }
 } // namespace Fooyin
@@ -29,12 +29,12 @@
 #include <QFileInfo>
 #include <QLoggingCategory>
 
+#include <unordered_map>
+
 Q_LOGGING_CATEGORY(TRK_DB, "fy.trackdb")
 
 using namespace Qt::StringLiterals;
 
-using BindingsMap = std::map<QString, QVariant>;
-
 namespace {
 float normaliseTrackRating(float rating)
 {
@@ -91,46 +91,146 @@ QString fetchTrackColumns()
     return columns;
 }
 
-BindingsMap trackBindings(const Fooyin::Track& track)
-{
-    return {{u":filePath"_s, track.filepath()},
-            {u":subsong"_s, track.subsong()},
-            {u":title"_s, track.title()},
-            {u":trackNumber"_s, track.trackNumber()},
-            {u":trackTotal"_s, track.trackTotal()},
-            {u":artists"_s, track.artist()},
-            {u":albumArtist"_s, track.albumArtist()},
-            {u":album"_s, track.album()},
-            {u":discNumber"_s, track.discNumber()},
-            {u":discTotal"_s, track.discTotal()},
-            {u":date"_s, track.date()},
-            {u":composer"_s, track.composer()},
-            {u":performer"_s, track.performer()},
-            {u":genres"_s, track.genre()},
-            {u":comment"_s, track.comment()},
-            {u":cuePath"_s, track.cuePath()},
-            {u":offset"_s, static_cast<quint64>(track.offset())},
-            {u":duration"_s, static_cast<quint64>(track.duration())},
-            {u":fileSize"_s, static_cast<quint64>(track.fileSize())},
-            {u":bitRate"_s, track.bitrate()},
-            {u":sampleRate"_s, track.sampleRate()},
-            {u":channels"_s, track.channels()},
-            {u":bitDepth"_s, track.bitDepth()},
-            {u":codec"_s, track.codec()},
-            {u":codecProfile"_s, track.codecProfile()},
-            {u":tool"_s, track.tool()},
-            {u":tagTypes"_s, track.tagType()},
-            {u":encoding"_s, track.encoding()},
-            {u":extraTags"_s, track.serialiseExtraTags()},
-            {u":extraProperties"_s, track.serialiseExtraProperties()},
-            {u":modifiedDate"_s, static_cast<quint64>(track.modifiedTime())},
-            {u":trackHash"_s, track.hash()},
-            {u":libraryID"_s, track.libraryId()},
-            {u":rgTrackGain"_s, track.rgTrackGain()},
-            {u":rgAlbumGain"_s, track.rgAlbumGain()},
-            {u":rgTrackPeak"_s, track.rgTrackPeak()},
-            {u":rgAlbumPeak"_s, track.rgAlbumPeak()},
-            {u":createdDate"_s, static_cast<quint64>(track.createdTime())}};
+// Columns written by insertTrack/updateTrack, indexed by Track::Field
+const QStringList& trackWriteColumns()
+{
+    static const QStringList columns
+        = {u"FilePath"_s,     u"Subsong"_s,     u"Title"_s,       u"TrackNumber"_s,  u"TrackTotal"_s,
+           u"Artists"_s,      u"AlbumArtist"_s, u"Album"_s,       u"DiscNumber"_s,   u"DiscTotal"_s,
+           u"Date"_s,         u"Composer"_s,    u"Performer"_s,   u"Genres"_s,       u"Comment"_s,
+           u"CuePath"_s,      u"Offset"_s,      u"Duration"_s,    u"FileSize"_s,     u"BitRate"_s,
+           u"SampleRate"_s,   u"Channels"_s,    u"BitDepth"_s,    u"Codec"_s,        u"CodecProfile"_s,
+           u"Tool"_s,         u"TagTypes"_s,    u"Encoding"_s,    u"ExtraTags"_s,    u"ExtraProperties"_s,
+           u"ModifiedDate"_s, u"TrackHash"_s,   u"LibraryID"_s,   u"RGTrackGain"_s,  u"RGAlbumGain"_s,
+           u"RGTrackPeak"_s,  u"RGAlbumPeak"_s, u"CreatedDate"_s};
+    Q_ASSERT(columns.size() == static_cast<qsizetype>(Fooyin::Track::Field::Count));
+
+    return columns;
+}
+
+QString insertTrackStatement(bool ignoreDuplicates)
+{
+    const QStringList& columns = trackWriteColumns();
+    const QStringList placeholders(columns.size(), u"?"_s);
+
+    return u"INSERT %1INTO Tracks (%2) VALUES (%3);"_s.arg(ignoreDuplicates ? u"OR IGNORE "_s : QString{},
+                                                            columns.join(u','), placeholders.join(u','));
+}
+
+QString updateTrackStatement(const Fooyin::Track::Fields& fields)
+{
+    const QStringList& columns = trackWriteColumns();
+
+    QStringList assignments;
+    for(qsizetype i{0}; i < columns.size(); ++i) {
+        if(fields.test(static_cast<size_t>(i))) {
+            assignments.push_back(columns.at(i) + u" = ?"_s);
+        }
+    }
+
+    return u"UPDATE Tracks SET %1 WHERE TrackID = ?;"_s.arg(assignments.join(u','));
+}
+
+QVariant trackValue(const Fooyin::Track& track, Fooyin::Track::Field field)
+{
+    using Field = Fooyin::Track::Field;
+
+    switch(field) {
+        case Field::FilePath:
+            return track.filepath();
+        case Field::Subsong:
+            return track.subsong();
+        case Field::Title:
+            return track.title();
+        case Field::TrackNumber:
+            return track.trackNumber();
+        case Field::TrackTotal:
+            return track.trackTotal();
+        case Field::Artists:
+            return track.artist();
+        case Field::AlbumArtists:
+            return track.albumArtist();
+        case Field::Album:
+            return track.album();
+        case Field::DiscNumber:
+            return track.discNumber();
+        case Field::DiscTotal:
+            return track.discTotal();
+        case Field::Date:
+            return track.date();
+        case Field::Composers:
+            return track.composer();
+        case Field::Performers:
+            return track.performer();
+        case Field::Genres:
+            return track.genre();
+        case Field::Comment:
+            return track.comment();
+        case Field::CuePath:
+            return track.cuePath();
+        case Field::Offset:
+            return static_cast<quint64>(track.offset());
+        case Field::Duration:
+            return static_cast<quint64>(track.duration());
+        case Field::FileSize:
+            return static_cast<quint64>(track.fileSize());
+        case Field::Bitrate:
+            return track.bitrate();
+        case Field::SampleRate:
+            return track.sampleRate();
+        case Field::Channels:
+            return track.channels();
+        case Field::BitDepth:
+            return track.bitDepth();
+        case Field::Codec:
+            return track.codec();
+        case Field::CodecProfile:
+            return track.codecProfile();
+        case Field::Tool:
+            return track.tool();
+        case Field::TagTypes:
+            return track.tagType();
+        case Field::Encoding:
+            return track.encoding();
+        case Field::ExtraTags:
+            return track.serialiseExtraTags();
+        case Field::ExtraProperties:
+            return track.serialiseExtraProperties();
+        case Field::ModifiedTime:
+            return static_cast<quint64>(track.modifiedTime());
+        case Field::Hash:
+            return track.hash();
+        case Field::LibraryId:
+            return track.libraryId();
+        case Field::RGTrackGain:
+            return track.rgTrackGain();
+        case Field::RGAlbumGain:
+            return track.rgAlbumGain();
+        case Field::RGTrackPeak:
+            return track.rgTrackPeak();
+        case Field::RGAlbumPeak:
+            return track.rgAlbumPeak();
+        case Field::CreatedTime:
+            return static_cast<quint64>(track.createdTime());
+        case Field::Count:
+            break;
+    }
+
+    return {};
+}
+
+//! Binds the values of the given trackWriteColumns positionally, returning the next free position.
+int bindTrackValues(Fooyin::DbQuery& query, const Fooyin::Track& track, const Fooyin::Track::Fields& fields)
+{
+    int pos{0};
+
+    for(size_t i{0}; i < fields.size(); ++i) {
+        if(fields.test(i)) {
+            query.bindValue(pos++, trackValue(track, static_cast<Fooyin::Track::Field>(i)));
+        }
+    }
+
+    return pos;
 }
 
 Fooyin::Track readToTrack(const Fooyin::DbQuery& q, const std::shared_ptr<Fooyin::TrackMetadataStore>& store)
@@ -195,6 +295,7 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q, const std::shared_ptr<Fooyin
 
     track.setMetadataWasRead(true);
     track.generateHash();
+    track.clearDirtyFields();
 
     return track;
 }
@@ -212,30 +313,32 @@ bool TrackDatabase::storeTracks(TrackList& tracks)
         return true;
     }
 
-    DbTransaction transaction{db()};
-
-    if(!transaction) {
-        return false;
-    }
+    return runWrite([this, &tracks]() {
+        DbTransaction transaction{db()};
 
-    for(auto& track : tracks) {
-        if(track.id() < 0) {
-            if(!insertTrack(track, true)) {
-                return false;
-            }
+        if(!transaction) {
+            return false;
+        }
 
+        for(auto& track : tracks) {
             if(track.id() < 0) {
-                if(const int existingTrackId = idForTrack(track); existingTrackId >= 0) {
-                    track.setId(existingTrackId);
-                }
-                else {
+                if(!insertTrack(track, true)) {
                     return false;
                 }
+
+                if(track.id() < 0) {
+                    if(const int existingTrackId = idForTrack(track); existingTrackId >= 0) {
+                        track.setId(existingTrackId);
+                    }
+                    else {
+                        return false;
+                    }
+                }
             }
         }
-    }
 
-    return transaction.commit();
+        return transaction.commit();
+    });
 }
 
 bool TrackDatabase::updateTracks(TrackList& tracks)
@@ -244,26 +347,52 @@ bool TrackDatabase::updateTracks(TrackList& tracks)
         return true;
     }
 
-    DbTransaction transaction{db()};
+    return runWrite([this, &tracks]() {
+        DbTransaction transaction{db()};
 
-    if(!transaction) {
-        return false;
-    }
+        if(!transaction) {
+            return false;
+        }
 
-    for(auto& track : tracks) {
-        if(track.id() >= 0) {
-            updateTrack(track);
+        // Group by changed column set so each narrow statement is built once and reused across the batch
+        std::unordered_map<unsigned long long, std::vector<Track*>> trackGroups;
+        for(auto& track : tracks) {
+            if(track.id() >= 0) {
+                trackGroups[track.dirtyFields().to_ullong()].push_back(&track);
+            }
         }
-    }
 
-    return transaction.commit();
+        std::vector<Track*> updatedTracks;
+        updatedTracks.reserve(tracks.size());
+
+        for(const auto& [mask, groupTracks] : trackGroups) {
+            const Track::Fields fields{mask};
+            const QString statement = updateTrackStatement(fields);
+
+            for(Track* track : groupTracks) {
+                if(updateTrack(*track, statement, fields)) {
+                    updatedTracks.push_back(track);
+                }
+            }
+        }
+
+        if(!transaction.commit()) {
+            return false;
+        }
+
+        for(Track* track : updatedTracks) {
+            track->clearDirtyFields();
+        }
+
+        return true;
+    });
 }
 
 bool TrackDatabase::reloadTrack(Track& track) const
 {
     static const QString statement = u"SELECT %1 FROM TracksView WHERE TrackID = :trackId;"_s.arg(fetchTrackColumns());
 
-    DbQuery query{db(), statement};
+    DbQuery query{connection(), statement};
 
     query.bindValue(u":trackId"_s, track.id());
 
@@ -355,7 +484,7 @@ int TrackDatabase::idForTrack(Track& track) const
     static const QString statement
         = u"SELECT TrackID FROM Tracks WHERE FilePath = :path AND Offset = :offset AND Subsong = :subsong;"_s;
 
-    DbQuery query{db(), statement};
+    DbQuery query{connection(), statement};
 
     query.bindValue(u":path"_s, track.filepath());
     query.bindValue(u":offset"_s, static_cast<quint64>(track.offset()));
@@ -379,88 +508,64 @@ bool TrackDatabase::updateTrack(const Track& track)
         return false;
     }
 
-    static const QString statement = u"UPDATE TRACKS SET "
-                                     "FilePath = :filePath,"
-                                     "Subsong = :subsong,"
-                                     "Title = :title, "
-                                     "TrackNumber = :trackNumber,"
-                                     "TrackTotal = :trackTotal,"
-                                     "Artists = :artists,"
-                                     "AlbumArtist = :albumArtist,"
-                                     "Album = :album,"
-                                     "DiscNumber = :discNumber,"
-                                     "DiscTotal = :discTotal,"
-                                     "Date = :date,"
-                                     "Composer = :composer,"
-                                     "Performer = :performer,"
-                                     "Genres = :genres,"
-                                     "Comment = :comment,"
-                                     "CuePath = :cuePath,"
-                                     "Offset = :offset,"
-                                     "Duration = :duration,"
-                                     "FileSize = :fileSize,"
-                                     "BitRate = :bitRate,"
-                                     "SampleRate = :sampleRate,"
-                                     "Channels = :channels,"
-                                     "BitDepth = :bitDepth,"
-                                     "Codec = :codec,"
-                                     "CodecProfile = :codecProfile,"
-                                     "Tool = :tool,"
-                                     "TagTypes = :tagTypes,"
-                                     "Encoding = :encoding,"
-                                     "ExtraTags = :extraTags,"
-                                     "ExtraProperties = :extraProperties,"
-                                     "ModifiedDate = :modifiedDate,"
-                                     "TrackHash = :trackHash,"
-                                     "LibraryID = :libraryID,"
-                                     "RGTrackGain = :rgTrackGain,"
-                                     "RGAlbumGain = :rgAlbumGain,"
-                                     "RGTrackPeak = :rgTrackPeak,"
-                                     "RGAlbumPeak = :rgAlbumPeak,"
-                                     "CreatedDate = :createdDate"
-                                     " WHERE TrackID = :trackId;"_s;
-
-    DbQuery query{db(), statement};
+    const Track::Fields fields = track.dirtyFields();
+    if(fields.all()) {
+        static const QString statement = updateTrackStatement(fields);
+        return updateTrack(track, statement, fields);
+    }
 
-    query.bindValue(u":trackId"_s, track.id());
+    return updateTrack(track, updateTrackStatement(fields), fields);
+}
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+bool TrackDatabase::updateTrack(const Track& track, const QString& statement, const Track::Fields& fields)
+{
+    if(fields.none()) {
+        return true;
     }
 
-    return query.exec();
+    return runWrite([this, &track, &statement, &fields]() {
+        DbQuery query{connection(), statement};
+
+        const int trackIdPos = bindTrackValues(query, track, fields);
+        query.bindValue(trackIdPos, track.id());
+
+        return query.exec();
+    });
 }
 
 bool TrackDatabase::updateTrackStats(const Track& track)
 {
-    return insertOrUpdateStats(track);
+    return runWrite([this, &track]() { return insertOrUpdateStats(track); });
 }
 
 bool TrackDatabase::updateTrackStats(const TrackList& tracks)
 {
-    bool success{true};
+    return runWrite([this, &tracks]() {
+        bool success{true};
 
-    DbTransaction transaction{db()};
+        DbTransaction transaction{db()};
 
-    for(const Track& track : tracks) {
-        if(!insertOrUpdateStats(track)) {
-            success = false;
+        for(const Track& track : tracks) {
+            if(!insertOrUpdateStats(track)) {
+                success = false;
+            }
         }
-    }
 
-    return success && transaction.commit();
+        return success && transaction.commit();
+    });
 }
 
 bool TrackDatabase::deleteTrack(int id)
 {
     static const QString statement = u"DELETE FROM Tracks WHERE TrackID = :trackID;"_s;
 
-    DbQuery query{db(), statement};
+    return runWrite([this, id]() {
+        DbQuery query{connection(), statement};
 
-    query.bindValue(u":trackID"_s, id);
+        query.bindValue(u":trackID"_s, id);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool TrackDatabase::deleteTracks(const TrackList& tracks)
@@ -469,73 +574,134 @@ bool TrackDatabase::deleteTracks(const TrackList& tracks)
         return true;
     }
 
-    DbTransaction transaction{db()};
+    return runWrite([this, &tracks]() {
+        DbTransaction transaction{db()};
 
-    if(!transaction) {
-        return false;
-    }
+        if(!transaction) {
+            return false;
+        }
 
-    const int fileCount = static_cast<int>(
-        std::count_if(tracks.cbegin(), tracks.cend(), [this](const Track& track) { return deleteTrack(track.id()); }));
+        const int fileCount = static_cast<int>(std::count_if(
+            tracks.cbegin(), tracks.cend(), [this](const Track& track) { return deleteTrack(track.id()); }));
 
-    const auto success = transaction.commit();
+        const auto success = transaction.commit();
 
-    return (success && (fileCount == static_cast<int>(tracks.size())));
+        return (success && (fileCount == static_cast<int>(tracks.size())));
+    });
 }
 
 std::set<int> TrackDatabase::deleteLibraryTracks(int libraryId)
 {
     std::set<int> tracksToRemove;
 
-    {
-        static const QString statement = u"SELECT TrackID FROM Tracks WHERE LibraryID = :libraryId AND TrackID "
-                                         "NOT IN (SELECT TrackID FROM PlaylistTracks);"_s;
+    const bool success = runWrite([this, libraryId, &tracksToRemove]() {
+        {
+            static const QString statement = u"SELECT TrackID FROM Tracks WHERE LibraryID = :libraryId AND TrackID "
+                                             "NOT IN (SELECT TrackID FROM PlaylistTracks);"_s;
 
-        DbQuery query{db(), statement};
+            DbQuery query{db(), statement};
 
-        query.bindValue(u":libraryId"_s, libraryId);
+            query.bindValue(u":libraryId"_s, libraryId);
 
-        if(!query.exec()) {
-            return {};
+            if(!query.exec()) {
+                return false;
+            }
+
+            while(query.next()) {
+                tracksToRemove.emplace(query.value(0).toInt());
+            }
         }
 
-        while(query.next()) {
-            tracksToRemove.emplace(query.value(0).toInt());
+        {
+            static const QString statement = u"DELETE FROM Tracks WHERE LibraryID = :libraryId AND TrackID NOT IN "
+                                             "(SELECT TrackID FROM PlaylistTracks);"_s;
+
+            DbQuery query{db(), statement};
+
+            query.bindValue(u":libraryId"_s, libraryId);
+
+            if(!query.exec()) {
+                return false;
+            }
         }
-    }
 
-    {
-        static const QString statement
-            = u"DELETE FROM Tracks WHERE LibraryID = :libraryId AND TrackID NOT IN (SELECT TrackID FROM PlaylistTracks);"_s;
+        static const QString statement = u"UPDATE Tracks SET LibraryID = :nonLibraryId WHERE LibraryID = :libraryId;"_s;
 
         DbQuery query{db(), statement};
 
+        query.bindValue(u":nonLibraryId"_s, u"-1"_s);
         query.bindValue(u":libraryId"_s, libraryId);
 
-        if(!query.exec()) {
-            return {};
-        }
+        return query.exec();
+    });
+
+    if(!success) {
+        return {};
     }
 
-    static const QString statement = u"UPDATE Tracks SET LibraryID = :nonLibraryId WHERE LibraryID = :libraryId;"_s;
+    return tracksToRemove;
+}
+
+void TrackDatabase::cleanupTracks()
+{
+    runWrite([this]() {
+        removeUnmanagedTracks();
+        updateLastSeenStats();
+        deleteExpiredStats();
+        return true;
+    });
+}
+
+int TrackDatabase::trackCount() const
+{
+    static const QString statement = u"SELECT COUNT(*) FROM Tracks;"_s;
 
     DbQuery query{db(), statement};
 
-    query.bindValue(u":nonLibraryId"_s, u"-1"_s);
-    query.bindValue(u":libraryId"_s, libraryId);
+    if(!query.exec()) {
+        return -1;
+    }
+
+    if(query.next()) {
+        return query.value(0).toInt();
+    }
+
+    return -1;
+}
+
+std::set<int> TrackDatabase::trackIds() const
+{
+    static const QString statement = u"SELECT TrackID FROM Tracks;"_s;
+
+    DbQuery query{db(), statement};
 
     if(!query.exec()) {
         return {};
     }
 
-    return tracksToRemove;
+    std::set<int> ids;
+    while(query.next()) {
+        ids.emplace(query.value(0).toInt());
+    }
+
+    return ids;
 }
 
-void TrackDatabase::cleanupTracks()
+int64_t TrackDatabase::libraryGeneration() const
 {
-    removeUnmanagedTracks();
-    updateLastSeenStats();
-    deleteExpiredStats();
+    static const QString statement = u"SELECT Generation FROM LibraryGeneration WHERE ID = 0;"_s;
+
+    DbQuery query{db(), statement};
+
+    if(!query.exec()) {
+        return -1;
+    }
+
+    if(query.next()) {
+        return query.value(0).toLongLong();
+    }
+
+    return -1;
 }
 
 void TrackDatabase::dropViews(const QSqlDatabase& db)
@@ -603,195 +769,51 @@ void TrackDatabase::insertViews(const QSqlDatabase& db)
     query.exec();
 }
 
-int TrackDatabase::trackCount() const
+void TrackDatabase::dropTriggers(const QSqlDatabase& db)
 {
-    static const QString statement = u"SELECT COUNT(*) FROM Tracks;"_s;
+    static const QStringList triggers = {u"LibraryGenerationTrackInsert"_s, u"LibraryGenerationTrackUpdate"_s,
+                                         u"LibraryGenerationTrackDelete"_s, u"LibraryGenerationStatsInsert"_s,
+                                         u"LibraryGenerationStatsUpdate"_s};
 
-    DbQuery query{db(), statement};
-
-    if(!query.exec()) {
-        return -1;
+    for(const QString& trigger : triggers) {
+        DbQuery query{db, u"DROP TRIGGER IF EXISTS %1;"_s.arg(trigger)};
+        query.exec();
     }
+}
 
-    if(query.next()) {
-        return query.value(0).toInt();
+void TrackDatabase::insertTriggers(const QSqlDatabase& db)
+{
+    // LastSeen updates and expired stats deletion are deliberately excluded, as they don't
+    // affect resident tracks and would otherwise invalidate the snapshot on every shutdown.
+    static const QStringList statements
+        = {u"CREATE TRIGGER IF NOT EXISTS LibraryGenerationTrackInsert AFTER INSERT ON Tracks "
+           "BEGIN UPDATE LibraryGeneration SET Generation = Generation + 1; END;"_s,
+           u"CREATE TRIGGER IF NOT EXISTS LibraryGenerationTrackUpdate AFTER UPDATE ON Tracks "
+           "BEGIN UPDATE LibraryGeneration SET Generation = Generation + 1; END;"_s,
+           u"CREATE TRIGGER IF NOT EXISTS LibraryGenerationTrackDelete AFTER DELETE ON Tracks "
+           "BEGIN UPDATE LibraryGeneration SET Generation = Generation + 1; END;"_s,
+           u"CREATE TRIGGER IF NOT EXISTS LibraryGenerationStatsInsert AFTER INSERT ON TrackStats "
+           "BEGIN UPDATE LibraryGeneration SET Generation = Generation + 1; END;"_s,
+           u"CREATE TRIGGER IF NOT EXISTS LibraryGenerationStatsUpdate "
+           "AFTER UPDATE OF AddedDate, FirstPlayed, LastPlayed, PlayCount, Rating ON TrackStats "
+           "BEGIN UPDATE LibraryGeneration SET Generation = Generation + 1; END;"_s};
+
+    for(const QString& statement : statements) {
+        DbQuery query{db, statement};
+        query.exec();
     }
-
-    return -1;
 }
 
 bool TrackDatabase::insertTrack(Track& track, bool ignoreDuplicates) const
 {
-    static const QString insertStatement = u"INSERT INTO Tracks ("
-                                           "FilePath,"
-                                           "Subsong,"
-                                           "Title,"
-                                           "TrackNumber,"
-                                           "TrackTotal,"
-                                           "Artists,"
-                                           "AlbumArtist,"
-                                           "Album,"
-                                           "DiscNumber,"
-                                           "DiscTotal,"
-                                           "Date,"
-                                           "Composer,"
-                                           "Performer,"
-                                           "Genres,"
-                                           "Comment,"
-                                           "CuePath,"
-                                           "Offset,"
-                                           "Duration,"
-                                           "FileSize,"
-                                           "BitRate,"
-                                           "SampleRate,"
-                                           "Channels,"
-                                           "BitDepth,"
-                                           "Codec,"
-                                           "CodecProfile,"
-                                           "Tool,"
-                                           "TagTypes,"
-                                           "Encoding,"
-                                           "ExtraTags,"
-                                           "ExtraProperties,"
-                                           "ModifiedDate,"
-                                           "TrackHash,"
-                                           "LibraryID,"
-                                           "RGTrackGain,"
-                                           "RGAlbumGain,"
-                                           "RGTrackPeak,"
-                                           "RGAlbumPeak,"
-                                           "CreatedDate"
-                                           ") "
-                                           "VALUES ("
-                                           ":filePath,"
-                                           ":subsong,"
-                                           ":title,"
-                                           ":trackNumber,"
-                                           ":trackTotal,"
-                                           ":artists,"
-                                           ":albumArtist,"
-                                           ":album,"
-                                           ":discNumber,"
-                                           ":discTotal,"
-                                           ":date,"
-                                           ":composer,"
-                                           ":performer,"
-                                           ":genres,"
-                                           ":comment,"
-                                           ":cuePath,"
-                                           ":offset,"
-                                           ":duration,"
-                                           ":fileSize,"
-                                           ":bitRate,"
-                                           ":sampleRate,"
-                                           ":channels,"
-                                           ":bitDepth,"
-                                           ":codec,"
-                                           ":codecProfile,"
-                                           ":tool,"
-                                           ":tagTypes,"
-                                           ":encoding,"
-                                           ":extraTags,"
-                                           ":extraProperties,"
-                                           ":modifiedDate,"
-                                           ":trackHash,"
-                                           ":libraryID,"
-                                           ":rgTrackGain,"
-                                           ":rgAlbumGain,"
-                                           ":rgTrackPeak,"
-                                           ":rgAlbumPeak,"
-                                           ":createdDate"
-                                           ");"_s;
-
-    static const QString ignoreStatement = u"INSERT OR IGNORE INTO Tracks ("
-                                           "FilePath,"
-                                           "Subsong,"
-                                           "Title,"
-                                           "TrackNumber,"
-                                           "TrackTotal,"
-                                           "Artists,"
-                                           "AlbumArtist,"
-                                           "Album,"
-                                           "DiscNumber,"
-                                           "DiscTotal,"
-                                           "Date,"
-                                           "Composer,"
-                                           "Performer,"
-                                           "Genres,"
-                                           "Comment,"
-                                           "CuePath,"
-                                           "Offset,"
-                                           "Duration,"
-                                           "FileSize,"
-                                           "BitRate,"
-                                           "SampleRate,"
-                                           "Channels,"
-                                           "BitDepth,"
-                                           "Codec,"
-                                           "CodecProfile,"
-                                           "Tool,"
-                                           "TagTypes,"
-                                           "Encoding,"
-                                           "ExtraTags,"
-                                           "ExtraProperties,"
-                                           "ModifiedDate,"
-                                           "TrackHash,"
-                                           "LibraryID,"
-                                           "RGTrackGain,"
-                                           "RGAlbumGain,"
-                                           "RGTrackPeak,"
-                                           "RGAlbumPeak,"
-                                           "CreatedDate"
-                                           ") "
-                                           "VALUES ("
-                                           ":filePath,"
-                                           ":subsong,"
-                                           ":title,"
-                                           ":trackNumber,"
-                                           ":trackTotal,"
-                                           ":artists,"
-                                           ":albumArtist,"
-                                           ":album,"
-                                           ":discNumber,"
-                                           ":discTotal,"
-                                           ":date,"
-                                           ":composer,"
-                                           ":performer,"
-                                           ":genres,"
-                                           ":comment,"
-                                           ":cuePath,"
-                                           ":offset,"
-                                           ":duration,"
-                                           ":fileSize,"
-                                           ":bitRate,"
-                                           ":sampleRate,"
-                                           ":channels,"
-                                           ":bitDepth,"
-                                           ":codec,"
-                                           ":codecProfile,"
-                                           ":tool,"
-                                           ":tagTypes,"
-                                           ":encoding,"
-                                           ":extraTags,"
-                                           ":extraProperties,"
-                                           ":modifiedDate,"
-                                           ":trackHash,"
-                                           ":libraryID,"
-                                           ":rgTrackGain,"
-                                           ":rgAlbumGain,"
-                                           ":rgTrackPeak,"
-                                           ":rgAlbumPeak,"
-                                           ":createdDate"
-                                           ");"_s;
+    static const QString insertStatement = insertTrackStatement(false);
+    static const QString ignoreStatement = insertTrackStatement(true);
 
     const QString& statement = ignoreDuplicates ? ignoreStatement : insertStatement;
 
-    DbQuery query{db(), statement};
+    DbQuery query{connection(), statement};
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
-    }
+    bindTrackValues(query, track, Track::Fields{}.set());
 
     if(!query.exec()) {
         return false;
@@ -802,6 +824,7 @@ bool TrackDatabase::insertTrack(Track& track, bool ignoreDuplicates) const
     }
 
     track.setId(query.lastInsertId().toInt());
+    track.clearDirtyFields();
 
     return insertOrUpdateStats(track);
 }
@@ -823,7 +846,7 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
         static const QString statement = u"SELECT AddedDate, FirstPlayed, LastPlayed, PlayCount, Rating FROM "
                                          "TrackStats WHERE TrackHash = :trackHash;"_s;
 
-        DbQuery query{db(), statement};
+        DbQuery query{connection(), statement};
 
         query.bindValue(u":trackHash"_s, track.hash());
 
@@ -886,7 +909,7 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
           u"PlayCount, Rating) VALUES "
           "(:trackHash, :addedDate, :firstPlayed, :lastPlayed, :playCount, :rating);"_s;
 
-    DbQuery query{db(), statement};
+    DbQuery query{connection(), statement};
 
     query.bindValue(u":trackHash"_s, track.hash());
     query.bindValue(u":addedDate"_s, QVariant::fromValue(added));
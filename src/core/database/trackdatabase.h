@@ -54,11 +54,18 @@ public:
 
     void cleanupTracks();
 
+    [[nodiscard]] int trackCount() const;
+    [[nodiscard]] std::set<int> trackIds() const;
+    //! Counter bumped by triggers whenever track or stats data changes, or -1 on error.
+    [[nodiscard]] int64_t libraryGeneration() const;
+
     static void dropViews(const QSqlDatabase& db);
     static void insertViews(const QSqlDatabase& db);
+    static void dropTriggers(const QSqlDatabase& db);
+    static void insertTriggers(const QSqlDatabase& db);
 
 private:
-    [[nodiscard]] int trackCount() const;
+    bool updateTrack(const Track& track, const QString& statement, const Track::Fields& fields);
     bool insertTrack(Track& track, bool ignoreDuplicates = false) const;
     bool insertOrUpdateStats(const Track& track) const;
     void removeUnmanagedTracks() const;
@@ -23,11 +23,19 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <random>
 #include <utility>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define FY_CONVERTER_X86_SIMD
+#define FY_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
 namespace {
 using ChannelMap = std::array<int, Fooyin::AudioFormat::MaxChannels>;
 
@@ -329,6 +337,7 @@ constexpr int laneIndex(Fooyin::SampleFormat f) noexcept
             return 0;
         case SF::S16:
             return 1;
+        // S24In32 shares the S32 kernels
         case SF::S24In32:
         case SF::S32:
             return 2;
@@ -341,6 +350,568 @@ constexpr int laneIndex(Fooyin::SampleFormat f) noexcept
     }
 }
 
+constexpr int LaneCount = static_cast<int>(Lane::Count);
+
+// Kernels for interleaved buffers where every output sample maps to the input sample at the
+// same index (same channel count, identity channel map). The vector kernels must produce the
+// same bits as the scalar conversion functions above, including clamping and NaN handling.
+using KernelFn = void (*)(const std::byte*, std::byte*, size_t);
+
+template <typename In, typename Out, auto ConvFunc>
+void convertContiguous(const std::byte* input, std::byte* output, size_t samples)
+{
+    for(size_t i{0}; i < samples; ++i) {
+        In inSample;
+        std::memcpy(&inSample, input + (i * sizeof(In)), sizeof(In));
+        const Out outSample = ConvFunc(inSample);
+        std::memcpy(output + (i * sizeof(Out)), &outSample, sizeof(Out));
+    }
+}
+
+template <typename In, typename Out, auto ConvFunc>
+void convertTail(const std::byte* input, std::byte* output, size_t offset, size_t samples)
+{
+    convertContiguous<In, Out, ConvFunc>(input + (offset * sizeof(In)), output + (offset * sizeof(Out)),
+                                         samples - offset);
+}
+
+template <typename T>
+void copyContiguous(const std::byte* input, std::byte* output, size_t samples)
+{
+    std::memcpy(output, input, samples * sizeof(T));
+}
+
+// xorshift64* generator for TPDF dither noise; much cheaper per sample than mt19937
+class DitherNoise
+{
+public:
+    DitherNoise()
+        : m_state{(static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}() | 1}
+    { }
+
+    // Sum of two uniform values in [-0.5, 0.5)
+    template <typename T>
+    T next()
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        const uint64_t bits = m_state * 0x2545F4914F6CDD1DULL;
+
+        constexpr T unit = T{1} / static_cast<T>(1 << 24);
+        const auto u1    = static_cast<T>(bits >> 40) * unit;
+        const auto u2    = static_cast<T>((bits >> 16) & 0xFFFFFF) * unit;
+        return u1 + u2 - T{1};
+    }
+
+private:
+    uint64_t m_state;
+};
+
+// Adds TPDF dither in blocks, then quantises each block with the given S16 kernel
+template <typename T, KernelFn Quantise>
+void ditherToS16(const std::byte* input, std::byte* output, size_t samples)
+{
+    constexpr size_t BlockSize = 256;
+    constexpr T lsb            = T{1} / T{32768};
+
+    thread_local DitherNoise noise;
+    std::array<T, BlockSize> block;
+
+    for(size_t offset{0}; offset < samples; offset += BlockSize) {
+        const size_t count = std::min(BlockSize, samples - offset);
+
+        for(size_t i{0}; i < count; ++i) {
+            T sample;
+            std::memcpy(&sample, input + ((offset + i) * sizeof(T)), sizeof(T));
+            block[i] = sample + (noise.next<T>() * lsb);
+        }
+
+        Quantise(reinterpret_cast<const std::byte*>(block.data()), output + (offset * sizeof(int16_t)), count);
+    }
+}
+
+struct ContiguousKernels
+{
+    std::array<std::array<KernelFn, LaneCount>, LaneCount> convert{};
+    // Indexed by input lane
+    std::array<KernelFn, LaneCount> ditherToS16{};
+};
+
+constexpr ContiguousKernels scalarKernels()
+{
+    ContiguousKernels kernels;
+    // clang-format off
+    kernels.convert = {{
+        { copyContiguous<uint8_t>,
+          convertContiguous<uint8_t, int16_t, convertU8ToS16>,
+          convertContiguous<uint8_t, int32_t, convertU8ToS32>,
+          convertContiguous<uint8_t, float,   convertU8ToFloat>,
+          convertContiguous<uint8_t, double,  convertU8ToDouble> },
+        { convertContiguous<int16_t, uint8_t, convertS16ToU8>,
+          copyContiguous<int16_t>,
+          convertContiguous<int16_t, int32_t, convertS16ToS32>,
+          convertContiguous<int16_t, float,   convertS16ToFloat>,
+          convertContiguous<int16_t, double,  convertS16ToDouble> },
+        { convertContiguous<int32_t, uint8_t, convertS32ToU8>,
+          convertContiguous<int32_t, int16_t, convertS32ToS16>,
+          copyContiguous<int32_t>,
+          convertContiguous<int32_t, float,   convertS32ToFloat>,
+          convertContiguous<int32_t, double,  convertS32ToDouble> },
+        { convertContiguous<float, uint8_t,   convertFloatToU8>,
+          convertContiguous<float, int16_t,   convertFloatToS16>,
+          convertContiguous<float, int32_t,   convertFloatToS32>,
+          copyContiguous<float>,
+          convertContiguous<float, double,    convertFloatToDouble> },
+        { convertContiguous<double, uint8_t,  convertDoubleToU8>,
+          convertContiguous<double, int16_t,  convertDoubleToS16>,
+          convertContiguous<double, int32_t,  convertDoubleToS32>,
+          convertContiguous<double, float,    convertDoubleToFloat>,
+          copyContiguous<double> },
+    }};
+    // clang-format on
+
+    kernels.ditherToS16[3] = ditherToS16<float, convertContiguous<float, int16_t, convertFloatToS16>>;
+    kernels.ditherToS16[4] = ditherToS16<double, convertContiguous<double, int16_t, convertDoubleToS16>>;
+
+    return kernels;
+}
+
+#ifdef FY_CONVERTER_X86_SIMD
+// Clamp bounds matching convertToIntegral()
+constexpr float S16MinF  = static_cast<float>(std::numeric_limits<int16_t>::min()) / 32768.0F;
+constexpr float S16MaxF  = static_cast<float>(std::numeric_limits<int16_t>::max()) / 32768.0F;
+constexpr double S16MinD = static_cast<double>(std::numeric_limits<int16_t>::min()) / 32768.0;
+constexpr double S16MaxD = static_cast<double>(std::numeric_limits<int16_t>::max()) / 32768.0;
+constexpr double S32MinD = static_cast<double>(std::numeric_limits<int32_t>::min()) / 2147483648.0;
+constexpr double S32MaxD = static_cast<double>(std::numeric_limits<int32_t>::max()) / 2147483648.0;
+
+// min(hi, x) and max(lo, x) return x when it is NaN, so NaN converts to the integer minimum as llrint does
+__m128 clampPs(__m128 x, __m128 lo, __m128 hi)
+{
+    return _mm_max_ps(lo, _mm_min_ps(hi, x));
+}
+
+__m128d clampPd(__m128d x, __m128d lo, __m128d hi)
+{
+    return _mm_max_pd(lo, _mm_min_pd(hi, x));
+}
+
+void s16ToFloatSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128 scale = _mm_set1_ps(1.0F / static_cast<float>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int16_t))));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+
+        auto* out = reinterpret_cast<float*>(output + (i * sizeof(float)));
+        _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    convertTail<int16_t, float, convertS16ToFloat>(input, output, i, samples);
+}
+
+void s16ToDoubleSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128d scale = _mm_set1_pd(1.0 / static_cast<double>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int16_t))));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+
+        auto* out = reinterpret_cast<double*>(output + (i * sizeof(double)));
+        _mm_storeu_pd(out, _mm_mul_pd(_mm_cvtepi32_pd(lo), scale));
+        _mm_storeu_pd(out + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(lo, 0xEE)), scale));
+        _mm_storeu_pd(out + 4, _mm_mul_pd(_mm_cvtepi32_pd(hi), scale));
+        _mm_storeu_pd(out + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(hi, 0xEE)), scale));
+    }
+
+    convertTail<int16_t, double, convertS16ToDouble>(input, output, i, samples);
+}
+
+void s32ToFloatSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128 scale = _mm_set1_ps(1.0F / static_cast<float>(0x80000000));
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int32_t))));
+        _mm_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))), _mm_mul_ps(_mm_cvtepi32_ps(in), scale));
+    }
+
+    convertTail<int32_t, float, convertS32ToFloat>(input, output, i, samples);
+}
+
+void s32ToDoubleSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128d scale = _mm_set1_pd(1.0 / static_cast<double>(0x80000000));
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int32_t))));
+
+        auto* out = reinterpret_cast<double*>(output + (i * sizeof(double)));
+        _mm_storeu_pd(out, _mm_mul_pd(_mm_cvtepi32_pd(in), scale));
+        _mm_storeu_pd(out + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(in, 0xEE)), scale));
+    }
+
+    convertTail<int32_t, double, convertS32ToDouble>(input, output, i, samples);
+}
+
+void floatToDoubleSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128 in = _mm_loadu_ps(reinterpret_cast<const float*>(input + (i * sizeof(float))));
+
+        auto* out = reinterpret_cast<double*>(output + (i * sizeof(double)));
+        _mm_storeu_pd(out, _mm_cvtps_pd(in));
+        _mm_storeu_pd(out + 2, _mm_cvtps_pd(_mm_movehl_ps(in, in)));
+    }
+
+    convertTail<float, double, convertFloatToDouble>(input, output, i, samples);
+}
+
+void doubleToFloatSse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const auto* in  = reinterpret_cast<const double*>(input + (i * sizeof(double)));
+        const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(in));
+        const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(in + 2));
+        _mm_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))), _mm_movelh_ps(lo, hi));
+    }
+
+    convertTail<double, float, convertDoubleToFloat>(input, output, i, samples);
+}
+
+void floatToS16Sse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128 lo    = _mm_set1_ps(S16MinF);
+    const __m128 hi    = _mm_set1_ps(S16MaxF);
+    const __m128 scale = _mm_set1_ps(32768.0F);
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const auto* in  = reinterpret_cast<const float*>(input + (i * sizeof(float)));
+        const __m128i a = _mm_cvtps_epi32(_mm_mul_ps(clampPs(_mm_loadu_ps(in), lo, hi), scale));
+        const __m128i b = _mm_cvtps_epi32(_mm_mul_ps(clampPs(_mm_loadu_ps(in + 4), lo, hi), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int16_t))), _mm_packs_epi32(a, b));
+    }
+
+    convertTail<float, int16_t, convertFloatToS16>(input, output, i, samples);
+}
+
+void doubleToS16Sse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128d lo    = _mm_set1_pd(S16MinD);
+    const __m128d hi    = _mm_set1_pd(S16MaxD);
+    const __m128d scale = _mm_set1_pd(32768.0);
+
+    const auto quantise = [&](const double* in) {
+        return _mm_cvtpd_epi32(_mm_mul_pd(clampPd(_mm_loadu_pd(in), lo, hi), scale));
+    };
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const auto* in  = reinterpret_cast<const double*>(input + (i * sizeof(double)));
+        const __m128i a = _mm_unpacklo_epi64(quantise(in), quantise(in + 2));
+        const __m128i b = _mm_unpacklo_epi64(quantise(in + 4), quantise(in + 6));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int16_t))), _mm_packs_epi32(a, b));
+    }
+
+    convertTail<double, int16_t, convertDoubleToS16>(input, output, i, samples);
+}
+
+void floatToS32Sse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    // Widen to double first: 1.0F * 2^31 overflows the 32-bit float conversion
+    const __m128d lo    = _mm_set1_pd(S32MinD);
+    const __m128d hi    = _mm_set1_pd(S32MaxD);
+    const __m128d scale = _mm_set1_pd(2147483648.0);
+
+    const auto quantise = [&](__m128 in) {
+        return _mm_cvtpd_epi32(_mm_mul_pd(clampPd(_mm_cvtps_pd(in), lo, hi), scale));
+    };
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128 in = _mm_loadu_ps(reinterpret_cast<const float*>(input + (i * sizeof(float))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int32_t))),
+                         _mm_unpacklo_epi64(quantise(in), quantise(_mm_movehl_ps(in, in))));
+    }
+
+    convertTail<float, int32_t, convertFloatToS32>(input, output, i, samples);
+}
+
+void doubleToS32Sse2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m128d lo    = _mm_set1_pd(S32MinD);
+    const __m128d hi    = _mm_set1_pd(S32MaxD);
+    const __m128d scale = _mm_set1_pd(2147483648.0);
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const auto* in  = reinterpret_cast<const double*>(input + (i * sizeof(double)));
+        const __m128i a = _mm_cvtpd_epi32(_mm_mul_pd(clampPd(_mm_loadu_pd(in), lo, hi), scale));
+        const __m128i b = _mm_cvtpd_epi32(_mm_mul_pd(clampPd(_mm_loadu_pd(in + 2), lo, hi), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int32_t))), _mm_unpacklo_epi64(a, b));
+    }
+
+    convertTail<double, int32_t, convertDoubleToS32>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 __m256 clampPs256(__m256 x, __m256 lo, __m256 hi)
+{
+    return _mm256_max_ps(lo, _mm256_min_ps(hi, x));
+}
+
+FY_TARGET_AVX2 __m256d clampPd256(__m256d x, __m256d lo, __m256d hi)
+{
+    return _mm256_max_pd(lo, _mm256_min_pd(hi, x));
+}
+
+FY_TARGET_AVX2 void s16ToFloatAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256 scale = _mm256_set1_ps(1.0F / static_cast<float>(0x8000));
+
+    size_t i{0};
+    for(; i + 16 <= samples; i += 16) {
+        const auto* in   = reinterpret_cast<const __m128i*>(input + (i * sizeof(int16_t)));
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(in));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(in + 1));
+
+        auto* out = reinterpret_cast<float*>(output + (i * sizeof(float)));
+        _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+
+    convertTail<int16_t, float, convertS16ToFloat>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void s16ToDoubleAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256d scale = _mm256_set1_pd(1.0 / static_cast<double>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const __m256i in
+            = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int16_t)))));
+
+        auto* out = reinterpret_cast<double*>(output + (i * sizeof(double)));
+        _mm256_storeu_pd(out, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(in)), scale));
+        _mm256_storeu_pd(out + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(in, 1)), scale));
+    }
+
+    convertTail<int16_t, double, convertS16ToDouble>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void s32ToFloatAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256 scale = _mm256_set1_ps(1.0F / static_cast<float>(0x80000000));
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + (i * sizeof(int32_t))));
+        _mm256_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))),
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(in), scale));
+    }
+
+    convertTail<int32_t, float, convertS32ToFloat>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void s32ToDoubleAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256d scale = _mm256_set1_pd(1.0 / static_cast<double>(0x80000000));
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * sizeof(int32_t))));
+        _mm256_storeu_pd(reinterpret_cast<double*>(output + (i * sizeof(double))),
+                         _mm256_mul_pd(_mm256_cvtepi32_pd(in), scale));
+    }
+
+    convertTail<int32_t, double, convertS32ToDouble>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void floatToDoubleAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m128 in = _mm_loadu_ps(reinterpret_cast<const float*>(input + (i * sizeof(float))));
+        _mm256_storeu_pd(reinterpret_cast<double*>(output + (i * sizeof(double))), _mm256_cvtps_pd(in));
+    }
+
+    convertTail<float, double, convertFloatToDouble>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void doubleToFloatAvx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m256d in = _mm256_loadu_pd(reinterpret_cast<const double*>(input + (i * sizeof(double))));
+        _mm_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))), _mm256_cvtpd_ps(in));
+    }
+
+    convertTail<double, float, convertDoubleToFloat>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void floatToS16Avx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256 lo    = _mm256_set1_ps(S16MinF);
+    const __m256 hi    = _mm256_set1_ps(S16MaxF);
+    const __m256 scale = _mm256_set1_ps(32768.0F);
+
+    size_t i{0};
+    for(; i + 16 <= samples; i += 16) {
+        const auto* in  = reinterpret_cast<const float*>(input + (i * sizeof(float)));
+        const __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(clampPs256(_mm256_loadu_ps(in), lo, hi), scale));
+        const __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(clampPs256(_mm256_loadu_ps(in + 8), lo, hi), scale));
+        // packs works per 128-bit lane, so restore sample order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0b11'01'10'00);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * sizeof(int16_t))), packed);
+    }
+
+    convertTail<float, int16_t, convertFloatToS16>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void doubleToS16Avx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256d lo    = _mm256_set1_pd(S16MinD);
+    const __m256d hi    = _mm256_set1_pd(S16MaxD);
+    const __m256d scale = _mm256_set1_pd(32768.0);
+
+    size_t i{0};
+    for(; i + 8 <= samples; i += 8) {
+        const auto* in  = reinterpret_cast<const double*>(input + (i * sizeof(double)));
+        const __m128i a = _mm256_cvtpd_epi32(_mm256_mul_pd(clampPd256(_mm256_loadu_pd(in), lo, hi), scale));
+        const __m128i b = _mm256_cvtpd_epi32(_mm256_mul_pd(clampPd256(_mm256_loadu_pd(in + 4), lo, hi), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int16_t))), _mm_packs_epi32(a, b));
+    }
+
+    convertTail<double, int16_t, convertDoubleToS16>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void floatToS32Avx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256d lo    = _mm256_set1_pd(S32MinD);
+    const __m256d hi    = _mm256_set1_pd(S32MaxD);
+    const __m256d scale = _mm256_set1_pd(2147483648.0);
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m256d in = _mm256_cvtps_pd(_mm_loadu_ps(reinterpret_cast<const float*>(input + (i * sizeof(float)))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int32_t))),
+                         _mm256_cvtpd_epi32(_mm256_mul_pd(clampPd256(in, lo, hi), scale)));
+    }
+
+    convertTail<float, int32_t, convertFloatToS32>(input, output, i, samples);
+}
+
+FY_TARGET_AVX2 void doubleToS32Avx2(const std::byte* input, std::byte* output, size_t samples)
+{
+    const __m256d lo    = _mm256_set1_pd(S32MinD);
+    const __m256d hi    = _mm256_set1_pd(S32MaxD);
+    const __m256d scale = _mm256_set1_pd(2147483648.0);
+
+    size_t i{0};
+    for(; i + 4 <= samples; i += 4) {
+        const __m256d in = _mm256_loadu_pd(reinterpret_cast<const double*>(input + (i * sizeof(double))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * sizeof(int32_t))),
+                         _mm256_cvtpd_epi32(_mm256_mul_pd(clampPd256(in, lo, hi), scale)));
+    }
+
+    convertTail<double, int32_t, convertDoubleToS32>(input, output, i, samples);
+}
+
+template <KernelFn S16ToFloat, KernelFn S16ToDouble, KernelFn S32ToFloat, KernelFn S32ToDouble,
+          KernelFn FloatToDouble, KernelFn DoubleToFloat, KernelFn FloatToS16, KernelFn DoubleToS16,
+          KernelFn FloatToS32, KernelFn DoubleToS32>
+constexpr ContiguousKernels vectorKernels()
+{
+    ContiguousKernels kernels = scalarKernels();
+
+    kernels.convert[1][3] = S16ToFloat;
+    kernels.convert[1][4] = S16ToDouble;
+    kernels.convert[2][3] = S32ToFloat;
+    kernels.convert[2][4] = S32ToDouble;
+    kernels.convert[3][4] = FloatToDouble;
+    kernels.convert[4][3] = DoubleToFloat;
+    kernels.convert[3][1] = FloatToS16;
+    kernels.convert[4][1] = DoubleToS16;
+    kernels.convert[3][2] = FloatToS32;
+    kernels.convert[4][2] = DoubleToS32;
+
+    kernels.ditherToS16[3] = ditherToS16<float, FloatToS16>;
+    kernels.ditherToS16[4] = ditherToS16<double, DoubleToS16>;
+
+    return kernels;
+}
+#endif
+
+Fooyin::Audio::SimdLevel detectSimdLevel()
+{
+#ifdef FY_CONVERTER_X86_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return Fooyin::Audio::SimdLevel::AVX2;
+    }
+    return Fooyin::Audio::SimdLevel::SSE2;
+#else
+    return Fooyin::Audio::SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<Fooyin::Audio::SimdLevel>& activeSimdLevel()
+{
+    static std::atomic<Fooyin::Audio::SimdLevel> level{Fooyin::Audio::supportedSimdLevel()};
+    return level;
+}
+
+const ContiguousKernels& contiguousKernels()
+{
+    static constexpr ContiguousKernels scalar = scalarKernels();
+#ifdef FY_CONVERTER_X86_SIMD
+    static constexpr ContiguousKernels sse2
+        = vectorKernels<s16ToFloatSse2, s16ToDoubleSse2, s32ToFloatSse2, s32ToDoubleSse2, floatToDoubleSse2,
+                        doubleToFloatSse2, floatToS16Sse2, doubleToS16Sse2, floatToS32Sse2, doubleToS32Sse2>();
+    static constexpr ContiguousKernels avx2
+        = vectorKernels<s16ToFloatAvx2, s16ToDoubleAvx2, s32ToFloatAvx2, s32ToDoubleAvx2, floatToDoubleAvx2,
+                        doubleToFloatAvx2, floatToS16Avx2, doubleToS16Avx2, floatToS32Avx2, doubleToS32Avx2>();
+
+    switch(activeSimdLevel().load(std::memory_order_relaxed)) {
+        case Fooyin::Audio::SimdLevel::AVX2:
+            return avx2;
+        case Fooyin::Audio::SimdLevel::SSE2:
+            return sse2;
+        case Fooyin::Audio::SimdLevel::Scalar:
+            break;
+    }
+#endif
+    return scalar;
+}
+
+bool isIdentityMap(const ChannelMap& channels, int inChannels, int outChannels)
+{
+    if(inChannels != outChannels) {
+        return false;
+    }
+
+    for(int ch{0}; ch < outChannels; ++ch) {
+        if(channels[ch] != ch) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool convertFormat(const Fooyin::AudioFormat& inFormat, const std::byte* input, const Fooyin::AudioFormat& outFormat,
                    std::byte* output, int frames, bool dither)
 {
@@ -352,7 +923,21 @@ bool convertFormat(const Fooyin::AudioFormat& inFormat, const std::byte* input,
         return false;
     }
 
-    static constexpr int N = static_cast<int>(Lane::Count);
+    if(frames <= 0) {
+        return true;
+    }
+
+    if(isIdentityMap(channels, inFormat.channelCount(), outFormat.channelCount())) {
+        const ContiguousKernels& kernels = contiguousKernels();
+
+        const KernelFn kernel = dither && kernels.ditherToS16[i] && o == laneIndex(Fooyin::SampleFormat::S16)
+                                  ? kernels.ditherToS16[i]
+                                  : kernels.convert[i][o];
+        kernel(input, output, static_cast<size_t>(frames) * static_cast<size_t>(outFormat.channelCount()));
+        return true;
+    }
+
+    static constexpr int N = LaneCount;
     // clang-format off
     static constexpr std::array<std::array<DispatchFn, N>, N> convertTable = {{
         // in: U8
@@ -421,4 +1006,20 @@ bool convert(const AudioFormat& inputFormat, const std::byte* input, const Audio
 
     return convertFormat(inputFormat, input, outputFormat, output, frames, dither);
 }
+
+SimdLevel supportedSimdLevel()
+{
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel simdLevel()
+{
+    return activeSimdLevel().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    activeSimdLevel().store(std::min(level, supportedSimdLevel()), std::memory_order_relaxed);
+}
 } // namespace Fooyin::Audio
@@ -332,6 +332,7 @@ AudioEngine::AudioEngine(std::shared_ptr<AudioLoader> audioLoader, SettingsManag
     , m_autoCrossfadeTailFadeGeneration{0}
     , m_autoBoundaryFadeActive{false}
     , m_autoBoundaryFadeGeneration{0}
+    , m_bufferUnderrun{false}
 {
     setupSettings();
 
@@ -2177,6 +2178,10 @@ void AudioEngine::updatePosition()
 
     const auto output = m_positionCoordinator.evaluate(input);
 
+    if(std::exchange(m_bufferUnderrun, pipelineStatus.bufferUnderrun) != pipelineStatus.bufferUnderrun) {
+        Q_EMIT bufferUnderrunChanged(m_bufferUnderrun);
+    }
+
     if(output.shouldEnsureDecodeTimer) {
         m_decoder.ensureDecodeTimerRunning();
     }
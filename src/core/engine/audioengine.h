@@ -200,6 +200,7 @@ Q_SIGNALS:
     void finished();
 
     void deviceError(const QString& error);
+    void bufferUnderrunChanged(bool underrun);
     void trackChanged(const Fooyin::Track& track);
     void trackCommitted(const Fooyin::Engine::TrackCommitContext& context);
 
@@ -441,6 +442,7 @@ private:
     uint64_t m_autoCrossfadeTailFadeGeneration;
     bool m_autoBoundaryFadeActive;
     uint64_t m_autoBoundaryFadeGeneration;
+    bool m_bufferUnderrun;
 
     Track m_upcomingTrackCandidate;
     uint64_t m_upcomingTrackCandidateItemId{0};
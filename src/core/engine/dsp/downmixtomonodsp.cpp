@@ -114,7 +114,8 @@ void DownmixToMonoDsp::process(ProcessingBufferList& chunks)
         return;
     }
 
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_output;
+    output.clear();
 
     for(size_t i{0}; i < count; ++i) {
         const auto* buffer = chunks.item(i);
@@ -199,14 +200,7 @@ void DownmixToMonoDsp::process(ProcessingBufferList& chunks)
         }
     }
 
-    chunks.clear();
-
-    const size_t outCount = output.count();
-    for(size_t i{0}; i < outCount; ++i) {
-        const auto* buffer = output.item(i);
-        if(buffer && buffer->isValid()) {
-            chunks.addChunk(*buffer);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 } // namespace Fooyin
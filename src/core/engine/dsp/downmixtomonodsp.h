@@ -22,7 +22,7 @@
 #include <core/engine/dsp/dspnode.h>
 
 namespace Fooyin {
-class DownmixToMonoDsp : public DspNode
+class FYCORE_EXPORT DownmixToMonoDsp : public DspNode
 {
 public:
     QString name() const override;
@@ -34,5 +34,6 @@ public:
 
 private:
     AudioFormat m_format;
+    ProcessingBufferList m_output;
 };
 } // namespace Fooyin
@@ -116,7 +116,8 @@ void DownmixToStereoDsp::process(ProcessingBufferList& chunks)
         return;
     }
 
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_output;
+    output.clear();
 
     for(size_t i{0}; i < count; ++i) {
         const auto* buffer = chunks.item(i);
@@ -208,15 +209,7 @@ void DownmixToStereoDsp::process(ProcessingBufferList& chunks)
         }
     }
 
-    chunks.clear();
-
-    const size_t outCount = output.count();
-    for(size_t i{0}; i < outCount; ++i) {
-        const auto* buffer = output.item(i);
-
-        if(buffer && buffer->isValid()) {
-            chunks.addChunk(*buffer);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 } // namespace Fooyin
@@ -34,5 +34,6 @@ public:
 
 private:
     AudioFormat m_format;
+    ProcessingBufferList m_output;
 };
 } // namespace Fooyin
@@ -23,7 +23,7 @@
 #include <core/engine/dsp/processingbuffer.h>
 
 namespace Fooyin {
-class MonoToStereoDsp : public DspNode
+class FYCORE_EXPORT MonoToStereoDsp : public DspNode
 {
 public:
     [[nodiscard]] QString name() const override;
@@ -35,5 +35,6 @@ public:
 
 private:
     AudioFormat m_format;
+    ProcessingBufferList m_output;
 };
 } // namespace Fooyin
@@ -74,6 +74,14 @@ void ProcessingBuffer::reset()
     m_sourceFrameDurationNs = 0;
 }
 
+void ProcessingBuffer::reset(const AudioFormat& format, uint64_t startTimeNs)
+{
+    m_samples.clear();
+    m_format                = normaliseProcessingFormat(format);
+    m_startTimeNs           = startTimeNs;
+    m_sourceFrameDurationNs = 0;
+}
+
 AudioFormat ProcessingBuffer::format() const
 {
     return m_format;
@@ -19,15 +19,18 @@
 
 #include <core/engine/dsp/processingbufferlist.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace Fooyin {
 size_t ProcessingBufferList::count() const
 {
-    return m_chunks.size();
+    return m_count;
 }
 
 ProcessingBuffer* ProcessingBufferList::item(size_t index)
 {
-    if(index >= m_chunks.size()) {
+    if(index >= m_count) {
         return nullptr;
     }
 
@@ -36,74 +39,124 @@ ProcessingBuffer* ProcessingBufferList::item(size_t index)
 
 const ProcessingBuffer* ProcessingBufferList::item(size_t index) const
 {
-    if(index >= m_chunks.size()) {
+    if(index >= m_count) {
         return nullptr;
     }
 
     return &m_chunks[index];
 }
 
-void ProcessingBufferList::reserve(size_t count)
+void ProcessingBufferList::reserve(size_t count, size_t samplesPerChunk)
 {
-    m_chunks.reserve(count);
+    if(m_chunks.size() < count) {
+        m_chunks.resize(count);
+    }
+
+    if(samplesPerChunk > 0) {
+        for(auto& chunk : m_chunks) {
+            chunk.reserveSamples(samplesPerChunk);
+        }
+    }
 }
 
 void ProcessingBufferList::clear()
 {
-    m_chunks.clear();
+    m_count = 0;
 }
 
 void ProcessingBufferList::removeByIdx(size_t index)
 {
-    if(index >= m_chunks.size()) {
+    if(index >= m_count) {
         return;
     }
 
-    m_chunks.erase(m_chunks.begin() + static_cast<ptrdiff_t>(index));
+    // Rotate the removed slot into the spare area so its storage can be reused
+    const auto first = m_chunks.begin() + static_cast<ptrdiff_t>(index);
+    std::rotate(first, first + 1, m_chunks.begin() + static_cast<ptrdiff_t>(m_count));
+    --m_count;
+}
+
+void ProcessingBufferList::removeInvalid()
+{
+    size_t kept{0};
+    for(size_t i{0}; i < m_count; ++i) {
+        if(m_chunks[i].isValid()) {
+            if(kept != i) {
+                std::swap(m_chunks[kept], m_chunks[i]);
+            }
+            ++kept;
+        }
+    }
+    m_count = kept;
+}
+
+void ProcessingBufferList::swap(ProcessingBufferList& other) noexcept
+{
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_count, other.m_count);
 }
 
 ProcessingBuffer* ProcessingBufferList::insertItem(size_t index, const AudioFormat& format, uint64_t startTimeNs,
                                                    size_t sampleCount)
 {
-    ProcessingBuffer buffer{format, startTimeNs};
+    ProcessingBuffer* buffer = acquireSlot(index);
+    buffer->reset(format, startTimeNs);
 
     if(sampleCount > 0) {
-        buffer.resizeSamples(sampleCount);
+        buffer->resizeSamples(sampleCount);
     }
 
-    if(index >= m_chunks.size()) {
-        m_chunks.push_back(std::move(buffer));
-        return &m_chunks.back();
-    }
-
-    m_chunks.insert(m_chunks.begin() + static_cast<ptrdiff_t>(index), std::move(buffer));
-
-    return &m_chunks[index];
+    return buffer;
 }
 
 ProcessingBuffer* ProcessingBufferList::addItem(const AudioFormat& format, uint64_t startTimeNs, size_t sampleCount)
 {
-    return insertItem(m_chunks.size(), format, startTimeNs, sampleCount);
+    return insertItem(m_count, format, startTimeNs, sampleCount);
 }
 
 void ProcessingBufferList::addChunk(const ProcessingBuffer& buffer)
 {
-    m_chunks.push_back(buffer);
+    if(m_count == m_chunks.size()) {
+        // No spare slot; push_back copes with buffer aliasing one of our own chunks
+        m_chunks.push_back(buffer);
+        ++m_count;
+        return;
+    }
+
+    // Copy-assignment reuses the slot's sample capacity
+    m_chunks[m_count++] = buffer;
 }
 
 void ProcessingBufferList::addChunk(ProcessingBuffer&& buffer)
 {
-    m_chunks.push_back(std::move(buffer));
+    // Hand the spare slot's storage back to the caller rather than freeing it, emptied as a move would leave it
+    using std::swap;
+    swap(*acquireSlot(m_count), buffer);
+    buffer.reset();
 }
 
 void ProcessingBufferList::setToSingle(const ProcessingBuffer& buffer)
 {
-    if(m_chunks.empty()) {
-        m_chunks.push_back(buffer);
-        return;
+    m_count = 0;
+    addChunk(buffer);
+}
+
+ProcessingBuffer* ProcessingBufferList::acquireSlot(size_t index)
+{
+    if(m_count == m_chunks.size()) {
+        m_chunks.emplace_back();
     }
 
-    m_chunks.resize(1);
-    m_chunks[0] = buffer;
+    index = std::min(index, m_count);
+    ++m_count;
+
+    if(index + 1 < m_count) {
+        // Move the spare slot at the end of the live range into position
+        const auto first = m_chunks.begin() + static_cast<ptrdiff_t>(index);
+        std::rotate(first, m_chunks.begin() + static_cast<ptrdiff_t>(m_count - 1),
+                    m_chunks.begin() + static_cast<ptrdiff_t>(m_count));
+    }
+
+    return &m_chunks[index];
 }
 } // namespace Fooyin
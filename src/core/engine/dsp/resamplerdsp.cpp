@@ -341,7 +341,8 @@ void ResamplerDsp::process(ProcessingBufferList& chunks)
         return;
     }
 
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_output;
+    output.clear();
 
     const size_t count = chunks.count();
     for(size_t i = 0; i < count; ++i) {
@@ -353,14 +354,8 @@ void ResamplerDsp::process(ProcessingBufferList& chunks)
         processBuffer(*buffer, output);
     }
 
-    chunks.clear();
-    const size_t outCount = output.count();
-    for(size_t i = 0; i < outCount; ++i) {
-        const auto* buffer = output.item(i);
-        if(buffer && buffer->isValid()) {
-            chunks.addChunk(*buffer);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 
 void ResamplerDsp::reset()
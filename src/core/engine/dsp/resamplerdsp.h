@@ -86,5 +86,7 @@ private:
     ResamplerSettings::SampleRateFilterMode m_sampleRateFilterMode;
     std::set<int> m_filteredRates;
     QString m_filteredRatesText;
+
+    ProcessingBufferList m_output;
 };
 } // namespace Fooyin
@@ -110,7 +110,8 @@ void SkipSilenceDsp::process(ProcessingBufferList& chunks)
         return;
     }
 
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_output;
+    output.clear();
     for(size_t i = 0; i < count; ++i) {
         const auto* buffer = chunks.item(i);
         if(buffer && buffer->isValid()) {
@@ -118,13 +119,8 @@ void SkipSilenceDsp::process(ProcessingBufferList& chunks)
         }
     }
 
-    chunks.clear();
-    for(size_t i{0}; i < output.count(); ++i) {
-        const auto* b = output.item(i);
-        if(b && b->isValid()) {
-            chunks.addChunk(*b);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 
 void SkipSilenceDsp::reset()
@@ -94,5 +94,7 @@ private:
 
     PendingSilence m_pendingSilence;
     bool m_haveSeenNonSilence;
+
+    ProcessingBufferList m_output;
 };
 } // namespace Fooyin
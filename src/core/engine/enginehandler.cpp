@@ -112,6 +112,7 @@ EngineHandler::EngineHandler(std::shared_ptr<AudioLoader> audioLoader, PlayerCon
     QObject::connect(m_engine, &AudioEngine::bitrateChanged, m_playerController, &PlayerController::setBitrate);
     QObject::connect(m_engine, &AudioEngine::stateChanged, this, &EngineHandler::handleStateChange);
     QObject::connect(m_engine, &AudioEngine::deviceError, this, &EngineController::engineError);
+    QObject::connect(m_engine, &AudioEngine::bufferUnderrunChanged, this, &EngineController::bufferUnderrunChanged);
     QObject::connect(m_engine, &AudioEngine::trackChanged, this, &EngineController::trackChanged);
     QObject::connect(m_engine, &AudioEngine::trackCommitted, this, &EngineHandler::handleTrackCommitted);
     QObject::connect(m_engine, &AudioEngine::trackStatusContextChanged, this, &EngineHandler::handleTrackStatus);
@@ -24,6 +24,7 @@
 #include "dsp/dspregistry.h"
 #include "enginehelpers.h"
 
+#include <utils/allocationcounter.h>
 #include <utils/timeconstants.h>
 
 #include <QDebug>
@@ -180,6 +181,10 @@ AudioPipeline::AudioPipeline()
     , m_playbackState{PipelinePlaybackState::Stopped}
     , m_playing{false}
     , m_pauseDrainActive{false}
+    , m_renderCycles{0}
+    , m_lastCycleAllocations{0}
+    , m_maxCycleAllocations{0}
+    , m_totalAllocations{0}
     , m_renderPhase{RenderPhase::Stopped}
     , m_outputBitdepth{SampleFormat::Unknown}
     , m_ditherEnabled{false}
@@ -1272,6 +1277,37 @@ PipelineStatus AudioPipeline::currentStatus() const
     return status;
 }
 
+AudioPipeline::RenderAllocationStats AudioPipeline::renderAllocationStats() const
+{
+    RenderAllocationStats stats;
+
+    stats.renderCycles         = m_renderCycles.load(std::memory_order_relaxed);
+    stats.lastCycleAllocations = m_lastCycleAllocations.load(std::memory_order_relaxed);
+    stats.maxCycleAllocations  = m_maxCycleAllocations.load(std::memory_order_relaxed);
+    stats.totalAllocations     = m_totalAllocations.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void AudioPipeline::resetRenderAllocationStats()
+{
+    m_renderCycles.store(0, std::memory_order_relaxed);
+    m_lastCycleAllocations.store(0, std::memory_order_relaxed);
+    m_maxCycleAllocations.store(0, std::memory_order_relaxed);
+    m_totalAllocations.store(0, std::memory_order_relaxed);
+}
+
+void AudioPipeline::recordRenderAllocations(uint64_t allocations)
+{
+    m_renderCycles.fetch_add(1, std::memory_order_relaxed);
+    m_lastCycleAllocations.store(allocations, std::memory_order_relaxed);
+    m_totalAllocations.fetch_add(allocations, std::memory_order_relaxed);
+
+    if(allocations > m_maxCycleAllocations.load(std::memory_order_relaxed)) {
+        m_maxCycleAllocations.store(allocations, std::memory_order_relaxed);
+    }
+}
+
 AudioPipeline::OutputQueueSnapshot AudioPipeline::outputQueueSnapshot() const
 {
     return onAudioThread([](const AudioPipeline& pipeline) {
@@ -1494,6 +1530,8 @@ void AudioPipeline::processAudio()
     bool sawMixerUnderrun{false};
     bool sawMixerReadStarved{false};
     bool sawMasterChainStarved{false};
+    int renderPulls{0};
+    uint64_t cycleRenderAllocations{0};
 
     for(int pull{0}; pull < maxTopUpPulls; ++pull) {
         const int queuedFrames = pendingOutputFrames();
@@ -1522,9 +1560,12 @@ void AudioPipeline::processAudio()
             break;
         }
 
+        const uint64_t allocationsBefore = AllocationCounter::threadAllocations();
         const auto pullResult
             = m_renderer.render(framesToProcess, m_outputFader, m_outputUnit.outputSupportsVolume(), m_masterVolume,
                                 m_analysisBus.load(std::memory_order_acquire), m_timelineUnit.playbackDelayMs());
+        cycleRenderAllocations += AllocationCounter::threadAllocations() - allocationsBefore;
+        ++renderPulls;
         const int framesRead = pullResult.framesRead;
 
         if(framesRead <= 0) {
@@ -1571,6 +1612,10 @@ void AudioPipeline::processAudio()
         }
     }
 
+    if(renderPulls > 0) {
+        recordRenderAllocations(cycleRenderAllocations);
+    }
+
     if(!hasPendingOutput()) {
         if(sawMixerUnderrun) {
             const bool seekPrerollActive = std::chrono::steady_clock::now() < m_seekPrerollGraceUntil;
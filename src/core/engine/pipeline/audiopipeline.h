@@ -151,6 +151,16 @@ public:
         bool valid{false};
     };
 
+    //! Heap allocations made by the render stage (mixer + DSP + fader), as seen by `AllocationCounter`.
+    struct RenderAllocationStats
+    {
+        //! Audio cycles which rendered at least one pull since the last reset.
+        uint64_t renderCycles{0};
+        uint64_t lastCycleAllocations{0};
+        uint64_t maxCycleAllocations{0};
+        uint64_t totalAllocations{0};
+    };
+
     AudioPipeline();
     ~AudioPipeline() override;
 
@@ -294,6 +304,9 @@ public:
 
     [[nodiscard]] PipelineStatus currentStatus() const;
     [[nodiscard]] OutputQueueSnapshot outputQueueSnapshot() const;
+    //! Per-cycle render allocation counts; only non-zero when allocations are being recorded.
+    [[nodiscard]] RenderAllocationStats renderAllocationStats() const;
+    void resetRenderAllocationStats();
 
     //! Reported pipeline playback delay in milliseconds (output + DSP latency).
     [[nodiscard]] uint64_t playbackDelayMs() const;
@@ -389,6 +402,7 @@ private:
     void syncAudibleOutputStreamId();
 
     void resetCycleRenderedPosition();
+    void recordRenderAllocations(uint64_t allocations);
     //! Queue processed master chunks into pending output FIFO.
     int queueProcessedOutput();
     //! Write a short hold-frame burst directly to output to conceal underrun pops.
@@ -653,6 +667,11 @@ private:
     std::atomic<bool> m_playing;
     std::atomic<bool> m_pauseDrainActive;
 
+    std::atomic<uint64_t> m_renderCycles;
+    std::atomic<uint64_t> m_lastCycleAllocations;
+    std::atomic<uint64_t> m_maxCycleAllocations;
+    std::atomic<uint64_t> m_totalAllocations;
+
     RenderPhase m_renderPhase;
 
     SampleFormat m_outputBitdepth;
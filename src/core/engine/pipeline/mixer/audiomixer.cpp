@@ -437,7 +437,6 @@ void AudioMixer::clear()
     std::vector<TimelineSegment>{}.swap(m_scratch.outputTimeline);
     std::vector<TimedAudioFifo::TimelineChunk>{}.swap(m_scratch.perTrackTimeline);
     std::vector<TimelineSegment>{}.swap(m_scratch.consumedTimeline);
-    m_scratch.perTrackBuffer = {};
     m_scratch.perTrackChunks = {};
 }
 
@@ -686,11 +685,22 @@ int AudioMixer::read(ProcessingBuffer& output, int frames)
 
 AudioMixer::ReadResult AudioMixer::readWithStatus(ProcessingBuffer& output, int frames)
 {
-    ReadResult result{};
+    ReadResult result;
+    readWithStatus(output, frames, result);
+    return result;
+}
+
+void AudioMixer::readWithStatus(ProcessingBuffer& output, int frames, ReadResult& result)
+{
+    result.producedFrames  = 0;
+    result.sourceFrames    = 0;
+    result.buffering       = false;
+    result.primaryStreamId = InvalidStreamId;
+    result.primaryTimeline.clear();
     m_scratch.consumedTimeline.clear();
 
     if(frames <= 0 || !output.isValid() || output.format().sampleFormat() != SampleFormat::F64) {
-        return result;
+        return;
     }
 
     const AudioFormat outFormat = m_outputFormat.isValid() ? m_outputFormat : m_format;
@@ -698,7 +708,7 @@ AudioMixer::ReadResult AudioMixer::readWithStatus(ProcessingBuffer& output, int
     const int outRate           = outFormat.sampleRate();
 
     if(outChannels <= 0 || outRate <= 0) {
-        return result;
+        return;
     }
 
     ReadPlan plan;
@@ -717,11 +727,11 @@ AudioMixer::ReadResult AudioMixer::readWithStatus(ProcessingBuffer& output, int
                 break;
             }
         }
-        return result;
+        return;
     }
 
     if(m_channels.empty()) {
-        return result;
+        return;
     }
 
     const int leftoverFrames = m_output->queuedFrames();
@@ -731,7 +741,7 @@ AudioMixer::ReadResult AudioMixer::readWithStatus(ProcessingBuffer& output, int
 
     plan.processFrames = std::max(1, framesNeeded);
     if(plan.processFrames <= 0) {
-        return result;
+        return;
     }
 
     const size_t maxInputSamples = calculateMaxInputSamples(outRate, plan.processFrames);
@@ -754,7 +764,6 @@ AudioMixer::ReadResult AudioMixer::readWithStatus(ProcessingBuffer& output, int
             break;
         }
     }
-    return result;
 }
 
 bool AudioMixer::isMixingState(AudioStream::State state)
@@ -1348,10 +1357,11 @@ AudioMixer::PerTrackResult AudioMixer::processPerTrackDsps(MixerChannel& channel
     AudioFormat dspFormat = stream->format();
     dspFormat.setSampleFormat(SampleFormat::F64);
 
-    const auto inSamples     = static_cast<size_t>(inputFrames) * inChannels;
-    m_scratch.perTrackBuffer = ProcessingBuffer({inputData, inSamples}, dspFormat, inputSourceStartNs);
-    m_scratch.perTrackBuffer.setSourceFrameDurationNs(frameDurationNs(stream->sampleRate()));
-    m_scratch.perTrackChunks.setToSingle(m_scratch.perTrackBuffer);
+    const auto inSamples = static_cast<size_t>(inputFrames) * inChannels;
+    m_scratch.perTrackChunks.clear();
+    auto* inputChunk = m_scratch.perTrackChunks.addItem(dspFormat, inputSourceStartNs, inSamples);
+    std::copy_n(inputData, inSamples, inputChunk->data().data());
+    inputChunk->setSourceFrameDurationNs(frameDurationNs(stream->sampleRate()));
 
     for(auto& node : channel.perTrackDsps) {
         if(node && node->isEnabled()) {
@@ -197,6 +197,8 @@ public:
     int read(ProcessingBuffer& output, int frames);
     //! Same as `read()` plus cycle metadata used by pipeline timeline logic.
     [[nodiscard]] ReadResult readWithStatus(ProcessingBuffer& output, int frames);
+    //! Same as above, filling @p result in place so its timeline storage is reused across cycles.
+    void readWithStatus(ProcessingBuffer& output, int frames, ReadResult& result);
 
     /*!
      * True when decode side should be nudged to provide more data.
@@ -381,7 +383,6 @@ private:
         std::vector<TimelineSegment> outputTimeline;
         std::vector<TimedAudioFifo::TimelineChunk> perTrackTimeline;
         std::vector<TimelineSegment> consumedTimeline; // reused by consumeTimeline() callers
-        ProcessingBuffer perTrackBuffer;
         ProcessingBufferList perTrackChunks;
     };
 
@@ -137,6 +137,7 @@ AudioFormat PipelineRenderer::configureForInputFormat(const AudioFormat& inputFo
     mixFormat.setSampleFormat(SampleFormat::F64);
 
     m_processBuffer = ProcessingBuffer{mixFormat, 0};
+    reserveProcessStorage(mixFormat, minProcessChunkFrames);
     configureAnalysisScratch(mixFormat, minProcessChunkFrames);
 
     return m_outputFormat;
@@ -195,7 +196,8 @@ PipelineRenderer::RenderResult PipelineRenderer::render(int framesToProcess, Out
     const auto samplesToProcess = static_cast<size_t>(framesToProcess) * static_cast<size_t>(channels);
     m_processBuffer.resizeSamples(samplesToProcess);
 
-    const auto mixerRead   = m_mixer.readWithStatus(m_processBuffer, framesToProcess);
+    m_mixer.readWithStatus(m_processBuffer, framesToProcess, m_mixerRead);
+    const auto& mixerRead  = m_mixerRead;
     result.framesRead      = mixerRead.producedFrames;
     result.mixerBuffering  = mixerRead.buffering;
     result.primaryStreamId = mixerRead.primaryStreamId;
@@ -238,6 +240,18 @@ void PipelineRenderer::clearProcessingState()
     m_analysisScratch.clear();
 }
 
+void PipelineRenderer::reserveProcessStorage(const AudioFormat& mixFormat, size_t minProcessChunkFrames)
+{
+    if(mixFormat.channelCount() <= 0) {
+        return;
+    }
+
+    // Size the mix buffer and chunk slots up front so the render loop only refills them
+    const size_t reserveSamples = static_cast<size_t>(mixFormat.channelCount()) * minProcessChunkFrames;
+    m_processBuffer.reserveSamples(reserveSamples);
+    m_processChunks.reserve(PreallocatedProcessChunks, reserveSamples);
+}
+
 void PipelineRenderer::configureAnalysisScratch(const AudioFormat& mixFormat, size_t minProcessChunkFrames)
 {
     m_analysisScratch.clear();
@@ -508,6 +522,7 @@ void PipelineRenderer::reconfigureForChainChange(const AudioFormat& effectiveInp
     m_processBuffer = ProcessingBuffer{mixFormat, 0};
     m_processChunks.clear();
 
+    reserveProcessStorage(mixFormat, minProcessChunkFrames);
     configureAnalysisScratch(mixFormat, minProcessChunkFrames);
 }
 
@@ -642,14 +657,10 @@ void PipelineRenderer::rebuildProcessChunksFromMixerRead(const AudioMixer::ReadR
             return false;
         }
 
-        ProcessingBuffer chunk{
-            sourceSamples.subspan(sampleOffset, sampleCount),
-            format,
-            startNs,
-        };
-
-        chunk.setSourceFrameDurationNs(sourceFrameDurationNs);
-        m_processChunks.addChunk(std::move(chunk));
+        // Fill a recycled slot rather than constructing a new buffer each cycle
+        auto* chunk = m_processChunks.addItem(format, startNs, sampleCount);
+        std::copy_n(sourceSamples.data() + sampleOffset, sampleCount, chunk->data().data());
+        chunk->setSourceFrameDurationNs(sourceFrameDurationNs);
 
         return true;
     };
@@ -139,6 +139,10 @@ public:
                                                                      StreamId streamId, uint64_t epoch) const;
 
 private:
+    //! Chunk slots kept ready in m_processChunks; covers a mixer read spanning a few track boundaries.
+    static constexpr size_t PreallocatedProcessChunks = 4;
+
+    void reserveProcessStorage(const AudioFormat& mixFormat, size_t minProcessChunkFrames);
     void configureAnalysisScratch(const AudioFormat& mixFormat, size_t minProcessChunkFrames);
     void setWorkingFormats(const AudioFormat& input, const AudioFormat& output);
     void clearFormats();
@@ -149,6 +153,7 @@ private:
 
     std::unordered_map<uint64_t, uint64_t> m_liveSettingsRevisionByKey;
 
+    AudioMixer::ReadResult m_mixerRead;
     ProcessingBufferList m_processChunks;
     std::vector<float> m_analysisScratch;
     ProcessingBuffer m_processBuffer;
@@ -0,0 +1,210 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/trackanalysis.h>
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioloader.h>
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <mutex>
+
+Q_LOGGING_CATEGORY(TRACK_ANALYSIS, "fy.analysis")
+
+constexpr size_t ReadSize = 64 * 1024;
+
+namespace Fooyin {
+class TrackAnalysisPipelinePrivate
+{
+public:
+    explicit TrackAnalysisPipelinePrivate(std::shared_ptr<AudioLoader> audioLoader)
+        : m_audioLoader{std::move(audioLoader)}
+    { }
+
+    std::shared_ptr<AudioLoader> m_audioLoader;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<QString, TrackAnalyserFactory>> m_analysers;
+};
+
+TrackAnalysisPipeline::TrackAnalysisPipeline(std::shared_ptr<AudioLoader> audioLoader)
+    : p{std::make_unique<TrackAnalysisPipelinePrivate>(std::move(audioLoader))}
+{ }
+
+TrackAnalysisPipeline::~TrackAnalysisPipeline() = default;
+
+void TrackAnalysisPipeline::registerAnalyser(const QString& id, TrackAnalyserFactory factory)
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    if(auto it = std::ranges::find(p->m_analysers, id, &std::pair<QString, TrackAnalyserFactory>::first);
+       it != p->m_analysers.end()) {
+        it->second = std::move(factory);
+        return;
+    }
+
+    p->m_analysers.emplace_back(id, std::move(factory));
+}
+
+void TrackAnalysisPipeline::unregisterAnalyser(const QString& id)
+{
+    const std::scoped_lock lock{p->m_mutex};
+    std::erase_if(p->m_analysers, [&id](const auto& analyser) { return analyser.first == id; });
+}
+
+QStringList TrackAnalysisPipeline::registeredAnalysers() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    QStringList ids;
+    for(const auto& [id, _] : p->m_analysers) {
+        ids.append(id);
+    }
+    return ids;
+}
+
+std::vector<TrackAnalyserPtr> TrackAnalysisPipeline::createRegisteredAnalysers() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    std::vector<TrackAnalyserPtr> analysers;
+    for(const auto& [_, factory] : p->m_analysers) {
+        if(auto analyser = factory()) {
+            analysers.push_back(std::move(analyser));
+        }
+    }
+    return analysers;
+}
+
+bool TrackAnalysisPipeline::analyse(Track& track, const std::vector<TrackAnalyser*>& analysers,
+                                    const std::function<bool()>& mayContinue) const
+{
+    if(analysers.empty()) {
+        return true;
+    }
+
+    const auto loadedDecoder
+        = p->m_audioLoader->loadDecoderForTrack(track, AudioDecoder::NoSeeking | AudioDecoder::NoInfiniteLooping);
+    if(!loadedDecoder.decoder || !loadedDecoder.format) {
+        qCWarning(TRACK_ANALYSIS) << "No decoder available for" << track.filepath();
+        return false;
+    }
+
+    AudioDecoder* decoder     = loadedDecoder.decoder.get();
+    const AudioFormat& format = loadedDecoder.format.value();
+
+    std::vector<TrackAnalyser*> started;
+    for(TrackAnalyser* analyser : analysers) {
+        if(analyser && analyser->start(track, format)) {
+            started.push_back(analyser);
+        }
+    }
+    if(started.empty()) {
+        return true;
+    }
+
+    // Each analyser is fed until it reports it's done; buffers are converted once per format still in use
+    struct Target
+    {
+        TrackAnalyser* analyser;
+        SampleFormat sampleFormat;
+        bool active{true};
+    };
+
+    std::vector<Target> targets;
+    for(TrackAnalyser* analyser : started) {
+        targets.emplace_back(analyser, analyser->sampleFormat());
+    }
+
+    decoder->start();
+
+    // Tracks sharing a file only cover part of it, so bound the read to the track itself
+    const bool isPartialFile = track.hasCue() || track.offset() > 0;
+    const uint64_t endBytes  = isPartialFile ? format.bytesForDuration(track.duration()) : 0;
+    if(track.offset() > 0) {
+        decoder->seek(track.offset());
+    }
+
+    uint64_t processedBytes{0};
+    std::vector<std::pair<SampleFormat, AudioBuffer>> converted;
+
+    while(std::ranges::any_of(targets, &Target::active)) {
+        if(mayContinue && !mayContinue()) {
+            decoder->stop();
+            return false;
+        }
+
+        if(endBytes > 0 && processedBytes >= endBytes) {
+            break;
+        }
+
+        const size_t bytesToRead
+            = endBytes > 0 ? static_cast<size_t>(std::min<uint64_t>(ReadSize, endBytes - processedBytes)) : ReadSize;
+
+        const AudioBuffer buffer = decoder->readBuffer(bytesToRead);
+        if(!buffer.isValid() || buffer.byteCount() == 0) {
+            break;
+        }
+        processedBytes += static_cast<uint64_t>(buffer.byteCount());
+
+        converted.clear();
+        for(Target& target : targets) {
+            if(!target.active) {
+                continue;
+            }
+
+            if(target.sampleFormat == buffer.format().sampleFormat()) {
+                target.active = target.analyser->process(buffer);
+                continue;
+            }
+
+            auto convertedIt
+                = std::ranges::find(converted, target.sampleFormat, &std::pair<SampleFormat, AudioBuffer>::first);
+            if(convertedIt == converted.end()) {
+                AudioFormat targetFormat{buffer.format()};
+                targetFormat.setSampleFormat(target.sampleFormat);
+                convertedIt
+                    = converted.emplace(converted.end(), target.sampleFormat, Audio::convert(buffer, targetFormat));
+            }
+            target.active = target.analyser->process(convertedIt->second);
+        }
+    }
+
+    decoder->stop();
+
+    for(TrackAnalyser* analyser : started) {
+        analyser->finish(track);
+    }
+
+    return true;
+}
+
+void TrackAnalysisPipeline::sortForLocality(TrackList& tracks)
+{
+    std::ranges::stable_sort(tracks, [](const Track& lhs, const Track& rhs) {
+        if(const int cmp = lhs.filepath().compare(rhs.filepath()); cmp != 0) {
+            return cmp < 0;
+        }
+        return lhs.offset() < rhs.offset();
+    });
+}
+} // namespace Fooyin
@@ -135,6 +135,7 @@ CoreSettings::CoreSettings(SettingsManager* settingsManager)
                                                               u"Engine/OutputDeviceProfiles"_s);
     m_settings->createSetting<Internal::OpusHeaderWriteMode>(static_cast<int>(OpusRGWriteMode::Album),
                                                              u"ReplayGain/OpusHeaderWriteMode"_s);
+    m_settings->createSetting<Internal::LibraryScanThreads>(1, u"Library/ScanThreads"_s);
 
     m_settings->set<FirstRun>(!QFileInfo::exists(Core::settingsPath()));
 
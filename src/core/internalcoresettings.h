@@ -82,6 +82,7 @@ enum CoreInternalSettings : uint32_t
     CrossfadeSwitchPolicy    = 17 | Type::Int,
     OutputDeviceProfiles     = 18 | Type::Variant,
     OpusHeaderWriteMode      = 19 | Type::Int,
+    LibraryScanThreads       = 20 | Type::Int,
 };
 Q_ENUM_NS(CoreInternalSettings)
 } // namespace Settings::Core::Internal
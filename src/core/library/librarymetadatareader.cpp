@@ -0,0 +1,162 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarymetadatareader.h"
+
+#include <algorithm>
+
+// Number of files each worker may have queued ahead of the scanner
+constexpr size_t QueueDepthPerThread = 8;
+
+namespace Fooyin {
+LibraryMetadataReader::LibraryMetadataReader(const int threadCount, ReadHandler handler)
+    : m_handler{std::move(handler)}
+    , m_capacity{static_cast<size_t>(std::max(threadCount, 1)) * QueueDepthPerThread}
+    , m_nextSequence{0}
+    , m_nextTake{0}
+    , m_inFlight{0}
+{
+    const int count = std::max(threadCount, 1);
+    m_workers.reserve(static_cast<size_t>(count));
+
+    for(int i{0}; i < count; ++i) {
+        m_workers.emplace_back([this](std::stop_token stopToken) { run(stopToken); });
+    }
+}
+
+LibraryMetadataReader::~LibraryMetadataReader()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_jobs.clear();
+    }
+
+    for(auto& worker : m_workers) {
+        worker.request_stop();
+    }
+    m_jobCv.notify_all();
+
+    m_workers.clear();
+}
+
+int LibraryMetadataReader::threadCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+size_t LibraryMetadataReader::capacity() const
+{
+    return m_capacity;
+}
+
+size_t LibraryMetadataReader::outstanding() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return static_cast<size_t>(m_nextSequence - m_nextTake);
+}
+
+bool LibraryMetadataReader::full() const
+{
+    return outstanding() >= m_capacity;
+}
+
+uint64_t LibraryMetadataReader::submit(const QString& filepath)
+{
+    uint64_t sequence{0};
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        sequence = m_nextSequence++;
+        m_jobs.emplace_back(sequence, filepath);
+    }
+
+    m_jobCv.notify_one();
+    return sequence;
+}
+
+std::optional<LibraryMetadataReader::Result> LibraryMetadataReader::takeNext(const bool wait)
+{
+    std::unique_lock lock{m_mutex};
+
+    if(m_nextTake == m_nextSequence) {
+        return {};
+    }
+
+    if(wait) {
+        m_resultCv.wait(lock, [this]() { return m_results.contains(m_nextTake); });
+    }
+
+    auto resultIt = m_results.find(m_nextTake);
+    if(resultIt == m_results.end()) {
+        return {};
+    }
+
+    Result result = std::move(resultIt->second);
+    m_results.erase(resultIt);
+    ++m_nextTake;
+
+    return result;
+}
+
+void LibraryMetadataReader::cancel()
+{
+    std::unique_lock lock{m_mutex};
+
+    m_jobs.clear();
+    m_resultCv.wait(lock, [this]() { return m_inFlight == 0; });
+
+    m_results.clear();
+    m_nextTake = m_nextSequence;
+}
+
+void LibraryMetadataReader::run(const std::stop_token& stopToken)
+{
+    while(true) {
+        std::pair<uint64_t, QString> job;
+
+        {
+            std::unique_lock lock{m_mutex};
+            m_jobCv.wait(lock, stopToken, [this]() { return !m_jobs.empty(); });
+
+            if(stopToken.stop_requested()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_inFlight;
+        }
+
+        TrackList tracks = m_handler(job.second);
+
+        {
+            const std::scoped_lock lock{m_mutex};
+            --m_inFlight;
+
+            // Results of reads dropped by cancel() are discarded
+            if(job.first >= m_nextTake) {
+                m_results.emplace(job.first,
+                                  Result{.sequence = job.first, .filepath = job.second, .tracks = std::move(tracks)});
+            }
+        }
+
+        m_resultCv.notify_all();
+    }
+}
+} // namespace Fooyin
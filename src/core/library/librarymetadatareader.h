@@ -0,0 +1,99 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * Bounded pool of metadata reader threads used by the library scanner.
+ *
+ * Files are submitted from the scanner thread and read concurrently by
+ * `threadCount` workers. Results are handed back strictly in submission
+ * order so the scanner can merge them into `LibraryScanWriter` batches
+ * exactly as a serial scan would.
+ *
+ * The read handler runs on worker threads and must only touch thread-safe state.
+ */
+class FYCORE_EXPORT LibraryMetadataReader
+{
+public:
+    using ReadHandler = std::function<TrackList(const QString& filepath)>;
+
+    struct Result
+    {
+        uint64_t sequence{0};
+        QString filepath;
+        TrackList tracks;
+    };
+
+    LibraryMetadataReader(int threadCount, ReadHandler handler);
+    ~LibraryMetadataReader();
+
+    LibraryMetadataReader(const LibraryMetadataReader&)            = delete;
+    LibraryMetadataReader& operator=(const LibraryMetadataReader&) = delete;
+
+    [[nodiscard]] int threadCount() const;
+    //! Maximum number of submitted files which have not yet been taken.
+    [[nodiscard]] size_t capacity() const;
+    //! Number of submitted files which have not yet been taken.
+    [[nodiscard]] size_t outstanding() const;
+    [[nodiscard]] bool full() const;
+
+    //! Queue @p filepath for reading and return its sequence number.
+    uint64_t submit(const QString& filepath);
+    /*!
+     * Take the next result in submission order.
+     * If @p wait is true, blocks until it is available; returns std::nullopt if nothing is outstanding.
+     */
+    [[nodiscard]] std::optional<Result> takeNext(bool wait);
+    //! Drop all queued (not yet started) reads and wait for in-flight reads to complete.
+    void cancel();
+
+private:
+    void run(const std::stop_token& stopToken);
+
+    ReadHandler m_handler;
+    size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_jobCv;
+    std::condition_variable_any m_resultCv;
+
+    std::deque<std::pair<uint64_t, QString>> m_jobs;
+    std::map<uint64_t, Result> m_results;
+    uint64_t m_nextSequence;
+    uint64_t m_nextTake;
+    size_t m_inFlight;
+
+    std::vector<std::jthread> m_workers;
+};
+} // namespace Fooyin
@@ -110,6 +110,8 @@ void LibraryScanSession::reset(const LibraryInfo& library)
     m_writer.reset();
     m_resolver       = nullptr;
     m_fileScanResult = nullptr;
+    m_metadataReader.reset();
+    m_pendingReads.clear();
     m_externalExplicitPaths.clear();
     m_externalExplicitDirs.clear();
     m_externalCueCoveredPaths.clear();
@@ -246,9 +248,17 @@ bool LibraryScanSession::handleEnumeratedFile(const QFileInfo& info, const Enume
     else {
         switch(type) {
             case EnumeratedFileType::Cue:
+                // Cue files decide which tracks are skipped, so every earlier read must be merged first
+                drainPendingReads();
                 m_resolver->readCue(info, m_onlyModified);
                 break;
             case EnumeratedFileType::Track:
+                if(m_metadataReader) {
+                    if(queueFileRead(info)) {
+                        return m_state.mayRun();
+                    }
+                    break;
+                }
                 m_resolver->readFile(info, m_onlyModified);
                 break;
             case EnumeratedFileType::Playlist:
@@ -261,6 +271,84 @@ bool LibraryScanSession::handleEnumeratedFile(const QFileInfo& info, const Enume
     return m_state.mayRun();
 }
 
+void LibraryScanSession::startMetadataReader()
+{
+    if(m_config.readThreads <= 1) {
+        return;
+    }
+
+    m_metadataReader = std::make_unique<LibraryMetadataReader>(
+        m_config.readThreads, [this](const QString& filepath) { return m_resolver->readTracks(filepath); });
+}
+
+void LibraryScanSession::stopMetadataReader()
+{
+    if(!m_metadataReader) {
+        return;
+    }
+
+    drainPendingReads();
+    m_metadataReader.reset();
+}
+
+bool LibraryScanSession::queueFileRead(const QFileInfo& info)
+{
+    auto read = m_resolver->prepareFileRead(info, m_onlyModified);
+    if(!read) {
+        return false;
+    }
+
+    if(read->isArchive) {
+        // Archive reads update scan state per entry, so they stay on the scanner thread
+        drainPendingReads();
+        m_resolver->applyFileRead(read.value(), m_resolver->readFileTracks(read.value()));
+        return false;
+    }
+
+    while(m_metadataReader->full() && applyNextRead(true)) { }
+
+    m_metadataReader->submit(read->filepath);
+    m_pendingReads.push_back(std::move(read.value()));
+
+    while(applyNextRead(false)) { }
+
+    return true;
+}
+
+bool LibraryScanSession::applyNextRead(const bool wait)
+{
+    auto result = m_metadataReader->takeNext(wait);
+    if(!result) {
+        return false;
+    }
+
+    const LibraryTrackResolver::PendingFileRead read = std::move(m_pendingReads.front());
+    m_pendingReads.pop_front();
+
+    if(m_state.mayRun()) {
+        m_resolver->applyFileRead(read, result->tracks);
+    }
+
+    m_state.fileScanned(read.filepath);
+    maybeFlushWriter();
+
+    return true;
+}
+
+void LibraryScanSession::drainPendingReads()
+{
+    if(!m_metadataReader) {
+        return;
+    }
+
+    while(m_state.mayRun() && applyNextRead(true)) { }
+
+    if(!m_state.mayRun()) {
+        m_metadataReader->cancel();
+        m_pendingReads.clear();
+    }
+}
+
 void LibraryScanSession::handleScanWriterFlush(const ScanResult& result)
 {
     m_host->reportScanUpdate(result);
@@ -333,8 +421,11 @@ bool LibraryScanSession::scanLibrary(const LibraryInfo& library, const TrackList
                                          return handleEnumeratedFile(info, type);
                                      }};
 
+    startMetadataReader();
+
     const bool completed = enumerator.enumerateFiles({library.path}, restrictExtensions, {});
-    m_resolver           = nullptr;
+    stopMetadataReader();
+    m_resolver = nullptr;
 
     if(completed && m_state.mayRun()) {
         finaliseMissingTracks();
@@ -376,8 +467,11 @@ bool LibraryScanSession::scanDirectories(const LibraryInfo& library, const QStri
                                          return handleEnumeratedFile(info, type);
                                      }};
 
+    startMetadataReader();
+
     const bool completed = enumerator.enumerateFiles(dirs, restrictExtensions, {});
-    m_resolver           = nullptr;
+    stopMetadataReader();
+    m_resolver = nullptr;
 
     if(completed && m_state.mayRun()) {
         finaliseMissingTracks();
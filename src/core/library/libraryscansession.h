@@ -24,10 +24,13 @@
 #include "libraryscantypes.h"
 
 #include "libraryfileenumerator.h"
+#include "librarymetadatareader.h"
 #include "libraryscanstate.h"
 #include "libraryscanwriter.h"
 #include "librarytrackresolver.h"
 
+#include <deque>
+
 namespace Fooyin {
 class AudioLoader;
 class PlaylistLoader;
@@ -65,6 +68,11 @@ private:
     void maybeFlushWriter();
     LibraryTrackResolver makeResolver();
     bool handleEnumeratedFile(const QFileInfo& info, EnumeratedFileType type);
+    void startMetadataReader();
+    void stopMetadataReader();
+    bool queueFileRead(const QFileInfo& info);
+    bool applyNextRead(bool wait);
+    void drainPendingReads();
     void handleScanWriterFlush(const ScanResult& result);
     void flushTrackResolverWrites();
     void finaliseMissingTracks();
@@ -81,6 +89,8 @@ private:
     LibraryInfo m_currentLibrary;
     LibraryTrackResolver* m_resolver;
     LibraryScanFilesResult* m_fileScanResult;
+    std::unique_ptr<LibraryMetadataReader> m_metadataReader;
+    std::deque<LibraryTrackResolver::PendingFileRead> m_pendingReads;
 
     std::set<QString> m_externalExplicitPaths;
     std::set<QString> m_externalExplicitDirs;
@@ -47,6 +47,8 @@ struct FYCORE_EXPORT LibraryScanConfig
     bool addFoldersIgnorePlaylists{false};
     bool overwriteRatingOnReload{false};
     bool overwritePlaycountOnReload{false};
+    // Number of threads reading file metadata during library scans (1 = read on the scanner thread)
+    int readThreads{1};
 };
 
 struct FYCORE_EXPORT LibraryScanFilesResult
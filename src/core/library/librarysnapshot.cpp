@@ -0,0 +1,530 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarysnapshot.h"
+
+#include <core/trackmetadatastore.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+Q_LOGGING_CATEGORY(LIB_SNAPSHOT, "fy.librarysnapshot")
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr std::array<char, 4> SnapshotMagic{'F', 'Y', 'L', 'S'};
+constexpr uint32_t ByteOrderMark = 0x01020304;
+
+enum StringField : uint8_t
+{
+    FilePath = 0,
+    Title,
+    TrackNumber,
+    TrackTotal,
+    Album,
+    DiscNumber,
+    DiscTotal,
+    Date,
+    Comment,
+    CuePath,
+    Codec,
+    CodecProfile,
+    Tool,
+    Encoding,
+    Hash,
+    StringFieldCount,
+};
+
+enum ListField : uint8_t
+{
+    Artists = 0,
+    AlbumArtists,
+    Composers,
+    Performers,
+    Genres,
+    TagTypes,
+    ListFieldCount,
+};
+
+struct SnapshotHeader
+{
+    std::array<char, 4> magic{};
+    uint32_t version{0};
+    uint32_t byteOrder{0};
+    uint32_t trackCount{0};
+    int64_t generation{0};
+    uint32_t stringCount{0};
+    uint32_t listCount{0};
+    uint64_t charCount{0};
+    uint64_t blobSize{0};
+    uint64_t reserved{0};
+};
+
+struct SnapshotRange
+{
+    uint32_t offset{0};
+    uint32_t size{0};
+};
+
+struct SnapshotTrack
+{
+    uint64_t offset{0};
+    uint64_t duration{0};
+    uint64_t fileSize{0};
+    uint64_t modifiedTime{0};
+    uint64_t createdTime{0};
+    uint64_t addedTime{0};
+    uint64_t firstPlayed{0};
+    uint64_t lastPlayed{0};
+
+    int32_t id{-1};
+    int32_t libraryId{-1};
+    int32_t subsong{0};
+    int32_t bitrate{0};
+    int32_t sampleRate{0};
+    int32_t channels{0};
+    int32_t bitDepth{0};
+    int32_t playCount{0};
+
+    float rating{0};
+    float rgTrackGain{0};
+    float rgAlbumGain{0};
+    float rgTrackPeak{0};
+    float rgAlbumPeak{0};
+    uint32_t reserved{0};
+
+    std::array<uint32_t, StringFieldCount> strings{};
+    uint32_t padding{0};
+    std::array<SnapshotRange, ListFieldCount> lists{};
+    SnapshotRange extraTags;
+    SnapshotRange extraProperties;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> && sizeof(SnapshotHeader) == 64);
+static_assert(std::is_trivially_copyable_v<SnapshotTrack> && sizeof(SnapshotTrack) % 8 == 0);
+
+class SnapshotWriter
+{
+public:
+    SnapshotWriter()
+    {
+        // Index 0 is always the empty string
+        m_strings.push_back({});
+    }
+
+    uint32_t addString(const QString& str)
+    {
+        if(str.isEmpty()) {
+            return 0;
+        }
+
+        const auto [it, inserted] = m_stringIds.tryEmplace(str, static_cast<uint32_t>(m_strings.size()));
+        if(inserted) {
+            m_strings.push_back({static_cast<uint32_t>(m_chars.size()), static_cast<uint32_t>(str.size())});
+            m_chars.insert(m_chars.end(), str.utf16(), str.utf16() + str.size());
+        }
+        return it.value();
+    }
+
+    SnapshotRange addList(const QStringList& list)
+    {
+        const SnapshotRange range{static_cast<uint32_t>(m_lists.size()), static_cast<uint32_t>(list.size())};
+        for(const QString& str : list) {
+            m_lists.push_back(addString(str));
+        }
+        return range;
+    }
+
+    SnapshotRange addBlob(const QByteArray& blob)
+    {
+        const SnapshotRange range{static_cast<uint32_t>(m_blobs.size()), static_cast<uint32_t>(blob.size())};
+        m_blobs.append(blob);
+        return range;
+    }
+
+    void addTrack(const Fooyin::Track& track)
+    {
+        SnapshotTrack record;
+
+        record.offset       = track.offset();
+        record.duration     = track.duration();
+        record.fileSize     = track.fileSize();
+        record.modifiedTime = track.modifiedTime();
+        record.createdTime  = track.createdTime();
+        record.addedTime    = track.addedTime();
+        record.firstPlayed  = track.firstPlayed();
+        record.lastPlayed   = track.lastPlayed();
+
+        record.id         = track.id();
+        record.libraryId  = track.libraryId();
+        record.subsong    = track.subsong();
+        record.bitrate    = track.bitrate();
+        record.sampleRate = track.sampleRate();
+        record.channels   = track.channels();
+        record.bitDepth   = track.bitDepth();
+        record.playCount  = track.playCount();
+
+        record.rating      = track.rating();
+        record.rgTrackGain = track.rgTrackGain();
+        record.rgAlbumGain = track.rgAlbumGain();
+        record.rgTrackPeak = track.rgTrackPeak();
+        record.rgAlbumPeak = track.rgAlbumPeak();
+
+        record.strings[FilePath]     = addString(track.filepath());
+        record.strings[Title]        = addString(track.title());
+        record.strings[TrackNumber]  = addString(track.trackNumber());
+        record.strings[TrackTotal]   = addString(track.trackTotal());
+        record.strings[Album]        = addString(track.album());
+        record.strings[DiscNumber]   = addString(track.discNumber());
+        record.strings[DiscTotal]    = addString(track.discTotal());
+        record.strings[Date]         = addString(track.date());
+        record.strings[Comment]      = addString(track.comment());
+        record.strings[CuePath]      = addString(track.cuePath());
+        record.strings[Codec]        = addString(track.codec());
+        record.strings[CodecProfile] = addString(track.codecProfile());
+        record.strings[Tool]         = addString(track.tool());
+        record.strings[Encoding]     = addString(track.encoding());
+        record.strings[Hash]         = addString(track.hash());
+
+        record.lists[Artists]      = addList(track.artists());
+        record.lists[AlbumArtists] = addList(track.albumArtists());
+        record.lists[Composers]    = addList(track.composers());
+        record.lists[Performers]   = addList(track.performers());
+        record.lists[Genres]       = addList(track.genres());
+        record.lists[TagTypes]     = addList(track.tagTypes());
+
+        record.extraTags       = addBlob(track.serialiseExtraTags());
+        record.extraProperties = addBlob(track.serialiseExtraProperties());
+
+        m_tracks.push_back(record);
+    }
+
+    bool write(QIODevice& device, int64_t generation) const
+    {
+        SnapshotHeader header;
+        header.magic       = SnapshotMagic;
+        header.version     = Fooyin::LibrarySnapshot::FormatVersion;
+        header.byteOrder   = ByteOrderMark;
+        header.trackCount  = static_cast<uint32_t>(m_tracks.size());
+        header.generation  = generation;
+        header.stringCount = static_cast<uint32_t>(m_strings.size());
+        header.listCount   = static_cast<uint32_t>(m_lists.size());
+        header.charCount   = m_chars.size();
+        header.blobSize    = static_cast<uint64_t>(m_blobs.size());
+
+        const auto writeData = [&device](const void* data, size_t size) {
+            return size == 0
+                || device.write(static_cast<const char*>(data), static_cast<qint64>(size)) == static_cast<qint64>(size);
+        };
+
+        return writeData(&header, sizeof(header))
+            && writeData(m_tracks.data(), m_tracks.size() * sizeof(SnapshotTrack))
+            && writeData(m_strings.data(), m_strings.size() * sizeof(SnapshotRange))
+            && writeData(m_lists.data(), m_lists.size() * sizeof(uint32_t))
+            && writeData(m_chars.data(), m_chars.size() * sizeof(char16_t))
+            && writeData(m_blobs.constData(), static_cast<size_t>(m_blobs.size()));
+    }
+
+private:
+    QHash<QString, uint32_t> m_stringIds;
+    std::vector<SnapshotRange> m_strings;
+    std::vector<uint32_t> m_lists;
+    std::vector<char16_t> m_chars;
+    QByteArray m_blobs;
+    std::vector<SnapshotTrack> m_tracks;
+};
+
+struct SnapshotView
+{
+    SnapshotHeader header;
+    const uchar* tracks{nullptr};
+    const uchar* strings{nullptr};
+    const uchar* lists{nullptr};
+    const uchar* chars{nullptr};
+    const uchar* blobs{nullptr};
+};
+
+bool mapSections(const uchar* data, uint64_t size, SnapshotView& view)
+{
+    if(size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    std::memcpy(&view.header, data, sizeof(SnapshotHeader));
+    const auto& header = view.header;
+
+    if(header.magic != SnapshotMagic || header.version != Fooyin::LibrarySnapshot::FormatVersion
+       || header.byteOrder != ByteOrderMark || header.stringCount == 0) {
+        return false;
+    }
+
+    // Every section size is bounded by 32-bit counts, so these sums can't overflow
+    const uint64_t tracksOffset  = sizeof(SnapshotHeader);
+    const uint64_t stringsOffset = tracksOffset + (uint64_t{header.trackCount} * sizeof(SnapshotTrack));
+    const uint64_t listsOffset   = stringsOffset + (uint64_t{header.stringCount} * sizeof(SnapshotRange));
+    const uint64_t charsOffset   = listsOffset + (uint64_t{header.listCount} * sizeof(uint32_t));
+
+    if(header.charCount > size || header.blobSize > size) {
+        return false;
+    }
+
+    const uint64_t blobsOffset = charsOffset + (header.charCount * sizeof(char16_t));
+    if(blobsOffset + header.blobSize != size) {
+        return false;
+    }
+
+    view.tracks  = data + tracksOffset;
+    view.strings = data + stringsOffset;
+    view.lists   = data + listsOffset;
+    view.chars   = data + charsOffset;
+    view.blobs   = data + blobsOffset;
+
+    return true;
+}
+
+std::optional<Fooyin::TrackList> readTracks(const SnapshotView& view,
+                                            const std::shared_ptr<Fooyin::TrackMetadataStore>& store)
+{
+    const auto& header = view.header;
+
+    // Resolve each distinct string once; tracks then share the implicitly-shared copies
+    std::vector<QString> strings(header.stringCount);
+    for(uint32_t i{1}; i < header.stringCount; ++i) {
+        SnapshotRange range;
+        std::memcpy(&range, view.strings + (i * sizeof(SnapshotRange)), sizeof(SnapshotRange));
+        if(uint64_t{range.offset} + range.size > header.charCount) {
+            return {};
+        }
+        strings[i] = QString{reinterpret_cast<const QChar*>(view.chars) + range.offset, range.size};
+    }
+
+    std::vector<uint32_t> lists(header.listCount);
+    if(!lists.empty()) {
+        std::memcpy(lists.data(), view.lists, lists.size() * sizeof(uint32_t));
+    }
+    for(const uint32_t index : lists) {
+        if(index >= header.stringCount) {
+            return {};
+        }
+    }
+
+    const auto stringAt = [&strings](uint32_t index, QString& str) {
+        if(index >= strings.size()) {
+            return false;
+        }
+        str = strings[index];
+        return true;
+    };
+
+    const auto listAt = [&lists, &strings](const SnapshotRange& range, QStringList& list) {
+        if(uint64_t{range.offset} + range.size > lists.size()) {
+            return false;
+        }
+        list.clear();
+        list.reserve(range.size);
+        for(uint32_t i{0}; i < range.size; ++i) {
+            list.push_back(strings[lists[range.offset + i]]);
+        }
+        return true;
+    };
+
+    const auto blobAt = [&view, &header](const SnapshotRange& range, QByteArray& blob) {
+        if(uint64_t{range.offset} + range.size > header.blobSize) {
+            return false;
+        }
+        blob = QByteArray::fromRawData(reinterpret_cast<const char*>(view.blobs) + range.offset, range.size);
+        return true;
+    };
+
+    Fooyin::TrackList tracks;
+    tracks.reserve(header.trackCount);
+
+    std::array<QString, StringFieldCount> fields;
+    std::array<QStringList, ListFieldCount> listFields;
+    QByteArray extraTags;
+    QByteArray extraProperties;
+
+    for(uint32_t i{0}; i < header.trackCount; ++i) {
+        SnapshotTrack record;
+        std::memcpy(&record, view.tracks + (i * sizeof(SnapshotTrack)), sizeof(SnapshotTrack));
+
+        for(size_t field{0}; field < fields.size(); ++field) {
+            if(!stringAt(record.strings[field], fields[field])) {
+                return {};
+            }
+        }
+        for(size_t field{0}; field < listFields.size(); ++field) {
+            if(!listAt(record.lists[field], listFields[field])) {
+                return {};
+            }
+        }
+        if(!blobAt(record.extraTags, extraTags) || !blobAt(record.extraProperties, extraProperties)) {
+            return {};
+        }
+
+        Fooyin::Track track{store};
+
+        track.setId(record.id);
+        track.setFilePath(fields[FilePath]);
+        track.setSubsong(record.subsong);
+        track.setTitle(fields[Title]);
+        track.setTrackNumber(fields[TrackNumber]);
+        track.setTrackTotal(fields[TrackTotal]);
+        track.setArtists(listFields[Artists]);
+        track.setAlbumArtists(listFields[AlbumArtists]);
+        track.setAlbum(fields[Album]);
+        track.setDiscNumber(fields[DiscNumber]);
+        track.setDiscTotal(fields[DiscTotal]);
+        track.setDate(fields[Date]);
+        track.setComposers(listFields[Composers]);
+        track.setPerformers(listFields[Performers]);
+        track.setGenres(listFields[Genres]);
+        track.setComment(fields[Comment]);
+        track.setCuePath(fields[CuePath]);
+        track.setOffset(record.offset);
+        track.setDuration(record.duration);
+        track.setFileSize(record.fileSize);
+        track.setBitrate(record.bitrate);
+        track.setSampleRate(record.sampleRate);
+        track.setChannels(record.channels);
+        track.setBitDepth(record.bitDepth);
+        track.setCodec(fields[Codec]);
+        track.setCodecProfile(fields[CodecProfile]);
+        track.setTool(fields[Tool]);
+        track.setTagTypes(listFields[TagTypes]);
+        track.setEncoding(fields[Encoding]);
+        track.storeExtraTags(extraTags);
+        track.storeExtraProperties(extraProperties);
+        track.setModifiedTime(record.modifiedTime);
+        track.setLibraryId(record.libraryId);
+        track.setRGTrackGain(record.rgTrackGain);
+        track.setRGAlbumGain(record.rgAlbumGain);
+        track.setRGTrackPeak(record.rgTrackPeak);
+        track.setRGAlbumPeak(record.rgAlbumPeak);
+        track.setCreatedTime(record.createdTime);
+
+        track.setAddedTime(record.addedTime);
+        track.setFirstPlayed(record.firstPlayed);
+        track.setLastPlayed(record.lastPlayed);
+        track.setPlayCount(record.playCount);
+        track.setRating(record.rating);
+
+        track.setMetadataWasRead(true);
+        // Stored hash was generated from the same fields, so there's no need to regenerate it
+        track.setHash(fields[Hash]);
+        // Loaded tracks match the database, so only later edits are written back
+        track.clearDirtyFields();
+
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin {
+LibrarySnapshot::LibrarySnapshot(QString filepath)
+    : m_filepath{std::move(filepath)}
+{ }
+
+QString LibrarySnapshot::filepath() const
+{
+    return m_filepath;
+}
+
+std::optional<TrackList> LibrarySnapshot::load(int64_t generation, int trackCount,
+                                               const std::shared_ptr<TrackMetadataStore>& store) const
+{
+    QFile file{m_filepath};
+    if(!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    const qint64 size = file.size();
+    if(size <= 0) {
+        return {};
+    }
+
+    const uchar* data = file.map(0, size);
+    if(!data) {
+        qCDebug(LIB_SNAPSHOT) << "Unable to map snapshot" << m_filepath << file.errorString();
+        return {};
+    }
+
+    std::optional<TrackList> tracks;
+
+    SnapshotView view;
+    if(!mapSections(data, static_cast<uint64_t>(size), view)) {
+        qCInfo(LIB_SNAPSHOT) << "Ignoring invalid library snapshot" << m_filepath;
+    }
+    else if(view.header.generation != generation || std::cmp_not_equal(view.header.trackCount, trackCount)) {
+        qCDebug(LIB_SNAPSHOT) << "Library snapshot is stale (generation" << view.header.generation << "vs"
+                              << generation << ")";
+    }
+    else {
+        tracks = readTracks(view, store);
+        if(!tracks) {
+            qCInfo(LIB_SNAPSHOT) << "Ignoring corrupt library snapshot" << m_filepath;
+        }
+    }
+
+    file.unmap(const_cast<uchar*>(data));
+
+    return tracks;
+}
+
+bool LibrarySnapshot::save(const TrackList& tracks, int64_t generation) const
+{
+    SnapshotWriter writer;
+    for(const Track& track : tracks) {
+        writer.addTrack(track);
+    }
+
+    QDir{}.mkpath(QFileInfo{m_filepath}.absolutePath());
+
+    QSaveFile file{m_filepath};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qCWarning(LIB_SNAPSHOT) << "Unable to write library snapshot" << m_filepath << file.errorString();
+        return false;
+    }
+
+    if(!writer.write(file, generation)) {
+        file.cancelWriting();
+        qCWarning(LIB_SNAPSHOT) << "Unable to write library snapshot" << m_filepath << file.errorString();
+        return false;
+    }
+
+    return file.commit();
+}
+
+void LibrarySnapshot::remove() const
+{
+    QFile::remove(m_filepath);
+}
+} // namespace Fooyin
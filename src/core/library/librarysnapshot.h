@@ -0,0 +1,61 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <optional>
+
+namespace Fooyin {
+class TrackMetadataStore;
+
+/*!
+ * Binary snapshot of the resident library used to skip `TracksView` on startup.
+ *
+ * The file holds one deduplicated string table shared by every track, followed by
+ * fixed-size track records which reference it by index. Loading maps the file and
+ * resolves each distinct string once, so hydration cost is dominated by interning
+ * into the `TrackMetadataStore` rather than by per-row `QVariant` conversions.
+ *
+ * A snapshot is tagged with the database library generation and track count it was
+ * written against. `load` returns std::nullopt if either differs, or if the file is
+ * missing, truncated or from another format version, in which case callers fall back
+ * to reading the database.
+ */
+class FYCORE_EXPORT LibrarySnapshot
+{
+public:
+    static constexpr uint32_t FormatVersion = 1;
+
+    explicit LibrarySnapshot(QString filepath);
+
+    [[nodiscard]] QString filepath() const;
+
+    [[nodiscard]] std::optional<TrackList> load(int64_t generation, int trackCount,
+                                                const std::shared_ptr<TrackMetadataStore>& store) const;
+    bool save(const TrackList& tracks, int64_t generation) const;
+    void remove() const;
+
+private:
+    QString m_filepath;
+};
+} // namespace Fooyin
@@ -81,6 +81,7 @@ LibraryScanConfig currentScanConfig(SettingsManager* settings)
         .addFoldersIgnorePlaylists  = settings->value<Settings::Core::AddFoldersIgnorePlaylists>(),
         .overwriteRatingOnReload    = settings->value<Settings::Core::OverwriteRatingOnReload>(),
         .overwritePlaycountOnReload = settings->value<Settings::Core::OverwritePlaycountOnReload>(),
+        .readThreads                = settings->value<LibraryScanThreads>(),
     };
 }
 
@@ -944,9 +945,10 @@ WriteRequest LibraryThreadHandler::deleteTracks(const TrackList& tracks)
     return operation.request;
 }
 
-void LibraryThreadHandler::cleanupTracks()
+void LibraryThreadHandler::cleanupTracks(const TrackList& libraryTracks)
 {
-    QMetaObject::invokeMethod(&p->m_trackDatabaseManager, &TrackDatabaseManager::cleanupTracks);
+    QMetaObject::invokeMethod(&p->m_trackDatabaseManager,
+                              [this, libraryTracks]() { p->m_trackDatabaseManager.cleanupTracks(libraryTracks); });
 }
 
 void LibraryThreadHandler::libraryRemoved(int id)
@@ -74,7 +74,7 @@ public:
 
     WriteRequest removeUnavailbleTracks(const TrackList& tracks);
     WriteRequest deleteTracks(const TrackList& tracks);
-    void cleanupTracks();
+    void cleanupTracks(const TrackList& libraryTracks);
     void libraryRemoved(int id);
 
 Q_SIGNALS:
@@ -342,98 +342,119 @@ void LibraryTrackResolver::readFile(const QString& file, const bool onlyModified
 }
 
 void LibraryTrackResolver::readFile(const QFileInfo& info, const bool onlyModified)
+{
+    if(const auto read = prepareFileRead(info, onlyModified)) {
+        applyFileRead(read.value(), readFileTracks(read.value()));
+    }
+}
+
+std::optional<LibraryTrackResolver::PendingFileRead> LibraryTrackResolver::prepareFileRead(const QFileInfo& info,
+                                                                                             const bool onlyModified)
 {
     const QString file = normalisePath(info.absoluteFilePath());
 
     if(!m_state->mayRun() || m_state->cueFilesScanned().contains(file)) {
-        return;
+        return {};
     }
 
     const QDateTime lastModifiedTime{info.lastModified()};
     const uint64_t lastModified
         = lastModifiedTime.isValid() ? static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch()) : 0;
 
+    const auto needsRefresh = [this, lastModified, onlyModified](const TrackList& existingTracks) {
+        const Track& libraryTrack = existingTracks.front();
+        return !libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
+            || libraryTrack.modifiedTime() < lastModified || !onlyModified;
+    };
+
     if(m_state->trackPaths().contains(file)) {
         const auto& existingTracks = m_state->trackPaths().at(file);
-        const Track& libraryTrack  = existingTracks.front();
-        const bool needsRefresh    = !libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
-                                  || libraryTrack.modifiedTime() < lastModified || !onlyModified;
-
-        if(!needsRefresh) {
+        if(!needsRefresh(existingTracks)) {
             m_state->markTracksSeen(existingTracks);
-            return;
+            return {};
         }
 
-        std::unordered_map<QString, Track> existingByPath;
-        for(const auto& track : existingTracks) {
-            existingByPath.emplace(track.uniqueFilepath(), track);
-        }
+        return PendingFileRead{.kind           = PendingFileRead::Kind::Existing,
+                               .filepath       = file,
+                               .info           = info,
+                               .existingTracks = existingTracks,
+                               .isArchive      = m_audioLoader->isArchive(file)};
+    }
 
-        const TrackList tracks = readTracks(file);
-        if(tracks.empty()) {
+    if(m_state->existingArchives().contains(file)) {
+        const auto& existingTracks = m_state->existingArchives().at(file);
+        if(!needsRefresh(existingTracks)) {
             m_state->markTracksSeen(existingTracks);
-            return;
+            return {};
         }
 
-        for(Track track : tracks) {
-            if(existingByPath.contains(track.uniqueFilepath())) {
-                const auto& existingTrack = existingByPath.at(track.uniqueFilepath());
-                applyExistingTrackIdentity(track, existingTrack);
-                mergeReloadedTrackStats(track, existingTrack, m_reloadOptions);
-            }
+        return PendingFileRead{.kind           = PendingFileRead::Kind::ExistingArchive,
+                               .filepath       = file,
+                               .info           = info,
+                               .existingTracks = existingTracks,
+                               .isArchive      = true};
+    }
 
-            const QDateTime createdTime{info.birthTime()};
-            if(createdTime.isValid()) {
-                track.setCreatedTime(static_cast<uint64_t>(createdTime.toMSecsSinceEpoch()));
-            }
-            if(lastModifiedTime.isValid()) {
-                track.setModifiedTime(lastModified);
-            }
+    qCDebug(LIB_SCANNER) << "Indexing new file:" << file;
 
-            updateExistingTrack(track, file);
-            m_flushWrites();
-        }
+    return PendingFileRead{.kind           = PendingFileRead::Kind::New,
+                           .filepath       = file,
+                           .info           = info,
+                           .existingTracks = {},
+                           .isArchive      = m_audioLoader->isArchive(file)};
+}
+
+TrackList LibraryTrackResolver::readFileTracks(const PendingFileRead& read)
+{
+    if(read.kind == PendingFileRead::Kind::ExistingArchive) {
+        return readArchiveTracks(read.filepath);
+    }
+    return readTracks(read.filepath);
+}
 
+void LibraryTrackResolver::applyFileRead(const PendingFileRead& read, const TrackList& tracks)
+{
+    if(read.kind == PendingFileRead::Kind::New) {
+        storeNewTracks(read.filepath, tracks);
         return;
     }
 
-    if(m_state->existingArchives().contains(file)) {
-        const auto& existingTracks = m_state->existingArchives().at(file);
-        const Track& libraryTrack  = existingTracks.front();
-        const bool needsRefresh    = !libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
-                                  || libraryTrack.modifiedTime() < lastModified || !onlyModified;
+    if(tracks.empty()) {
+        m_state->markTracksSeen(read.existingTracks);
+        return;
+    }
 
-        if(!needsRefresh) {
-            m_state->markTracksSeen(existingTracks);
-            return;
-        }
+    std::unordered_map<QString, Track> existingByPath;
+    for(const auto& track : read.existingTracks) {
+        existingByPath.emplace(track.uniqueFilepath(), track);
+    }
 
-        std::unordered_map<QString, Track> existingByPath;
-        for(const auto& track : existingTracks) {
-            existingByPath.emplace(track.uniqueFilepath(), track);
-        }
+    const QDateTime lastModifiedTime{read.info.lastModified()};
+    const QDateTime createdTime{read.info.birthTime()};
 
-        const TrackList tracks = readArchiveTracks(file);
-        if(tracks.empty()) {
-            m_state->markTracksSeen(existingTracks);
-            return;
+    for(Track track : tracks) {
+        if(existingByPath.contains(track.uniqueFilepath())) {
+            const auto& existingTrack = existingByPath.at(track.uniqueFilepath());
+            applyExistingTrackIdentity(track, existingTrack);
+            mergeReloadedTrackStats(track, existingTrack, m_reloadOptions);
         }
 
-        for(Track track : tracks) {
-            if(existingByPath.contains(track.uniqueFilepath())) {
-                const auto& existingTrack = existingByPath.at(track.uniqueFilepath());
-                applyExistingTrackIdentity(track, existingTrack);
-                mergeReloadedTrackStats(track, existingTrack, m_reloadOptions);
+        if(read.kind == PendingFileRead::Kind::ExistingArchive) {
+            updateExistingTrack(track, track.filepath());
+        }
+        else {
+            if(createdTime.isValid()) {
+                track.setCreatedTime(static_cast<uint64_t>(createdTime.toMSecsSinceEpoch()));
+            }
+            if(lastModifiedTime.isValid()) {
+                track.setModifiedTime(static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch()));
             }
 
-            updateExistingTrack(track, track.filepath());
-            m_flushWrites();
+            updateExistingTrack(track, read.filepath);
         }
 
-        return;
+        m_flushWrites();
     }
-
-    readNewTrack(file);
 }
 
 TrackList LibraryTrackResolver::readArchiveTracks(const QString& filepath)
@@ -591,15 +612,8 @@ void LibraryTrackResolver::updateExistingTrack(Track& track, const QString& file
     m_state->markTrackSeen(track);
 }
 
-void LibraryTrackResolver::readNewTrack(const QString& file)
+void LibraryTrackResolver::storeNewTracks(const QString& file, const TrackList& tracks)
 {
-    qCDebug(LIB_SCANNER) << "Indexing new file:" << file;
-
-    const TrackList tracks = readTracks(file);
-    if(tracks.empty()) {
-        return;
-    }
-
     for(Track track : tracks) {
         if(const Track refoundTrack = m_state->matchRelocatedTrack(track);
            refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
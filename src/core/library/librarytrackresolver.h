@@ -26,9 +26,10 @@
 #include <core/library/libraryinfo.h>
 #include <core/track.h>
 
-#include <functional>
+#include <QFileInfo>
 
-class QFileInfo;
+#include <functional>
+#include <optional>
 
 namespace Fooyin {
 class AudioLoader;
@@ -43,6 +44,29 @@ class FYCORE_EXPORT LibraryTrackResolver
 public:
     using FlushWritesHandler = std::function<void()>;
 
+    /*!
+     * A file whose metadata needs to be (re)read.
+     *
+     * Produced by `prepareFileRead` on the scanner thread. The tag read itself
+     * (`readFileTracks`) may then run on any thread, after which the result is
+     * merged back on the scanner thread through `applyFileRead`.
+     */
+    struct PendingFileRead
+    {
+        enum class Kind : uint8_t
+        {
+            Existing = 0,
+            ExistingArchive,
+            New,
+        };
+
+        Kind kind{Kind::New};
+        QString filepath;
+        QFileInfo info;
+        TrackList existingTracks;
+        bool isArchive{false};
+    };
+
     LibraryTrackResolver(LibraryInfo currentLibrary, PlaylistLoader* playlistLoader, AudioLoader* audioLoader,
                          bool playlistSkipMissing, std::shared_ptr<TrackMetadataStore> metadataStore,
                          TrackDatabase* trackDatabase, LibraryScanState* state, LibraryScanWriter* writer,
@@ -59,6 +83,12 @@ public:
     void readFile(const QString& file, bool onlyModified);
     void readFile(const QFileInfo& info, bool onlyModified);
 
+    //! Returns std::nullopt if the file is unchanged, already covered by a cue, or the scan was stopped.
+    [[nodiscard]] std::optional<PendingFileRead> prepareFileRead(const QFileInfo& info, bool onlyModified);
+    //! Thread-safe for non-archive files.
+    [[nodiscard]] TrackList readFileTracks(const PendingFileRead& read);
+    void applyFileRead(const PendingFileRead& read, const TrackList& tracks);
+
 private:
     [[nodiscard]] TrackList readArchiveTracks(const QString& filepath);
 
@@ -66,7 +96,7 @@ private:
     void setTrackProps(Track& track, const QString& file);
 
     void updateExistingTrack(Track& track, const QString& file);
-    void readNewTrack(const QString& file);
+    void storeNewTracks(const QString& file, const TrackList& tracks);
 
     LibraryInfo m_currentLibrary;
     PlaylistLoader* m_playlistLoader;
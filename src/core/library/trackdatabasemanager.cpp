@@ -27,13 +27,18 @@
 #include <core/library/musiclibrary.h>
 #include <core/track.h>
 #include <utils/database/dbconnectionhandler.h>
+#include <utils/fypaths.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <QFileInfo>
 #include <QLoggingCategory>
 
+#include <algorithm>
+
 Q_LOGGING_CATEGORY(TRK_DBMAN, "fy.trackdbmanager")
 
+using namespace Qt::StringLiterals;
+
 namespace {
 bool shouldContinue(const std::stop_token& stopToken)
 {
@@ -50,6 +55,7 @@ TrackDatabaseManager::TrackDatabaseManager(DbConnectionPoolPtr dbPool, std::shar
     , m_audioLoader{std::move(audioLoader)}
     , m_settings{settings}
     , m_metadataStore{std::move(metadataStore)}
+    , m_snapshot{Utils::cachePath(u"library.snapshot"_s)}
 { }
 
 void TrackDatabaseManager::initialiseThread()
@@ -65,7 +71,7 @@ void TrackDatabaseManager::getAllTracks()
 {
     setState(Running);
 
-    const TrackList tracks = m_trackDatabase.getAllTracks();
+    const TrackList tracks = loadTracks();
     Q_EMIT gotTracks(tracks);
 
     setState(Idle);
@@ -129,6 +135,9 @@ void TrackDatabaseManager::updateTracks(const TrackList& tracks, bool write, int
         }
     }
 
+    // Write files first, then apply all database changes in a single write so they share a commit
+    TrackList pendingTracks;
+
     for(const Track& track : std::as_const(tracksToUpdate)) {
         if(!shouldContinue(stopToken) || !mayRun()) {
             cancelled = true;
@@ -150,13 +159,24 @@ void TrackDatabaseManager::updateTracks(const TrackList& tracks, bool write, int
             }
         }
 
-        if(m_trackDatabase.updateTrack(updatedTrack) && m_trackDatabase.updateTrackStats(updatedTrack)) {
-            tracksUpdated.push_back(updatedTrack);
-        }
-        else {
-            ++failedCount;
+        pendingTracks.push_back(updatedTrack);
+    }
+
+    const bool committed = pendingTracks.empty() || m_trackDatabase.runWrite([this, &pendingTracks, &tracksUpdated]() {
+        for(Track& updatedTrack : pendingTracks) {
+            if(m_trackDatabase.updateTrack(updatedTrack) && m_trackDatabase.updateTrackStats(updatedTrack)) {
+                updatedTrack.clearDirtyFields();
+                tracksUpdated.push_back(updatedTrack);
+            }
         }
+        return true;
+    });
+
+    if(!committed) {
+        qCWarning(TRK_DBMAN) << "Failed to commit track updates";
+        tracksUpdated.clear();
     }
+    failedCount += static_cast<int>(pendingTracks.size() - tracksUpdated.size());
 
     Q_EMIT updatedTracks(tracksUpdated);
     if(operationId >= 0) {
@@ -187,6 +207,9 @@ void TrackDatabaseManager::updateTrackStats(const TrackList& tracks, AudioReader
         writeOptions |= AudioReader::PreserveTimestamps;
     }
 
+    // Write files first, then apply all database changes in a single write so they share a commit
+    std::vector<std::pair<Track, bool>> pendingTracks;
+
     for(const Track& track : std::as_const(tracksToUpdate)) {
         if(!mayRun()) {
             break;
@@ -204,15 +227,35 @@ void TrackDatabaseManager::updateTrackStats(const TrackList& tracks, AudioReader
             updatedTrack.normaliseExtraProperties();
             needsTrackUpdate = newModifiedTime != track.modifiedTime();
         }
-        if(success && (!needsTrackUpdate || m_trackDatabase.updateTrack(updatedTrack))
-           && m_trackDatabase.updateTrackStats(updatedTrack)) {
-            tracksUpdated.push_back(updatedTrack);
+        if(success) {
+            pendingTracks.emplace_back(updatedTrack, needsTrackUpdate);
         }
         else {
             qCWarning(TRK_DBMAN) << "Failed to update track playback statistics:" << updatedTrack.filepath();
         }
     }
 
+    const bool committed = pendingTracks.empty() || m_trackDatabase.runWrite([this, &pendingTracks, &tracksUpdated]() {
+        for(auto& [updatedTrack, needsTrackUpdate] : pendingTracks) {
+            if((!needsTrackUpdate || m_trackDatabase.updateTrack(updatedTrack))
+               && m_trackDatabase.updateTrackStats(updatedTrack)) {
+                if(needsTrackUpdate) {
+                    updatedTrack.clearDirtyFields();
+                }
+                tracksUpdated.push_back(updatedTrack);
+            }
+            else {
+                qCWarning(TRK_DBMAN) << "Failed to update track playback statistics:" << updatedTrack.filepath();
+            }
+        }
+        return true;
+    });
+
+    if(!committed) {
+        qCWarning(TRK_DBMAN) << "Failed to commit track playback statistics";
+        tracksUpdated.clear();
+    }
+
     if(!tracksUpdated.empty()) {
         Q_EMIT updatedTracksStats(tracksUpdated);
     }
@@ -239,6 +282,8 @@ void TrackDatabaseManager::writeCovers(const TrackCoverData& tracks, int operati
         options |= AudioReader::PreserveTimestamps;
     }
 
+    TrackList pendingTracks;
+
     for(const auto& track : std::as_const(tracksToUpdate)) {
         if(!shouldContinue(stopToken) || !mayRun()) {
             cancelled = true;
@@ -254,13 +299,7 @@ void TrackDatabaseManager::writeCovers(const TrackCoverData& tracks, int operati
         if(m_audioLoader->writeTrackCover(updatedTrack, tracks.coverData, options)) {
             const QDateTime modifiedTime = QFileInfo{updatedTrack.filepath()}.lastModified();
             updatedTrack.setModifiedTime(modifiedTime.isValid() ? modifiedTime.toMSecsSinceEpoch() : 0);
-
-            if(m_trackDatabase.updateTrack(updatedTrack)) {
-                tracksUpdated.push_back(updatedTrack);
-            }
-            else {
-                ++failedCount;
-            }
+            pendingTracks.push_back(updatedTrack);
         }
         else {
             qCWarning(TRK_DBMAN) << "Failed to update track covers:" << updatedTrack.filepath();
@@ -268,6 +307,22 @@ void TrackDatabaseManager::writeCovers(const TrackCoverData& tracks, int operati
         }
     }
 
+    const bool committed = pendingTracks.empty() || m_trackDatabase.runWrite([this, &pendingTracks, &tracksUpdated]() {
+        for(Track& updatedTrack : pendingTracks) {
+            if(m_trackDatabase.updateTrack(updatedTrack)) {
+                updatedTrack.clearDirtyFields();
+                tracksUpdated.push_back(updatedTrack);
+            }
+        }
+        return true;
+    });
+
+    if(!committed) {
+        qCWarning(TRK_DBMAN) << "Failed to commit track covers";
+        tracksUpdated.clear();
+    }
+    failedCount += static_cast<int>(pendingTracks.size() - tracksUpdated.size());
+
     Q_EMIT updatedTracks(tracksUpdated);
     if(operationId >= 0) {
         Q_EMIT trackCoverWriteCompleted(operationId, tracksUpdated, failedCount, cancelled);
@@ -350,15 +405,62 @@ void TrackDatabaseManager::removeUnavailbleTracks(const TrackList& tracks, int o
     setState(Idle);
 }
 
-void TrackDatabaseManager::cleanupTracks()
+void TrackDatabaseManager::cleanupTracks(const TrackList& libraryTracks)
 {
     setState(Running);
 
     m_settings->set<Settings::Core::ActiveTrackId>(-2);
     m_trackDatabase.cleanupTracks();
+    saveSnapshot(libraryTracks);
 
     setState(Idle);
 }
+
+TrackList TrackDatabaseManager::loadTracks()
+{
+    const int64_t generation = m_trackDatabase.libraryGeneration();
+
+    if(generation >= 0) {
+        if(auto tracks = m_snapshot.load(generation, m_trackDatabase.trackCount(), m_metadataStore)) {
+            qCDebug(TRK_DBMAN) << "Loaded" << tracks->size() << "tracks from library snapshot";
+            return std::move(*tracks);
+        }
+    }
+
+    TrackList tracks = m_trackDatabase.getAllTracks();
+
+    // Only cache the result if nothing was written while we were reading
+    if(generation >= 0 && m_trackDatabase.libraryGeneration() == generation) {
+        m_snapshot.save(tracks, generation);
+    }
+
+    return tracks;
+}
+
+void TrackDatabaseManager::saveSnapshot(const TrackList& libraryTracks)
+{
+    const int64_t generation = m_trackDatabase.libraryGeneration();
+    if(generation < 0) {
+        return;
+    }
+
+    // The resident library may still hold tracks removed by cleanup, or lack tracks added by
+    // pending writes; the snapshot is only kept if it matches the database exactly.
+    const std::set<int> ids = m_trackDatabase.trackIds();
+
+    TrackList tracks;
+    tracks.reserve(ids.size());
+    std::ranges::copy_if(libraryTracks, std::back_inserter(tracks),
+                         [&ids](const Track& track) { return ids.contains(track.id()); });
+
+    if(tracks.size() != ids.size()) {
+        qCDebug(TRK_DBMAN) << "Library is out of sync with the database; discarding snapshot";
+        m_snapshot.remove();
+        return;
+    }
+
+    m_snapshot.save(tracks, generation);
+}
 } // namespace Fooyin
 
 #include "moc_trackdatabasemanager.cpp"
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "database/trackdatabase.h"
+#include "librarysnapshot.h"
 
 #include <core/engine/audioinput.h>
 #include <core/trackmetadatastore.h>
@@ -65,7 +66,7 @@ public Q_SLOTS:
     void writeCovers(const Fooyin::TrackCoverData& tracks);
     void deleteTracks(const TrackList& tracks);
     void removeUnavailbleTracks(const TrackList& tracks);
-    void cleanupTracks();
+    void cleanupTracks(const Fooyin::TrackList& libraryTracks);
 
     void updateTracks(const Fooyin::TrackList& tracks, bool write, int operationId, std::stop_token stopToken);
     void writeCovers(const Fooyin::TrackCoverData& tracks, int operationId, std::stop_token stopToken);
@@ -73,6 +74,9 @@ public Q_SLOTS:
     void removeUnavailbleTracks(const TrackList& tracks, int operationId, std::stop_token stopToken);
 
 private:
+    [[nodiscard]] TrackList loadTracks();
+    void saveSnapshot(const TrackList& libraryTracks);
+
     DbConnectionPoolPtr m_dbPool;
     std::shared_ptr<AudioLoader> m_audioLoader;
     SettingsManager* m_settings;
@@ -80,5 +84,6 @@ private:
 
     std::unique_ptr<DbConnectionHandler> m_dbHandler;
     TrackDatabase m_trackDatabase;
+    LibrarySnapshot m_snapshot;
 };
 } // namespace Fooyin
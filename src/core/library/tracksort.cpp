@@ -19,6 +19,11 @@
 
 #include <core/library/tracksort.h>
 
+#include <QLocale>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <numeric>
 #include <utility>
 
 namespace Fooyin {
@@ -76,6 +81,64 @@ TrackList TrackSorter::calcSortTracks(const ParsedScript& sortScript, TrackList
     return sortedTracks;
 }
 
+size_t TrackSorter::taskCount(size_t count)
+{
+    const auto maxThreads = static_cast<size_t>(std::max(QThreadPool::globalInstance()->maxThreadCount(), 1));
+    return std::clamp<size_t>(count / MinItemsPerTask, 1, maxThreads);
+}
+
+void TrackSorter::runTasks(size_t count, const std::function<void(size_t)>& task)
+{
+    if(count == 1) {
+        task(0);
+        return;
+    }
+
+    std::vector<size_t> tasks(count);
+    std::iota(tasks.begin(), tasks.end(), 0);
+
+    // The calling thread takes part in a blocking map, so this is safe to call from a pool thread
+    QtConcurrent::blockingMap(tasks, [&task](const size_t index) { task(index); });
+}
+
+TrackSorter::CollationConfig TrackSorter::syncCollationConfig()
+{
+    // StringCollator uses the default locale at construction, so this matches the collators created per task
+    CollationConfig config{
+        .locale = QLocale{}.bcp47Name(), .caseSensitivity = m_caseSensitivity, .numericMode = m_numericMode};
+
+    if(config != m_collationConfig) {
+        m_collationKeys.clear();
+        m_collationConfig = config;
+    }
+
+    return config;
+}
+
+void TrackSorter::prepareTaskParsers(size_t count)
+{
+    while(m_taskParsers.size() + 1 < count) {
+        m_taskParsers.push_back(std::make_unique<ScriptParser>());
+    }
+}
+
+ScriptParser& TrackSorter::taskParser(size_t task)
+{
+    return task == 0 ? m_parser : *m_taskParsers.at(task - 1);
+}
+
+void TrackSorter::setCaseSensitivity(Qt::CaseSensitivity sensitivity)
+{
+    const std::scoped_lock lock{m_parserGuard};
+    m_caseSensitivity = sensitivity;
+}
+
+void TrackSorter::setNumericMode(bool enabled)
+{
+    const std::scoped_lock lock{m_parserGuard};
+    m_numericMode = enabled;
+}
+
 ParsedScript TrackSorter::parseSortScript(const QString& sort)
 {
     const std::scoped_lock lock{m_parserGuard};
@@ -117,6 +117,8 @@ public:
     QFuture<TrackList> sortTracksFuture(const QString& sort, TrackList tracks);
     void attachMetadataStore(TrackList& tracks) const;
     QCoro::Task<> resortLibraryTracks();
+    [[nodiscard]] QFuture<void> rebuildSearchIndex() const;
+    [[nodiscard]] QFuture<void> updateSearchIndex(TrackList tracks) const;
 
     void enqueueCommit(CommitOperation operation);
     void processNextCommit();
@@ -222,6 +224,18 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::resortLibraryTracks()
     m_tracks = co_await sortTracks(librarySortScript(), std::move(m_tracks));
 }
 
+QFuture<void> UnifiedMusicLibraryPrivate::rebuildSearchIndex() const
+{
+    return Utils::asyncExec(
+        [store = m_metadataStore, tracks = m_tracks]() { store->searchIndex().rebuild(tracks); });
+}
+
+QFuture<void> UnifiedMusicLibraryPrivate::updateSearchIndex(TrackList tracks) const
+{
+    return Utils::asyncExec(
+        [store = m_metadataStore, tracks = std::move(tracks)]() { store->searchIndex().update(tracks); });
+}
+
 void UnifiedMusicLibraryPrivate::enqueueCommit(CommitOperation operation)
 {
     m_commitQueue.push_back(std::move(operation));
@@ -296,13 +310,19 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitLoadTracks(TrackList tracksToLoa
 {
     if(tracksToLoad.empty()) {
         m_tracks.clear();
+        m_metadataStore->markChanged();
+        m_metadataStore->searchIndex().clear();
         Q_EMIT m_self->tracksLoaded({});
         co_return;
     }
 
     attachMetadataStore(tracksToLoad);
     m_tracks = co_await sortTracks(librarySortScript(), std::move(tracksToLoad));
+    m_metadataStore->markChanged();
     Q_EMIT m_self->tracksLoaded(m_tracks);
+
+    // Searches fall back to unindexed matching until this completes
+    co_await rebuildSearchIndex();
 }
 
 QCoro::Task<> UnifiedMusicLibraryPrivate::commitChangeSort(QString sort)
@@ -344,8 +364,10 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitAddTracks(TrackList newTracks)
             m_tracks.push_back(track);
         }
     }
+    m_metadataStore->markChanged();
 
     co_await resortLibraryTracks();
+    co_await updateSearchIndex(sortedTracks);
 
     if(!updatedTracks.empty()) {
         Q_EMIT m_self->tracksMetadataChanged(updatedTracks);
@@ -365,6 +387,7 @@ void UnifiedMusicLibraryPrivate::updateLibraryTracks(const TrackList& updatedTra
             trackIt->clearWasModified();
         }
     }
+    m_metadataStore->markChanged();
 }
 
 void UnifiedMusicLibraryPrivate::updateTracksMetadata(TrackList tracksToUpdate)
@@ -408,6 +431,7 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitUpdateTracksMetadata(TrackList t
 
     updateLibraryTracks(sortedTracks);
     co_await resortLibraryTracks();
+    co_await updateSearchIndex(sortedTracks);
     Q_EMIT m_self->tracksMetadataChanged(sortedTracks);
 }
 
@@ -463,6 +487,7 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitUpdateTracks(TrackList tracksToU
 
     updateLibraryTracks(sortedTracks);
     co_await resortLibraryTracks();
+    co_await updateSearchIndex(sortedTracks);
     Q_EMIT m_self->tracksUpdated(sortedTracks);
 }
 
@@ -480,6 +505,8 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitRemoveTracks(TrackList tracksToR
     }
 
     m_tracks = std::move(remainingTracks);
+    m_metadataStore->markChanged();
+    m_metadataStore->searchIndex().remove(tracksToRemove);
 
     Q_EMIT m_self->tracksDeleted(tracksToRemove);
     co_return;
@@ -592,6 +619,8 @@ QCoro::Task<> UnifiedMusicLibraryPrivate::commitRemoveLibrary(LibraryInfo librar
     }
 
     m_tracks = std::move(remainingTracks);
+    m_metadataStore->markChanged();
+    m_metadataStore->searchIndex().remove(removedTracks);
 
     if(!removedTracks.empty()) {
         Q_EMIT m_self->tracksDeleted(removedTracks);
@@ -863,7 +892,7 @@ void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
 
 void UnifiedMusicLibrary::cleanupTracks()
 {
-    p->m_threadHandler.cleanupTracks();
+    p->m_threadHandler.cleanupTracks(p->m_tracks);
 }
 
 WriteRequest UnifiedMusicLibrary::removeUnavailbleTracks()
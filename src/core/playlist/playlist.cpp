@@ -26,11 +26,14 @@
 #include <utils/crypto.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <random>
 #include <ranges>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 using namespace Qt::StringLiterals;
@@ -50,6 +53,22 @@ int groupIndexContainingTrack(const std::vector<AlbumTracks>& groups, const int
 
     return -1;
 }
+
+bool containsExpression(const ExpressionList& expressions, const std::function<bool(Expr::Type)>& predicate)
+{
+    return std::ranges::any_of(expressions, [&predicate](const Expression& expr) {
+        if(predicate(expr.type)) {
+            return true;
+        }
+        if(const auto* args = std::get_if<ExpressionList>(&expr.value)) {
+            return containsExpression(*args, predicate);
+        }
+        if(const auto* func = std::get_if<FuncValue>(&expr.value)) {
+            return containsExpression(func->args, predicate);
+        }
+        return false;
+    });
+}
 } // namespace
 
 bool PlaylistTrack::isValid() const
@@ -140,8 +159,14 @@ public:
 
     PlaylistPrivate(int dbId, QString name, int index, SettingsManager* settings);
 
+    [[nodiscard]] QString autoQuery() const;
+    void updateQueryTraits();
     [[nodiscard]] TrackList filteredAutoTracks(const TrackList& tracks);
+    [[nodiscard]] TrackList orderedAutoTracks(TrackList filteredTracks) const;
     [[nodiscard]] TrackList updatedAutoTracks(const TrackList& tracks);
+    [[nodiscard]] std::optional<TrackList>
+    patchedAutoTracks(const TrackList& changedTracks, const TrackList& removedTracks,
+                      const std::function<const TrackPositionMap&()>& libraryPositions);
 
     [[nodiscard]] NavigationState navigationState() const;
     void restoreNavigationState(NavigationState state);
@@ -202,6 +227,10 @@ public:
     QString m_query;
     QString m_sortQuery;
     bool m_forceSorted{false};
+
+    bool m_queryTraitsValid{false};
+    bool m_queryIsIncremental{false};
+    bool m_queryIsSorted{false};
 };
 
 PlaylistPrivate::PlaylistPrivate(int dbId, QString name, int index, SettingsManager* settings)
@@ -212,7 +241,7 @@ PlaylistPrivate::PlaylistPrivate(int dbId, QString name, int index, SettingsMana
     , m_settings{settings}
 { }
 
-TrackList PlaylistPrivate::filteredAutoTracks(const TrackList& tracks)
+QString PlaylistPrivate::autoQuery() const
 {
     QString query{m_query};
     if(!m_sortQuery.isEmpty()) {
@@ -221,15 +250,44 @@ TrackList PlaylistPrivate::filteredAutoTracks(const TrackList& tracks)
         }
         query.append(m_sortQuery);
     }
+    return query;
+}
 
-    m_parser.clearCache();
-    return m_parser.filter(query, tracks);
+void PlaylistPrivate::updateQueryTraits()
+{
+    if(m_queryTraitsValid) {
+        return;
+    }
+
+    m_queryTraitsValid = true;
+
+    const ParsedScript script = m_parser.parseQuery(autoQuery());
+
+    // Queries which fail to parse are evaluated as plain per-track searches
+    if(!script.isValid()) {
+        m_queryIsIncremental = true;
+        m_queryIsSorted      = false;
+        return;
+    }
+
+    m_queryIsIncremental = !containsExpression(script.expressions, [](Expr::Type type) {
+        return type == Expr::Limit || type == Expr::Before || type == Expr::After || type == Expr::Since
+            || type == Expr::During;
+    });
+
+    m_queryIsSorted = containsExpression(script.expressions, [](Expr::Type type) {
+        return type == Expr::SortAscending || type == Expr::SortDescending;
+    });
 }
 
-TrackList PlaylistPrivate::updatedAutoTracks(const TrackList& tracks)
+TrackList PlaylistPrivate::filteredAutoTracks(const TrackList& tracks)
 {
-    TrackList filteredTracks = filteredAutoTracks(tracks);
+    m_parser.clearCache();
+    return m_parser.filter(autoQuery(), tracks);
+}
 
+TrackList PlaylistPrivate::orderedAutoTracks(TrackList filteredTracks) const
+{
     if(m_forceSorted) {
         return filteredTracks;
     }
@@ -262,6 +320,78 @@ TrackList PlaylistPrivate::updatedAutoTracks(const TrackList& tracks)
     return updatedTracks;
 }
 
+TrackList PlaylistPrivate::updatedAutoTracks(const TrackList& tracks)
+{
+    return orderedAutoTracks(filteredAutoTracks(tracks));
+}
+
+std::optional<TrackList>
+PlaylistPrivate::patchedAutoTracks(const TrackList& changedTracks, const TrackList& removedTracks,
+                                   const std::function<const TrackPositionMap&()>& libraryPositions)
+{
+    updateQueryTraits();
+    if(!m_queryIsIncremental) {
+        return {};
+    }
+
+    std::unordered_set<QString> removedKeys;
+    removedKeys.reserve(changedTracks.size() + removedTracks.size());
+    for(const Track& track : changedTracks) {
+        removedKeys.emplace(track.uniqueFilepath());
+    }
+    for(const Track& track : removedTracks) {
+        removedKeys.emplace(track.uniqueFilepath());
+    }
+
+    if(removedKeys.empty()) {
+        return m_tracks;
+    }
+
+    const TrackPositionMap* positions{nullptr};
+    const auto libraryPosition = [&](const Track& track) {
+        if(!positions) {
+            positions = &libraryPositions();
+        }
+        const auto it = positions->find(track.uniqueFilepath());
+        return it != positions->cend() ? it->second : std::numeric_limits<int>::max();
+    };
+    const auto byLibraryPosition = [&libraryPosition](const Track& lhs, const Track& rhs) {
+        return libraryPosition(lhs) < libraryPosition(rhs);
+    };
+
+    // Changed tracks are evaluated in library order so new tracks are placed as a full regeneration would
+    TrackList candidates{changedTracks};
+    if(candidates.size() > 1) {
+        std::ranges::stable_sort(candidates, byLibraryPosition);
+    }
+    const TrackList matchedTracks = candidates.empty() ? TrackList{} : filteredAutoTracks(candidates);
+
+    TrackList tracks;
+    tracks.reserve(m_tracks.size() + matchedTracks.size());
+    std::ranges::copy_if(m_tracks, std::back_inserter(tracks),
+                         [&removedKeys](const Track& track) { return !removedKeys.contains(track.uniqueFilepath()); });
+
+    if(matchedTracks.empty()) {
+        return tracks;
+    }
+
+    if(!m_forceSorted) {
+        // Matched tracks already in the playlist keep their position, new ones are appended
+        tracks.insert(tracks.end(), matchedTracks.cbegin(), matchedTracks.cend());
+        return orderedAutoTracks(std::move(tracks));
+    }
+
+    tracks.insert(tracks.end(), matchedTracks.cbegin(), matchedTracks.cend());
+    std::ranges::stable_sort(tracks, byLibraryPosition);
+
+    if(m_queryIsSorted) {
+        // Only the current members are re-evaluated to apply the query's sort
+        return filteredAutoTracks(tracks);
+    }
+
+    return tracks;
+}
+
 PlaylistPrivate::NavigationState PlaylistPrivate::navigationState() const
 {
     return {
@@ -978,6 +1108,17 @@ TrackList Playlist::autoPlaylistTracks(const TrackList& tracks) const
     return p->updatedAutoTracks(tracks);
 }
 
+std::optional<TrackList>
+Playlist::patchedAutoPlaylistTracks(const TrackList& changedTracks, const TrackList& removedTracks,
+                                    const std::function<const TrackPositionMap&()>& libraryPositions) const
+{
+    if(!isAutoPlaylist()) {
+        return {};
+    }
+
+    return p->patchedAutoTracks(changedTracks, removedTracks, libraryPositions);
+}
+
 bool Playlist::regenerateTracks(const TrackList& tracks)
 {
     if(!isAutoPlaylist()) {
@@ -1226,14 +1367,16 @@ void Playlist::setIndex(int index)
 void Playlist::setQuery(const QString& query)
 {
     if(std::exchange(p->m_query, query) != query) {
-        p->m_modified = true;
+        p->m_modified         = true;
+        p->m_queryTraitsValid = false;
     }
 }
 
 void Playlist::setSortQuery(const QString& query)
 {
     if(std::exchange(p->m_sortQuery, query) != query) {
-        p->m_modified = true;
+        p->m_modified         = true;
+        p->m_queryTraitsValid = false;
     }
 }
 
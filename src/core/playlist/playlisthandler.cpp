@@ -37,6 +37,7 @@
 #include <QFileInfo>
 #include <QLoggingCategory>
 
+#include <optional>
 #include <ranges>
 #include <set>
 #include <unordered_map>
@@ -138,7 +139,7 @@ public:
 
     void reloadPlaylists();
     void populatePlaylists();
-    void regenerateAutoPlaylists(const TrackList& updatedTracks = {});
+    void regenerateAutoPlaylists(const TrackList& changedTracks = {}, const TrackList& removedTracks = {});
     bool noConcretePlaylists();
 
     void handleTracksChanged(const TrackList& tracks);
@@ -242,10 +243,32 @@ void PlaylistHandlerPrivate::populatePlaylists()
     Q_EMIT m_self->playlistsPopulated();
 }
 
-void PlaylistHandlerPrivate::regenerateAutoPlaylists(const TrackList& updatedTracks)
+void PlaylistHandlerPrivate::regenerateAutoPlaylists(const TrackList& changedTracks, const TrackList& removedTracks)
 {
-    const TrackList tracks            = m_library->tracks();
-    const TrackKeySet updatedTrackIds = playlistTrackKeySet(updatedTracks);
+    const bool incremental            = !changedTracks.empty() || !removedTracks.empty();
+    const TrackKeySet updatedTrackIds = playlistTrackKeySet(changedTracks);
+
+    // Only fetched if a playlist needs a full regeneration or library ordering
+    std::optional<TrackList> libraryTracks;
+    std::optional<TrackPositionMap> libraryPositions;
+
+    const auto allTracks = [this, &libraryTracks]() -> const TrackList& {
+        if(!libraryTracks) {
+            libraryTracks = m_library->tracks();
+        }
+        return *libraryTracks;
+    };
+    const auto trackPositions = [&allTracks, &libraryPositions]() -> const TrackPositionMap& {
+        if(!libraryPositions) {
+            const TrackList& tracks = allTracks();
+            libraryPositions.emplace();
+            libraryPositions->reserve(tracks.size());
+            for(int i{0}; const Track& track : tracks) {
+                libraryPositions->emplace(track.uniqueFilepath(), i++);
+            }
+        }
+        return *libraryPositions;
+    };
 
     for(auto& playlist : m_playlists) {
         if(!playlist->isAutoPlaylist()) {
@@ -253,7 +276,13 @@ void PlaylistHandlerPrivate::regenerateAutoPlaylists(const TrackList& updatedTra
         }
 
         const PlaylistTrackList oldTracks = playlist->playlistTracks();
-        const TrackList regeneratedTracks = playlist->autoPlaylistTracks(tracks);
+
+        std::optional<TrackList> patchedTracks;
+        if(incremental) {
+            patchedTracks = playlist->patchedAutoPlaylistTracks(changedTracks, removedTracks, trackPositions);
+        }
+        const TrackList regeneratedTracks
+            = patchedTracks ? std::move(*patchedTracks) : playlist->autoPlaylistTracks(allTracks());
         const PlaylistTrackList newTracks
             = rebuildPlaylistTracks(playlist.get(), regeneratedTracks, PreservationMode::Preserve);
 
@@ -597,7 +626,8 @@ PlaylistHandler::PlaylistHandler(DbConnectionPoolPtr dbPool, std::shared_ptr<Aud
     }
 
     QObject::connect(p->m_library, &MusicLibrary::tracksLoaded, this, [this]() { p->populatePlaylists(); });
-    QObject::connect(p->m_library, &MusicLibrary::tracksAdded, this, [this]() { p->regenerateAutoPlaylists(); });
+    QObject::connect(p->m_library, &MusicLibrary::tracksAdded, this,
+                     [this](const TrackList& tracks) { p->regenerateAutoPlaylists(tracks); });
     QObject::connect(p->m_library, &MusicLibrary::tracksMetadataChanged, this, [this](const TrackList& tracks) {
         p->handleTracksChanged(tracks);
         p->regenerateAutoPlaylists(tracks);
@@ -985,7 +1015,7 @@ std::vector<int> PlaylistHandler::deadTrackIndexes(const UId& id) const
 void PlaylistHandler::handleTracksDeleted(const TrackList& tracks)
 {
     p->handleTracksDeleted(tracks);
-    p->regenerateAutoPlaylists(tracks);
+    p->regenerateAutoPlaylists({}, tracks);
 }
 
 void PlaylistHandler::changePlaylistIndex(const UId& id, int index)
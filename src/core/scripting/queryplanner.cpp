@@ -0,0 +1,555 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "queryplanner.h"
+
+#include "scriptregistry.h"
+
+#include <core/trackmetadatastore.h>
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+Q_LOGGING_CATEGORY(QUERY_PLANNER, "fy.queryplanner")
+
+using namespace Qt::StringLiterals;
+
+namespace {
+using Fooyin::BoundExpression;
+using Fooyin::QueryPlanner;
+using Fooyin::VariableKind;
+
+namespace Expr = Fooyin::Expr;
+
+// Keeps per-query bitsets bounded
+constexpr int MaxIndexedId = 1 << 26;
+
+bool isLiteral(const BoundExpression& expr)
+{
+    return expr.type == Expr::Literal || expr.type == Expr::QuotedLiteral;
+}
+
+// Built-in fields whose values depend only on the track itself
+bool isTrackMetadataKind(VariableKind kind)
+{
+    switch(kind) {
+        case VariableKind::Track:
+        case VariableKind::Disc:
+        case VariableKind::Title:
+        case VariableKind::Artist:
+        case VariableKind::UniqueArtist:
+        case VariableKind::Album:
+        case VariableKind::Genre:
+        case VariableKind::Genres:
+        case VariableKind::Composer:
+        case VariableKind::Performer:
+        case VariableKind::Date:
+        case VariableKind::Year:
+        case VariableKind::PlayCount:
+        case VariableKind::Rating:
+        case VariableKind::Duration:
+        case VariableKind::DurationSecs:
+        case VariableKind::DurationMSecs:
+        case VariableKind::FileSize:
+        case VariableKind::SampleRate:
+        case VariableKind::BitDepth:
+        case VariableKind::Channels:
+        case VariableKind::Codec:
+        case VariableKind::Extension:
+        case VariableKind::FirstPlayed:
+        case VariableKind::LastPlayed:
+        case VariableKind::AddedTime:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::optional<int> indexedId(const Fooyin::Track& track, const Fooyin::TrackMetadataStore* store)
+{
+    if(!store || track.metadataStore().get() != store) {
+        return {};
+    }
+
+    const int id = track.id();
+    if(id < 0 || id >= MaxIndexedId) {
+        return {};
+    }
+
+    return id;
+}
+
+QString indexKey(const QueryPlanner::Predicate& predicate)
+{
+    return u"%1:%2:%3"_s.arg(static_cast<int>(predicate.source))
+        .arg(static_cast<int>(predicate.kind))
+        .arg(predicate.field);
+}
+
+QString operatorName(Expr::Type op)
+{
+    switch(op) {
+        case Expr::Equals:
+            return u"="_s;
+        case Expr::Greater:
+            return u">"_s;
+        case Expr::GreaterEqual:
+            return u">="_s;
+        case Expr::Less:
+            return u"<"_s;
+        case Expr::LessEqual:
+            return u"<="_s;
+        case Expr::Before:
+            return u"BEFORE"_s;
+        case Expr::After:
+            return u"AFTER"_s;
+        case Expr::Since:
+            return u"SINCE"_s;
+        case Expr::During:
+            return u"DURING"_s;
+        default:
+            return u"?"_s;
+    }
+}
+
+QString residualName(const BoundExpression& expr)
+{
+    QString name;
+    switch(expr.type) {
+        case Expr::Literal:
+        case Expr::QuotedLiteral:
+            return u"search \"%1\""_s.arg(std::get<QString>(expr.value));
+        case Expr::Contains:
+            name = u"contains"_s;
+            break;
+        case Expr::Missing:
+            name = u"missing"_s;
+            break;
+        case Expr::Present:
+            name = u"present"_s;
+            break;
+        case Expr::Not:
+            name = u"not"_s;
+            break;
+        case Expr::Or:
+            name = u"or"_s;
+            break;
+        case Expr::XOr:
+            name = u"xor"_s;
+            break;
+        case Expr::Equals:
+        case Expr::Greater:
+        case Expr::GreaterEqual:
+        case Expr::Less:
+        case Expr::LessEqual:
+        case Expr::Before:
+        case Expr::After:
+        case Expr::Since:
+        case Expr::During:
+            name = operatorName(expr.type);
+            break;
+        default:
+            name = u"expression"_s;
+            break;
+    }
+
+    if(const auto* args = std::get_if<Fooyin::BoundExpressionList>(&expr.value)) {
+        if(!args->empty() && args->front().type == Expr::Variable) {
+            return std::get<QString>(args->front().value) + u' ' + name;
+        }
+    }
+
+    return name;
+}
+
+template <typename T>
+auto matchingRange(const std::vector<std::pair<T, int>>& column, Expr::Type op, T value)
+{
+    const auto lower = [&]() {
+        return std::ranges::lower_bound(column, value, {}, &std::pair<T, int>::first);
+    };
+    const auto upper = [&]() {
+        return std::ranges::upper_bound(column, value, {}, &std::pair<T, int>::first);
+    };
+
+    switch(op) {
+        case Expr::Greater:
+        case Expr::After:
+            return std::pair{upper(), column.end()};
+        case Expr::GreaterEqual:
+        case Expr::Since:
+            return std::pair{lower(), column.end()};
+        case Expr::Less:
+        case Expr::Before:
+            return std::pair{column.begin(), lower()};
+        case Expr::LessEqual:
+            return std::pair{column.begin(), upper()};
+        default:
+            return std::pair{column.end(), column.end()};
+    }
+}
+} // namespace
+
+namespace Fooyin {
+QString QueryPlanner::Plan::explain() const
+{
+    QStringList lines{u"QUERY PLAN"_s};
+
+    for(const Predicate& predicate : indexed) {
+        QString line;
+        switch(predicate.source) {
+            case Predicate::Source::Value:
+                line = u"INDEX %1 = \"%2\""_s.arg(predicate.field, predicate.value);
+                break;
+            case Predicate::Source::Number:
+                line = u"INDEX RANGE %1 %2 %3"_s.arg(predicate.field, operatorName(predicate.op))
+                           .arg(predicate.number);
+                break;
+            case Predicate::Source::Date:
+                line = predicate.op == Expr::During
+                         ? u"INDEX DATE %1 DURING (%2, %3)"_s.arg(predicate.field).arg(predicate.min).arg(predicate.max)
+                         : u"INDEX DATE %1 %2 %3"_s.arg(predicate.field, operatorName(predicate.op))
+                               .arg(predicate.min);
+                break;
+        }
+        if(!predicate.satisfiable) {
+            line += u" (never matches)"_s;
+        }
+        lines.append(u"  "_s + line);
+    }
+
+    for(const BoundExpression* expr : residual) {
+        lines.append(u"  SCAN "_s + residualName(*expr));
+    }
+
+    return lines.join(u'\n');
+}
+
+std::optional<bool> QueryPlanner::Matches::matches(const Track& track) const
+{
+    const auto id = indexedId(track, m_store);
+    if(!id || std::cmp_greater_equal(*id, m_tracks.size())) {
+        return {};
+    }
+
+    const auto pos         = static_cast<size_t>(*id);
+    const Track* indexedAs = m_tracks[pos];
+    if(!indexedAs || !indexedAs->sharesDataWith(track)) {
+        return {};
+    }
+
+    return m_matches[pos];
+}
+
+QueryPlanner::QueryPlanner(const ScriptRegistry* registry)
+    : m_registry{registry}
+    , m_store{nullptr}
+    , m_revision{0}
+{ }
+
+QueryPlanner::Plan QueryPlanner::plan(const BoundExpressionList& expressions) const
+{
+    Plan plan;
+    for(const auto& expr : expressions) {
+        collect(expr, plan);
+    }
+
+    if(!plan.indexed.empty()) {
+        qCDebug(QUERY_PLANNER).noquote() << plan.explain();
+    }
+
+    return plan;
+}
+
+QueryPlanner::Matches QueryPlanner::match(const Plan& plan, const std::vector<const Track*>& tracks,
+                                          const FieldEvaluator& evaluate)
+{
+    Matches result;
+    if(plan.indexed.empty() || tracks.empty()) {
+        return result;
+    }
+
+    const auto store = tracks.front()->metadataStore();
+    if(!store || store->revision() == 0) {
+        return result;
+    }
+
+    int maxId{-1};
+    for(const Track* track : tracks) {
+        if(const auto id = indexedId(*track, store.get())) {
+            maxId = std::max(maxId, *id);
+        }
+    }
+    if(maxId < 0) {
+        return result;
+    }
+
+    if(store.get() != m_store || store->revision() != m_revision) {
+        reset(store.get(), store->revision());
+    }
+
+    const auto size = static_cast<size_t>(maxId) + 1;
+    if(m_tracks.size() < size) {
+        m_tracks.resize(size);
+    }
+
+    result.m_store = store.get();
+    result.m_matches.assign(size, true);
+    result.m_tracks.assign(size, nullptr);
+
+    // Tracks which don't share data with the copy an id was indexed from may have been edited since
+    std::vector<const Track*> indexable;
+    indexable.reserve(tracks.size());
+
+    for(const Track* track : tracks) {
+        const auto id = indexedId(*track, m_store);
+        if(!id) {
+            continue;
+        }
+
+        const auto pos = static_cast<size_t>(*id);
+        Track& indexed = m_tracks[pos];
+        if(!indexed.isValid()) {
+            indexed = *track;
+        }
+        else if(!indexed.sharesDataWith(*track)) {
+            continue;
+        }
+
+        if(!result.m_tracks[pos]) {
+            result.m_tracks[pos] = track;
+            indexable.push_back(track);
+        }
+    }
+
+    std::vector<bool> hits;
+
+    for(const Predicate& predicate : plan.indexed) {
+        hits.assign(size, false);
+
+        if(predicate.satisfiable) {
+            FieldIndex& index = m_indexes[indexKey(predicate)];
+            extend(index, predicate, indexable, evaluate);
+
+            const auto mark = [&hits, size](int id) {
+                if(std::cmp_less(id, size)) {
+                    hits[static_cast<size_t>(id)] = true;
+                }
+            };
+
+            switch(predicate.source) {
+                case Predicate::Source::Value:
+                    if(const auto it = index.values.find(predicate.value); it != index.values.cend()) {
+                        std::ranges::for_each(it->second, mark);
+                    }
+                    break;
+                case Predicate::Source::Number: {
+                    const auto [first, last] = matchingRange(index.numbers, predicate.op, predicate.number);
+                    std::for_each(first, last, [&mark](const auto& entry) { mark(entry.second); });
+                    break;
+                }
+                case Predicate::Source::Date: {
+                    if(predicate.op == Expr::During) {
+                        const auto first = matchingRange(index.dates, Expr::After, predicate.min).first;
+                        const auto last  = matchingRange(index.dates, Expr::Before, predicate.max).second;
+                        if(first < last) {
+                            std::for_each(first, last, [&mark](const auto& entry) { mark(entry.second); });
+                        }
+                    }
+                    else {
+                        const auto [first, last] = matchingRange(index.dates, predicate.op, predicate.min);
+                        std::for_each(first, last, [&mark](const auto& entry) { mark(entry.second); });
+                    }
+                    break;
+                }
+            }
+        }
+
+        for(size_t i{0}; i < size; ++i) {
+            result.m_matches[i] = result.m_matches[i] && hits[i];
+        }
+    }
+
+    return result;
+}
+
+void QueryPlanner::clear()
+{
+    reset(nullptr, 0);
+}
+
+void QueryPlanner::reset(const TrackMetadataStore* store, uint64_t revision)
+{
+    m_store    = store;
+    m_revision = revision;
+    m_tracks.clear();
+    m_indexes.clear();
+}
+
+void QueryPlanner::collect(const BoundExpression& expr, Plan& plan) const
+{
+    if(expr.type == Expr::And || expr.type == Expr::Group) {
+        const auto& args = std::get<BoundExpressionList>(expr.value);
+        // AND only looks at its first two operands, and is never true with fewer
+        if(expr.type == Expr::Group || args.size() >= 2) {
+            const size_t count = expr.type == Expr::And ? 2 : args.size();
+            for(size_t i{0}; i < count; ++i) {
+                collect(args.at(i), plan);
+            }
+            return;
+        }
+    }
+
+    if(auto predicate = indexedPredicate(expr)) {
+        plan.indexed.push_back(std::move(*predicate));
+        return;
+    }
+
+    plan.residual.push_back(&expr);
+}
+
+std::optional<QueryPlanner::Predicate> QueryPlanner::indexedPredicate(const BoundExpression& expr) const
+{
+    switch(expr.type) {
+        case Expr::Equals:
+        case Expr::Greater:
+        case Expr::GreaterEqual:
+        case Expr::Less:
+        case Expr::LessEqual: {
+            const auto& args = std::get<BoundExpressionList>(expr.value);
+            if(args.size() < 2 || !isIndexedField(args.at(0)) || !isLiteral(args.at(1))) {
+                return {};
+            }
+
+            Predicate predicate;
+            predicate.op    = expr.type;
+            predicate.kind  = args.at(0).variableKind;
+            predicate.field = std::get<QString>(args.at(0).value);
+
+            const auto& operand = std::get<QString>(args.at(1).value);
+            if(expr.type == Expr::Equals) {
+                predicate.source = Predicate::Source::Value;
+                predicate.value  = operand.toCaseFolded();
+            }
+            else {
+                bool ok{false};
+                predicate.source      = Predicate::Source::Number;
+                predicate.number      = operand.toDouble(&ok);
+                predicate.satisfiable = ok && !std::isnan(predicate.number);
+            }
+            return predicate;
+        }
+        case Expr::Before:
+        case Expr::After:
+        case Expr::Since:
+        case Expr::During: {
+            const auto& args = std::get<BoundExpressionList>(expr.value);
+            if(args.empty() || args.front().type != Expr::Variable) {
+                return {};
+            }
+
+            Predicate predicate;
+            predicate.source = Predicate::Source::Date;
+            predicate.op     = expr.type;
+            predicate.field  = std::get<QString>(args.front().value);
+
+            const size_t operands = expr.type == Expr::During ? 2 : 1;
+            if(args.size() < operands + 1) {
+                predicate.satisfiable = false;
+                return predicate;
+            }
+
+            predicate.min = std::get<QString>(args.at(1).value).toLongLong();
+            if(expr.type == Expr::During) {
+                predicate.max = std::get<QString>(args.at(2).value).toLongLong();
+            }
+            return predicate;
+        }
+        default:
+            return {};
+    }
+}
+
+bool QueryPlanner::isIndexedField(const BoundExpression& field) const
+{
+    if(field.type != Expr::Variable || !isTrackMetadataKind(field.variableKind)) {
+        return false;
+    }
+
+    return !m_registry || !m_registry->hasCustomVariable(field.variableKind);
+}
+
+void QueryPlanner::extend(FieldIndex& index, const Predicate& predicate, const std::vector<const Track*>& tracks,
+                          const FieldEvaluator& evaluate) const
+{
+    for(const Track* track : tracks) {
+        const auto id = indexedId(*track, m_store);
+        if(!id) {
+            continue;
+        }
+
+        const auto pos = static_cast<size_t>(*id);
+        if(pos < index.indexed.size() && index.indexed[pos]) {
+            continue;
+        }
+        if(pos >= index.indexed.size()) {
+            index.indexed.resize(pos + 1, false);
+        }
+        index.indexed[pos] = true;
+
+        switch(predicate.source) {
+            case Predicate::Source::Value: {
+                const ScriptResult result = evaluate(predicate.kind, predicate.field, *track);
+                if(result.cond) {
+                    index.values[result.value.toCaseFolded()].push_back(*id);
+                }
+                break;
+            }
+            case Predicate::Source::Number: {
+                const ScriptResult result = evaluate(predicate.kind, predicate.field, *track);
+                if(!result.cond) {
+                    break;
+                }
+                bool ok{false};
+                const double number = result.value.toDouble(&ok);
+                if(ok && !std::isnan(number)) {
+                    index.numbers.emplace_back(number, *id);
+                    index.sorted = false;
+                }
+                break;
+            }
+            case Predicate::Source::Date:
+                if(const auto date = track->dateValue(predicate.field)) {
+                    index.dates.emplace_back(*date, *id);
+                    index.sorted = false;
+                }
+                break;
+        }
+    }
+
+    if(!index.sorted) {
+        std::ranges::sort(index.numbers);
+        std::ranges::sort(index.dates);
+        index.sorted = true;
+    }
+}
+} // namespace Fooyin
@@ -0,0 +1,142 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "scriptbinder.h"
+
+#include <core/track.h>
+
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Fooyin {
+class ScriptRegistry;
+class TrackMetadataStore;
+
+/*!
+ * Splits filter queries into indexed predicates and scripted residuals.
+ *
+ * Top-level query expressions, along with the operands of AND and group
+ * expressions, form a conjunction. Equality and range predicates on built-in
+ * track fields, and date predicates, are answered from per-field indexes; the
+ * rest are left to be evaluated by the script parser.
+ *
+ * Field indexes are built lazily from the tracks being filtered. They are only
+ * kept for tracks of a library-maintained TrackMetadataStore, and are rebuilt
+ * once the store's revision changes. Each id is indexed from the first copy of
+ * its track seen in a revision; copies which don't share that copy's data, such
+ * as edited or playlist-local tracks, are evaluated directly instead.
+ */
+class QueryPlanner
+{
+public:
+    struct Predicate
+    {
+        enum class Source : uint8_t
+        {
+            Value = 0,
+            Number,
+            Date,
+        };
+
+        Source source{Source::Value};
+        Expr::Type op{Expr::Null};
+        VariableKind kind{VariableKind::Generic};
+        QString field;
+        //! Case-folded value for equality predicates
+        QString value;
+        double number{0.0};
+        int64_t min{0};
+        int64_t max{0};
+        //! False if the operand means the predicate can never match
+        bool satisfiable{true};
+    };
+
+    struct Plan
+    {
+        std::vector<Predicate> indexed;
+        //! Points into the bound expressions the plan was made from
+        std::vector<const BoundExpression*> residual;
+
+        //! Returns a readable description of the plan for debugging.
+        [[nodiscard]] QString explain() const;
+    };
+
+    /*!
+     * Result of the indexed predicates of a plan for a set of tracks.
+     */
+    class Matches
+    {
+    public:
+        /*!
+         * Returns whether @p track passes every indexed predicate, or `std::nullopt`
+         * if it isn't indexed and every query expression must be evaluated.
+         * Only valid while the tracks passed to `match()` are alive.
+         */
+        [[nodiscard]] std::optional<bool> matches(const Track& track) const;
+
+    private:
+        friend class QueryPlanner;
+
+        const TrackMetadataStore* m_store{nullptr};
+        std::vector<bool> m_matches;
+        //! The track each id's result was computed for, or null if it couldn't be answered from the indexes
+        std::vector<const Track*> m_tracks;
+    };
+
+    using FieldEvaluator = std::function<ScriptResult(VariableKind kind, const QString& field, const Track& track)>;
+
+    explicit QueryPlanner(const ScriptRegistry* registry);
+
+    [[nodiscard]] Plan plan(const BoundExpressionList& expressions) const;
+    //! Evaluates the indexed predicates of @p plan, extending field indexes with @p tracks as needed.
+    [[nodiscard]] Matches match(const Plan& plan, const std::vector<const Track*>& tracks,
+                                const FieldEvaluator& evaluate);
+
+    void clear();
+
+private:
+    struct FieldIndex
+    {
+        std::vector<bool> indexed;
+        std::unordered_map<QString, std::vector<int>> values;
+        std::vector<std::pair<double, int>> numbers;
+        std::vector<std::pair<int64_t, int>> dates;
+        bool sorted{true};
+    };
+
+    void collect(const BoundExpression& expr, Plan& plan) const;
+    [[nodiscard]] std::optional<Predicate> indexedPredicate(const BoundExpression& expr) const;
+    [[nodiscard]] bool isIndexedField(const BoundExpression& field) const;
+
+    void reset(const TrackMetadataStore* store, uint64_t revision);
+    void extend(FieldIndex& index, const Predicate& predicate, const std::vector<const Track*>& tracks,
+                const FieldEvaluator& evaluate) const;
+
+    const ScriptRegistry* m_registry;
+    const TrackMetadataStore* m_store;
+    uint64_t m_revision;
+    //! Copies of the tracks the field indexes were built from, by id
+    std::vector<Track> m_tracks;
+    std::unordered_map<QString, FieldIndex> m_indexes;
+};
+} // namespace Fooyin
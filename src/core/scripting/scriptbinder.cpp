@@ -358,6 +358,10 @@ BoundScript bindScript(const ParsedScript& script, const ScriptRegistry* registr
         bound.expressions.emplace_back(bindExpression(expr, registry));
     }
 
+    if(bound.isValid()) {
+        bound.program = compileScript(bound.expressions);
+    }
+
     return bound;
 }
 } // namespace Fooyin
@@ -21,6 +21,8 @@
 
 #include "fycore_export.h"
 
+#include "scriptprogram.h"
+
 #include <core/scripting/expression.h>
 #include <core/scripting/scriptparser.h>
 
@@ -51,6 +53,7 @@ struct FYCORE_EXPORT BoundScript
 {
     QString input;
     BoundExpressionList expressions;
+    ScriptProgram program;
     ErrorList errors;
 
     [[nodiscard]] bool isValid() const
@@ -19,6 +19,7 @@
 
 #include <core/scripting/scriptparser.h>
 
+#include "queryplanner.h"
 #include "scriptbinder.h"
 #include "scriptcache.h"
 #include "scriptregistry.h"
@@ -27,6 +28,7 @@
 #include <core/library/tracksort.h>
 #include <core/scripting/scriptscanner.h>
 #include <core/track.h>
+#include <core/trackmetadatastore.h>
 #include <utils/helpers.h>
 #include <utils/stringutils.h>
 #include <utils/utils.h>
@@ -35,6 +37,7 @@
 #include <QDebug>
 
 #include <atomic>
+#include <optional>
 
 using namespace Qt::StringLiterals;
 
@@ -116,24 +119,6 @@ Fooyin::ScriptScanner::WhitespaceMode whitespaceMode(Fooyin::ScriptWhitespaceMod
     return Fooyin::ScriptScanner::WhitespaceMode::IgnoreLayout;
 }
 
-QStringList evalStringList(const Fooyin::ScriptResult& evalExpr, const QStringList& result)
-{
-    QStringList listResult;
-    const QStringList values = evalExpr.value.split(QLatin1String{Fooyin::Constants::UnitSeparator});
-    const bool isEmpty       = result.empty();
-
-    for(const QString& value : values) {
-        if(isEmpty) {
-            listResult.append(value);
-        }
-        else {
-            std::ranges::transform(result, std::back_inserter(listResult),
-                                   [&](const QString& retValue) -> QString { return retValue + value; });
-        }
-    }
-    return listResult;
-}
-
 bool matchSearch(const Fooyin::Track& track, const QString& search, bool singleString)
 {
     if(search.isEmpty()) {
@@ -148,6 +133,63 @@ bool matchSearch(const Fooyin::Track& track, const QString& search, bool singleS
     return std::ranges::all_of(terms, [&track](const QString& term) { return track.hasMatch(term); });
 }
 
+/*!
+ * Plain search prepared once per query rather than per track.
+ *
+ * Uses the search index of the metadata store shared by the tracks being filtered,
+ * falling back to matchSearch for tracks which aren't indexed.
+ */
+class SearchMatcher
+{
+public:
+    SearchMatcher(const QString& search, bool singleString, std::shared_ptr<Fooyin::TrackMetadataStore> store)
+        : m_search{search}
+        , m_singleString{singleString}
+        , m_store{std::move(store)}
+    {
+        if(m_search.isEmpty() || !m_store || m_store->searchIndex().isEmpty()) {
+            return;
+        }
+
+        const QStringList terms = m_singleString ? QStringList{m_search} : m_search.split(u' ', Qt::SkipEmptyParts);
+        if(!terms.empty()) {
+            m_query = m_store->searchIndex().prepare(terms);
+        }
+    }
+
+    bool operator()(const Fooyin::Track& track) const
+    {
+        if(m_query && track.metadataStore() == m_store) {
+            if(const auto matches = m_query->matches(track)) {
+                return *matches;
+            }
+        }
+
+        return matchSearch(track, m_search, m_singleString);
+    }
+
+private:
+    QString m_search;
+    bool m_singleString;
+    std::shared_ptr<Fooyin::TrackMetadataStore> m_store;
+    std::optional<Fooyin::TrackSearchIndex::Query> m_query;
+};
+
+template <typename TrackListType>
+std::shared_ptr<Fooyin::TrackMetadataStore> searchStore(const TrackListType& tracks)
+{
+    if(tracks.empty()) {
+        return {};
+    }
+
+    if constexpr(std::is_same_v<TrackListType, Fooyin::PlaylistTrackList>) {
+        return tracks.front().track.metadataStore();
+    }
+    else {
+        return tracks.front().metadataStore();
+    }
+}
+
 bool isQueryExpression(Fooyin::Expr::Type type)
 {
     using Type = Fooyin::Expr::Type;
@@ -267,6 +309,14 @@ public:
     ScriptResult evalLimit(const BoundExpression& exp);
     ScriptResult evalSort(const BoundExpression& exp);
 
+    ScriptResult variableValue(VariableKind kind, const QString& var, const auto& tracks);
+    ScriptResult rawVariableValue(const QString& var, const auto& tracks);
+    ScriptResult getVariable(const QString& name) const;
+    ScriptResult putVariable(const QString& name, const QString& value, bool output);
+
+    void runProgram(const ScriptProgram& program, const auto& tracks);
+    void appendResult(const ScriptResult& evalExpr);
+
     ParsedScript parse(const QString& input,
                        ScriptScanner::WhitespaceMode whitespaceMode = ScriptScanner::WhitespaceMode::IgnoreLayout);
     ParsedScript parseQuery(const QString& input);
@@ -305,6 +355,10 @@ public:
     BoundScriptCache m_boundQueryCache;
     BoundScript m_currentBoundScript;
     QStringList m_currentResult;
+    QueryPlanner m_queryPlanner;
+    bool m_compilationEnabled{true};
+    std::vector<ScriptSlot> m_registers;
+    std::vector<const ScriptSlot*> m_slotArgs;
 
     QString m_sortScript;
     Qt::SortOrder m_sortOrder{Qt::AscendingOrder};
@@ -316,6 +370,7 @@ public:
 ScriptParserPrivate::ScriptParserPrivate(ScriptParser* self)
     : m_self{self}
     , m_registry{std::make_unique<ScriptRegistry>()}
+    , m_queryPlanner{m_registry.get()}
 { }
 
 void ScriptParserPrivate::advance()
@@ -1013,8 +1068,12 @@ ScriptResult ScriptParserPrivate::evalLiteral(const BoundExpression& exp)
 
 ScriptResult ScriptParserPrivate::evalVariable(const BoundExpression& exp, const auto& tracks)
 {
-    const auto& var     = std::get<QString>(exp.value);
-    ScriptResult result = m_registry->value(exp.variableKind, var, makeScriptSubject(tracks));
+    return variableValue(exp.variableKind, std::get<QString>(exp.value), tracks);
+}
+
+ScriptResult ScriptParserPrivate::variableValue(VariableKind kind, const QString& var, const auto& tracks)
+{
+    ScriptResult result = m_registry->value(kind, var, makeScriptSubject(tracks));
 
     if(!result.cond) {
         return {};
@@ -1035,8 +1094,11 @@ ScriptResult ScriptParserPrivate::evalVariableList(const BoundExpression& exp, c
 
 ScriptResult ScriptParserPrivate::evalVariableRaw(const BoundExpression& exp, const auto& tracks)
 {
-    const auto& var = std::get<QString>(exp.value);
+    return rawVariableValue(std::get<QString>(exp.value), tracks);
+}
 
+ScriptResult ScriptParserPrivate::rawVariableValue(const QString& var, const auto& tracks)
+{
     ScriptResult result;
     if constexpr(std::is_same_v<std::decay_t<decltype(tracks)>, Track>) {
         result.value = tracks.metaValue(var);
@@ -1057,6 +1119,31 @@ ScriptResult ScriptParserPrivate::evalVariableRaw(const BoundExpression& exp, co
     return result;
 }
 
+ScriptResult ScriptParserPrivate::getVariable(const QString& name) const
+{
+    const QString variableName = name.trimmed().toLower();
+    if(variableName.isEmpty()) {
+        return {};
+    }
+
+    if(const auto it = m_variables.find(variableName); it != m_variables.cend()) {
+        return {.value = it->second, .cond = !it->second.isEmpty()};
+    }
+
+    return {};
+}
+
+ScriptResult ScriptParserPrivate::putVariable(const QString& name, const QString& value, bool output)
+{
+    m_variables.insert_or_assign(name, value);
+
+    if(output) {
+        return {.value = value, .cond = !value.isEmpty()};
+    }
+
+    return {.value = QString{}, .cond = false};
+}
+
 ScriptResult ScriptParserPrivate::evalFunction(const BoundExpression& exp, const auto& tracks)
 {
     const auto& func = std::get<BoundFunctionValue>(exp.value);
@@ -1071,16 +1158,7 @@ ScriptResult ScriptParserPrivate::evalFunction(const BoundExpression& exp, const
                 return {};
             }
 
-            const QString variableName = evalExpression(func.args.at(0), tracks).value.trimmed().toLower();
-            if(variableName.isEmpty()) {
-                return {};
-            }
-
-            if(const auto it = m_variables.find(variableName); it != m_variables.cend()) {
-                return {.value = it->second, .cond = !it->second.isEmpty()};
-            }
-
-            return {};
+            return getVariable(evalExpression(func.args.at(0), tracks).value);
         }
         case FunctionKind::Put:
         case FunctionKind::Puts: {
@@ -1094,13 +1172,7 @@ ScriptResult ScriptParserPrivate::evalFunction(const BoundExpression& exp, const
             }
 
             const ScriptResult value = evalExpression(func.args.at(1), tracks);
-            m_variables.insert_or_assign(variableName, value.value);
-
-            if(func.kind == FunctionKind::Put) {
-                return {.value = value.value, .cond = !value.value.isEmpty()};
-            }
-
-            return {.value = QString{}, .cond = false};
+            return putVariable(variableName, value.value, func.kind == FunctionKind::Put);
         }
         case FunctionKind::If: {
             const auto size = func.args.size();
@@ -1377,7 +1449,7 @@ ScriptResult ScriptParserPrivate::evalConditional(const BoundExpression& exp, co
             }
         }
         if(subExpr.value.contains(QLatin1String{Constants::UnitSeparator})) {
-            const QStringList evalList = evalStringList(subExpr, exprResult);
+            const QStringList evalList = Scripting::evalStringList(subExpr, exprResult);
             if(!evalList.empty()) {
                 exprResult = evalList;
             }
@@ -1732,6 +1804,186 @@ const BoundScript& ScriptParserPrivate::bind(const ParsedScript& input)
     return *cache.find(input.cacheId);
 }
 
+void ScriptParserPrivate::runProgram(const ScriptProgram& program, const auto& tracks)
+{
+    m_registers.resize(program.registerCount);
+
+    const auto reg    = [this](uint32_t index) -> const ScriptSlot& { return m_registers[index]; };
+    const auto gather = [this, &program](const ScriptInstruction& instruction) {
+        m_slotArgs.clear();
+        for(uint32_t i{0}; i < instruction.b; ++i) {
+            m_slotArgs.push_back(&m_registers[program.args[instruction.a + i]]);
+        }
+        return Scripting::SlotArgs{m_slotArgs};
+    };
+
+    const size_t size = program.code.size();
+    size_t pc{0};
+
+    while(pc < size) {
+        const ScriptInstruction& instruction = program.code[pc++];
+        ScriptSlot& dst                      = m_registers[instruction.dst];
+
+        switch(instruction.op) {
+            case ScriptOp::LoadConst:
+                dst = program.constants[instruction.a];
+                break;
+            case ScriptOp::LoadField:
+                if constexpr(std::is_same_v<std::decay_t<decltype(tracks)>, Track>) {
+                    if(!m_registry->hasCustomVariable(instruction.kind)) {
+                        dst = Scripting::trackField(instruction.kind, tracks);
+                        break;
+                    }
+                }
+                [[fallthrough]];
+            case ScriptOp::LoadVariable:
+                dst = ScriptSlot::fromResult(variableValue(instruction.kind, program.names[instruction.a], tracks));
+                break;
+            case ScriptOp::LoadVariableList:
+                dst = ScriptSlot::fromResult(
+                    m_registry->value(instruction.kind, program.names[instruction.a], makeScriptSubject(tracks)));
+                break;
+            case ScriptOp::LoadVariableRaw:
+                dst = ScriptSlot::fromResult(rawVariableValue(program.names[instruction.a], tracks));
+                break;
+            case ScriptOp::Call: {
+                ScriptValueList args;
+                args.reserve(instruction.b);
+                for(uint32_t i{0}; i < instruction.b; ++i) {
+                    args.push_back(m_registers[program.args[instruction.a + i]].toResult());
+                }
+                dst = ScriptSlot::fromResult(m_registry->function(instruction.target, program.names[instruction.c],
+                                                                  args, makeScriptSubject(tracks)));
+                break;
+            }
+            case ScriptOp::Get:
+                dst = ScriptSlot::fromResult(getVariable(reg(instruction.a).toString()));
+                break;
+            case ScriptOp::Put:
+                dst = ScriptSlot::fromResult(
+                    putVariable(program.names[instruction.a], reg(instruction.b).toString(), instruction.c == 0));
+                break;
+            case ScriptOp::Move:
+                dst = reg(instruction.a);
+                break;
+            case ScriptOp::Clear:
+                dst = {};
+                break;
+            case ScriptOp::Present: {
+                const ScriptSlot& value = reg(instruction.a);
+                if(instruction.c == 0 && (!value.cond || value.isEmpty())) {
+                    dst = {};
+                }
+                else {
+                    dst      = value;
+                    dst.cond = true;
+                }
+                break;
+            }
+            case ScriptOp::Arithmetic:
+                dst = Scripting::evalArithmetic(static_cast<FunctionKind>(instruction.c), gather(instruction));
+                break;
+            case ScriptOp::Mod:
+                dst = Scripting::evalMod(gather(instruction));
+                break;
+            case ScriptOp::Num:
+                dst = Scripting::evalNum(gather(instruction));
+                break;
+            case ScriptOp::Pad:
+                dst = Scripting::evalPad(static_cast<FunctionKind>(instruction.c), gather(instruction));
+                break;
+            case ScriptOp::Concat:
+                dst = Scripting::evalConcat(gather(instruction));
+                break;
+            case ScriptOp::Join:
+                dst = Scripting::evalJoin(gather(instruction));
+                break;
+            case ScriptOp::Jump:
+                pc = instruction.target;
+                break;
+            case ScriptOp::JumpIfTrue:
+                if(reg(instruction.a).cond) {
+                    pc = instruction.target;
+                }
+                break;
+            case ScriptOp::JumpIfFalse:
+                if(!reg(instruction.a).cond) {
+                    pc = instruction.target;
+                }
+                break;
+            case ScriptOp::JumpIfAbsent: {
+                const ScriptSlot& value = reg(instruction.a);
+                if(!value.cond || value.isEmpty()) {
+                    pc = instruction.target;
+                }
+                break;
+            }
+            case ScriptOp::JumpIfNotNumber: {
+                bool ok{false};
+                static_cast<void>(reg(instruction.a).toDouble(&ok));
+                if(!ok) {
+                    pc = instruction.target;
+                }
+                break;
+            }
+            case ScriptOp::JumpIfNotLength: {
+                bool ok{false};
+                const int len = reg(instruction.a).toInt(&ok);
+                if(!ok || len < 0) {
+                    pc = instruction.target;
+                }
+                break;
+            }
+            case ScriptOp::JumpIfNotLongLong: {
+                bool ok{false};
+                static_cast<void>(reg(instruction.a).toLongLong(&ok));
+                if(!ok) {
+                    pc = instruction.target;
+                }
+                break;
+            }
+            case ScriptOp::JumpIfNotEqual:
+                if(reg(instruction.a).toDouble() != reg(instruction.b).toDouble()) {
+                    pc = instruction.target;
+                }
+                break;
+            case ScriptOp::JumpIfNotGreater:
+                if(!(reg(instruction.a).toDouble() > reg(instruction.b).toDouble())) {
+                    pc = instruction.target;
+                }
+                break;
+            case ScriptOp::JumpIfShorter:
+                if(reg(instruction.a).toString().size() < reg(instruction.b).toLongLong()) {
+                    pc = instruction.target;
+                }
+                break;
+        }
+    }
+}
+
+void ScriptParserPrivate::appendResult(const ScriptResult& evalExpr)
+{
+    if(evalExpr.value.isNull()) {
+        return;
+    }
+
+    if(evalExpr.value.contains(QLatin1String{Constants::UnitSeparator})) {
+        const QStringList evalList = Scripting::evalStringList(evalExpr, m_currentResult);
+        if(!evalList.empty()) {
+            m_currentResult = evalList;
+        }
+    }
+    else {
+        if(m_currentResult.empty()) {
+            m_currentResult.push_back(evalExpr.value);
+        }
+        else {
+            std::ranges::transform(m_currentResult, m_currentResult.begin(),
+                                   [&](const QString& retValue) -> QString { return retValue + evalExpr.value; });
+        }
+    }
+}
+
 QString ScriptParserPrivate::evaluate(const ParsedScript& input, const auto& tracks)
 {
     if(!input.isValid()) {
@@ -1745,28 +1997,15 @@ QString ScriptParserPrivate::evaluate(const ParsedScript& input, const auto& tra
 
     reset();
 
-    const auto& expressions = bound.expressions;
-    for(const auto& expr : expressions) {
-        const auto evalExpr = evalExpression(expr, tracks);
-
-        if(evalExpr.value.isNull()) {
-            continue;
-        }
-
-        if(evalExpr.value.contains(QLatin1String{Constants::UnitSeparator})) {
-            const QStringList evalList = evalStringList(evalExpr, m_currentResult);
-            if(!evalList.empty()) {
-                m_currentResult = evalList;
-            }
+    if(m_compilationEnabled && bound.program.isValid()) {
+        runProgram(bound.program, tracks);
+        for(const uint16_t root : bound.program.roots) {
+            appendResult(m_registers[root].toResult());
         }
-        else {
-            if(m_currentResult.empty()) {
-                m_currentResult.push_back(evalExpr.value);
-            }
-            else {
-                std::ranges::transform(m_currentResult, m_currentResult.begin(),
-                                       [&](const QString& retValue) -> QString { return retValue + evalExpr.value; });
-            }
+    }
+    else {
+        for(const auto& expr : bound.expressions) {
+            appendResult(evalExpression(expr, tracks));
         }
     }
 
@@ -1798,17 +2037,20 @@ TrackListType ScriptParserPrivate::evaluateQuery(const ParsedScript& input, cons
     reset();
     TrackListType filteredTracks;
 
+    const auto store = searchStore(tracks);
+
     if(bound.expressions.size() == 1) {
         const auto& firstExpr = bound.expressions.front();
         if(firstExpr.type == Expr::Literal || firstExpr.type == Expr::QuotedLiteral) {
             // Simple search query - just match all terms in metadata/filepath
-            const auto& search = std::get<QString>(firstExpr.value);
-            filteredTracks     = Utils::filter(tracks, [&search, &firstExpr](const auto& track) {
+            const SearchMatcher matcher{std::get<QString>(firstExpr.value), firstExpr.type == Expr::QuotedLiteral,
+                                        store};
+            filteredTracks = Utils::filter(tracks, [&matcher](const auto& track) {
                 if constexpr(std::is_same_v<TrackListType, PlaylistTrackList>) {
-                    return matchSearch(track.track, search, firstExpr.type == Expr::QuotedLiteral);
+                    return matcher(track.track);
                 }
                 else {
-                    return matchSearch(track, search, firstExpr.type == Expr::QuotedLiteral);
+                    return matcher(track);
                 }
             });
         }
@@ -1818,26 +2060,56 @@ TrackListType ScriptParserPrivate::evaluateQuery(const ParsedScript& input, cons
     }
 
     if(filteredTracks.empty()) {
-        for(const auto& track : tracks) {
-            const bool matches = std::ranges::all_of(bound.expressions, [&](const auto& expr) {
-                if(expr.type == Expr::Literal || expr.type == Expr::QuotedLiteral) {
-                    // Assume simple search query
-                    const auto& search = std::get<QString>(expr.value);
-                    if constexpr(std::is_same_v<TrackListType, PlaylistTrackList>) {
-                        return matchSearch(track.track, search, expr.type == Expr::QuotedLiteral);
-                    }
-                    else {
-                        return matchSearch(track, search, expr.type == Expr::QuotedLiteral);
-                    }
-                }
+        const auto trackOf = [](const auto& track) -> const Track& {
+            if constexpr(std::is_same_v<TrackListType, PlaylistTrackList>) {
+                return track.track;
+            }
+            else {
+                return track;
+            }
+        };
 
-                if constexpr(std::is_same_v<TrackListType, PlaylistTrackList>) {
-                    return evalExpression(expr, track.track).cond;
-                }
-                else {
-                    return evalExpression(expr, track).cond;
-                }
-            });
+        // Literal expressions are plain searches; prepare them once for all tracks
+        std::unordered_map<const BoundExpression*, SearchMatcher> matchers;
+        for(const auto& expr : bound.expressions) {
+            if(expr.type == Expr::Literal || expr.type == Expr::QuotedLiteral) {
+                matchers.try_emplace(&expr, std::get<QString>(expr.value), expr.type == Expr::QuotedLiteral, store);
+            }
+        }
+
+        const auto matchesExpr = [&](const BoundExpression& expr, const Track& track) {
+            if(const auto it = matchers.find(&expr); it != matchers.cend()) {
+                return it->second(track);
+            }
+            return evalExpression(expr, track).cond;
+        };
+
+        const QueryPlanner::Plan plan = m_queryPlanner.plan(bound.expressions);
+
+        QueryPlanner::Matches indexMatches;
+        if(!plan.indexed.empty()) {
+            std::vector<const Track*> trackPtrs;
+            trackPtrs.reserve(tracks.size());
+            for(const auto& track : tracks) {
+                trackPtrs.push_back(&trackOf(track));
+            }
+            indexMatches = m_queryPlanner.match(
+                plan, trackPtrs, [this](VariableKind kind, const QString& field, const Track& track) {
+                    return variableValue(kind, field, track);
+                });
+        }
+
+        for(const auto& track : tracks) {
+            bool matches{false};
+            if(const auto indexed = indexMatches.matches(trackOf(track))) {
+                matches = *indexed && std::ranges::all_of(plan.residual, [&](const BoundExpression* expr) {
+                              return matchesExpr(*expr, trackOf(track));
+                          });
+            }
+            else {
+                matches = std::ranges::all_of(bound.expressions,
+                                              [&](const auto& expr) { return matchesExpr(expr, trackOf(track)); });
+            }
 
             if(matches) {
                 filteredTracks.emplace_back(track);
@@ -2251,6 +2523,26 @@ PlaylistTrackList ScriptParser::filter(const ParsedScript& input, const Playlist
     return p->evaluateQuery(input, tracks);
 }
 
+QString ScriptParser::explainQuery(const QString& input)
+{
+    if(input.isEmpty()) {
+        return {};
+    }
+
+    auto script = parseQuery(input);
+    if(!canEvaluateAsQuery(script)) {
+        script = makeLiteralQuery(input);
+    }
+
+    p->m_isQuery             = true;
+    const BoundScript& bound = p->bind(script);
+    if(!bound.isValid()) {
+        return {};
+    }
+
+    return p->m_queryPlanner.plan(bound.expressions).explain();
+}
+
 int ScriptParser::cacheLimit() const
 {
     return p->m_scriptCache.limit();
@@ -2270,5 +2562,16 @@ void ScriptParser::clearCache()
     p->m_queryCache.clear();
     p->m_boundScriptCache.clear();
     p->m_boundQueryCache.clear();
+    p->m_queryPlanner.clear();
+}
+
+bool ScriptParser::compilationEnabled() const
+{
+    return p->m_compilationEnabled;
+}
+
+void ScriptParser::setCompilationEnabled(bool enabled)
+{
+    p->m_compilationEnabled = enabled;
 }
 } // namespace Fooyin
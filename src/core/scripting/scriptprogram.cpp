@@ -0,0 +1,978 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scriptprogram.h"
+
+#include "scriptbinder.h"
+
+#include <core/constants.h>
+#include <core/track.h>
+#include <utils/stringutils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <ranges>
+
+namespace {
+using namespace Fooyin;
+
+// QString::number(double) keeps six significant digits, so only whole values below
+// a million survive the string round trip the interpreter makes.
+bool isExactFloat(double value)
+{
+    return std::abs(value) < 1e6 && value == std::trunc(value);
+}
+
+ScriptSlot stringSlot(QString value)
+{
+    const bool cond = !value.isEmpty();
+    return ScriptSlot::fromResult({.value = std::move(value), .cond = cond});
+}
+
+ScriptSlot fromUnsigned(uint64_t value)
+{
+    if(value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        return ScriptSlot::fromInt(static_cast<int64_t>(value));
+    }
+    return ScriptSlot::fromResult({.value = QString::number(value), .cond = true});
+}
+
+bool isLiteral(const BoundExpression& expr)
+{
+    return expr.type == Expr::Literal || expr.type == Expr::QuotedLiteral;
+}
+
+// A compiled expression: either the register holding its result or a folded constant
+struct Operand
+{
+    uint16_t reg{0};
+    std::optional<ScriptSlot> constant;
+};
+
+class ScriptCompiler
+{
+public:
+    ScriptProgram compileProgram(const BoundExpressionList& expressions)
+    {
+        std::vector<uint16_t> roots;
+        roots.reserve(expressions.size());
+
+        for(const auto& expr : expressions) {
+            const Operand result = compile(expr);
+            roots.push_back(reg(result));
+        }
+
+        if(m_failed) {
+            return {};
+        }
+
+        m_program.roots = std::move(roots);
+        return std::move(m_program);
+    }
+
+private:
+    static Operand constant(ScriptSlot slot)
+    {
+        return {.reg = 0, .constant = std::move(slot)};
+    }
+
+    Operand unsupported()
+    {
+        m_failed = true;
+        return constant({});
+    }
+
+    uint16_t allocate()
+    {
+        if(m_program.registerCount == std::numeric_limits<uint16_t>::max()) {
+            m_failed = true;
+            return 0;
+        }
+        return m_program.registerCount++;
+    }
+
+    size_t emit(const ScriptInstruction& instruction)
+    {
+        m_program.code.push_back(instruction);
+        return m_program.code.size() - 1;
+    }
+
+    void patch(size_t jump)
+    {
+        m_program.code[jump].target = static_cast<uint32_t>(m_program.code.size());
+    }
+
+    uint32_t addConstant(ScriptSlot slot)
+    {
+        m_program.constants.push_back(std::move(slot));
+        return static_cast<uint32_t>(m_program.constants.size() - 1);
+    }
+
+    uint32_t addName(const QString& name)
+    {
+        m_program.names.push_back(name);
+        return static_cast<uint32_t>(m_program.names.size() - 1);
+    }
+
+    void loadTo(uint16_t dst, const Operand& operand)
+    {
+        if(operand.constant) {
+            emit({.op = ScriptOp::LoadConst, .dst = dst, .a = addConstant(*operand.constant)});
+        }
+        else {
+            emit({.op = ScriptOp::Move, .dst = dst, .a = operand.reg});
+        }
+    }
+
+    uint16_t reg(const Operand& operand)
+    {
+        if(!operand.constant) {
+            return operand.reg;
+        }
+
+        const uint16_t dst = allocate();
+        loadTo(dst, operand);
+        return dst;
+    }
+
+    std::vector<Operand> compileAll(const BoundExpressionList& exprs)
+    {
+        std::vector<Operand> operands;
+        operands.reserve(exprs.size());
+        for(const auto& expr : exprs) {
+            operands.push_back(compile(expr));
+        }
+        return operands;
+    }
+
+    static bool allConstant(const std::vector<Operand>& operands)
+    {
+        return std::ranges::all_of(operands, [](const Operand& operand) { return operand.constant.has_value(); });
+    }
+
+    static std::vector<const ScriptSlot*> constantArgs(const std::vector<Operand>& operands)
+    {
+        std::vector<const ScriptSlot*> args;
+        args.reserve(operands.size());
+        for(const auto& operand : operands) {
+            args.push_back(&*operand.constant);
+        }
+        return args;
+    }
+
+    //! Emits a range instruction over the operands, or folds it if every operand is constant.
+    Operand fold(ScriptOp op, const std::vector<Operand>& operands, uint32_t c, const auto& evaluate)
+    {
+        if(allConstant(operands)) {
+            return constant(evaluate(Scripting::SlotArgs{constantArgs(operands)}));
+        }
+
+        const auto offset = static_cast<uint32_t>(m_program.args.size());
+        for(const auto& operand : operands) {
+            const uint16_t arg = reg(operand);
+            m_program.args.push_back(arg);
+        }
+
+        const uint16_t dst = allocate();
+        emit({.op    = op,
+              .dst   = dst,
+              .a     = offset,
+              .b     = static_cast<uint32_t>(operands.size()),
+              .c     = c});
+        return {.reg = dst};
+    }
+
+    //! Finishes a branch started by a conditional jump taken when the test fails.
+    Operand branch(size_t jump, const BoundExpression& then, const BoundExpression* otherwise)
+    {
+        const uint16_t dst = allocate();
+        loadTo(dst, compile(then));
+        const size_t end = emit({.op = ScriptOp::Jump});
+
+        patch(jump);
+        if(otherwise) {
+            loadTo(dst, compile(*otherwise));
+        }
+        else {
+            emit({.op = ScriptOp::Clear, .dst = dst});
+        }
+        patch(end);
+
+        return {.reg = dst};
+    }
+
+    //! Clears the result of a guarded instruction when its guard jump was taken.
+    Operand guarded(std::optional<size_t> guard, const Operand& result)
+    {
+        if(!guard) {
+            return result;
+        }
+
+        const uint16_t dst = reg(result);
+        const size_t end   = emit({.op = ScriptOp::Jump});
+        patch(*guard);
+        emit({.op = ScriptOp::Clear, .dst = dst});
+        patch(end);
+
+        return {.reg = dst};
+    }
+
+    Operand load(ScriptOp op, const BoundExpression& expr)
+    {
+        const uint16_t dst = allocate();
+        emit({.op = op, .kind = expr.variableKind, .dst = dst, .a = addName(std::get<QString>(expr.value))});
+        return {.reg = dst};
+    }
+
+    Operand compile(const BoundExpression& expr)
+    {
+        switch(expr.type) {
+            case Expr::Literal:
+            case Expr::QuotedLiteral:
+                return constant(ScriptSlot::fromResult({.value = std::get<QString>(expr.value), .cond = true}));
+            case Expr::Variable:
+                return load(Scripting::isTrackField(expr.variableKind) ? ScriptOp::LoadField : ScriptOp::LoadVariable,
+                            expr);
+            case Expr::VariableList:
+                return load(ScriptOp::LoadVariableList, expr);
+            case Expr::VariableRaw:
+                return load(ScriptOp::LoadVariableRaw, expr);
+            case Expr::Function:
+                return compileFunction(std::get<BoundFunctionValue>(expr.value));
+            case Expr::FunctionArg:
+                return compileFunctionArg(std::get<BoundExpressionList>(expr.value));
+            case Expr::Conditional:
+                return compileConditional(std::get<BoundExpressionList>(expr.value));
+            case Expr::Null:
+                return constant({});
+            default:
+                return unsupported();
+        }
+    }
+
+    Operand compileFunction(const BoundFunctionValue& func)
+    {
+        const auto& args = func.args;
+        const auto size  = args.size();
+
+        switch(func.kind) {
+            case FunctionKind::Get: {
+                if(size != 1) {
+                    return constant({});
+                }
+                const uint16_t name = reg(compile(args.front()));
+                const uint16_t dst  = allocate();
+                emit({.op = ScriptOp::Get, .dst = dst, .a = name});
+                return {.reg = dst};
+            }
+            case FunctionKind::Put:
+            case FunctionKind::Puts: {
+                if(size != 2) {
+                    return constant({});
+                }
+                // The value isn't evaluated for empty names, so only constant names are compiled
+                const Operand name = compile(args.front());
+                if(!name.constant) {
+                    return unsupported();
+                }
+                const QString variableName = name.constant->toString().trimmed().toLower();
+                if(variableName.isEmpty()) {
+                    return constant({});
+                }
+                const uint16_t value = reg(compile(args.back()));
+                const uint16_t dst   = allocate();
+                emit({.op  = ScriptOp::Put,
+                      .dst = dst,
+                      .a   = addName(variableName),
+                      .b   = value,
+                      .c   = func.kind == FunctionKind::Puts ? 1U : 0U});
+                return {.reg = dst};
+            }
+            case FunctionKind::If: {
+                if(size < 2 || size > 3) {
+                    return constant({});
+                }
+                const Operand condition = compile(args.at(0));
+                const auto* otherwise   = size == 3 ? &args.at(2) : nullptr;
+                if(condition.constant) {
+                    if(condition.constant->cond) {
+                        return compile(args.at(1));
+                    }
+                    return otherwise ? compile(*otherwise) : constant({});
+                }
+                const size_t jump = emit({.op = ScriptOp::JumpIfFalse, .a = condition.reg});
+                return branch(jump, args.at(1), otherwise);
+            }
+            case FunctionKind::If2: {
+                if(size < 1 || size > 2) {
+                    return constant({});
+                }
+                const Operand first = compile(args.at(0));
+                if(first.constant) {
+                    if(first.constant->cond) {
+                        return first;
+                    }
+                    return size == 2 ? compile(args.at(1)) : constant({});
+                }
+                const uint16_t dst = allocate();
+                emit({.op = ScriptOp::Move, .dst = dst, .a = first.reg});
+                const size_t jump = emit({.op = ScriptOp::JumpIfTrue, .a = first.reg});
+                if(size == 2) {
+                    loadTo(dst, compile(args.at(1)));
+                }
+                else {
+                    emit({.op = ScriptOp::Clear, .dst = dst});
+                }
+                patch(jump);
+                return {.reg = dst};
+            }
+            case FunctionKind::If3: {
+                if(size < 2) {
+                    return constant({});
+                }
+                std::optional<uint16_t> dst;
+                std::vector<size_t> jumps;
+                for(size_t i{0}; i + 1 < size; ++i) {
+                    const Operand current = compile(args.at(i));
+                    if(current.constant) {
+                        if(!current.constant->cond) {
+                            continue;
+                        }
+                        if(!dst) {
+                            return current;
+                        }
+                        loadTo(*dst, current);
+                        std::ranges::for_each(jumps, [this](size_t jump) { patch(jump); });
+                        return {.reg = *dst};
+                    }
+                    if(!dst) {
+                        dst = allocate();
+                    }
+                    emit({.op = ScriptOp::Move, .dst = *dst, .a = current.reg});
+                    jumps.push_back(emit({.op = ScriptOp::JumpIfTrue, .a = current.reg}));
+                }
+                const Operand last = compile(args.back());
+                if(!dst) {
+                    return last;
+                }
+                loadTo(*dst, last);
+                std::ranges::for_each(jumps, [this](size_t jump) { patch(jump); });
+                return {.reg = *dst};
+            }
+            case FunctionKind::IfEqual:
+            case FunctionKind::IfGreater: {
+                const bool isEqual = func.kind == FunctionKind::IfEqual;
+                if(isEqual ? size != 4 : (size < 3 || size > 4)) {
+                    return constant({});
+                }
+                const Operand first   = compile(args.at(0));
+                const Operand second  = compile(args.at(1));
+                const auto* otherwise = size == 4 ? &args.at(3) : nullptr;
+                if(first.constant && second.constant) {
+                    const double lhs  = first.constant->toDouble();
+                    const double rhs  = second.constant->toDouble();
+                    const bool passed = isEqual ? lhs == rhs : lhs > rhs;
+                    if(passed) {
+                        return compile(args.at(2));
+                    }
+                    return otherwise ? compile(*otherwise) : constant({});
+                }
+                const uint16_t lhs = reg(first);
+                const uint16_t rhs = reg(second);
+                const size_t jump
+                    = emit({.op = isEqual ? ScriptOp::JumpIfNotEqual : ScriptOp::JumpIfNotGreater, .a = lhs, .b = rhs});
+                return branch(jump, args.at(2), otherwise);
+            }
+            case FunctionKind::IfLonger: {
+                if(size != 4) {
+                    return constant({});
+                }
+                const Operand first  = compile(args.at(0));
+                const Operand second = compile(args.at(1));
+                if(first.constant && second.constant) {
+                    bool ok{false};
+                    const auto length = second.constant->toLongLong(&ok);
+                    if(!ok) {
+                        return constant({});
+                    }
+                    return compile(first.constant->toString().size() >= length ? args.at(2) : args.at(3));
+                }
+                const uint16_t str    = reg(first);
+                const uint16_t length = reg(second);
+                const size_t invalid  = emit({.op = ScriptOp::JumpIfNotLongLong, .a = length});
+                const size_t jump     = emit({.op = ScriptOp::JumpIfShorter, .a = str, .b = length});
+                return guarded(invalid, branch(jump, args.at(2), &args.at(3)));
+            }
+            case FunctionKind::Add:
+            case FunctionKind::Sub:
+            case FunctionKind::Mul:
+            case FunctionKind::Div: {
+                if(size < 2) {
+                    return constant({});
+                }
+                // Later arguments aren't evaluated if the first isn't a number
+                std::vector<Operand> operands{compile(args.front())};
+                std::optional<size_t> guard;
+                if(operands.front().constant) {
+                    bool ok{false};
+                    static_cast<void>(operands.front().constant->toDouble(&ok));
+                    if(!ok) {
+                        return constant({});
+                    }
+                }
+                else {
+                    guard = emit({.op = ScriptOp::JumpIfNotNumber, .a = operands.front().reg});
+                }
+                for(size_t i{1}; i < size; ++i) {
+                    operands.push_back(compile(args.at(i)));
+                }
+                const auto kind = func.kind;
+                return guarded(guard, fold(ScriptOp::Arithmetic, operands, static_cast<uint32_t>(kind),
+                                           [kind](Scripting::SlotArgs slots) {
+                                               return Scripting::evalArithmetic(kind, slots);
+                                           }));
+            }
+            case FunctionKind::Mod: {
+                if(size < 2) {
+                    return constant({});
+                }
+                const auto operands = compileAll(args);
+                // Division by zero is left to the interpreter rather than folded
+                const bool hasZero
+                    = std::ranges::any_of(operands | std::views::drop(1), [](const Operand& operand) {
+                          return operand.constant && operand.constant->toInt() == 0;
+                      });
+                if(hasZero) {
+                    return unsupported();
+                }
+                return fold(ScriptOp::Mod, operands, 0, [](Scripting::SlotArgs slots) {
+                    return Scripting::evalMod(slots);
+                });
+            }
+            case FunctionKind::Num: {
+                if(size < 1 || size > 2) {
+                    return constant({});
+                }
+                return fold(ScriptOp::Num, compileAll(args), 0, [](Scripting::SlotArgs slots) {
+                    return Scripting::evalNum(slots);
+                });
+            }
+            case FunctionKind::Pad:
+            case FunctionKind::PadRight: {
+                if(size < 2 || size > 3) {
+                    return constant({});
+                }
+                // The pad character isn't evaluated for invalid lengths
+                std::vector<Operand> operands{compile(args.at(0)), compile(args.at(1))};
+                std::optional<size_t> guard;
+                if(operands.back().constant) {
+                    bool ok{false};
+                    const int len = operands.back().constant->toInt(&ok);
+                    if(!ok || len < 0) {
+                        return constant({});
+                    }
+                }
+                else if(size == 3) {
+                    guard = emit({.op = ScriptOp::JumpIfNotLength, .a = operands.back().reg});
+                }
+                if(size == 3) {
+                    operands.push_back(compile(args.at(2)));
+                }
+                const auto kind = func.kind;
+                return guarded(guard, fold(ScriptOp::Pad, operands, static_cast<uint32_t>(kind),
+                                           [kind](Scripting::SlotArgs slots) {
+                                               return Scripting::evalPad(kind, slots);
+                                           }));
+            }
+            case FunctionKind::Generic:
+                break;
+        }
+
+        const auto offset = static_cast<uint32_t>(m_program.args.size());
+        for(const auto& arg : args) {
+            const uint16_t argReg = reg(compile(arg));
+            m_program.args.push_back(argReg);
+        }
+
+        const uint16_t dst = allocate();
+        emit({.op     = ScriptOp::Call,
+              .dst    = dst,
+              .a      = offset,
+              .b      = static_cast<uint32_t>(size),
+              .c      = addName(func.name),
+              .target = func.functionId});
+        return {.reg = dst};
+    }
+
+    Operand compileFunctionArg(const BoundExpressionList& args)
+    {
+        if(args.empty()) {
+            return constant(ScriptSlot::fromResult({.value = QString{}, .cond = false}));
+        }
+
+        if(args.size() == 1) {
+            return compile(args.front());
+        }
+
+        return fold(ScriptOp::Concat, compileAll(args), 0, [](Scripting::SlotArgs slots) {
+            return Scripting::evalConcat(slots);
+        });
+    }
+
+    Operand compileConditional(const BoundExpressionList& args)
+    {
+        if(args.empty()) {
+            return constant({});
+        }
+
+        if(args.size() == 1) {
+            const BoundExpression& arg = args.front();
+            const Operand operand      = compile(arg);
+            const bool literal         = isLiteral(arg);
+
+            if(operand.constant) {
+                if(!literal && (!operand.constant->cond || operand.constant->isEmpty())) {
+                    return constant({});
+                }
+                ScriptSlot result = *operand.constant;
+                result.cond       = true;
+                return constant(std::move(result));
+            }
+
+            const uint16_t dst = allocate();
+            emit({.op = ScriptOp::Present, .dst = dst, .a = operand.reg, .c = literal ? 1U : 0U});
+            return {.reg = dst};
+        }
+
+        // Stop at the first missing value, as the interpreter does
+        std::vector<Operand> operands;
+        std::vector<size_t> missing;
+        bool alwaysMissing{false};
+
+        for(const BoundExpression& arg : args) {
+            const Operand operand = compile(arg);
+            if(!isLiteral(arg)) {
+                if(operand.constant) {
+                    if(!operand.constant->cond || operand.constant->isEmpty()) {
+                        alwaysMissing = true;
+                        break;
+                    }
+                }
+                else {
+                    missing.push_back(emit({.op = ScriptOp::JumpIfAbsent, .a = operand.reg}));
+                }
+            }
+            operands.push_back(operand);
+        }
+
+        if(missing.empty()) {
+            if(alwaysMissing) {
+                return constant({});
+            }
+            if(allConstant(operands)) {
+                return constant(Scripting::evalJoin(Scripting::SlotArgs{constantArgs(operands)}));
+            }
+        }
+
+        uint16_t dst{0};
+        std::optional<size_t> end;
+        if(alwaysMissing) {
+            dst = allocate();
+        }
+        else {
+            dst = fold(ScriptOp::Join, operands, 0, [](Scripting::SlotArgs slots) {
+                      return Scripting::evalJoin(slots);
+                  }).reg;
+            end = emit({.op = ScriptOp::Jump});
+        }
+
+        std::ranges::for_each(missing, [this](size_t jump) { patch(jump); });
+        emit({.op = ScriptOp::Clear, .dst = dst});
+        if(end) {
+            patch(*end);
+        }
+
+        return {.reg = dst};
+    }
+
+    ScriptProgram m_program;
+    bool m_failed{false};
+};
+} // namespace
+
+namespace Fooyin {
+ScriptSlot ScriptSlot::fromResult(ScriptResult result)
+{
+    ScriptSlot slot;
+    slot.string = std::move(result.value);
+    slot.cond   = result.cond;
+    return slot;
+}
+
+ScriptSlot ScriptSlot::fromInt(int64_t value)
+{
+    ScriptSlot slot;
+    slot.intValue = value;
+    slot.type     = Type::Int;
+    slot.cond     = true;
+    return slot;
+}
+
+ScriptSlot ScriptSlot::fromFloat(double value)
+{
+    ScriptSlot slot;
+    slot.floatValue = value;
+    slot.type       = Type::Float;
+    slot.cond       = true;
+    return slot;
+}
+
+QString ScriptSlot::toString() const
+{
+    switch(type) {
+        case Type::Int:
+            return QString::number(intValue);
+        case Type::Float:
+            return QString::number(floatValue);
+        case Type::String:
+            break;
+    }
+    return string;
+}
+
+ScriptResult ScriptSlot::toResult() const
+{
+    return {.value = toString(), .cond = cond};
+}
+
+bool ScriptSlot::isEmpty() const
+{
+    return type == Type::String && string.isEmpty();
+}
+
+bool ScriptSlot::isNull() const
+{
+    return type == Type::String && string.isNull();
+}
+
+double ScriptSlot::toDouble(bool* ok) const
+{
+    switch(type) {
+        case Type::Int:
+            if(ok) {
+                *ok = true;
+            }
+            return static_cast<double>(intValue);
+        case Type::Float:
+            if(isExactFloat(floatValue)) {
+                if(ok) {
+                    *ok = true;
+                }
+                return floatValue;
+            }
+            return toString().toDouble(ok);
+        case Type::String:
+            break;
+    }
+    return string.toDouble(ok);
+}
+
+int ScriptSlot::toInt(bool* ok) const
+{
+    switch(type) {
+        case Type::Int: {
+            const bool inRange
+                = intValue >= std::numeric_limits<int>::min() && intValue <= std::numeric_limits<int>::max();
+            if(ok) {
+                *ok = inRange;
+            }
+            return inRange ? static_cast<int>(intValue) : 0;
+        }
+        case Type::Float:
+            if(isExactFloat(floatValue)) {
+                if(ok) {
+                    *ok = true;
+                }
+                return static_cast<int>(floatValue);
+            }
+            return toString().toInt(ok);
+        case Type::String:
+            break;
+    }
+    return string.toInt(ok);
+}
+
+qlonglong ScriptSlot::toLongLong(bool* ok) const
+{
+    switch(type) {
+        case Type::Int:
+            if(ok) {
+                *ok = true;
+            }
+            return intValue;
+        case Type::Float:
+            if(isExactFloat(floatValue)) {
+                if(ok) {
+                    *ok = true;
+                }
+                return static_cast<qlonglong>(floatValue);
+            }
+            return toString().toLongLong(ok);
+        case Type::String:
+            break;
+    }
+    return string.toLongLong(ok);
+}
+
+ScriptProgram compileScript(const BoundExpressionList& expressions)
+{
+    if(expressions.empty()) {
+        return {};
+    }
+
+    return ScriptCompiler{}.compileProgram(expressions);
+}
+
+namespace Scripting {
+bool isTrackField(VariableKind kind)
+{
+    switch(kind) {
+        case VariableKind::PlayCount:
+        case VariableKind::Year:
+        case VariableKind::Subsong:
+        case VariableKind::FileSize:
+        case VariableKind::DurationSecs:
+        case VariableKind::DurationMSecs:
+            return true;
+        default:
+            return false;
+    }
+}
+
+ScriptSlot trackField(VariableKind kind, const Track& track)
+{
+    // Negative numbers and zero durations are treated as missing, matching the registry
+    const auto number = [](int value) {
+        return value < 0 ? ScriptSlot{} : ScriptSlot::fromInt(value);
+    };
+
+    switch(kind) {
+        case VariableKind::PlayCount:
+            return number(track.playCount());
+        case VariableKind::Year:
+            return number(track.year());
+        case VariableKind::Subsong:
+            return number(track.subsong());
+        case VariableKind::FileSize:
+            return fromUnsigned(track.fileSize());
+        case VariableKind::DurationSecs: {
+            const auto duration = track.duration();
+            return duration == 0 ? ScriptSlot{} : fromUnsigned(duration / 1000);
+        }
+        case VariableKind::DurationMSecs: {
+            const auto duration = track.duration();
+            return duration == 0 ? ScriptSlot{} : fromUnsigned(duration);
+        }
+        default:
+            return {};
+    }
+}
+
+QStringList evalStringList(const ScriptResult& evalExpr, const QStringList& result)
+{
+    QStringList listResult;
+    const QStringList values = evalExpr.value.split(QLatin1String{Constants::UnitSeparator});
+    const bool isEmpty       = result.empty();
+
+    for(const QString& value : values) {
+        if(isEmpty) {
+            listResult.append(value);
+        }
+        else {
+            std::ranges::transform(result, std::back_inserter(listResult),
+                                   [&](const QString& retValue) -> QString { return retValue + value; });
+        }
+    }
+    return listResult;
+}
+
+ScriptSlot evalArithmetic(FunctionKind kind, SlotArgs args)
+{
+    if(args.size() < 2) {
+        return {};
+    }
+
+    bool ok{false};
+    double total = args.front()->toDouble(&ok);
+    if(!ok) {
+        return {};
+    }
+
+    for(const ScriptSlot* arg : args.subspan(1)) {
+        const double num = arg->toDouble(&ok);
+        if(!ok) {
+            continue;
+        }
+
+        if(kind == FunctionKind::Add) {
+            total += num;
+        }
+        else if(kind == FunctionKind::Sub) {
+            total -= num;
+        }
+        else if(kind == FunctionKind::Mul) {
+            total *= num;
+        }
+        else {
+            total /= num;
+        }
+    }
+
+    return ScriptSlot::fromFloat(total);
+}
+
+ScriptSlot evalMod(SlotArgs args)
+{
+    if(args.size() < 2) {
+        return {};
+    }
+
+    int total = args.front()->toInt();
+    for(const ScriptSlot* arg : args.subspan(1)) {
+        total %= arg->toInt();
+    }
+    return ScriptSlot::fromInt(total);
+}
+
+ScriptSlot evalNum(SlotArgs args)
+{
+    if(args.empty() || args.size() > 2) {
+        return {};
+    }
+
+    const auto passThrough = [&args]() {
+        ScriptSlot result = *args.front();
+        result.cond       = !result.isEmpty();
+        return result;
+    };
+
+    if(args.size() == 1) {
+        return passThrough();
+    }
+
+    bool isInt{false};
+    const int number = args.front()->toInt(&isInt);
+    if(!isInt) {
+        return passThrough();
+    }
+
+    const int prefix = args.back()->toInt(&isInt);
+    if(!isInt) {
+        return passThrough();
+    }
+
+    return stringSlot(Utils::addLeadingZero(number, prefix));
+}
+
+ScriptSlot evalPad(FunctionKind kind, SlotArgs args)
+{
+    if(args.size() < 2 || args.size() > 3) {
+        return {};
+    }
+
+    const QString str = args.front()->toString();
+    bool ok{false};
+    const int len = args[1]->toInt(&ok);
+    if(!ok || len < 0) {
+        return {};
+    }
+
+    QChar padChar = u' ';
+    if(args.size() == 3) {
+        const QString customPad = args.back()->toString();
+        if(!customPad.isEmpty()) {
+            padChar = customPad.front();
+        }
+    }
+
+    return stringSlot(kind == FunctionKind::Pad ? str.leftJustified(len, padChar) : str.rightJustified(len, padChar));
+}
+
+ScriptSlot evalConcat(SlotArgs args)
+{
+    QString result;
+    bool allPassed{true};
+
+    for(const ScriptSlot* arg : args) {
+        if(!arg->cond) {
+            allPassed = false;
+        }
+        const QString value = arg->toString();
+        if(value.contains(QLatin1String{Constants::UnitSeparator})) {
+            QStringList newResult;
+            const auto values = value.split(QLatin1String{Constants::UnitSeparator});
+            std::ranges::transform(values, std::back_inserter(newResult),
+                                   [&](const auto& subValue) { return result + subValue; });
+            result = newResult.join(QLatin1String{Constants::UnitSeparator});
+        }
+        else {
+            result = result + value;
+        }
+    }
+
+    return ScriptSlot::fromResult({.value = std::move(result), .cond = allPassed});
+}
+
+ScriptSlot evalJoin(SlotArgs args)
+{
+    QStringList exprResult;
+
+    for(const ScriptSlot* arg : args) {
+        const ScriptResult subExpr = arg->toResult();
+        if(subExpr.value.contains(QLatin1String{Constants::UnitSeparator})) {
+            const QStringList evalList = evalStringList(subExpr, exprResult);
+            if(!evalList.empty()) {
+                exprResult = evalList;
+            }
+        }
+        else {
+            if(exprResult.empty()) {
+                exprResult.append(subExpr.value);
+            }
+            else {
+                std::ranges::transform(exprResult, exprResult.begin(),
+                                       [&](const QString& retValue) -> QString { return retValue + subExpr.value; });
+            }
+        }
+    }
+
+    ScriptSlot result;
+    result.cond = true;
+    if(exprResult.size() == 1) {
+        result.string = exprResult.constFirst();
+    }
+    else if(exprResult.size() > 1) {
+        result.string = exprResult.join(QLatin1String{Constants::UnitSeparator});
+    }
+    return result;
+}
+} // namespace Scripting
+} // namespace Fooyin
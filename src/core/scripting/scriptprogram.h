@@ -0,0 +1,187 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/scripting/expression.h>
+#include <core/scripting/scripttypes.h>
+#include <core/scripting/scriptvalue.h>
+
+#include <QStringList>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Fooyin {
+class Track;
+struct BoundExpression;
+using BoundExpressionList = std::vector<BoundExpression>;
+
+/*!
+ * Typed register value used by compiled scripts.
+ *
+ * Numbers stay numeric between operations and are only converted to strings
+ * when a string is needed. Conversions give the same results as the
+ * interpreter, which passes every intermediate value as a string.
+ */
+struct FYCORE_EXPORT ScriptSlot
+{
+    enum class Type : uint8_t
+    {
+        String = 0,
+        Int,
+        Float,
+    };
+
+    QString string;
+    int64_t intValue{0};
+    double floatValue{0.0};
+    Type type{Type::String};
+    bool cond{false};
+
+    [[nodiscard]] static ScriptSlot fromResult(ScriptResult result);
+    [[nodiscard]] static ScriptSlot fromInt(int64_t value);
+    [[nodiscard]] static ScriptSlot fromFloat(double value);
+
+    [[nodiscard]] QString toString() const;
+    [[nodiscard]] ScriptResult toResult() const;
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] bool isNull() const;
+
+    [[nodiscard]] double toDouble(bool* ok = nullptr) const;
+    [[nodiscard]] int toInt(bool* ok = nullptr) const;
+    [[nodiscard]] qlonglong toLongLong(bool* ok = nullptr) const;
+};
+
+enum class ScriptOp : uint8_t
+{
+    //! dst = constants[a]
+    LoadConst = 0,
+    //! dst = %variable% (kind, names[a])
+    LoadVariable,
+    //! dst = %<variable>% (kind, names[a])
+    LoadVariableList,
+    //! dst = %_variable% (names[a])
+    LoadVariableRaw,
+    //! dst = typed built-in field (kind) for single tracks, otherwise as LoadVariable
+    LoadField,
+    //! dst = $function(args[a..a+b]) with id target and name names[c]
+    Call,
+    //! dst = $get(reg a)
+    Get,
+    //! dst = $put(names[a], reg b); $puts if c != 0
+    Put,
+    //! dst = reg a
+    Move,
+    //! dst = {}
+    Clear,
+    //! dst = [reg a], keeping empty values if c != 0 (literals)
+    Present,
+    //! Arithmetic fold of args[a..a+b] (c = FunctionKind)
+    Arithmetic,
+    //! dst = $mod(args[a..a+b])
+    Mod,
+    //! dst = $num(args[a..a+b])
+    Num,
+    //! dst = $pad/$padright(args[a..a+b]) (c = FunctionKind)
+    Pad,
+    //! Function argument concatenation of args[a..a+b]
+    Concat,
+    //! Conditional concatenation of args[a..a+b]
+    Join,
+    //! pc = target
+    Jump,
+    //! if reg a cond: pc = target
+    JumpIfTrue,
+    //! if !reg a cond: pc = target
+    JumpIfFalse,
+    //! if reg a is false or empty: pc = target
+    JumpIfAbsent,
+    //! if reg a isn't a number: pc = target
+    JumpIfNotNumber,
+    //! if reg a isn't a non-negative integer: pc = target
+    JumpIfNotLength,
+    //! if reg a isn't a 64-bit integer: pc = target
+    JumpIfNotLongLong,
+    //! if reg a != reg b (numerically): pc = target
+    JumpIfNotEqual,
+    //! if !(reg a > reg b) (numerically): pc = target
+    JumpIfNotGreater,
+    //! if length of reg a < reg b: pc = target
+    JumpIfShorter,
+};
+
+struct ScriptInstruction
+{
+    ScriptOp op{ScriptOp::Clear};
+    VariableKind kind{VariableKind::Generic};
+    uint16_t dst{0};
+    uint32_t a{0};
+    uint32_t b{0};
+    uint32_t c{0};
+    uint32_t target{0};
+};
+
+/*!
+ * Flat, register-based form of a bound script.
+ *
+ * Produced by the binder for scripts made up of literals, variables, functions,
+ * function arguments and conditionals; query expressions aren't compiled and
+ * leave the program empty, in which case the bound expressions are interpreted. Each
+ * top-level expression leaves its result in the register listed in `roots`.
+ * Constant sub-expressions are folded during compilation.
+ */
+struct FYCORE_EXPORT ScriptProgram
+{
+    std::vector<ScriptInstruction> code;
+    std::vector<ScriptSlot> constants;
+    std::vector<QString> names;
+    std::vector<uint16_t> args;
+    std::vector<uint16_t> roots;
+    uint16_t registerCount{0};
+
+    [[nodiscard]] bool isValid() const
+    {
+        return !roots.empty();
+    }
+};
+
+[[nodiscard]] FYCORE_EXPORT ScriptProgram compileScript(const BoundExpressionList& expressions);
+
+namespace Scripting {
+using SlotArgs = std::span<const ScriptSlot* const>;
+
+//! Built-in fields loaded directly from a track rather than through the registry.
+[[nodiscard]] bool isTrackField(VariableKind kind);
+[[nodiscard]] ScriptSlot trackField(VariableKind kind, const Track& track);
+
+// Used by the interpreter, compiled programs and constant folding
+[[nodiscard]] QStringList evalStringList(const ScriptResult& evalExpr, const QStringList& result);
+[[nodiscard]] ScriptSlot evalArithmetic(FunctionKind kind, SlotArgs args);
+[[nodiscard]] ScriptSlot evalMod(SlotArgs args);
+[[nodiscard]] ScriptSlot evalNum(SlotArgs args);
+[[nodiscard]] ScriptSlot evalPad(FunctionKind kind, SlotArgs args);
+[[nodiscard]] ScriptSlot evalConcat(SlotArgs args);
+[[nodiscard]] ScriptSlot evalJoin(SlotArgs args);
+} // namespace Scripting
+} // namespace Fooyin
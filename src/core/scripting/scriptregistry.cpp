@@ -1045,6 +1045,11 @@ bool ScriptRegistry::isFunction(const QString& func) const
     return m_functionIds.contains(key);
 }
 
+bool ScriptRegistry::hasCustomVariable(VariableKind kind) const
+{
+    return m_customVariables.contains(kind);
+}
+
 ScriptResult ScriptRegistry::value(VariableKind kind, const QString& var, const ScriptSubject& subject) const
 {
     return valueInternal(kind, var, subject);
@@ -49,6 +49,7 @@ public:
     [[nodiscard]] bool isVariable(const QString& var, const Track& track) const;
     [[nodiscard]] bool isVariable(const QString& var, const TrackList& tracks) const;
     [[nodiscard]] bool isFunction(const QString& func) const;
+    [[nodiscard]] bool hasCustomVariable(VariableKind kind) const;
 
     [[nodiscard]] ScriptResult value(VariableKind kind, const QString& var, const ScriptSubject& subject) const;
     [[nodiscard]] ScriptResult value(const QString& var, const ScriptSubject& subject) const;
@@ -20,11 +20,90 @@
 #include <core/stringpool.h>
 
 #include <array>
+#include <atomic>
+#include <bit>
 #include <functional>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+namespace {
+/*!
+ * Append-only array which can be read without locking.
+ *
+ * Elements are stored in chunks which double in size and are never moved or freed
+ * before destruction. Appends must be externally synchronised; the size is published
+ * with release semantics once an element is in place, so any index below an acquired
+ * size() can be read while another thread appends.
+ */
+template <typename T>
+class AppendOnlyArray
+{
+public:
+    AppendOnlyArray() = default;
+
+    ~AppendOnlyArray()
+    {
+        for(auto& chunk : m_chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    AppendOnlyArray(const AppendOnlyArray&)            = delete;
+    AppendOnlyArray& operator=(const AppendOnlyArray&) = delete;
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    //! Returns the element at @p index, or nullptr if it hasn't been published yet.
+    [[nodiscard]] const T* find(size_t index) const
+    {
+        if(index >= size()) {
+            return nullptr;
+        }
+
+        const auto [chunk, offset] = locate(index);
+        return &m_chunks[chunk].load(std::memory_order_relaxed)[offset];
+    }
+
+    void push_back(T value)
+    {
+        const size_t index         = m_size.load(std::memory_order_relaxed);
+        const auto [chunk, offset] = locate(index);
+
+        T* data = m_chunks[chunk].load(std::memory_order_relaxed);
+        if(!data) {
+            data = new T[BaseChunkSize << chunk];
+            m_chunks[chunk].store(data, std::memory_order_relaxed);
+        }
+
+        data[offset] = std::move(value);
+        m_size.store(index + 1, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t BaseChunkShift = 6;
+    static constexpr size_t BaseChunkSize  = size_t{1} << BaseChunkShift;
+    // Enough chunks to address every 32-bit id
+    static constexpr size_t MaxChunks = 33 - BaseChunkShift;
+
+    [[nodiscard]] static std::pair<size_t, size_t> locate(size_t index)
+    {
+        const size_t biased = index + BaseChunkSize;
+        const auto highBit  = static_cast<size_t>(std::bit_width(biased) - 1);
+        const size_t chunk  = highBit - BaseChunkShift;
+        const size_t offset = biased - (size_t{1} << highBit);
+        return {chunk, offset};
+    }
+
+    std::array<std::atomic<T*>, MaxChunks> m_chunks{};
+    std::atomic<size_t> m_size{0};
+};
+} // namespace
+
 namespace Fooyin {
 class StringPoolPrivate
 {
@@ -43,11 +122,37 @@ public:
             }
         };
 
-        mutable std::mutex mutex;
+        Bucket()
+        {
+            strings.push_back({});
+        }
+
+        [[nodiscard]] QString stringAt(StringPool::StringId id) const
+        {
+            const QString* str = strings.find(id);
+            return str ? *str : QString{};
+        }
+
+        [[nodiscard]] StringPool::StringId addString(const QString& value)
+        {
+            if(const auto it = ids.find(value); it != ids.cend()) {
+                return it->second;
+            }
+
+            const auto id = static_cast<StringPool::StringId>(strings.size());
+            strings.push_back(value);
+            ids.emplace(value, id);
+
+            return id;
+        }
+
+        // Only guards writers; readers go through the published sizes of the arrays below
+        std::mutex mutex;
         std::unordered_map<QString, StringPool::StringId> ids;
-        std::vector<QString> strings{{}};
-        std::vector<StringPool::StringId> listEntries;
         std::unordered_map<std::vector<StringPool::StringId>, StringPool::StringListRef, ListKeyHash> lists;
+
+        AppendOnlyArray<QString> strings;
+        AppendOnlyArray<StringPool::StringId> listEntries;
     };
 
     static constexpr auto DomainCount = static_cast<size_t>(StringPool::Domain::ExtraTagKey) + 1;
@@ -86,16 +191,7 @@ StringPool::StringId StringPool::internId(Domain domain, const QString& value)
     auto& bucket = p->bucket(domain);
 
     const std::scoped_lock lock{bucket.mutex};
-
-    if(const auto it = bucket.ids.find(value); it != bucket.ids.cend()) {
-        return it->second;
-    }
-
-    const auto id = static_cast<StringId>(bucket.strings.size());
-    bucket.strings.push_back(value);
-    bucket.ids.emplace(bucket.strings.back(), id);
-
-    return id;
+    return bucket.addString(value);
 }
 
 StringPool::StringListRef StringPool::internList(Domain domain, const QStringList& values)
@@ -112,20 +208,7 @@ StringPool::StringListRef StringPool::internList(Domain domain, const QStringLis
     internedIds.reserve(values.size());
 
     for(const auto& value : values) {
-        if(value.isEmpty()) {
-            internedIds.push_back(EmptyStringId);
-            continue;
-        }
-
-        if(const auto it = bucket.ids.find(value); it != bucket.ids.cend()) {
-            internedIds.push_back(it->second);
-            continue;
-        }
-
-        const auto id = static_cast<StringId>(bucket.strings.size());
-        bucket.strings.push_back(value);
-        bucket.ids.emplace(bucket.strings.back(), id);
-        internedIds.push_back(id);
+        internedIds.push_back(value.isEmpty() ? EmptyStringId : bucket.addString(value));
     }
 
     if(const auto it = bucket.lists.find(internedIds); it != bucket.lists.cend()) {
@@ -133,8 +216,9 @@ StringPool::StringListRef StringPool::internList(Domain domain, const QStringLis
     }
 
     const auto offset = static_cast<uint32_t>(bucket.listEntries.size());
-    bucket.listEntries.reserve(bucket.listEntries.size() + internedIds.size());
-    bucket.listEntries.insert(bucket.listEntries.end(), internedIds.cbegin(), internedIds.cend());
+    for(const auto id : internedIds) {
+        bucket.listEntries.push_back(id);
+    }
 
     const StringListRef ref{.offset = offset, .size = static_cast<uint32_t>(internedIds.size())};
     bucket.lists.emplace(std::move(internedIds), ref);
@@ -147,11 +231,7 @@ QString StringPool::resolve(Domain domain, StringId id) const
         return {};
     }
 
-    const auto& bucket = p->bucket(domain);
-
-    const std::scoped_lock lock{bucket.mutex};
-
-    return id < bucket.strings.size() ? bucket.strings.at(id) : QString{};
+    return p->bucket(domain).stringAt(id);
 }
 
 QStringList StringPool::resolveList(Domain domain, StringListRef ref) const
@@ -162,19 +242,16 @@ QStringList StringPool::resolveList(Domain domain, StringListRef ref) const
 
     const auto& bucket = p->bucket(domain);
 
-    const std::scoped_lock lock{bucket.mutex};
-
-    QStringList values;
-    values.reserve(ref.size);
-
     const auto end = static_cast<size_t>(ref.offset) + static_cast<size_t>(ref.size);
     if(end > bucket.listEntries.size()) {
         return {};
     }
 
+    QStringList values;
+    values.reserve(ref.size);
+
     for(size_t index{ref.offset}; index < end; ++index) {
-        const auto id = bucket.listEntries.at(index);
-        values.push_back(id < bucket.strings.size() ? bucket.strings.at(id) : QString{});
+        values.push_back(bucket.stringAt(*bucket.listEntries.find(index)));
     }
 
     return values;
@@ -182,28 +259,7 @@ QStringList StringPool::resolveList(Domain domain, StringListRef ref) const
 
 QString StringPool::joined(Domain domain, StringListRef ref, const QString& separator) const
 {
-    if(ref.isEmpty()) {
-        return {};
-    }
-
-    const auto& bucket = p->bucket(domain);
-
-    const std::scoped_lock lock{bucket.mutex};
-
-    const auto end = static_cast<size_t>(ref.offset) + static_cast<size_t>(ref.size);
-    if(end > bucket.listEntries.size()) {
-        return {};
-    }
-
-    QStringList values;
-    values.reserve(ref.size);
-
-    for(size_t index{ref.offset}; index < end; ++index) {
-        const auto id = bucket.listEntries.at(index);
-        values.push_back(id < bucket.strings.size() ? bucket.strings.at(id) : QString{});
-    }
-
-    return values.join(separator);
+    return resolveList(domain, ref).join(separator);
 }
 
 QString StringPool::valueAt(Domain domain, StringListRef ref, qsizetype index) const
@@ -214,15 +270,10 @@ QString StringPool::valueAt(Domain domain, StringListRef ref, qsizetype index) c
 
     const auto& bucket = p->bucket(domain);
 
-    const std::scoped_lock lock{bucket.mutex};
-
     const auto listIndex = static_cast<size_t>(ref.offset) + static_cast<size_t>(index);
-    if(listIndex >= bucket.listEntries.size()) {
-        return {};
-    }
+    const auto* id       = bucket.listEntries.find(listIndex);
 
-    const auto id = bucket.listEntries.at(listIndex);
-    return id < bucket.strings.size() ? bucket.strings.at(id) : QString{};
+    return id ? bucket.stringAt(*id) : QString{};
 }
 
 bool StringPool::contains(Domain domain, StringListRef ref, const QString& value) const
@@ -233,20 +284,15 @@ bool StringPool::contains(Domain domain, StringListRef ref, const QString& value
 
     const auto& bucket = p->bucket(domain);
 
-    const std::scoped_lock lock{bucket.mutex};
-
-    const auto it = bucket.ids.find(value);
-    if(it == bucket.ids.cend()) {
-        return false;
-    }
-
     const auto end = static_cast<size_t>(ref.offset) + static_cast<size_t>(ref.size);
     if(end > bucket.listEntries.size()) {
         return false;
     }
 
+    // Lists are short, so comparing strings avoids a locked lookup in the id map
     for(size_t listIndex{ref.offset}; listIndex < end; ++listIndex) {
-        if(bucket.listEntries.at(listIndex) == it->second) {
+        const QString* str = bucket.strings.find(*bucket.listEntries.find(listIndex));
+        if(str && *str == value) {
             return true;
         }
     }
@@ -258,13 +304,13 @@ QStringList StringPool::values(Domain domain) const
 {
     const auto& bucket = p->bucket(domain);
 
-    const std::scoped_lock lock{bucket.mutex};
+    const size_t count = bucket.strings.size();
 
     QStringList values;
-    values.reserve(static_cast<qsizetype>(bucket.strings.size()));
+    values.reserve(static_cast<qsizetype>(count));
 
-    for(size_t index{1}; index < bucket.strings.size(); ++index) {
-        values.push_back(bucket.strings.at(index));
+    for(size_t index{1}; index < count; ++index) {
+        values.push_back(*bucket.strings.find(index));
     }
 
     values.sort(Qt::CaseInsensitive);
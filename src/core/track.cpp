@@ -188,20 +188,24 @@ float opusHeaderLinearGain(const Fooyin::Track& track)
     return std::pow(10.0F, opusHeaderGainDb(track) / 20.0F);
 }
 
-void normaliseExtraProperties(Fooyin::Track::ExtraProperties& props)
+bool normaliseExtraProperties(Fooyin::Track::ExtraProperties& props)
 {
+    bool changed{false};
+
     if(const QString* opusHeader = props.find(QString::fromLatin1(Fooyin::Constants::OpusHeaderGainQ78))) {
         bool ok{false};
         if(const int gain = opusHeader->toInt(&ok); ok && gain == 0) {
-            props.erase(QString::fromLatin1(Fooyin::Constants::OpusHeaderGainQ78));
+            changed |= props.erase(QString::fromLatin1(Fooyin::Constants::OpusHeaderGainQ78));
         }
     }
 
     if(const QString* chapter = props.find(ChapterProperty)) {
         if(*chapter != ChapterValue) {
-            props.erase(ChapterProperty);
+            changed |= props.erase(ChapterProperty);
         }
     }
+
+    return changed;
 }
 
 template <typename Value, typename KeyFn>
@@ -250,6 +254,11 @@ public:
     static bool readPropsToVector(QDataStream& stream, Track::ExtraProperties& out);
     [[nodiscard]] StringPool& stringPool() const;
 
+    void markDirty(Track::Field field)
+    {
+        dirtyFields.set(static_cast<size_t>(field));
+    }
+
     std::shared_ptr<TrackMetadataStore> metadataStore;
     int libraryId{-1};
     bool enabled{true};
@@ -307,6 +316,8 @@ public:
 
     bool metadataWasRead{false};
     bool metadataWasModified{false};
+    // Never-synced tracks need a full row write
+    Track::Fields dirtyFields{~0ULL};
 
     // Archive related
     bool isInArchive{false};
@@ -543,6 +554,11 @@ bool Track::sameDataAs(const Track& other) const
         && p->filepathWithinArchive == other.p->filepathWithinArchive;
 }
 
+bool Track::sharesDataWith(const Track& other) const
+{
+    return p == other.p;
+}
+
 QString Track::generateHash()
 {
     QString title = p->title;
@@ -553,6 +569,7 @@ QString Track::generateHash()
     p->hash = Utils::generateHash(joinStrings(*p, StringPool::Domain::Artist, p->artists, ","_L1),
                                   resolveString(*p, StringPool::Domain::Album, p->album), p->discNumber, p->trackNumber,
                                   title, QString::number(p->subsong));
+    p->markDirty(Field::Hash);
     return p->hash;
 }
 
@@ -586,6 +603,16 @@ bool Track::metadataWasModified() const
     return p->metadataWasModified;
 }
 
+Track::Fields Track::dirtyFields() const
+{
+    return p->dirtyFields;
+}
+
+bool Track::isDirty(Field field) const
+{
+    return p->dirtyFields.test(static_cast<size_t>(field));
+}
+
 bool Track::exists() const
 {
     if(isInArchive()) {
@@ -1445,6 +1472,7 @@ void Track::setMetadataStore(std::shared_ptr<TrackMetadataStore> store)
 void Track::setLibraryId(int id)
 {
     p->libraryId = id;
+    p->markDirty(Field::LibraryId);
 }
 
 void Track::setIsEnabled(bool enabled)
@@ -1465,6 +1493,7 @@ void Track::setId(int id)
 void Track::setHash(const QString& hash)
 {
     p->hash = hash;
+    p->markDirty(Field::Hash);
 }
 
 void Track::setFilePath(const QString& path)
@@ -1474,6 +1503,7 @@ void Track::setFilePath(const QString& path)
     }
 
     p->filepath = path;
+    p->markDirty(Field::FilePath);
 
     if(Track::isArchivePath(path)) {
         p->isInArchive = true;
@@ -1488,6 +1518,8 @@ void Track::setFilePath(const QString& path)
 
 void Track::setTitle(const QString& title)
 {
+    p->markDirty(Field::Title);
+
     p->title = title;
 
     if(!p->hash.isEmpty()) {
@@ -1497,6 +1529,8 @@ void Track::setTitle(const QString& title)
 
 void Track::setArtists(const QStringList& artists)
 {
+    p->markDirty(Field::Artists);
+
     if(artists.size() == 1 && artists.front().isEmpty()) {
         p->artists = {};
     }
@@ -1511,6 +1545,8 @@ void Track::setArtists(const QStringList& artists)
 
 void Track::setAlbum(const QString& title)
 {
+    p->markDirty(Field::Album);
+
     p->album = internStringId(*p, StringPool::Domain::Album, title);
 
     if(!p->hash.isEmpty()) {
@@ -1520,6 +1556,8 @@ void Track::setAlbum(const QString& title)
 
 void Track::setAlbumArtists(const QStringList& artists)
 {
+    p->markDirty(Field::AlbumArtists);
+
     if(artists.size() == 1 && artists.front().isEmpty()) {
         p->albumArtists = {};
     }
@@ -1530,6 +1568,9 @@ void Track::setAlbumArtists(const QStringList& artists)
 
 void Track::setTrackNumber(const QString& number)
 {
+    p->markDirty(Field::TrackNumber);
+    p->markDirty(Field::TrackTotal);
+
     if(number.contains(u'/')) {
         const auto& parts = number.split(u'/', Qt::SkipEmptyParts);
         if(!parts.empty()) {
@@ -1551,10 +1592,14 @@ void Track::setTrackNumber(const QString& number)
 void Track::setTrackTotal(const QString& total)
 {
     p->trackTotal = total;
+    p->markDirty(Field::TrackTotal);
 }
 
 void Track::setDiscNumber(const QString& number)
 {
+    p->markDirty(Field::DiscNumber);
+    p->markDirty(Field::DiscTotal);
+
     if(number.contains(u'/')) {
         const auto& parts = number.split(u'/', Qt::SkipEmptyParts);
         if(!parts.empty()) {
@@ -1576,10 +1621,13 @@ void Track::setDiscNumber(const QString& number)
 void Track::setDiscTotal(const QString& total)
 {
     p->discTotal = total;
+    p->markDirty(Field::DiscTotal);
 }
 
 void Track::setGenres(const QStringList& genres)
 {
+    p->markDirty(Field::Genres);
+
     if(genres.size() == 1 && genres.front().isEmpty()) {
         p->genres = {};
     }
@@ -1590,6 +1638,8 @@ void Track::setGenres(const QStringList& genres)
 
 void Track::setComposers(const QStringList& composers)
 {
+    p->markDirty(Field::Composers);
+
     if(composers.size() == 1 && composers.front().isEmpty()) {
         p->composers = {};
     }
@@ -1600,6 +1650,8 @@ void Track::setComposers(const QStringList& composers)
 
 void Track::setPerformers(const QStringList& performers)
 {
+    p->markDirty(Field::Performers);
+
     if(performers.size() == 1 && performers.front().isEmpty()) {
         p->performers = {};
     }
@@ -1611,6 +1663,7 @@ void Track::setPerformers(const QStringList& performers)
 void Track::setComment(const QString& comment)
 {
     p->comment = comment;
+    p->markDirty(Field::Comment);
 }
 
 void Track::setDate(const QString& date)
@@ -1622,6 +1675,8 @@ void Track::setDate(const QString& date)
     };
 
     p->date = date;
+    p->markDirty(Field::Date);
+
     if(date.isEmpty()) {
         clearDerivedDateFields();
         return;
@@ -1720,26 +1775,31 @@ void Track::setRatingStars(int rating)
 void Track::setRGTrackGain(float gain)
 {
     p->rgTrackGain = gain;
+    p->markDirty(Field::RGTrackGain);
 }
 
 void Track::setRGAlbumGain(float gain)
 {
     p->rgAlbumGain = gain;
+    p->markDirty(Field::RGAlbumGain);
 }
 
 void Track::setRGTrackPeak(float peak)
 {
     p->rgTrackPeak = peak;
+    p->markDirty(Field::RGTrackPeak);
 }
 
 void Track::setRGAlbumPeak(float peak)
 {
     p->rgAlbumPeak = peak;
+    p->markDirty(Field::RGAlbumPeak);
 }
 
 void Track::setOpusHeaderGainQ78(int16_t gainQ78)
 {
     p->extraProps.insertOrAssign(QString::fromLatin1(Fooyin::Constants::OpusHeaderGainQ78), QString::number(gainQ78));
+    p->markDirty(Field::ExtraProperties);
 }
 
 void Track::clearOpusHeaderGain()
@@ -1749,6 +1809,11 @@ void Track::clearOpusHeaderGain()
 
 void Track::clearRGInfo()
 {
+    p->markDirty(Field::RGTrackGain);
+    p->markDirty(Field::RGAlbumGain);
+    p->markDirty(Field::RGTrackPeak);
+    p->markDirty(Field::RGAlbumPeak);
+
     p->rgTrackGain = Constants::InvalidGain;
     p->rgAlbumGain = Constants::InvalidGain;
     p->rgTrackPeak = Constants::InvalidPeak;
@@ -1801,6 +1866,8 @@ QString Track::rawRatingTag(const QString& tag) const
 
 void Track::setRawRatingTag(const QString& tag, const QString& value)
 {
+    p->markDirty(Field::ExtraProperties);
+
     const QString property = rawRatingTagProperty(tag);
     if(value.isEmpty()) {
         p->extraProps.erase(property);
@@ -1812,6 +1879,7 @@ void Track::setRawRatingTag(const QString& tag, const QString& value)
 void Track::removeRawRatingTag(const QString& tag)
 {
     p->extraProps.erase(rawRatingTagProperty(tag));
+    p->markDirty(Field::ExtraProperties);
 }
 
 QString Track::techInfo(const QString& name) const
@@ -1882,6 +1950,7 @@ std::optional<int64_t> Track::dateValue(const QString& name) const
 void Track::setCuePath(const QString& path)
 {
     p->cuePath = path;
+    p->markDirty(Field::CuePath);
 }
 
 void Track::setIsChapter(bool isChapter)
@@ -1900,6 +1969,8 @@ void Track::addExtraTag(const QString& tag, const QString& value)
         return;
     }
 
+    p->markDirty(Field::ExtraTags);
+
     const QString extraTag = internExtraTagKey(*p, tag);
     if(auto* values = p->extraTags.find(extraTag)) {
         values->emplace_back(value);
@@ -1915,6 +1986,8 @@ void Track::addExtraTag(const QString& tag, const QStringList& value)
         return;
     }
 
+    p->markDirty(Field::ExtraTags);
+
     const QString extraTag = internExtraTagKey(*p, tag);
     if(auto* values = p->extraTags.find(extraTag)) {
         values->append(value);
@@ -1928,6 +2001,7 @@ void Track::removeExtraTag(const QString& tag)
 {
     const QString extraTag = tag.toUpper();
     if(p->extraTags.erase(extraTag)) {
+        p->markDirty(Field::ExtraTags);
         p->removedTags.append(internExtraTagKey(*p, extraTag));
     }
 }
@@ -1941,6 +2015,7 @@ void Track::replaceExtraTag(const QString& tag, const QString& value)
     }
 
     p->extraTags.insertOrAssign(extraTag, QStringList{value});
+    p->markDirty(Field::ExtraTags);
 }
 
 void Track::replaceExtraTag(const QString& tag, const QStringList& value)
@@ -1952,15 +2027,19 @@ void Track::replaceExtraTag(const QString& tag, const QStringList& value)
     }
 
     p->extraTags.insertOrAssign(extraTag, value);
+    p->markDirty(Field::ExtraTags);
 }
 
 void Track::clearExtraTags()
 {
     p->extraTags.clear();
+    p->markDirty(Field::ExtraTags);
 }
 
 void Track::storeExtraTags(const QByteArray& tags)
 {
+    p->markDirty(Field::ExtraTags);
+
     p->extraTags.clear();
 
     if(tags.isEmpty()) {
@@ -1985,25 +2064,32 @@ void Track::setExtraProperty(const QString& prop, const QString& value)
     }
 
     p->extraProps.insertOrAssign(prop, value);
+    p->markDirty(Field::ExtraProperties);
 }
 
 void Track::removeExtraProperty(const QString& prop)
 {
     p->extraProps.erase(prop);
+    p->markDirty(Field::ExtraProperties);
 }
 
 void Track::normaliseExtraProperties()
 {
-    ::normaliseExtraProperties(p->extraProps);
+    if(::normaliseExtraProperties(p->extraProps)) {
+        p->markDirty(Field::ExtraProperties);
+    }
 }
 
 void Track::clearExtraProperties()
 {
     p->extraProps.clear();
+    p->markDirty(Field::ExtraProperties);
 }
 
 void Track::storeExtraProperties(const QByteArray& props)
 {
+    p->markDirty(Field::ExtraProperties);
+
     p->extraProps.clear();
 
     if(props.isEmpty()) {
@@ -2025,69 +2111,82 @@ void Track::setSubsong(int index)
 {
     if(index >= 0) {
         p->subsong = index;
+        p->markDirty(Field::Subsong);
     }
 }
 
 void Track::setOffset(uint64_t offset)
 {
     p->offset = offset;
+    p->markDirty(Field::Offset);
 }
 
 void Track::setDuration(uint64_t duration)
 {
     p->duration = duration;
+    p->markDirty(Field::Duration);
 }
 
 void Track::setFileSize(uint64_t fileSize)
 {
     p->filesize = fileSize;
+    p->markDirty(Field::FileSize);
 }
 
 void Track::setBitrate(int rate)
 {
     p->bitrate = rate;
+    p->markDirty(Field::Bitrate);
 }
 
 void Track::setSampleRate(int rate)
 {
     p->sampleRate = rate;
+    p->markDirty(Field::SampleRate);
 }
 
 void Track::setChannels(int channels)
 {
     if(channels > 0) {
         p->channels = channels;
+        p->markDirty(Field::Channels);
     }
 }
 
 void Track::setBitDepth(int depth)
 {
     p->bitDepth = depth;
+    p->markDirty(Field::BitDepth);
 }
 
 void Track::setCodec(const QString& codec)
 {
     p->codec = internStringId(*p, StringPool::Domain::Codec, codec);
+    p->markDirty(Field::Codec);
 }
 
 void Track::setCodecProfile(const QString& profile)
 {
     p->codecProfile = profile;
+    p->markDirty(Field::CodecProfile);
 }
 
 void Track::setTool(const QString& tool)
 {
     p->tool = tool;
+    p->markDirty(Field::Tool);
 }
 
 void Track::setTagTypes(const QStringList& tagTypes)
 {
     p->tagTypes = tagTypes;
+    p->markDirty(Field::TagTypes);
 }
 
 void Track::setEncoding(const QString& encoding)
 {
     p->encoding = internStringId(*p, StringPool::Domain::Encoding, encoding);
+    p->markDirty(Field::Encoding);
 }
 
 void Track::setPlayCount(int count)
@@ -2098,6 +2197,7 @@ void Track::setPlayCount(int count)
 void Track::setCreatedTime(uint64_t time)
 {
     p->createdTime = time;
+    p->markDirty(Field::CreatedTime);
 }
 
 void Track::setAddedTime(uint64_t time)
@@ -2111,6 +2211,7 @@ void Track::setModifiedTime(uint64_t time)
         p->metadataWasModified = true;
     }
     p->modifiedTime = time;
+    p->markDirty(Field::ModifiedTime);
 }
 
 void Track::setFirstPlayed(uint64_t time)
@@ -2132,6 +2233,18 @@ void Track::clearWasModified()
     p->metadataWasModified = false;
 }
 
+void Track::clearDirtyFields()
+{
+    if(p->dirtyFields.any()) {
+        p->dirtyFields.reset();
+    }
+}
+
+void Track::markAllDirty()
+{
+    p->dirtyFields.set();
+}
+
 QString Track::findCommonField(const TrackList& tracks)
 {
     if(tracks.size() < 2) {
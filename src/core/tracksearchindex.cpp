@@ -0,0 +1,375 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/tracksearchindex.h>
+
+#include <utils/stringutils.h>
+
+#include <QHash>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+// Joins folded fields so a term can never match across two of them
+constexpr QChar FieldSeparator = u'\n';
+// Shorter pieces match most of the vocabulary, so they aren't used to narrow candidates
+constexpr qsizetype MinCandidateLength = 2;
+// Candidate sets are bitsets over track ids; don't allocate them for very sparse ids
+constexpr int MaxCandidateId = 1 << 26;
+// Below this, folding tracks isn't worth spreading across the thread pool
+constexpr size_t MinParallelTracks = 4096;
+
+struct PreparedEntry
+{
+    int id{-1};
+    Fooyin::Track track;
+    QString text;
+    QStringList tokens;
+};
+
+QStringList tokenise(const QString& text)
+{
+    QStringList tokens;
+
+    qsizetype start{-1};
+    for(qsizetype i{0}; i <= text.size(); ++i) {
+        const bool isSpace = i == text.size() || text.at(i).isSpace();
+        if(isSpace && start >= 0) {
+            tokens.emplace_back(text.sliced(start, i - start));
+            start = -1;
+        }
+        else if(!isSpace && start < 0) {
+            start = i;
+        }
+    }
+
+    return tokens;
+}
+
+PreparedEntry prepareEntry(const Fooyin::Track& track)
+{
+    // Same fields as Track::hasMatch
+    const std::array fields{track.artist(),    track.title(),    track.album(),
+                            track.albumArtist(), track.performer(), track.composer(),
+                            track.genre(),     track.comment(),  track.filepath()};
+
+    PreparedEntry entry;
+    entry.id    = track.id();
+    entry.track = track;
+
+    for(const QString& field : fields) {
+        if(!entry.text.isEmpty()) {
+            entry.text.append(FieldSeparator);
+        }
+        entry.text.append(Fooyin::Utils::foldForSearch(field));
+    }
+
+    entry.tokens = tokenise(entry.text);
+    entry.tokens.removeDuplicates();
+
+    return entry;
+}
+
+std::vector<PreparedEntry> prepareEntries(const Fooyin::TrackList& tracks)
+{
+    std::vector<const Fooyin::Track*> indexed;
+    indexed.reserve(tracks.size());
+
+    for(const Fooyin::Track& track : tracks) {
+        if(track.id() >= 0) {
+            indexed.push_back(&track);
+        }
+    }
+
+    std::vector<PreparedEntry> entries(indexed.size());
+
+    if(indexed.size() < MinParallelTracks) {
+        std::ranges::transform(indexed, entries.begin(), [](const Fooyin::Track* track) { return prepareEntry(*track); });
+        return entries;
+    }
+
+    std::vector<size_t> indexes(indexed.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    // The calling thread takes part in a blocking map, so this is safe to call from a pool thread
+    QtConcurrent::blockingMap(indexes,
+                              [&entries, &indexed](const size_t index) { entries[index] = prepareEntry(*indexed[index]); });
+
+    return entries;
+}
+
+struct IndexData
+{
+    struct Entry
+    {
+        //! The copy the text was folded from; edited copies no longer share its data
+        Fooyin::Track track;
+        QString text;
+        std::vector<uint32_t> tokens;
+    };
+
+    struct TokenChanges
+    {
+        std::vector<int> added;
+        std::vector<int> removed;
+    };
+
+    uint32_t tokenId(const QString& token);
+    void apply(std::vector<PreparedEntry> prepared, const std::vector<int>& removed);
+
+    std::unordered_map<int, Entry> entries;
+    std::vector<QString> tokens;
+    //! Sorted track ids containing each token
+    std::vector<std::vector<int>> postings;
+    QHash<QString, uint32_t> tokenIds;
+    int maxId{-1};
+};
+
+uint32_t IndexData::tokenId(const QString& token)
+{
+    const auto it = tokenIds.constFind(token);
+    if(it != tokenIds.cend()) {
+        return it.value();
+    }
+
+    const auto id = static_cast<uint32_t>(tokens.size());
+    tokens.push_back(token);
+    postings.emplace_back();
+    tokenIds.insert(token, id);
+
+    return id;
+}
+
+void IndexData::apply(std::vector<PreparedEntry> prepared, const std::vector<int>& removed)
+{
+    std::unordered_map<uint32_t, TokenChanges> changes;
+
+    const auto dropEntry = [this, &changes](int id) {
+        const auto it = entries.find(id);
+        if(it == entries.end()) {
+            return;
+        }
+        for(const uint32_t token : it->second.tokens) {
+            changes[token].removed.push_back(id);
+        }
+        entries.erase(it);
+    };
+
+    for(const int id : removed) {
+        dropEntry(id);
+    }
+
+    for(PreparedEntry& preparedEntry : prepared) {
+        dropEntry(preparedEntry.id);
+
+        Entry entry;
+        entry.track = std::move(preparedEntry.track);
+        entry.text  = std::move(preparedEntry.text);
+        entry.tokens.reserve(preparedEntry.tokens.size());
+
+        for(const QString& token : std::as_const(preparedEntry.tokens)) {
+            const uint32_t id = tokenId(token);
+            entry.tokens.push_back(id);
+            changes[id].added.push_back(preparedEntry.id);
+        }
+
+        maxId = std::max(maxId, preparedEntry.id);
+        entries.insert_or_assign(preparedEntry.id, std::move(entry));
+    }
+
+    // Merge each touched posting list once, rather than once per track
+    for(auto& [token, change] : changes) {
+        std::ranges::sort(change.added);
+        std::ranges::sort(change.removed);
+
+        std::vector<int>& posting = postings[token];
+
+        std::vector<int> kept;
+        kept.reserve(posting.size());
+        std::ranges::set_difference(posting, change.removed, std::back_inserter(kept));
+
+        posting.clear();
+        std::ranges::set_union(kept, change.added, std::back_inserter(posting));
+    }
+}
+} // namespace
+
+namespace Fooyin {
+class TrackSearchIndexPrivate
+{
+public:
+    mutable std::shared_mutex m_mutex;
+    IndexData m_data;
+    uint64_t m_generation{0};
+};
+
+std::optional<bool> TrackSearchIndex::Query::matches(const Track& track) const
+{
+    if(!m_index || track.id() < 0) {
+        return {};
+    }
+
+    const auto& p = m_index->p;
+    const std::shared_lock lock{p->m_mutex};
+
+    const auto it = p->m_data.entries.find(track.id());
+    // An edited copy may not have reached the index yet
+    if(it == p->m_data.entries.cend() || !track.sharesDataWith(it->second.track)) {
+        return {};
+    }
+
+    // Candidates are only valid for the index state they were prepared against
+    if(m_filtered && m_generation == p->m_generation) {
+        const auto id = static_cast<size_t>(track.id());
+        if(id >= m_candidates.size() || !m_candidates[id]) {
+            return false;
+        }
+    }
+
+    const QString& text = it->second.text;
+    return std::ranges::all_of(m_terms, [&text](const QString& term) { return text.contains(term); });
+}
+
+TrackSearchIndex::TrackSearchIndex()
+    : p{std::make_unique<TrackSearchIndexPrivate>()}
+{ }
+
+TrackSearchIndex::~TrackSearchIndex() = default;
+
+void TrackSearchIndex::rebuild(const TrackList& tracks)
+{
+    IndexData data;
+    data.apply(prepareEntries(tracks), {});
+
+    const std::unique_lock lock{p->m_mutex};
+    p->m_data = std::move(data);
+    ++p->m_generation;
+}
+
+void TrackSearchIndex::update(const TrackList& tracks)
+{
+    std::vector<PreparedEntry> prepared = prepareEntries(tracks);
+    if(prepared.empty()) {
+        return;
+    }
+
+    const std::unique_lock lock{p->m_mutex};
+    p->m_data.apply(std::move(prepared), {});
+    ++p->m_generation;
+}
+
+void TrackSearchIndex::remove(const TrackList& tracks)
+{
+    std::vector<int> ids;
+    ids.reserve(tracks.size());
+
+    for(const Track& track : tracks) {
+        if(track.id() >= 0) {
+            ids.push_back(track.id());
+        }
+    }
+
+    if(ids.empty()) {
+        return;
+    }
+
+    const std::unique_lock lock{p->m_mutex};
+    p->m_data.apply({}, ids);
+    ++p->m_generation;
+}
+
+void TrackSearchIndex::clear()
+{
+    const std::unique_lock lock{p->m_mutex};
+    p->m_data = {};
+    ++p->m_generation;
+}
+
+bool TrackSearchIndex::isEmpty() const
+{
+    const std::shared_lock lock{p->m_mutex};
+    return p->m_data.entries.empty();
+}
+
+size_t TrackSearchIndex::size() const
+{
+    const std::shared_lock lock{p->m_mutex};
+    return p->m_data.entries.size();
+}
+
+TrackSearchIndex::Query TrackSearchIndex::prepare(const QStringList& terms) const
+{
+    Query query;
+    query.m_index = this;
+
+    for(const QString& term : terms) {
+        query.m_terms.push_back(Utils::foldForSearch(term));
+    }
+
+    const std::shared_lock lock{p->m_mutex};
+
+    query.m_generation = p->m_generation;
+
+    const IndexData& data = p->m_data;
+    if(data.maxId < 0 || data.maxId > MaxCandidateId) {
+        return query;
+    }
+
+    const auto candidateCount = static_cast<size_t>(data.maxId) + 1;
+    std::vector<bool> pieceCandidates;
+
+    for(const QString& term : std::as_const(query.m_terms)) {
+        // A piece without whitespace can only match inside a single token
+        for(const QString& piece : tokenise(term)) {
+            if(piece.size() < MinCandidateLength) {
+                continue;
+            }
+
+            pieceCandidates.assign(candidateCount, false);
+
+            for(size_t token{0}; token < data.tokens.size(); ++token) {
+                if(!data.postings[token].empty() && data.tokens[token].contains(piece)) {
+                    for(const int id : data.postings[token]) {
+                        pieceCandidates[static_cast<size_t>(id)] = true;
+                    }
+                }
+            }
+
+            if(!query.m_filtered) {
+                query.m_candidates = std::move(pieceCandidates);
+                query.m_filtered   = true;
+            }
+            else {
+                for(size_t id{0}; id < candidateCount; ++id) {
+                    query.m_candidates[id] = query.m_candidates[id] && pieceCandidates[id];
+                }
+            }
+        }
+    }
+
+    return query;
+}
+} // namespace Fooyin
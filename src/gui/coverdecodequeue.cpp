@@ -0,0 +1,252 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "coverdecodequeue.h"
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+using namespace Qt::StringLiterals;
+
+namespace Fooyin {
+class CoverDecodeQueuePrivate
+{
+public:
+    using Order = std::map<std::pair<int, uint64_t>, QString>;
+
+    struct QueuedJob
+    {
+        Order::iterator order;
+        CoverDecodeQueue::Job job;
+    };
+
+    explicit CoverDecodeQueuePrivate(int maxThreads);
+
+    void startWorkers();
+    void runJobs();
+    void requeue(QueuedJob& queued, int priority);
+
+    QThreadPool m_pool;
+    int m_maxThreads;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+    Order m_order;
+    std::unordered_map<QString, QueuedJob> m_jobs;
+    std::unordered_map<QString, int> m_running;
+    uint64_t m_sequence{0};
+    int m_workers{0};
+
+    CoverDecodeQueue::Stats m_stats;
+};
+
+CoverDecodeQueuePrivate::CoverDecodeQueuePrivate(int maxThreads)
+    : m_maxThreads{std::max(maxThreads, 1)}
+{
+    m_pool.setMaxThreadCount(m_maxThreads);
+    m_pool.setObjectName(u"CoverDecodeQueue"_s);
+}
+
+void CoverDecodeQueuePrivate::startWorkers()
+{
+    // Called with m_mutex held
+    const int needed = std::min(static_cast<int>(m_jobs.size()), m_maxThreads) - m_workers;
+    for(int i{0}; i < needed; ++i) {
+        ++m_workers;
+        m_pool.start([this]() { runJobs(); });
+    }
+}
+
+void CoverDecodeQueuePrivate::runJobs()
+{
+    std::unique_lock lock{m_mutex};
+
+    while(!m_order.empty()) {
+        const auto next   = m_order.begin();
+        const QString key = next->second;
+        m_order.erase(next);
+
+        const auto jobIt = m_jobs.find(key);
+        const CoverDecodeQueue::Job job{std::move(jobIt->second.job)};
+        m_jobs.erase(jobIt);
+
+        ++m_running[key];
+        lock.unlock();
+
+        if(job) {
+            job();
+        }
+
+        lock.lock();
+        if(--m_running[key] == 0) {
+            m_running.erase(key);
+        }
+        ++m_stats.decoded;
+    }
+
+    --m_workers;
+    if(m_workers == 0) {
+        m_idle.notify_all();
+    }
+}
+
+void CoverDecodeQueuePrivate::requeue(QueuedJob& queued, int priority)
+{
+    if(priority >= queued.order->first.first) {
+        return;
+    }
+
+    const QString key = queued.order->second;
+    m_order.erase(queued.order);
+    queued.order = m_order.emplace(std::pair{priority, m_sequence++}, key).first;
+}
+
+double CoverDecodeQueue::Stats::hitRate() const
+{
+    const uint64_t requests = hits + queued + coalesced;
+    return requests == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(requests);
+}
+
+CoverDecodeQueue::CoverDecodeQueue(int maxThreads)
+    : p{std::make_unique<CoverDecodeQueuePrivate>(maxThreads)}
+{ }
+
+CoverDecodeQueue::~CoverDecodeQueue()
+{
+    {
+        const std::scoped_lock lock{p->m_mutex};
+        p->m_stats.cancelled += p->m_jobs.size();
+        p->m_order.clear();
+        p->m_jobs.clear();
+    }
+
+    p->m_pool.waitForDone();
+}
+
+int CoverDecodeQueue::defaultThreadCount()
+{
+    // Leave room for playback, scanning and the rest of the global pool
+    return std::clamp(QThread::idealThreadCount() / 2, 1, 4);
+}
+
+int CoverDecodeQueue::maxThreads() const
+{
+    return p->m_maxThreads;
+}
+
+bool CoverDecodeQueue::enqueue(const QString& key, int priority, Job job)
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    if(const auto it = p->m_jobs.find(key); it != p->m_jobs.end()) {
+        p->requeue(it->second, priority);
+        ++p->m_stats.coalesced;
+        return false;
+    }
+
+    const auto order = p->m_order.emplace(std::pair{priority, p->m_sequence++}, key).first;
+    p->m_jobs.emplace(key, CoverDecodeQueuePrivate::QueuedJob{order, std::move(job)});
+    ++p->m_stats.queued;
+
+    p->startWorkers();
+
+    return true;
+}
+
+bool CoverDecodeQueue::coalesce(const QString& key, int priority)
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    if(const auto it = p->m_jobs.find(key); it != p->m_jobs.end()) {
+        p->requeue(it->second, priority);
+        ++p->m_stats.coalesced;
+        return true;
+    }
+    if(p->m_running.contains(key)) {
+        ++p->m_stats.coalesced;
+        return true;
+    }
+
+    return false;
+}
+
+bool CoverDecodeQueue::cancel(const QString& key)
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    const auto it = p->m_jobs.find(key);
+    if(it == p->m_jobs.end()) {
+        return false;
+    }
+
+    p->m_order.erase(it->second.order);
+    p->m_jobs.erase(it);
+    ++p->m_stats.cancelled;
+
+    return true;
+}
+
+bool CoverDecodeQueue::isQueued(const QString& key) const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return p->m_jobs.contains(key);
+}
+
+bool CoverDecodeQueue::isRunning(const QString& key) const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return p->m_running.contains(key);
+}
+
+int CoverDecodeQueue::queuedCount() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return static_cast<int>(p->m_jobs.size());
+}
+
+void CoverDecodeQueue::recordHit()
+{
+    const std::scoped_lock lock{p->m_mutex};
+    ++p->m_stats.hits;
+}
+
+CoverDecodeQueue::Stats CoverDecodeQueue::stats() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return p->m_stats;
+}
+
+void CoverDecodeQueue::resetStats()
+{
+    const std::scoped_lock lock{p->m_mutex};
+    p->m_stats = {};
+}
+
+void CoverDecodeQueue::waitForDone()
+{
+    std::unique_lock lock{p->m_mutex};
+    p->m_idle.wait(lock, [this]() { return p->m_workers == 0; });
+}
+} // namespace Fooyin
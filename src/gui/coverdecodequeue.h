@@ -0,0 +1,104 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fygui_export.h"
+
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+namespace Fooyin {
+class CoverDecodeQueuePrivate;
+
+/*!
+ * Bounded worker pool for decoding cover thumbnails.
+ *
+ * Jobs are keyed by cover and run lowest priority first, where the priority is the
+ * distance of the cover from the visible area of a view. Requests for a cover which is
+ * already queued are coalesced into the existing job, and jobs which are no longer
+ * needed can be cancelled until they start.
+ */
+class FYGUI_EXPORT CoverDecodeQueue
+{
+public:
+    using Job = std::function<void()>;
+
+    struct Stats
+    {
+        //! Jobs accepted into the queue.
+        uint64_t queued{0};
+        //! Requests merged into a job which was already queued or running.
+        uint64_t coalesced{0};
+        //! Jobs which have run.
+        uint64_t decoded{0};
+        //! Jobs removed before they started.
+        uint64_t cancelled{0};
+        //! Requests served without needing a job.
+        uint64_t hits{0};
+
+        //! Returns the fraction of requests served without needing a job.
+        [[nodiscard]] double hitRate() const;
+    };
+
+    explicit CoverDecodeQueue(int maxThreads = defaultThreadCount());
+    //! Drops all queued jobs and waits for running ones to finish.
+    ~CoverDecodeQueue();
+
+    CoverDecodeQueue(const CoverDecodeQueue&)            = delete;
+    CoverDecodeQueue& operator=(const CoverDecodeQueue&) = delete;
+
+    static int defaultThreadCount();
+
+    [[nodiscard]] int maxThreads() const;
+
+    /*!
+     * Queues @p job under @p key. Lower priorities run first, and jobs of the same priority
+     * run in the order they were queued.
+     * @returns false if a job for @p key is already queued, in which case the request is
+     * coalesced into it and @p job is discarded.
+     */
+    bool enqueue(const QString& key, int priority, Job job);
+    /*!
+     * Merges a request into the job for @p key, raising its priority to @p priority if it's
+     * still queued.
+     * @returns false if no job for @p key is queued or running.
+     */
+    bool coalesce(const QString& key, int priority);
+    //! Removes the job for @p key if it hasn't started. Returns true if a job was removed.
+    bool cancel(const QString& key);
+
+    [[nodiscard]] bool isQueued(const QString& key) const;
+    [[nodiscard]] bool isRunning(const QString& key) const;
+    [[nodiscard]] int queuedCount() const;
+
+    //! Records a request which was served without queueing a job (e.g. from a cache).
+    void recordHit();
+    [[nodiscard]] Stats stats() const;
+    void resetStats();
+
+    //! Blocks until no jobs are queued or running.
+    void waitForDone();
+
+private:
+    std::unique_ptr<CoverDecodeQueuePrivate> p;
+};
+} // namespace Fooyin
@@ -19,7 +19,9 @@
 
 #include <gui/coverprovider.h>
 
+#include "coverdecodequeue.h"
 #include "internalguisettings.h"
+#include "thumbnailstore.h"
 
 #include <core/engine/audioloader.h>
 #include <core/scripting/scriptparser.h>
@@ -45,7 +47,9 @@
 #include <QLoggingCategory>
 #include <QMimeDatabase>
 #include <QPromise>
+#include <QRegularExpression>
 
+#include <cmath>
 #include <set>
 #include <unordered_map>
 
@@ -55,6 +59,8 @@ using namespace Qt::StringLiterals;
 
 constexpr auto MaxSize            = 1024;
 constexpr int64_t RetryIntervalMs = 5000;
+// Decode priority of covers requested for painting; prefetched covers use their distance from the viewport
+constexpr int VisiblePriority = 0;
 
 QCache<QString, QPixmap> Fooyin::CoverProvider::m_coverCache;
 // Used to keep track of tracks without artwork so we don't query the filesystem more than necessary
@@ -82,9 +88,37 @@ QString generateThumbCoverKey(const QString& key, int size)
     return Fooyin::Utils::generateHash(u"Thumb|%1|%2"_s.arg(key).arg(size));
 }
 
-QString coverThumbnailPath(const QString& key)
+Fooyin::ThumbnailStore& thumbnailStore()
 {
-    return Fooyin::Gui::coverPath() + key + u".jpg"_s;
+    static Fooyin::ThumbnailStore store{[]() {
+        const QString path = Fooyin::Gui::coverPath() + u"thumbnails"_s;
+        if(!QFileInfo::exists(path)) {
+            // Thumbnails used to be stored as a file per cover, named by its key. Other files share the
+            // directory, so only names matching a key are removed.
+            static const QRegularExpression legacyThumbnail{u"^[0-9a-f]{32}\\.jpg$"_s};
+
+            QDir cache{Fooyin::Gui::coverPath()};
+            const QStringList files = cache.entryList({u"*.jpg"_s}, QDir::Files);
+            for(const QString& file : files) {
+                if(legacyThumbnail.match(file).hasMatch()) {
+                    cache.remove(file);
+                }
+            }
+        }
+        return path;
+    }()};
+    return store;
+}
+
+Fooyin::CoverDecodeQueue& decodeQueue()
+{
+    static Fooyin::CoverDecodeQueue queue;
+    return queue;
+}
+
+int thumbnailSizeClass(int size, double dpr)
+{
+    return static_cast<int>(std::lround(size * dpr));
 }
 
 QString noCoverCacheKey(int size)
@@ -102,15 +136,6 @@ QFuture<T> makeReadyFuture(T value)
     return promise.future();
 }
 
-bool saveThumbnail(const QImage& cover, const QString& key)
-{
-    QFile file{coverThumbnailPath(key)};
-    if(file.open(QIODevice::WriteOnly)) {
-        return cover.save(&file, "JPG", 85);
-    }
-    return false;
-}
-
 QSize calculateScaledSize(const QSize& originalSize, int maxSize)
 {
     int newWidth{0};
@@ -335,7 +360,7 @@ bool hasEmbeddedCover(const CoverLoader& loader)
     return !coverData.isEmpty();
 }
 
-QImage loadImageFromEmbedded(const CoverLoader& loader, const QString& cachePath)
+QImage loadImageFromEmbedded(const CoverLoader& loader)
 {
     const QByteArray coverData = loader.audioLoader->readTrackCover(loader.track, loader.type);
     if(coverData.isEmpty()) {
@@ -344,11 +369,17 @@ QImage loadImageFromEmbedded(const CoverLoader& loader, const QString& cachePath
 
     QImage cover = loader.originalSize ? readImageOriginal(coverData) : readImage(coverData);
 
-    if(loader.isThumb && !cover.isNull() && !QFileInfo::exists(cachePath)) {
-        if(!saveThumbnail(cover, loader.key)) {
+    if(loader.isThumb && !cover.isNull()) {
+        auto& store      = thumbnailStore();
+        const double dpr = Fooyin::Utils::windowDpr();
+
+        if(!store.contains(loader.key, Fooyin::ThumbnailStore::SourceClass)
+           && !store.insert(loader.key, Fooyin::ThumbnailStore::SourceClass, cover)) {
             qCInfo(COV_PROV) << "Failed to save cover thumbnail for track:" << loader.track.filepath();
         }
-        cover = Fooyin::Utils::scaleImage(cover, loader.size, Fooyin::Utils::windowDpr());
+
+        cover = Fooyin::Utils::scaleImage(cover, loader.size, dpr);
+        store.insert(loader.key, thumbnailSizeClass(loader.size, dpr), cover);
     }
 
     return cover;
@@ -363,20 +394,39 @@ bool hasCoverImage(const CoverLoader& loader)
     return hasImageInDirectory(loader) || hasEmbeddedCover(loader);
 }
 
+QImage loadStoredThumbnail(const CoverLoader& loader)
+{
+    auto& store         = thumbnailStore();
+    const double dpr    = Fooyin::Utils::windowDpr();
+    const int sizeClass = thumbnailSizeClass(loader.size, dpr);
+
+    QImage cover = store.image(loader.key, sizeClass);
+    if(cover.isNull()) {
+        // Scale from the stored source image and keep the result for next time
+        const QImage source = store.image(loader.key, Fooyin::ThumbnailStore::SourceClass);
+        if(source.isNull()) {
+            return {};
+        }
+        cover = Fooyin::Utils::scaleImage(source, loader.size, dpr);
+        store.insert(loader.key, sizeClass, cover);
+    }
+
+    cover.setDevicePixelRatio(dpr);
+    return cover;
+}
+
 CoverLoader loadCoverImage(const CoverLoader& loader)
 {
     CoverLoader result{loader};
 
-    const QString cachePath = coverThumbnailPath(loader.key);
-
     // First check disk cache
-    if(result.isThumb && QFileInfo::exists(cachePath)) {
-        result.cover = readImage(cachePath, loader.size, u"cached"_s);
+    if(result.isThumb && result.size != CoverProvider::None) {
+        result.cover = loadStoredThumbnail(loader);
     }
 
     if(prefersEmbedded(loader)) {
         if(result.cover.isNull()) {
-            result.cover = loadImageFromEmbedded(loader, cachePath);
+            result.cover = loadImageFromEmbedded(loader);
         }
         if(result.cover.isNull()) {
             result.cover = loadImageFromDirectory(loader);
@@ -387,7 +437,7 @@ CoverLoader loadCoverImage(const CoverLoader& loader)
             result.cover = loadImageFromDirectory(loader);
         }
         if(result.cover.isNull()) {
-            result.cover = loadImageFromEmbedded(loader, cachePath);
+            result.cover = loadImageFromEmbedded(loader);
         }
     }
 
@@ -407,12 +457,17 @@ public:
     static QPixmap processLoadResult(const CoverLoader& loader);
     static QPixmap processOriginalLoadResult(const CoverLoader& loader);
     static void cachePixmap(const QString& key, const QPixmap& cover, int size = 0);
-    void fetchCover(const QString& key, const Track& track, Track::Cover type, bool thumbnail,
-                    ThumbnailSize size = None);
+    void fetchCover(const QString& key, const Track& track, Track::Cover type);
     [[nodiscard]] QFuture<QPixmap> loadCover(const Track& track, Track::Cover type) const;
     [[nodiscard]] QFuture<QPixmap> loadOriginalCover(const Track& track, Track::Cover type) const;
-    [[nodiscard]] QFuture<QPixmap> loadThumbnail(const QString& key, const Track& track, ThumbnailSize size,
-                                                 Track::Cover type) const;
+
+    [[nodiscard]] CoverLoader thumbnailLoader(const QString& key, const Track& track, Track::Cover type,
+                                              ThumbnailSize size) const;
+    [[nodiscard]] QString thumbnailJobKey(const QString& key, ThumbnailSize size) const;
+    [[nodiscard]] bool hasThumbnailRequest(const QString& key, ThumbnailSize size) const;
+    void queueThumbnail(const CoverLoader& loader, int priority, std::shared_ptr<QPromise<QPixmap>> promise = {});
+    void finishThumbnail(const QString& jobKey, const CoverLoader& result);
+    void cancelStaleThumbnails(const std::set<QString>& current);
     QPixmap loadCachedCover(const QString& key, int size = 0);
     [[nodiscard]] QFuture<bool> hasCover(const QString& key, const Track& track, Track::Cover type) const;
     [[nodiscard]] QString thumbnailCoverKey(const Track& track, Track::Cover type) const;
@@ -425,6 +480,15 @@ public:
 
     bool m_usePlaceholder{true};
     std::set<QString> m_pendingCovers;
+
+    struct ThumbnailRequest
+    {
+        std::vector<std::shared_ptr<QPromise<QPixmap>>> promises;
+        bool notify{false};
+    };
+    std::unordered_map<QString, ThumbnailRequest> m_thumbnailRequests;
+    uint64_t m_prefetchGeneration{0};
+
     mutable std::unordered_map<QString, int64_t> m_noCoverRetryAfterMs;
 
     CoverPaths m_paths;
@@ -450,6 +514,17 @@ CoverProvider::CoverProviderPrivate::CoverProviderPrivate(CoverProvider* self, s
     updateCache(m_settings->value<Settings::Gui::Internal::PixmapCacheSize>());
     m_settings->subscribe<Settings::Gui::Internal::PixmapCacheSize>(m_self, updateCache);
 
+    // Opening the store, and any eviction or compaction a smaller size causes, happen off the main thread
+    auto updateThumbnailStore = [settings = m_settings]() {
+        Utils::asyncExec([settings]() {
+            const int sizeMb = settings->value<Settings::Gui::Internal::ThumbnailCacheSize>();
+            thumbnailStore().setMaxSize(static_cast<uint64_t>(sizeMb) * 1024 * 1024);
+        });
+    };
+
+    updateThumbnailStore();
+    m_settings->subscribe<Settings::Gui::Internal::ThumbnailCacheSize>(m_self, updateThumbnailStore);
+
     m_settings->subscribe<Settings::Gui::Internal::TrackCoverPaths>(
         m_self, [this](const QVariant& var) { m_paths = var.value<CoverPaths>(); });
     m_settings->subscribe<Settings::Gui::Internal::TrackCoverSourcePreference>(m_self, [this](int preference) {
@@ -559,8 +634,7 @@ void CoverProvider::CoverProviderPrivate::cachePixmap(const QString& key, const
     }
 }
 
-void CoverProvider::CoverProviderPrivate::fetchCover(const QString& key, const Track& track, Track::Cover type,
-                                                     bool thumbnail, ThumbnailSize size)
+void CoverProvider::CoverProviderPrivate::fetchCover(const QString& key, const Track& track, Track::Cover type)
 {
     CoverLoader loader;
     loader.key              = key;
@@ -569,8 +643,6 @@ void CoverProvider::CoverProviderPrivate::fetchCover(const QString& key, const T
     loader.sourcePreference = m_sourcePreference;
     loader.audioLoader      = m_audioLoader;
     loader.paths            = m_paths;
-    loader.isThumb          = thumbnail;
-    loader.size             = size;
 
     auto loaderResult = Utils::asyncExec([loader]() -> CoverLoader {
         auto result = loadCoverImage(loader);
@@ -612,8 +684,8 @@ QFuture<QPixmap> CoverProvider::CoverProviderPrivate::loadOriginalCover(const Tr
     return loaderResult.then(m_self, [](const CoverLoader& result) { return processOriginalLoadResult(result); });
 }
 
-QFuture<QPixmap> CoverProvider::CoverProviderPrivate::loadThumbnail(const QString& key, const Track& track,
-                                                                    ThumbnailSize size, Track::Cover type) const
+CoverLoader CoverProvider::CoverProviderPrivate::thumbnailLoader(const QString& key, const Track& track,
+                                                                 Track::Cover type, ThumbnailSize size) const
 {
     CoverLoader loader;
     loader.key              = key;
@@ -625,22 +697,84 @@ QFuture<QPixmap> CoverProvider::CoverProviderPrivate::loadThumbnail(const QStrin
     loader.isThumb          = true;
     loader.size             = size;
 
-    auto loaderResult = Utils::asyncExec([loader]() -> CoverLoader {
-        auto result = loadCoverImage(loader);
-        return result;
+    return loader;
+}
+
+QString CoverProvider::CoverProviderPrivate::thumbnailJobKey(const QString& key, ThumbnailSize size) const
+{
+    // The decode queue is shared, so keep each provider's requests separate
+    return u"%1|%2"_s.arg(reinterpret_cast<quintptr>(this)).arg(generateThumbCoverKey(key, size));
+}
+
+bool CoverProvider::CoverProviderPrivate::hasThumbnailRequest(const QString& key, ThumbnailSize size) const
+{
+    return m_thumbnailRequests.contains(thumbnailJobKey(key, size));
+}
+
+void CoverProvider::CoverProviderPrivate::queueThumbnail(const CoverLoader& loader, int priority,
+                                                         std::shared_ptr<QPromise<QPixmap>> promise)
+{
+    const QString jobKey = thumbnailJobKey(loader.key, loader.size);
+
+    auto [requestIt, inserted] = m_thumbnailRequests.try_emplace(jobKey);
+    auto& request              = requestIt->second;
+    if(promise) {
+        request.promises.push_back(std::move(promise));
+    }
+    else {
+        request.notify = true;
+    }
+
+    if(!inserted) {
+        decodeQueue().coalesce(jobKey, priority);
+        return;
+    }
+
+    auto result = std::make_shared<QPromise<CoverLoader>>();
+    result->start();
+    result->future().then(m_self, [this, jobKey](const CoverLoader& loaded) { finishThumbnail(jobKey, loaded); });
+
+    // If the job is cancelled the promise is dropped unfinished, so the continuation never runs
+    decodeQueue().enqueue(jobKey, priority, [result, loader]() {
+        result->addResult(loadCoverImage(loader));
+        result->finish();
     });
+}
 
-    return loaderResult.then(m_self, [this, key, size](const CoverLoader& result) {
-        clearNoCoverRetry(key);
-        m_noCoverKeys.erase(key);
-        const QPixmap cover = processLoadResult(result);
-        if(cover.isNull()) {
-            m_noCoverKeys.emplace(key);
-        }
-        else {
-            cachePixmap(key, cover, size);
-        }
-        return cover;
+void CoverProvider::CoverProviderPrivate::finishThumbnail(const QString& jobKey, const CoverLoader& result)
+{
+    auto request = m_thumbnailRequests.extract(jobKey);
+    if(request.empty()) {
+        return;
+    }
+
+    clearNoCoverRetry(result.key);
+    m_noCoverKeys.erase(result.key);
+
+    const QPixmap cover = processLoadResult(result);
+    if(cover.isNull()) {
+        m_noCoverKeys.emplace(result.key);
+    }
+    else {
+        cachePixmap(result.key, cover, result.size);
+    }
+
+    for(const auto& promise : request.mapped().promises) {
+        promise->addResult(cover);
+        promise->finish();
+    }
+
+    if(request.mapped().notify && !cover.isNull()) {
+        Q_EMIT m_self->coverAdded(result.track);
+    }
+}
+
+void CoverProvider::CoverProviderPrivate::cancelStaleThumbnails(const std::set<QString>& current)
+{
+    std::erase_if(m_thumbnailRequests, [&current](const auto& item) {
+        const auto& [jobKey, request] = item;
+        // Callers of the async API are always given a result
+        return request.promises.empty() && !current.contains(jobKey) && decodeQueue().cancel(jobKey);
     });
 }
 
@@ -694,7 +828,12 @@ CoverProvider::CoverProvider(std::shared_ptr<AudioLoader> audioLoader, SettingsM
     , p{std::make_unique<CoverProviderPrivate>(this, std::move(audioLoader), settings)}
 { }
 
-CoverProvider::~CoverProvider() = default;
+CoverProvider::~CoverProvider()
+{
+    for(const auto& [jobKey, request] : p->m_thumbnailRequests) {
+        decodeQueue().cancel(jobKey);
+    }
+}
 
 void CoverProvider::setUsePlaceholder(bool enabled)
 {
@@ -743,7 +882,7 @@ QPixmap CoverProvider::trackCover(const Track& track, Track::Cover type) const
         }
 
         p->m_pendingCovers.emplace(coverKey);
-        p->fetchCover(coverKey, track, type, false);
+        p->fetchCover(coverKey, track, type);
     }
 
     return p->m_usePlaceholder ? p->loadNoCover() : QPixmap{};
@@ -784,10 +923,17 @@ QFuture<QPixmap> CoverProvider::trackCoverThumbnailAsync(const Track& track, Thu
     }
 
     if(const QPixmap cover = p->loadCachedCover(coverKey, size); !cover.isNull()) {
+        decodeQueue().recordHit();
         return makeReadyFuture(cover);
     }
 
-    return p->loadThumbnail(coverKey, track, size, type);
+    auto promise = std::make_shared<QPromise<QPixmap>>();
+    promise->start();
+    QFuture<QPixmap> future = promise->future();
+
+    p->queueThumbnail(p->thumbnailLoader(coverKey, track, type, size), VisiblePriority, std::move(promise));
+
+    return future;
 }
 
 QFuture<QPixmap> CoverProvider::trackCoverThumbnailAsync(const Track& track, const QSize& size, Track::Cover type) const
@@ -803,25 +949,21 @@ QPixmap CoverProvider::trackCoverThumbnail(const Track& track, ThumbnailSize siz
 
     const QString coverKey = p->thumbnailCoverKey(track, type);
     if(m_noCoverKeys.contains(coverKey)) {
-        if(!p->m_pendingCovers.contains(coverKey) && p->shouldRetryNoCover(coverKey)) {
+        if(!p->hasThumbnailRequest(coverKey, size) && p->shouldRetryNoCover(coverKey)) {
             m_noCoverKeys.erase(coverKey);
-            p->m_pendingCovers.emplace(coverKey);
-            p->fetchCover(coverKey, track, type, true, size);
+            p->queueThumbnail(p->thumbnailLoader(coverKey, track, type, size), VisiblePriority);
         }
 
         return p->m_usePlaceholder ? p->loadNoCover(size) : QPixmap{};
     }
 
-    if(!p->m_pendingCovers.contains(coverKey)) {
-        QPixmap cover = p->loadCachedCover(coverKey, size);
-        if(!cover.isNull()) {
-            return cover;
-        }
-
-        p->m_pendingCovers.emplace(coverKey);
-        p->fetchCover(coverKey, track, type, true, size);
+    if(QPixmap cover = p->loadCachedCover(coverKey, size); !cover.isNull()) {
+        decodeQueue().recordHit();
+        return cover;
     }
 
+    p->queueThumbnail(p->thumbnailLoader(coverKey, track, type, size), VisiblePriority);
+
     return p->m_usePlaceholder ? p->loadNoCover(size) : QPixmap{};
 }
 
@@ -830,6 +972,79 @@ QPixmap CoverProvider::trackCoverThumbnail(const Track& track, const QSize& size
     return trackCoverThumbnail(track, findThumbnailSize(size), type);
 }
 
+void CoverProvider::prefetchThumbnails(const TrackList& tracks, ThumbnailSize size, Track::Cover type) const
+{
+    if(size == None) {
+        return;
+    }
+
+    std::set<QString> current;
+    std::vector<std::pair<CoverLoader, int>> pending;
+    std::vector<ThumbnailStore::Lookup> lookups;
+
+    const double dpr = Utils::windowDpr();
+    int priority{VisiblePriority};
+
+    for(const Track& track : tracks) {
+        ++priority;
+        if(!track.isValid()) {
+            continue;
+        }
+
+        const QString coverKey = p->thumbnailCoverKey(track, type);
+        if(!current.emplace(p->thumbnailJobKey(coverKey, size)).second || m_noCoverKeys.contains(coverKey)
+           || m_coverCache.contains(generateThumbCoverKey(coverKey, size))) {
+            continue;
+        }
+
+        if(p->hasThumbnailRequest(coverKey, size)) {
+            // Already queued, so only its priority needs updating
+            p->queueThumbnail(p->thumbnailLoader(coverKey, track, type, size), priority);
+            continue;
+        }
+
+        pending.emplace_back(p->thumbnailLoader(coverKey, track, type, size), priority);
+        lookups.emplace_back(coverKey, thumbnailSizeClass(size, dpr));
+    }
+
+    p->cancelStaleThumbnails(current);
+
+    if(pending.empty()) {
+        return;
+    }
+
+    // Read every stored thumbnail in one pass in on-disk order, and only queue decode jobs for the rest
+    const uint64_t generation = ++p->m_prefetchGeneration;
+
+    auto applyStored = [d = p.get(), pending = std::move(pending), generation, dpr](const std::vector<QImage>& images) {
+        for(size_t i{0}; i < pending.size(); ++i) {
+            const auto& [loader, loaderPriority] = pending.at(i);
+
+            if(!images.at(i).isNull()) {
+                CoverLoader result{loader};
+                result.cover = images.at(i);
+                result.cover.setDevicePixelRatio(dpr);
+
+                CoverProviderPrivate::cachePixmap(loader.key, CoverProviderPrivate::processLoadResult(result),
+                                                  loader.size);
+                Q_EMIT d->m_self->coverAdded(loader.track);
+            }
+            // A newer prefetch has queued whatever is still close to being shown
+            else if(generation == d->m_prefetchGeneration) {
+                d->queueThumbnail(loader, loaderPriority);
+            }
+        }
+    };
+
+    Utils::asyncExec([lookups = std::move(lookups)]() { return thumbnailStore().images(lookups); })
+        .then(p->m_self, std::move(applyStored));
+}
+
+void CoverProvider::prefetchThumbnails(const TrackList& tracks, const QSize& size, Track::Cover type) const
+{
+    prefetchThumbnails(tracks, findThumbnailSize(size), type);
+}
+
 QPixmap CoverProvider::placeholderCover() const
 {
     return p->loadNoCover();
@@ -864,8 +1079,22 @@ CoverProvider::ThumbnailSize CoverProvider::findThumbnailSize(const QSize& size)
     return Full;
 }
 
+CoverProvider::ThumbnailStats CoverProvider::thumbnailStats()
+{
+    const auto stats = decodeQueue().stats();
+
+    return {.queued    = stats.queued,
+            .coalesced = stats.coalesced,
+            .decoded   = stats.decoded,
+            .cancelled = stats.cancelled,
+            .hits      = stats.hits,
+            .hitRate   = stats.hitRate()};
+}
+
 void CoverProvider::clearCache()
 {
+    thumbnailStore().clear();
+
     QDir cache{Gui::coverPath()};
     cache.removeRecursively();
 
@@ -892,8 +1121,7 @@ void CoverProvider::removeFromCache(const Track& track)
 void CoverProvider::removeFromCache(const Track& track, const QString& thumbnailGroup)
 {
     auto removeKey = [](const QString& key) {
-        QDir cache{Fooyin::Gui::coverPath()};
-        cache.remove(coverThumbnailPath(key));
+        thumbnailStore().remove(key);
         m_noCoverKeys.erase(key);
         m_coverCache.remove(key);
 
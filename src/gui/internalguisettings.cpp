@@ -36,7 +36,8 @@
 
 using namespace Qt::StringLiterals;
 
-constexpr int PixmapCacheSize = 64;
+constexpr int PixmapCacheSize    = 64;
+constexpr int ThumbnailCacheSize = 512;
 
 namespace {
 Fooyin::CoverPaths defaultCoverPaths()
@@ -138,6 +139,7 @@ GuiSettings::GuiSettings(SettingsManager* settingsManager)
     m_settings->createSetting<Internal::PlaylistImagePaddingTop>(0, u"PlaylistWidget/ImagePaddingTop"_s);
     m_settings->createSetting<Internal::PixmapCacheSize>(
         static_cast<int>(PixmapCacheSize * std::pow(qApp->devicePixelRatio(), 2)), u"Interface/PixmapCacheSize"_s);
+    m_settings->createSetting<Internal::ThumbnailCacheSize>(ThumbnailCacheSize, u"Artwork/ThumbnailCacheSize"_s);
     m_settings->createSetting<Internal::EditableLayoutMargin>(-1, u"Interface/EditableLayoutMargin"_s);
     m_settings->createSetting<Internal::PlaylistTabsAddButton>(false, u"PlaylistTabs/ShowAddButton"_s);
     m_settings->createSetting<Internal::ShowTrayIcon>(false, u"Interface/ShowTrayIcon"_s);
@@ -163,6 +165,7 @@ GuiSettings::GuiSettings(SettingsManager* settingsManager)
     m_settings->createSetting<Internal::ImageAllocationLimit>(QImageReader::allocationLimit(),
                                                               u"Interface/ImageAllocationLimit"_s);
     m_settings->createSetting<Internal::PlaylistTrackPreloadCount>(2000, u"Playlist/TrackPreloadCount"_s);
+    m_settings->createSetting<Internal::PlaylistLazyRows>(false, u"Playlist/LazyRows"_s);
     m_settings->createSetting<Internal::PlaylistInlineTagEditing>(false, u"PlaylistWidget/InlineTagEditing"_s);
     m_settings->createSetting<Internal::ContextMenuTrackDisabledSections>(
         QStringList{QString::fromLatin1(Constants::Actions::CopyLocation),
@@ -176,6 +176,8 @@ enum GuiInternalSettings : uint32_t
     ContextMenuDirBrowserLayout              = 52 | Type::StringList,
     ContextMenuLayoutEditingDisabledSections = 53 | Type::StringList,
     ContextMenuLayoutEditingLayout           = 54 | Type::StringList,
+    PlaylistLazyRows                         = 55 | Type::Bool,
+    ThumbnailCacheSize                       = 56 | Type::Int,
 };
 Q_ENUM_NS(GuiInternalSettings)
 } // namespace Settings::Gui::Internal
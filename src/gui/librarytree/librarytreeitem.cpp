@@ -22,6 +22,9 @@
 #include <core/constants.h>
 #include <core/library/tracksort.h>
 
+#include <unordered_map>
+#include <unordered_set>
+
 namespace {
 Fooyin::RichText plainTextToRichText(const QString& text)
 {
@@ -257,6 +260,21 @@ void LibraryTreeItem::removeTrack(const Track& track)
     std::erase_if(m_tracks, [track](const Track& child) { return child.id() == track.id(); });
 }
 
+void LibraryTreeItem::removeTracks(const TrackList& tracks)
+{
+    if(m_tracks.empty() || tracks.empty()) {
+        return;
+    }
+
+    std::unordered_set<int> ids;
+    ids.reserve(tracks.size());
+    for(const Track& track : tracks) {
+        ids.emplace(track.id());
+    }
+
+    std::erase_if(m_tracks, [&ids](const Track& child) { return ids.contains(child.id()); });
+}
+
 void LibraryTreeItem::replaceTrack(const Track& track)
 {
     if(m_tracks.empty()) {
@@ -265,6 +283,25 @@ void LibraryTreeItem::replaceTrack(const Track& track)
     std::ranges::replace_if(m_tracks, [track](const Track& child) { return child.id() == track.id(); }, track);
 }
 
+void LibraryTreeItem::replaceTracks(const TrackList& tracks)
+{
+    if(m_tracks.empty() || tracks.empty()) {
+        return;
+    }
+
+    std::unordered_map<int, const Track*> replacements;
+    replacements.reserve(tracks.size());
+    for(const Track& track : tracks) {
+        replacements.emplace(track.id(), &track);
+    }
+
+    for(Track& child : m_tracks) {
+        if(const auto it = replacements.find(child.id()); it != replacements.end()) {
+            child = *it->second;
+        }
+    }
+}
+
 void LibraryTreeItem::sortTracks(TrackSorter& sorter, const QString& script)
 {
     if(m_tracks.empty() || script.isEmpty()) {
@@ -93,6 +93,13 @@ struct cmpItems
     }
 };
 
+// Nodes which lost tracks, split by whether they are already part of the visible tree
+struct AffectedItems
+{
+    std::set<Fooyin::LibraryTreeItem*, cmpItems> items;
+    std::set<Fooyin::LibraryTreeItem*> pendingItems;
+};
+
 Fooyin::LibraryTreeItem* treeItem(const QModelIndex& index)
 {
     return static_cast<Fooyin::LibraryTreeItem*>(index.internalPointer());
@@ -268,6 +275,9 @@ public:
     [[nodiscard]] int summaryChildCountForScript();
 
     void removeTracks(const TrackList& tracks);
+    void removeTrackFromNodes(const Track& track, const std::vector<Md5Hash>& keys, AffectedItems& affected);
+    void pruneAffectedItems(const AffectedItems& affected, const ItemKeyMap& incomingItems);
+    void applyTrackUpdates(PendingTreeData& data);
     void mergeTrackParents(const TrackIdNodeMap& parents);
 
     void batchFinished(const PendingTreeDataPtr& data);
@@ -307,7 +317,7 @@ public:
     std::unordered_set<Md5Hash> m_addedNodes;
     bool m_addingTracks{false};
 
-    TrackList m_tracksPendingRemoval;
+    std::unordered_map<int, Track> m_tracksPendingUpdate;
     ItemKeyMap m_pendingRichTitleUpdates;
 
     Player::PlayState m_playingState;
@@ -444,34 +454,56 @@ void LibraryTreeModelPrivate::startRichTitleUpdate(ItemKeyMap items)
 
 void LibraryTreeModelPrivate::removeTracks(const TrackList& tracks)
 {
-    std::set<LibraryTreeItem*, cmpItems> items;
-    std::set<LibraryTreeItem*> pendingItems;
-    ItemKeyMap itemsToUpdate;
+    AffectedItems affected;
 
     for(const Track& track : tracks) {
-        const int id = track.id();
-        if(!m_trackParents.contains(id)) {
+        const auto parentIt = m_trackParents.find(track.id());
+        if(parentIt == m_trackParents.end()) {
             continue;
         }
 
-        const auto trackNodes = m_trackParents[id];
-        for(const auto& node : trackNodes) {
-            if(m_nodes.contains(node)) {
-                LibraryTreeItem* item = &m_nodes[node];
-                item->removeTrack(track);
-                if(item->pending()) {
-                    pendingItems.emplace(item);
-                }
-                else {
-                    items.emplace(item);
-                }
-            }
+        removeTrackFromNodes(track, parentIt->second, affected);
+        m_trackParents.erase(parentIt);
+    }
+
+    pruneAffectedItems(affected, {});
+}
+
+void LibraryTreeModelPrivate::removeTrackFromNodes(const Track& track, const std::vector<Md5Hash>& keys,
+                                                   AffectedItems& affected)
+{
+    for(const auto& key : keys) {
+        const auto nodeIt = m_nodes.find(key);
+        if(nodeIt == m_nodes.end()) {
+            continue;
+        }
+
+        LibraryTreeItem* item = &nodeIt->second;
+        item->removeTrack(track);
+        if(item->pending()) {
+            affected.pendingItems.emplace(item);
+        }
+        else {
+            affected.items.emplace(item);
         }
-        m_trackParents.erase(id);
     }
+}
+
+void LibraryTreeModelPrivate::pruneAffectedItems(const AffectedItems& affected, const ItemKeyMap& incomingItems)
+{
+    ItemKeyMap itemsToUpdate;
 
-    for(const LibraryTreeItem* item : pendingItems) {
-        if(item->trackCount() == 0) {
+    // Nodes about to receive tracks from the current batch are kept, so they aren't removed and re-inserted
+    const auto isEmpty = [&incomingItems](const LibraryTreeItem* item) {
+        if(item->trackCount() > 0) {
+            return false;
+        }
+        const auto incomingIt = incomingItems.find(item->key());
+        return incomingIt == incomingItems.end() || incomingIt->second.trackCount() == 0;
+    };
+
+    for(const LibraryTreeItem* item : affected.pendingItems) {
+        if(isEmpty(item)) {
             removePendingNode(item->key());
             m_nodes.erase(item->key());
         }
@@ -480,8 +512,8 @@ void LibraryTreeModelPrivate::removeTracks(const TrackList& tracks)
         }
     }
 
-    for(auto* item : items) {
-        if(item->trackCount() == 0) {
+    for(auto* item : affected.items) {
+        if(isEmpty(item)) {
             auto* parent  = item->parent();
             const int row = item->row();
 
@@ -502,6 +534,69 @@ void LibraryTreeModelPrivate::removeTracks(const TrackList& tracks)
     updateSummary();
 }
 
+void LibraryTreeModelPrivate::applyTrackUpdates(PendingTreeData& data)
+{
+    AffectedItems affected;
+    std::unordered_map<Md5Hash, TrackList> keptTracks;
+
+    // Diff each updated track's new nodes against its current ones: tracks stay in place in nodes they still
+    // belong to, and are only removed from nodes they left. Nodes they joined are added by the batch as usual.
+    for(auto parentsIt = data.trackParents.begin(); parentsIt != data.trackParents.end();) {
+        const auto& [id, newKeys] = *parentsIt;
+
+        const auto pendingIt = m_tracksPendingUpdate.find(id);
+        if(pendingIt == m_tracksPendingUpdate.end()) {
+            ++parentsIt;
+            continue;
+        }
+        const Track track = pendingIt->second;
+        m_tracksPendingUpdate.erase(pendingIt);
+
+        const auto oldIt = m_trackParents.find(id);
+        if(oldIt == m_trackParents.end()) {
+            ++parentsIt;
+            continue;
+        }
+
+        std::vector<Md5Hash> leftKeys;
+        for(const auto& key : oldIt->second) {
+            if(std::ranges::find(newKeys, key) != newKeys.cend() && m_nodes.contains(key)) {
+                keptTracks[key].push_back(track);
+            }
+            else {
+                leftKeys.push_back(key);
+            }
+        }
+        removeTrackFromNodes(track, leftKeys, affected);
+
+        oldIt->second = newKeys;
+        parentsIt     = data.trackParents.erase(parentsIt);
+    }
+
+    for(const int id : data.ungroupedTracks) {
+        const auto pendingIt = m_tracksPendingUpdate.find(id);
+        if(pendingIt == m_tracksPendingUpdate.end()) {
+            continue;
+        }
+        if(const auto oldIt = m_trackParents.find(id); oldIt != m_trackParents.end()) {
+            removeTrackFromNodes(pendingIt->second, oldIt->second, affected);
+            m_trackParents.erase(oldIt);
+        }
+        m_tracksPendingUpdate.erase(pendingIt);
+    }
+
+    for(const auto& [key, tracks] : keptTracks) {
+        m_nodes.at(key).replaceTracks(tracks);
+
+        // The batch item is kept even with no tracks left, so its new titles and sort fields still reach the node
+        if(auto itemIt = data.items.find(key); itemIt != data.items.end()) {
+            itemIt->second.removeTracks(tracks);
+        }
+    }
+
+    pruneAffectedItems(affected, data.items);
+}
+
 void LibraryTreeModelPrivate::mergeTrackParents(const TrackIdNodeMap& parents)
 {
     for(const auto& pair : parents) {
@@ -528,9 +623,8 @@ void LibraryTreeModelPrivate::batchFinished(const PendingTreeDataPtr& data)
         beginReset();
     }
 
-    if(!m_tracksPendingRemoval.empty()) {
-        removeTracks(m_tracksPendingRemoval);
-        m_tracksPendingRemoval.clear();
+    if(!m_tracksPendingUpdate.empty()) {
+        applyTrackUpdates(*data);
     }
 
     populateModel(*data);
@@ -1269,8 +1363,10 @@ void LibraryTreeModel::updateTracks(const TrackList& tracks)
         return;
     }
 
-    p->m_tracksPendingRemoval = tracksToUpdate;
-    p->m_addingTracks         = false;
+    for(const Track& track : tracksToUpdate) {
+        p->m_tracksPendingUpdate.insert_or_assign(track.id(), track);
+    }
+    p->m_addingTracks = false;
     p->m_populatorThread.start();
 
     QMetaObject::invokeMethod(&p->m_populator, [this, tracksToUpdate = std::move(tracksToUpdate)] {
@@ -1327,7 +1423,7 @@ void LibraryTreeModel::reset(const TrackList& tracks)
 
     p->m_resetting = true;
     p->m_trackParents.clear();
-    p->m_tracksPendingRemoval.clear();
+    p->m_tracksPendingUpdate.clear();
 
     QMetaObject::invokeMethod(&p->m_populator, [this, tracks] {
         p->m_populator.setFont(libraryTreeFont());
@@ -43,6 +43,21 @@ QString identityText(const RichText& richText)
 {
     return richText.joinedText().trimmed();
 }
+
+struct NodeTitle
+{
+    QString title;
+    RichText richTitle;
+};
+
+// Bookkeeping for a node across batches. Only the track count is needed to resolve node variables,
+// so tracks are only copied into the batch items sent to the model.
+struct PopulatorNode
+{
+    LibraryTreeItem item;
+    int trackCount{0};
+    std::unordered_map<QString, Md5Hash> childKeys;
+};
 } // namespace
 
 class LibraryTreePopulatorPrivate
@@ -59,11 +74,15 @@ public:
         m_parser.addProvider(libraryTreeNodeVariableProvider());
     }
 
-    LibraryTreeItem* getOrInsertItem(const Md5Hash& key, const LibraryTreeItem* parent, const QString& title,
-                                     const RichText& richTitle, const QString& sortTitle, int level);
-    void updateRichTitle(LibraryTreeItem& item);
+    const NodeTitle& nodeTitle(const QString& item);
+    const QString& nodeSortTitle(const QString& item);
+    const Md5Hash& childKey(PopulatorNode& parent, const QString& title);
+    PopulatorNode* getOrInsertNode(const Md5Hash& key, const PopulatorNode& parent, const QString& title,
+                                   const RichText& richTitle, const QString& sortTitle, int level);
+    void updateRichTitle(LibraryTreeItem& item, int trackCount);
     PendingTreeData buildBatchData();
     void clearBatchData();
+    void clearCaches();
     void iterateTrack(const Track& track);
     bool runBatch(int size);
 
@@ -80,70 +99,104 @@ public:
     ParsedScript m_displayScript;
     ParsedScript m_sortScript;
 
-    LibraryTreeItem m_root;
-    ItemKeyMap m_items;
+    PopulatorNode m_root;
+    std::unordered_map<Md5Hash, PopulatorNode> m_nodes;
     PendingTreeData m_data;
     std::unordered_set<Md5Hash> m_touchedItems;
     std::unordered_set<Md5Hash> m_emittedItems;
-    std::unordered_map<Md5Hash, std::unordered_set<Md5Hash>> m_childKeys;
     TrackList m_pendingTracks;
     size_t m_pendingTrackIndex{0};
+
+    // Grouping levels repeat the same few values across many tracks, so formatter output is memoised per value
+    std::unordered_map<QString, NodeTitle> m_titleCache;
+    std::unordered_map<QString, QString> m_sortTitleCache;
 };
 
-LibraryTreeItem* LibraryTreePopulatorPrivate::getOrInsertItem(const Md5Hash& key, const LibraryTreeItem* parent,
-                                                              const QString& title, const RichText& richTitle,
-                                                              const QString& sortTitle, int level)
+const NodeTitle& LibraryTreePopulatorPrivate::nodeTitle(const QString& item)
 {
-    auto [node, inserted] = m_items.try_emplace(key, LibraryTreeItem{title, nullptr, level});
+    auto [titleIt, inserted] = m_titleCache.try_emplace(item);
     if(inserted) {
-        node->second.setKey(key);
-        node->second.setTitleSource(title);
-        node->second.setRichTitle(richTitle);
-        node->second.setSortTitle(sortTitle);
+        const QString identityItem = resolveLibraryTreeNodeVariables(item, 0, 0);
+        RichText richTitle         = trimRichText(m_formatter.evaluate(identityItem));
+        titleIt->second.title      = identityText(richTitle);
+        titleIt->second.richTitle  = std::move(richTitle);
+    }
+    return titleIt->second;
+}
+
+const QString& LibraryTreePopulatorPrivate::nodeSortTitle(const QString& item)
+{
+    auto [sortIt, inserted] = m_sortTitleCache.try_emplace(item);
+    if(inserted) {
+        sortIt->second
+            = identityText(trimRichText(m_formatter.evaluate(resolveLibraryTreeNodeVariables(item, 0, 0))));
+    }
+    return sortIt->second;
+}
+
+const Md5Hash& LibraryTreePopulatorPrivate::childKey(PopulatorNode& parent, const QString& title)
+{
+    auto [keyIt, inserted] = parent.childKeys.try_emplace(title);
+    if(inserted) {
+        keyIt->second = Utils::generateMd5Hash(parent.item.key(), title);
+    }
+    return keyIt->second;
+}
+
+PopulatorNode* LibraryTreePopulatorPrivate::getOrInsertNode(const Md5Hash& key, const PopulatorNode& parent,
+                                                            const QString& title, const RichText& richTitle,
+                                                            const QString& sortTitle, int level)
+{
+    auto [nodeIt, inserted] = m_nodes.try_emplace(key, PopulatorNode{.item = LibraryTreeItem{title, nullptr, level}});
+    LibraryTreeItem& child  = nodeIt->second.item;
+    if(inserted) {
+        child.setKey(key);
+        child.setTitleSource(title);
+        child.setRichTitle(richTitle);
+        child.setSortTitle(sortTitle);
     }
-    LibraryTreeItem* child = &node->second;
     m_touchedItems.insert(key);
-    m_childKeys[parent->key()].insert(key);
 
-    if(child->sortTitle().isEmpty() && !sortTitle.isEmpty()) {
-        child->setSortTitle(sortTitle);
+    if(child.sortTitle().isEmpty() && !sortTitle.isEmpty()) {
+        child.setSortTitle(sortTitle);
     }
 
     if(!m_emittedItems.contains(key) && !m_data.items.contains(key)) {
-        m_data.nodes[parent->key()].push_back(key);
+        m_data.nodes[parent.item.key()].push_back(key);
     }
-    return child;
+    return &nodeIt->second;
 }
 
-void LibraryTreePopulatorPrivate::updateRichTitle(LibraryTreeItem& item)
+void LibraryTreePopulatorPrivate::updateRichTitle(LibraryTreeItem& item, int trackCount)
 {
-    const QString title
-        = resolveLibraryTreeNodeVariables(item.titleSource(), item.trackCount(), item.scriptChildCount());
+    const QString title = resolveLibraryTreeNodeVariables(item.titleSource(), trackCount, item.scriptChildCount());
     item.setRichTitle(trimRichText(m_formatter.evaluate(title)));
 }
 
 PendingTreeData LibraryTreePopulatorPrivate::buildBatchData()
 {
     PendingTreeData data;
-    data.nodes        = m_data.nodes;
-    data.trackParents = m_data.trackParents;
+    data.nodes           = m_data.nodes;
+    data.trackParents    = m_data.trackParents;
+    data.ungroupedTracks = m_data.ungroupedTracks;
 
     for(const auto& key : m_touchedItems) {
-        auto itemIt = m_items.find(key);
-        if(itemIt == m_items.end()) {
+        auto nodeIt = m_nodes.find(key);
+        if(nodeIt == m_nodes.end()) {
             continue;
         }
 
-        itemIt->second.setScriptChildCount(static_cast<int>(m_childKeys[key].size()));
-        updateRichTitle(itemIt->second);
+        PopulatorNode& node = nodeIt->second;
+        node.item.setScriptChildCount(static_cast<int>(node.childKeys.size()));
+        updateRichTitle(node.item, node.trackCount);
 
         if(auto batchIt = m_data.items.find(key); batchIt != m_data.items.end()) {
-            batchIt->second.setScriptChildCount(itemIt->second.scriptChildCount());
-            batchIt->second.setRichTitles(itemIt->second.richTitle(), itemIt->second.rightRichTitle());
+            batchIt->second.setScriptChildCount(node.item.scriptChildCount());
+            batchIt->second.setRichTitles(node.item.richTitle(), node.item.rightRichTitle());
             data.items.emplace(key, batchIt->second);
         }
         else if(m_emittedItems.contains(key)) {
-            data.updatedItems.emplace(key, itemIt->second);
+            data.updatedItems.emplace(key, node.item);
         }
     }
 
@@ -160,10 +213,17 @@ void LibraryTreePopulatorPrivate::clearBatchData()
     m_touchedItems.clear();
 }
 
+void LibraryTreePopulatorPrivate::clearCaches()
+{
+    m_titleCache.clear();
+    m_sortTitleCache.clear();
+}
+
 void LibraryTreePopulatorPrivate::iterateTrack(const Track& track)
 {
     const QString displayField = m_parser.evaluate(m_displayScript, track, m_scriptContext);
     if(displayField.isNull()) {
+        m_data.ungroupedTracks.push_back(track.id());
         return;
     }
     const QString sortField
@@ -178,29 +238,21 @@ void LibraryTreePopulatorPrivate::iterateTrack(const Track& track)
             continue;
         }
 
-        const LibraryTreeItem* parent  = &m_root;
+        PopulatorNode* parent          = &m_root;
         const QStringList displayItems = displayValue.split(u"||"_s);
         const QStringList sortItems    = pairSortValues ? sortValues.value(valueIndex).split(u"||"_s) : QStringList{};
         const bool pairSortItems       = displayItems.size() == sortItems.size();
 
         for(int level{0}; const QString& item : displayItems) {
-            const QString identityItem = resolveLibraryTreeNodeVariables(item, 0, 0);
-            QString title              = identityText(trimRichText(m_formatter.evaluate(identityItem)));
-            const RichText richTitle   = trimRichText(m_formatter.evaluate(identityItem));
-
-            const auto key          = Utils::generateMd5Hash(parent->key(), title);
-            const QString sortTitle = [&] {
-                if(!pairSortItems) {
-                    return title;
-                }
-                const QString sortItem = resolveLibraryTreeNodeVariables(sortItems.value(level), 0, 0);
-                return identityText(trimRichText(m_formatter.evaluate(sortItem)));
-            }();
+            const auto& [title, richTitle] = nodeTitle(item);
 
-            auto* node = getOrInsertItem(key, parent, title, richTitle, sortTitle.isEmpty() ? title : sortTitle, level);
-            node->setTitleSource(item);
+            const Md5Hash key           = childKey(*parent, title);
+            const QString& itemSortText = pairSortItems ? nodeSortTitle(sortItems.at(level)) : title;
+            const QString& sortTitle    = itemSortText.isEmpty() ? title : itemSortText;
 
-            node->addTrack(track);
+            PopulatorNode* node = getOrInsertNode(key, *parent, title, richTitle, sortTitle, level);
+            node->item.setTitleSource(item);
+            ++node->trackCount;
 
             auto [batchNode, inserted] = m_data.items.try_emplace(key, LibraryTreeItem{title, nullptr, level});
             if(inserted) {
@@ -208,17 +260,21 @@ void LibraryTreePopulatorPrivate::iterateTrack(const Track& track)
                 batchNode->second.setPending(true);
                 batchNode->second.setTitleSource(item);
                 batchNode->second.setRichTitle(richTitle);
-                batchNode->second.setSortTitle(sortTitle.isEmpty() ? title : sortTitle);
+                batchNode->second.setSortTitle(sortTitle);
             }
             batchNode->second.addTrack(track);
 
-            m_data.trackParents[track.id()].push_back(node->key());
+            m_data.trackParents[track.id()].push_back(key);
 
             parent = node;
             ++level;
         }
         ++valueIndex;
     }
+
+    if(!m_data.trackParents.contains(track.id())) {
+        m_data.ungroupedTracks.push_back(track.id());
+    }
 }
 
 bool LibraryTreePopulatorPrivate::runBatch(int size)
@@ -238,6 +294,9 @@ bool LibraryTreePopulatorPrivate::runBatch(int size)
         if(track.isInLibrary()) {
             iterateTrack(track);
         }
+        else {
+            m_data.ungroupedTracks.push_back(track.id());
+        }
     }
 
     if(!m_self->mayRun()) {
@@ -263,6 +322,7 @@ LibraryTreePopulator::~LibraryTreePopulator() = default;
 void LibraryTreePopulator::setFont(const QFont& font)
 {
     p->m_formatter.setBaseFont(font);
+    p->clearCaches();
 }
 
 void LibraryTreePopulator::run(const LibraryTreeGrouping& grouping, const TrackList& tracks, bool useVarious)
@@ -270,10 +330,11 @@ void LibraryTreePopulator::run(const LibraryTreeGrouping& grouping, const TrackL
     setState(Running);
 
     p->m_data.clear();
-    p->m_items.clear();
+    p->m_root.childKeys.clear();
+    p->m_nodes.clear();
     p->m_touchedItems.clear();
     p->m_emittedItems.clear();
-    p->m_childKeys.clear();
+    p->clearCaches();
 
     p->m_scriptEnvironment.setRatingStarSymbols(Gui::ratingStarSymbols(*p->m_settings));
     p->m_scriptEnvironment.setEvaluationPolicy(TrackListContextPolicy::Unresolved, {}, true, useVarious);
@@ -311,7 +372,7 @@ void LibraryTreePopulator::updateItems(ItemKeyMap items, bool useVarious)
             setState(Idle);
             return;
         }
-        p->updateRichTitle(item);
+        p->updateRichTitle(item, item.trackCount());
         data.updatedItems.emplace(key, std::move(item));
     }
 
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "fygui_export.h"
+
 #include "librarytreegroup.h"
 #include "librarytreeitem.h"
 
@@ -44,6 +46,8 @@ struct PendingTreeData
     ItemKeyMap updatedItems;
     NodeKeyMap nodes;
     TrackIdNodeMap trackParents;
+    //! Tracks in this batch which don't map to any node
+    std::vector<int> ungroupedTracks;
 
     void clear()
     {
@@ -51,12 +55,13 @@ struct PendingTreeData
         updatedItems.clear();
         nodes.clear();
         trackParents.clear();
+        ungroupedTracks.clear();
     }
 };
 
 using PendingTreeDataPtr = std::shared_ptr<PendingTreeData>;
 
-class LibraryTreePopulator : public Worker
+class FYGUI_EXPORT LibraryTreePopulator : public Worker
 {
     Q_OBJECT
 
@@ -281,16 +281,31 @@ QSize PlaylistTrackItem::size(int column) const
     return m_sizes.front();
 }
 
+std::vector<QSize> PlaylistTrackItem::sizes() const
+{
+    if(m_sizes.empty()) {
+        calculateSize();
+    }
+    return m_sizes;
+}
+
+bool PlaylistTrackItem::isPending() const
+{
+    return m_pending;
+}
+
 void PlaylistTrackItem::setColumns(const std::vector<RichText>& columns)
 {
     m_columns = columns;
+    m_pending = false;
     m_sizes.clear();
 }
 
 void PlaylistTrackItem::setLeftRight(const RichText& left, const RichText& right)
 {
-    m_left  = left;
-    m_right = right;
+    m_left    = left;
+    m_right   = right;
+    m_pending = false;
     m_sizes.clear();
 }
 
@@ -325,6 +340,30 @@ void PlaylistTrackItem::removeColumn(int column)
     m_sizes.clear();
 }
 
+void PlaylistTrackItem::setPending(bool pending)
+{
+    m_pending = pending;
+}
+
+void PlaylistTrackItem::setSizes(const std::vector<QSize>& sizes)
+{
+    m_sizes = sizes;
+}
+
+void PlaylistTrackItem::releaseText()
+{
+    if(m_sizes.empty()) {
+        calculateSize();
+    }
+
+    for(auto& column : m_columns) {
+        column = {};
+    }
+    m_left    = {};
+    m_right   = {};
+    m_pending = true;
+}
+
 void PlaylistTrackItem::calculateSize() const
 {
     m_sizes.clear();
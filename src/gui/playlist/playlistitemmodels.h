@@ -92,6 +92,10 @@ public:
     [[nodiscard]] int rowHeight() const;
     [[nodiscard]] int depth() const;
     [[nodiscard]] QSize size(int column = 0) const;
+    //! Returns the size of every column, or of the whole row in single column mode.
+    [[nodiscard]] std::vector<QSize> sizes() const;
+    //! Returns true if the row text hasn't been evaluated yet, or has been released since.
+    [[nodiscard]] bool isPending() const;
 
     void setColumns(const std::vector<RichText>& columns);
     void setLeftRight(const RichText& left, const RichText& right);
@@ -101,6 +105,11 @@ public:
     void setRowHeight(int height);
     void setDepth(int depth);
     void removeColumn(int column);
+    void setPending(bool pending);
+    //! Sets the row size without measuring its text, e.g. to give a pending row the size of an evaluated one.
+    void setSizes(const std::vector<QSize>& sizes);
+    //! Releases the evaluated text, keeping the last calculated size so the row layout stays stable.
+    void releaseText();
 
     void calculateSize() const;
 
@@ -113,5 +122,6 @@ private:
     mutable std::vector<QSize> m_sizes;
     int m_rowHeight;
     int m_depth;
+    bool m_pending{false};
 };
 } // namespace Fooyin
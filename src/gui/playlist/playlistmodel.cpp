@@ -64,6 +64,9 @@ constexpr auto MimeModelId               = "application/x-playlistmodel-id";
 constexpr auto MaxPlaylistTracks         = 250;
 constexpr int UniformHeightValueMask     = 0xFFFF;
 constexpr auto LoadingTextTrackThreshold = 10000;
+// Lazy rows: rows evaluated either side of a requested row, and the number of evaluated rows kept
+constexpr auto RowPrefetchCount = 100;
+constexpr auto RowCacheSize     = 5000;
 
 namespace {
 int loadingTextClearTrackCount(const Fooyin::SettingsManager& settings, qsizetype trackCount)
@@ -103,6 +106,12 @@ bool isRatingWriteField(const QString& field)
         || field.compare(QLatin1String{Fooyin::Constants::MetaData::Stars}, Qt::CaseInsensitive) == 0;
 }
 
+bool isRowTextRole(int role)
+{
+    return role == Fooyin::PlaylistItem::Role::Column || role == Fooyin::PlaylistItem::Role::Left
+        || role == Fooyin::PlaylistItem::Role::Right || role == Qt::ToolTipRole;
+}
+
 QList<int> playlistTrackChangedRoles()
 {
     return {Fooyin::PlaylistItem::Role::Column,
@@ -122,7 +131,7 @@ Fooyin::Data mergeUpdatedItemData(const Fooyin::Data& currentData, const Fooyin:
 
     const auto* currentTrack = std::get_if<Fooyin::PlaylistTrackItem>(&currentData);
     const auto* updatedTrack = std::get_if<Fooyin::PlaylistTrackItem>(&updatedData);
-    if(!currentTrack || !updatedTrack) {
+    if(!currentTrack || !updatedTrack || currentTrack->isPending()) {
         return updatedData;
     }
 
@@ -717,6 +726,7 @@ PlaylistModel::PlaylistModel(PlaylistInteractor* playlistInteractor, AudioLoader
     , m_populator{playlistInteractor->playerController(), settings}
     , m_playlistLoaded{false}
     , m_loadingTextPending{false}
+    , m_lazyRows{settings->value<Settings::Gui::Internal::PlaylistLazyRows>()}
     , m_pixmapPadding{settings->value<Settings::Gui::Internal::PlaylistImagePadding>()}
     , m_pixmapPaddingTop{settings->value<Settings::Gui::Internal::PlaylistImagePaddingTop>()}
     , m_starRatingSize{settings->value<Settings::Gui::StarRatingSize>()}
@@ -731,6 +741,14 @@ PlaylistModel::PlaylistModel(PlaylistInteractor* playlistInteractor, AudioLoader
     m_populator.moveToThread(&m_populatorThread);
     m_populatorThread.start();
 
+    m_settings->subscribe<Settings::Gui::Internal::PlaylistLazyRows>(this, [this](bool enabled) {
+        m_lazyRows = enabled;
+        if(!enabled) {
+            // Rows already pending are still evaluated when shown, but shown rows are no longer released
+            m_rowCache.clear();
+            m_rowCachePositions.clear();
+        }
+    });
     m_settings->subscribe<Settings::Gui::Internal::PlaylistImagePadding>(this, [this](int padding) {
         m_pixmapPadding = padding;
         invalidateData();
@@ -1214,6 +1232,7 @@ void PlaylistModel::updateColours()
 void PlaylistModel::reset(const PlaylistTrackList& tracks)
 {
     m_populator.stopThread();
+    clearRowCache();
 
     const bool loadingTextVisible = shouldShowLoadingText();
     m_playlistLoaded              = false;
@@ -1240,9 +1259,10 @@ void PlaylistModel::reset(const PlaylistTrackList& tracks)
         return;
     }
 
-    QMetaObject::invokeMethod(&m_populator, [this, tracks] {
+    QMetaObject::invokeMethod(&m_populator, [this, tracks, lazyRows = m_lazyRows] {
         m_populator.setUseVarious(m_settings->value<Settings::Core::UseVariousForCompilations>());
         m_populator.setPreloadCount(m_settings->value<Settings::Gui::Internal::PlaylistTrackPreloadCount>());
+        m_populator.setLazyRows(lazyRows);
         m_populator.run(m_currentPlaylist, m_currentPreset, m_columns, tracks);
     });
 }
@@ -1448,12 +1468,21 @@ void PlaylistModel::refreshTracks(const std::vector<int>& indexes, const std::se
     for(const int index : indexes) {
         const auto& [modelIndex, end] = trackIndexAtPlaylistIndex(index);
         if(!end) {
+            const PlaylistItem* item = itemForIndex(modelIndex);
+            if(std::get<PlaylistTrackItem>(item->data()).isPending()) {
+                // Evaluated in full once shown
+                continue;
+            }
             if(const auto track = m_currentPlaylist->playlistTrack(index)) {
-                items.emplace(track.value(), *itemForIndex(modelIndex));
+                items.emplace(track.value(), *item);
             }
         }
     }
 
+    if(items.empty()) {
+        return;
+    }
+
     QMetaObject::invokeMethod(&m_populator, [this, columns, items] {
         m_populator.setUseVarious(m_settings->value<Settings::Core::UseVariousForCompilations>());
         m_populator.updateTracks(m_currentPlaylist, m_currentPreset, m_columns, columns, items);
@@ -1963,6 +1992,8 @@ void PlaylistModel::updateTracks(const ItemList& tracks, const std::set<int>& co
     }
 
     for(const PlaylistItem& item : tracks) {
+        m_rowsInFlight.erase(item.key());
+
         if(m_nodes.contains(item.key())) {
             auto* node = &m_nodes.at(item.key());
             node->setData(mergeUpdatedItemData(node->data(), item.data(), columnsUpdated));
@@ -2140,6 +2171,11 @@ QVariant PlaylistModel::trackData(PlaylistItem* item, const QModelIndex& index,
     const bool singleColumnMode = m_columns.empty();
     const bool isPlaying        = trackIsPlaying(playlistTrack, item->index());
 
+    // Pending rows are left from lazy population, even if it has since been turned off
+    if(isRowTextRole(role) && (m_lazyRows || trackItem.isPending())) {
+        requestRowText(item);
+    }
+
     auto getCover = [this, &index, column](const Track::Cover type) -> QVariant {
         if(std::cmp_greater_equal(column, m_columnSizes.size())) {
             return {};
@@ -2291,6 +2327,130 @@ QVariant PlaylistModel::trackData(PlaylistItem* item, const QModelIndex& index,
     return {};
 }
 
+void PlaylistModel::requestRowText(const PlaylistItem* item) const
+{
+    const UId key = item->key();
+
+    if(!std::get<PlaylistTrackItem>(item->data()).isPending()) {
+        if(const auto cacheIt = m_rowCachePositions.find(key); cacheIt != m_rowCachePositions.cend()) {
+            m_rowCache.splice(m_rowCache.begin(), m_rowCache, cacheIt->second);
+        }
+        return;
+    }
+
+    if(!m_rowsInFlight.emplace(key).second) {
+        return;
+    }
+
+    m_rowRequests.push_back(key);
+
+    if(!std::exchange(m_rowRequestScheduled, true)) {
+        auto* self = const_cast<PlaylistModel*>(this);
+        QMetaObject::invokeMethod(self, [self]() { self->materialiseRequestedRows(); }, Qt::QueuedConnection);
+    }
+}
+
+void PlaylistModel::materialiseRequestedRows()
+{
+    m_rowRequestScheduled = false;
+
+    const std::vector<UId> requests = std::exchange(m_rowRequests, {});
+    if(!m_currentPlaylist || m_resetting || requests.empty()) {
+        m_rowsInFlight.clear();
+        return;
+    }
+
+    // Prefetch around each requested row, so scrolling doesn't request rows one at a time
+    std::set<int> indexes;
+    const int lastIndex = m_currentPlaylist->trackCount() - 1;
+
+    for(const UId& key : requests) {
+        const auto nodeIt = m_nodes.find(key);
+        if(nodeIt == m_nodes.cend() || nodeIt->second.type() != PlaylistItem::Track) {
+            continue;
+        }
+
+        const int index = std::get<PlaylistTrackItem>(nodeIt->second.data()).index();
+        for(int i{std::max(0, index - RowPrefetchCount)}; i <= std::min(lastIndex, index + RowPrefetchCount); ++i) {
+            indexes.emplace(i);
+        }
+    }
+
+    TrackItemMap items;
+    std::unordered_set<UId, UId::UIdHash> requestedKeys;
+
+    for(const int index : indexes) {
+        const auto& [modelIndex, end] = trackIndexAtPlaylistIndex(index);
+        if(end) {
+            continue;
+        }
+
+        const PlaylistItem* item = itemForIndex(modelIndex);
+        if(!item || item->type() != PlaylistItem::Track || !std::get<PlaylistTrackItem>(item->data()).isPending()) {
+            continue;
+        }
+
+        if(const auto track = m_currentPlaylist->playlistTrack(index)) {
+            const UId key = item->key();
+            items.emplace(track.value(), *item);
+            requestedKeys.emplace(key);
+            m_rowsInFlight.emplace(key);
+
+            if(const auto cacheIt = m_rowCachePositions.find(key); cacheIt != m_rowCachePositions.cend()) {
+                m_rowCache.splice(m_rowCache.begin(), m_rowCache, cacheIt->second);
+            }
+            else if(m_lazyRows) {
+                m_rowCache.push_front(key);
+                m_rowCachePositions.emplace(key, m_rowCache.begin());
+            }
+        }
+    }
+
+    // Requests that turned out not to be needed can be made again later
+    for(const UId& key : requests) {
+        if(!requestedKeys.contains(key)) {
+            m_rowsInFlight.erase(key);
+        }
+    }
+
+    // Release the text of the rows least recently shown
+    while(m_rowCache.size() > RowCacheSize) {
+        const UId key = m_rowCache.back();
+        m_rowCache.pop_back();
+        m_rowCachePositions.erase(key);
+
+        if(m_rowsInFlight.contains(key)) {
+            continue;
+        }
+        if(const auto nodeIt = m_nodes.find(key);
+           nodeIt != m_nodes.cend() && nodeIt->second.type() == PlaylistItem::Track) {
+            std::get<PlaylistTrackItem>(nodeIt->second.data()).releaseText();
+        }
+    }
+
+    if(items.empty()) {
+        return;
+    }
+
+    std::set<int> columns;
+    for(int i{0}; std::cmp_less(i, m_columns.size()); ++i) {
+        columns.insert(i);
+    }
+
+    QMetaObject::invokeMethod(&m_populator, [this, columns, items] {
+        m_populator.setUseVarious(m_settings->value<Settings::Core::UseVariousForCompilations>());
+        m_populator.updateTracks(m_currentPlaylist, m_currentPreset, m_columns, columns, items);
+    });
+}
+
+void PlaylistModel::clearRowCache()
+{
+    m_rowRequests.clear();
+    m_rowsInFlight.clear();
+    m_rowCache.clear();
+    m_rowCachePositions.clear();
+}
+
 QVariant PlaylistModel::headerData(PlaylistItem* item, int column, int role) const
 {
     const auto& header = std::get<PlaylistContainerItem>(item->data());
@@ -32,7 +32,9 @@
 #include <QThread>
 
 #include <expected>
+#include <list>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace Fooyin {
 class AudioLoader;
@@ -219,6 +221,9 @@ private:
     [[nodiscard]] bool hasSameParentChain(const PlaylistItem* currentItem, const PlaylistItem* updatedItem) const;
 
     QVariant trackData(PlaylistItem* item, const QModelIndex& index, int role) const;
+    void requestRowText(const PlaylistItem* item) const;
+    void materialiseRequestedRows();
+    void clearRowCache();
     QVariant headerData(PlaylistItem* item, int column, int role) const;
     QVariant subheaderData(PlaylistItem* item, int column, int role) const;
 
@@ -320,6 +325,7 @@ private:
 
     bool m_playlistLoaded;
     bool m_loadingTextPending;
+    bool m_lazyRows;
     ItemKeyMap m_nodes;
     TrackIdNodeMap m_trackParents;
     std::map<int, UId> m_trackIndexes;
@@ -348,6 +354,13 @@ private:
     QPersistentModelIndex m_playingIndex;
     QPersistentModelIndex m_stopAtIndex;
     QModelIndexList m_indexesPendingRemoval;
+
+    // Lazy rows: pending rows requested by views, and an LRU of rows evaluated on demand
+    mutable std::vector<UId> m_rowRequests;
+    mutable std::unordered_set<UId, UId::UIdHash> m_rowsInFlight;
+    mutable std::list<UId> m_rowCache;
+    mutable std::unordered_map<UId, std::list<UId>::iterator, UId::UIdHash> m_rowCachePositions;
+    mutable bool m_rowRequestScheduled{false};
 };
 } // namespace Fooyin
 
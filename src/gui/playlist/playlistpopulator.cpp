@@ -33,6 +33,9 @@
 #include <ranges>
 #include <utility>
 
+// Rows evaluated up front in lazy mode, so the initial view doesn't have to wait for the model
+constexpr auto LazyEagerRows = 200;
+
 namespace Fooyin {
 class PlaylistPopulatorPrivate
 {
@@ -109,6 +112,9 @@ public:
     ScriptContext m_scriptContext;
 
     int m_preloadCount{2000};
+    bool m_lazyRows{false};
+    //! Sizes of the last evaluated track row, used as the size of pending rows
+    std::vector<QSize> m_evaluatedRowSizes;
     int m_trackDepth{0};
     Md5Hash m_prevBaseHeaderKey;
     UId m_prevHeaderKey;
@@ -149,6 +155,7 @@ void PlaylistPopulatorPrivate::resetState()
     m_parsedHeader = {};
     m_parsedSubheaders.clear();
     m_parsedTrack = {};
+    m_evaluatedRowSizes.clear();
 }
 
 void PlaylistPopulatorPrivate::prepareScripts()
@@ -484,9 +491,19 @@ PlaylistItem* PlaylistPopulatorPrivate::iterateTrack(const PlaylistTrack& track,
         return nullptr;
     }
 
-    const auto& context = makeContext(index, m_trackDepth);
+    const bool pending = m_lazyRows && index >= LazyEagerRows;
 
     PlaylistTrackItem playlistTrack = [&] {
+        if(pending) {
+            PlaylistTrackItem pendingTrack = m_columns.empty()
+                                               ? PlaylistTrackItem{RichText{}, RichText{}, track}
+                                               : PlaylistTrackItem{std::vector<RichText>(m_columns.size()), track};
+            pendingTrack.setPending(true);
+            return pendingTrack;
+        }
+
+        const auto& context = makeContext(index, m_trackDepth);
+
         if(!m_columns.empty()) {
             std::vector<RichText> trackColumns;
             trackColumns.reserve(m_columns.size());
@@ -503,10 +520,21 @@ PlaylistItem* PlaylistPopulatorPrivate::iterateTrack(const PlaylistTrack& track,
 
     playlistTrack.setRowHeight(m_currentPreset.track.rowHeight);
     playlistTrack.setDepth(m_trackDepth);
-    playlistTrack.calculateSize();
+    if(pending) {
+        // Rows share a script, so an evaluated row's size keeps the layout stable until this one is shown
+        playlistTrack.setSizes(m_evaluatedRowSizes);
+    }
+    else {
+        playlistTrack.calculateSize();
+        if(m_lazyRows) {
+            m_evaluatedRowSizes = playlistTrack.sizes();
+        }
+    }
 
-    const auto baseKey
-        = Utils::generateMd5Hash(parent->key().toString(UId::Id128), track.track.hash(), QString::number(index));
+    // Pending rows may never be shown, so they take the parent key and index as is rather than hashing them
+    const Md5Hash baseKey = pending ? parent->key().toRfc4122() + QByteArray::number(index)
+                                    : Utils::generateMd5Hash(parent->key().toString(UId::Id128), track.track.hash(),
+                                                             QString::number(index));
     const UId key{UId::create()};
 
     auto* trackItem = getOrInsertItem(key, PlaylistItem::Track, playlistTrack, parent, baseKey);
@@ -609,6 +637,11 @@ void PlaylistPopulator::setPreloadCount(int count)
     p->m_preloadCount = count;
 }
 
+void PlaylistPopulator::setLazyRows(bool enabled)
+{
+    p->m_lazyRows = enabled;
+}
+
 void PlaylistPopulator::run(Playlist* playlist, const PlaylistPreset& preset, const PlaylistColumnList& columns,
                             const PlaylistTrackList& tracks)
 {
@@ -674,12 +707,15 @@ void PlaylistPopulator::updateTracks(Playlist* playlist, const PlaylistPreset& p
         trackData.setTrack(track);
         const auto& context = p->makeContext(trackData.track().indexInPlaylist, trackData.depth());
 
-        if(!columnsToUpdate.empty()) {
+        // Pending rows have no text to keep, so every column is evaluated
+        const bool evaluateAll = trackData.isPending();
+
+        if(!columnsToUpdate.empty() || (evaluateAll && !columns.empty())) {
             std::vector<RichText> trackColumns;
             trackColumns.reserve(columns.size());
             for(size_t i{0}; i < columns.size(); ++i) {
                 const int columnIndex = static_cast<int>(i);
-                if(columnsToUpdate.contains(columnIndex)) {
+                if(evaluateAll || columnsToUpdate.contains(columnIndex)) {
                     const auto evalScript = p->m_parser.evaluate(p->m_parsedTrack.columns.at(i), track.track, context);
                     trackColumns.emplace_back(p->m_formatter.evaluate(evalScript));
                 }
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "fygui_export.h"
+
 #include "playlistcolumn.h"
 #include "playlistitem.h"
 
@@ -74,7 +76,7 @@ struct PendingData
     }
 };
 
-class PlaylistPopulator : public Worker
+class FYGUI_EXPORT PlaylistPopulator : public Worker
 {
     Q_OBJECT
 
@@ -86,6 +88,8 @@ public:
     void setFont(const QFont& font);
     void setUseVarious(bool enabled);
     void setPreloadCount(int count);
+    //! If enabled, only the first rows of a playlist have their text evaluated; the rest are left pending.
+    void setLazyRows(bool enabled);
 
     void run(Playlist* playlist, const PlaylistPreset& preset, const PlaylistColumnList& columns,
              const PlaylistTrackList& tracks);
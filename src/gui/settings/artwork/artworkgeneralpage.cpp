@@ -67,6 +67,7 @@ private:
 
     ScriptLineEdit* m_thumbnailGroupScript;
     QSpinBox* m_pixmapCache;
+    QSpinBox* m_thumbnailCache;
     QLabel* m_cacheSizeLabel;
 };
 
@@ -78,6 +79,7 @@ ArtworkPageWidget::ArtworkPageWidget(SettingsManager* settings)
     , m_preferEmbedded{new QRadioButton(tr("Prefer embedded artwork"), this)}
     , m_thumbnailGroupScript{new ScriptLineEdit(this)}
     , m_pixmapCache{new QSpinBox(this)}
+    , m_thumbnailCache{new QSpinBox(this)}
     , m_cacheSizeLabel{new QLabel(this)}
 {
     auto* displayGroupBox = new QGroupBox(tr("Display"), this);
@@ -121,6 +123,12 @@ ArtworkPageWidget::ArtworkPageWidget(SettingsManager* settings)
     m_pixmapCache->setMaximum(1000);
     m_pixmapCache->setSuffix(u" MB"_s);
 
+    auto* thumbnailCacheLabel = new QLabel(tr("Disk cache size") + u":"_s, this);
+
+    m_thumbnailCache->setMinimum(16);
+    m_thumbnailCache->setMaximum(8192);
+    m_thumbnailCache->setSuffix(u" MB"_s);
+
     auto* clearCacheButton = new QPushButton(tr("Clear Cache"), this);
     QObject::connect(clearCacheButton, &QPushButton::clicked, this, [this]() {
         CoverProvider::clearCache();
@@ -130,6 +138,8 @@ ArtworkPageWidget::ArtworkPageWidget(SettingsManager* settings)
     int row{0};
     cacheLayout->addWidget(pixmapCacheLabel, row, 0);
     cacheLayout->addWidget(m_pixmapCache, row++, 1);
+    cacheLayout->addWidget(thumbnailCacheLabel, row, 0);
+    cacheLayout->addWidget(m_thumbnailCache, row++, 1);
     cacheLayout->addWidget(m_cacheSizeLabel, row, 0);
     cacheLayout->addWidget(clearCacheButton, row++, 1);
     cacheLayout->setColumnStretch(cacheLayout->columnCount(), 1);
@@ -164,6 +174,7 @@ void ArtworkPageWidget::load()
     }
 
     m_pixmapCache->setValue(m_settings->value<Settings::Gui::Internal::PixmapCacheSize>());
+    m_thumbnailCache->setValue(m_settings->value<Settings::Gui::Internal::ThumbnailCacheSize>());
     m_thumbnailGroupScript->setText(m_settings->value<Settings::Gui::Internal::TrackCoverThumbnailGroupScript>());
     updateCacheSize();
 }
@@ -179,6 +190,7 @@ void ArtworkPageWidget::apply()
     m_settings->set<Settings::Gui::Internal::TrackCoverSourcePreference>(static_cast<int>(sourcePref));
     m_settings->set<Settings::Gui::Internal::TrackCoverThumbnailGroupScript>(m_thumbnailGroupScript->text());
     m_settings->set<Settings::Gui::Internal::PixmapCacheSize>(m_pixmapCache->value());
+    m_settings->set<Settings::Gui::Internal::ThumbnailCacheSize>(m_thumbnailCache->value());
 }
 
 void ArtworkPageWidget::reset()
@@ -187,6 +199,7 @@ void ArtworkPageWidget::reset()
     m_settings->reset<Settings::Gui::Internal::TrackCoverSourcePreference>();
     m_settings->reset<Settings::Gui::Internal::TrackCoverThumbnailGroupScript>();
     m_settings->reset<Settings::Gui::Internal::PixmapCacheSize>();
+    m_settings->reset<Settings::Gui::Internal::ThumbnailCacheSize>();
 }
 
 void ArtworkPageWidget::updateCacheSize()
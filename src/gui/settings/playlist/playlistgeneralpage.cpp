@@ -62,6 +62,7 @@ private:
     SettingsManager* m_settings;
 
     QSpinBox* m_preloadCount;
+    QCheckBox* m_lazyRows;
     QComboBox* m_middleClick;
     QCheckBox* m_inlineTagEditing;
     QCheckBox* m_skipMissing;
@@ -72,6 +73,7 @@ private:
 PlaylistGeneralPageWidget::PlaylistGeneralPageWidget(SettingsManager* settings)
     : m_settings{settings}
     , m_preloadCount{new QSpinBox(this)}
+    , m_lazyRows{new QCheckBox(tr("Only evaluate tracks when shown"), this)}
     , m_middleClick{new QComboBox(this)}
     , m_inlineTagEditing{new QCheckBox(tr("Enable inline tag editing"), this)}
     , m_skipMissing{new QCheckBox(tr("Skip missing tracks"), this)}
@@ -89,12 +91,15 @@ PlaylistGeneralPageWidget::PlaylistGeneralPageWidget(SettingsManager* settings)
 
     m_preloadCount->setMinimum(0);
     m_preloadCount->setMaximum(10000);
+    m_lazyRows->setToolTip(tr("Build the text of track rows as they are scrolled into view, which reduces "
+                              "the time and memory needed to load large playlists"));
     m_inlineTagEditing->setToolTip(tr("Allow editing writable track tag columns directly from the playlist"));
 
     int row{0};
     behaviourLayout->addWidget(preloadCountLabel, row, 0);
     behaviourLayout->addWidget(m_preloadCount, row++, 1);
     behaviourLayout->addWidget(new QLabel(u"🛈 "_s + tr("Set to '0' to disable preloading."), this), row++, 0, 1, 2);
+    behaviourLayout->addWidget(m_lazyRows, row++, 0, 1, 2);
     behaviourLayout->addWidget(m_inlineTagEditing, row++, 0, 1, 2);
     behaviourLayout->setColumnStretch(behaviourLayout->columnCount(), 1);
 
@@ -131,6 +136,7 @@ PlaylistGeneralPageWidget::PlaylistGeneralPageWidget(SettingsManager* settings)
 void PlaylistGeneralPageWidget::load()
 {
     m_preloadCount->setValue(m_settings->value<Settings::Gui::Internal::PlaylistTrackPreloadCount>());
+    m_lazyRows->setChecked(m_settings->value<Settings::Gui::Internal::PlaylistLazyRows>());
     m_inlineTagEditing->setChecked(m_settings->value<Settings::Gui::Internal::PlaylistInlineTagEditing>());
 
     ActionIndexMap middleActions;
@@ -153,6 +159,7 @@ void PlaylistGeneralPageWidget::load()
 void PlaylistGeneralPageWidget::apply()
 {
     m_settings->set<Settings::Gui::Internal::PlaylistTrackPreloadCount>(m_preloadCount->value());
+    m_settings->set<Settings::Gui::Internal::PlaylistLazyRows>(m_lazyRows->isChecked());
     m_settings->set<Settings::Gui::Internal::PlaylistInlineTagEditing>(m_inlineTagEditing->isChecked());
     m_settings->set<Settings::Gui::Internal::PlaylistMiddleClick>(m_middleClick->currentData().toInt());
     m_settings->set<Settings::Core::PlaylistSkipMissing>(m_skipMissing->isChecked());
@@ -163,6 +170,7 @@ void PlaylistGeneralPageWidget::apply()
 void PlaylistGeneralPageWidget::reset()
 {
     m_settings->reset<Settings::Gui::Internal::PlaylistTrackPreloadCount>();
+    m_settings->reset<Settings::Gui::Internal::PlaylistLazyRows>();
     m_settings->reset<Settings::Gui::Internal::PlaylistInlineTagEditing>();
     m_settings->reset<Settings::Gui::Internal::PlaylistMiddleClick>();
     m_settings->reset<Settings::Core::PlaylistSkipMissing>();
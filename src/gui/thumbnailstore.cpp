@@ -0,0 +1,990 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "thumbnailstore.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+Q_LOGGING_CATEGORY(THUMB_STORE, "fy.thumbnailstore")
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr uint32_t RecordMagic  = 0x48545946; // FYTH
+constexpr uint32_t IndexMagic   = 0x58495946; // FYIX
+constexpr uint32_t IndexVersion = 1;
+
+constexpr qint64 SegmentSize = 64LL * 1024 * 1024;
+// Thumbnails up to this many pixels are stored as raw ARGB32 and need no decoding
+constexpr int MaxRawPixels = 128 * 128;
+constexpr int JpegQuality  = 85;
+// Number of inserts before the index is rewritten, bounding the records replayed on open
+constexpr int FlushInterval = 64;
+// Evict below the cap so eviction doesn't run on every insert once full
+constexpr double EvictionTarget = 0.9;
+
+enum class Encoding : uint8_t
+{
+    Raw = 0,
+    Jpeg,
+    Tombstone
+};
+
+struct RecordHeader
+{
+    uint32_t magic{RecordMagic};
+    uint32_t payloadSize{0};
+    uint16_t keySize{0};
+    uint16_t sizeClass{0};
+    uint16_t width{0};
+    uint16_t height{0};
+    Encoding encoding{Encoding::Raw};
+    uint8_t reserved[3]{};
+};
+static_assert(sizeof(RecordHeader) == 20);
+
+struct Entry
+{
+    uint32_t segment{0};
+    uint64_t offset{0};
+    uint32_t recordSize{0};
+    uint64_t lastAccess{0};
+};
+
+struct Payload
+{
+    RecordHeader header;
+    QByteArray data;
+};
+
+struct EncodedImage
+{
+    Encoding encoding{Encoding::Raw};
+    uint16_t width{0};
+    uint16_t height{0};
+    QByteArray data;
+};
+
+std::optional<EncodedImage> encodeImage(const QImage& image)
+{
+    if(image.isNull() || image.width() > UINT16_MAX || image.height() > UINT16_MAX) {
+        return {};
+    }
+
+    EncodedImage encoded;
+    encoded.width  = static_cast<uint16_t>(image.width());
+    encoded.height = static_cast<uint16_t>(image.height());
+
+    if(image.width() * image.height() <= MaxRawPixels) {
+        const QImage argb  = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const auto rowSize = static_cast<qsizetype>(argb.width()) * 4;
+
+        encoded.encoding = Encoding::Raw;
+        encoded.data.resize(rowSize * argb.height());
+        for(int y{0}; y < argb.height(); ++y) {
+            std::memcpy(encoded.data.data() + (rowSize * y), argb.constScanLine(y), rowSize);
+        }
+        return encoded;
+    }
+
+    QBuffer buffer{&encoded.data};
+    if(!buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "JPG", JpegQuality)) {
+        return {};
+    }
+    encoded.encoding = Encoding::Jpeg;
+
+    return encoded;
+}
+
+QImage decodeImage(const Payload& payload)
+{
+    if(payload.header.encoding == Encoding::Jpeg) {
+        return QImage::fromData(payload.data, "JPG");
+    }
+
+    const int width    = payload.header.width;
+    const int height   = payload.header.height;
+    const auto rowSize = static_cast<qsizetype>(width) * 4;
+    if(payload.data.size() != rowSize * height) {
+        return {};
+    }
+
+    QImage image{width, height, QImage::Format_ARGB32_Premultiplied};
+    for(int y{0}; y < height; ++y) {
+        std::memcpy(image.scanLine(y), payload.data.constData() + (rowSize * y), rowSize);
+    }
+    return image;
+}
+} // namespace
+
+namespace Fooyin {
+class ThumbnailStorePrivate
+{
+public:
+    struct Segment
+    {
+        std::unique_ptr<QFile> file;
+        uchar* map{nullptr};
+        qint64 mappedSize{0};
+        qint64 size{0};
+        uint64_t deadBytes{0};
+    };
+
+    ThumbnailStorePrivate(QString directory, uint64_t maxSize);
+
+    [[nodiscard]] QString segmentPath(uint32_t id) const;
+    [[nodiscard]] QString indexPath() const;
+
+    void open();
+    bool loadIndex();
+    void replay(uint32_t id, qint64 from);
+    void reset();
+    void closeSegments();
+
+    void setEntry(const QString& key, int sizeClass, const Entry& entry);
+    void markDead(const Entry& entry);
+    void removeKey(const QString& key);
+
+    bool startSegment();
+    std::optional<Entry> append(const QByteArray& record);
+    const uchar* mapped(const Entry& entry);
+    std::optional<Payload> readPayload(const Entry& entry);
+
+    void evict();
+    //! Called without the lock held; records are moved under short locks so lookups aren't blocked.
+    void compact(bool force);
+    void writeIndex();
+
+    QString m_directory;
+    uint64_t m_maxSize;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<QString, std::map<int, Entry>> m_entries;
+    std::map<uint32_t, Segment> m_segments;
+    std::unique_ptr<QFile> m_writer;
+
+    uint64_t m_liveBytes{0};
+    uint64_t m_accessCounter{0};
+    //! Bumped by reset(), so a compaction running alongside clear() knows to stop
+    uint64_t m_generation{0};
+    int m_unflushed{0};
+    bool m_indexDirty{false};
+    bool m_compacting{false};
+};
+
+ThumbnailStorePrivate::ThumbnailStorePrivate(QString directory, uint64_t maxSize)
+    : m_directory{std::move(directory)}
+    , m_maxSize{maxSize}
+{ }
+
+QString ThumbnailStorePrivate::segmentPath(uint32_t id) const
+{
+    return m_directory + u"/segment-%1.dat"_s.arg(id, 6, 10, '0'_L1);
+}
+
+QString ThumbnailStorePrivate::indexPath() const
+{
+    return m_directory + u"/index.dat"_s;
+}
+
+void ThumbnailStorePrivate::open()
+{
+    if(!QDir{}.mkpath(m_directory)) {
+        qCWarning(THUMB_STORE) << "Unable to create thumbnail store at" << m_directory;
+        return;
+    }
+
+    std::map<uint32_t, qint64> fileSizes;
+
+    const QDir dir{m_directory};
+    const QFileInfoList files = dir.entryInfoList({u"segment-*.dat"_s}, QDir::Files, QDir::Name);
+    for(const QFileInfo& file : files) {
+        bool ok{false};
+        const uint32_t id = file.completeBaseName().mid(8).toUInt(&ok);
+        if(ok) {
+            fileSizes.emplace(id, file.size());
+        }
+    }
+
+    if(!loadIndex()) {
+        reset();
+    }
+    else {
+        const bool stale = std::ranges::any_of(m_segments, [&fileSizes](const auto& item) {
+            const auto it = fileSizes.find(item.first);
+            return it == fileSizes.cend() || it->second < item.second.size;
+        });
+        if(stale) {
+            qCInfo(THUMB_STORE) << "Thumbnail index is out of date; rebuilding";
+            reset();
+        }
+    }
+
+    // Replay anything written after the index was last saved
+    for(const auto& [id, fileSize] : fileSizes) {
+        const qint64 from = m_segments[id].size;
+        if(from < fileSize) {
+            replay(id, from);
+        }
+    }
+}
+
+bool ThumbnailStorePrivate::loadIndex()
+{
+    QFile file{indexPath()};
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream{&file};
+
+    quint32 magic{0};
+    quint32 version{0};
+    quint64 accessCounter{0};
+    stream >> magic >> version >> accessCounter;
+    if(magic != IndexMagic || version != IndexVersion) {
+        return false;
+    }
+
+    quint32 segmentCount{0};
+    stream >> segmentCount;
+    for(quint32 i{0}; i < segmentCount && stream.status() == QDataStream::Ok; ++i) {
+        quint32 id{0};
+        qint64 size{0};
+        stream >> id >> size;
+        m_segments[id].size = size;
+    }
+
+    quint32 entryCount{0};
+    stream >> entryCount;
+    for(quint32 i{0}; i < entryCount && stream.status() == QDataStream::Ok; ++i) {
+        QString key;
+        qint32 sizeClass{0};
+        quint32 segment{0};
+        quint64 offset{0};
+        quint32 recordSize{0};
+        quint64 lastAccess{0};
+        stream >> key >> sizeClass >> segment >> offset >> recordSize >> lastAccess;
+
+        if(!m_segments.contains(segment)) {
+            return false;
+        }
+        m_entries[key][sizeClass] = {segment, offset, recordSize, lastAccess};
+        m_liveBytes += recordSize;
+    }
+
+    if(stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    m_accessCounter = accessCounter;
+
+    // Anything not referenced by a live entry is waiting for compaction
+    for(auto& [id, segment] : m_segments) {
+        segment.deadBytes = static_cast<uint64_t>(segment.size);
+    }
+    for(const auto& [key, classes] : m_entries) {
+        for(const auto& [sizeClass, entry] : classes) {
+            m_segments[entry.segment].deadBytes -= entry.recordSize;
+        }
+    }
+
+    return true;
+}
+
+void ThumbnailStorePrivate::replay(uint32_t id, qint64 from)
+{
+    QFile file{segmentPath(id)};
+    if(!file.open(QIODevice::ReadWrite)) {
+        qCWarning(THUMB_STORE) << "Unable to open thumbnail segment" << file.fileName() << file.errorString();
+        return;
+    }
+
+    Segment& segment  = m_segments[id];
+    const qint64 size = file.size();
+    qint64 offset{from};
+
+    file.seek(offset);
+
+    while(offset < size) {
+        RecordHeader header;
+        if(file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+           || header.magic != RecordMagic) {
+            break;
+        }
+
+        const qint64 recordSize = static_cast<qint64>(sizeof(header)) + header.keySize + header.payloadSize;
+        if(offset + recordSize > size) {
+            break;
+        }
+
+        const QString key = QString::fromUtf8(file.read(header.keySize));
+        file.seek(offset + recordSize);
+
+        segment.size = offset + recordSize;
+
+        const Entry entry{id, static_cast<uint64_t>(offset), static_cast<uint32_t>(recordSize), ++m_accessCounter};
+        if(header.encoding == Encoding::Tombstone) {
+            removeKey(key);
+            segment.deadBytes += entry.recordSize;
+        }
+        else {
+            setEntry(key, header.sizeClass, entry);
+        }
+
+        offset += recordSize;
+        m_indexDirty = true;
+    }
+
+    if(offset < size) {
+        // Partially written record, most likely from being interrupted
+        qCInfo(THUMB_STORE) << "Truncating thumbnail segment" << file.fileName() << "at" << offset;
+        file.resize(offset);
+    }
+    segment.size = offset;
+}
+
+void ThumbnailStorePrivate::reset()
+{
+    closeSegments();
+    m_entries.clear();
+    m_segments.clear();
+    m_liveBytes     = 0;
+    m_accessCounter = 0;
+    m_unflushed     = 0;
+    m_indexDirty    = false;
+    m_compacting    = false;
+    ++m_generation;
+}
+
+void ThumbnailStorePrivate::closeSegments()
+{
+    m_writer.reset();
+
+    for(auto& [id, segment] : m_segments) {
+        if(segment.map) {
+            segment.file->unmap(segment.map);
+            segment.map        = nullptr;
+            segment.mappedSize = 0;
+        }
+        segment.file.reset();
+    }
+}
+
+void ThumbnailStorePrivate::setEntry(const QString& key, int sizeClass, const Entry& entry)
+{
+    auto& classes = m_entries[key];
+    if(const auto it = classes.find(sizeClass); it != classes.cend()) {
+        markDead(it->second);
+    }
+
+    classes[sizeClass] = entry;
+    m_liveBytes += entry.recordSize;
+}
+
+void ThumbnailStorePrivate::markDead(const Entry& entry)
+{
+    m_segments[entry.segment].deadBytes += entry.recordSize;
+    m_liveBytes -= entry.recordSize;
+}
+
+void ThumbnailStorePrivate::removeKey(const QString& key)
+{
+    const auto it = m_entries.find(key);
+    if(it == m_entries.cend()) {
+        return;
+    }
+
+    for(const auto& [sizeClass, entry] : it->second) {
+        markDead(entry);
+    }
+    m_entries.erase(it);
+}
+
+bool ThumbnailStorePrivate::startSegment()
+{
+    if(!QDir{}.mkpath(m_directory)) {
+        qCWarning(THUMB_STORE) << "Unable to create thumbnail store at" << m_directory;
+        return false;
+    }
+
+    const uint32_t id = m_segments.empty() ? 1 : m_segments.crbegin()->first + 1;
+
+    auto writer = std::make_unique<QFile>(segmentPath(id));
+    if(!writer->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(THUMB_STORE) << "Unable to create thumbnail segment" << writer->fileName() << writer->errorString();
+        return false;
+    }
+
+    m_segments[id].size = writer->size();
+    m_writer            = std::move(writer);
+
+    return true;
+}
+
+std::optional<Entry> ThumbnailStorePrivate::append(const QByteArray& record)
+{
+    if(m_segments.empty() || m_segments.crbegin()->second.size >= SegmentSize) {
+        if(!startSegment()) {
+            return {};
+        }
+    }
+
+    auto& [id, segment] = *m_segments.rbegin();
+
+    if(!m_writer) {
+        m_writer = std::make_unique<QFile>(segmentPath(id));
+        if(!m_writer->open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(THUMB_STORE) << "Unable to open thumbnail segment" << m_writer->fileName()
+                                   << m_writer->errorString();
+            m_writer.reset();
+            return {};
+        }
+    }
+
+    if(m_writer->write(record) != record.size() || !m_writer->flush()) {
+        qCWarning(THUMB_STORE) << "Unable to write thumbnail segment" << m_writer->fileName()
+                               << m_writer->errorString();
+        m_writer.reset();
+        return {};
+    }
+
+    const Entry entry{id, static_cast<uint64_t>(segment.size), static_cast<uint32_t>(record.size()),
+                      ++m_accessCounter};
+    segment.size += record.size();
+    m_indexDirty = true;
+
+    return entry;
+}
+
+const uchar* ThumbnailStorePrivate::mapped(const Entry& entry)
+{
+    const auto it = m_segments.find(entry.segment);
+    if(it == m_segments.end()) {
+        return nullptr;
+    }
+
+    Segment& segment = it->second;
+    const auto end   = static_cast<qint64>(entry.offset + entry.recordSize);
+
+    if(!segment.map || end > segment.mappedSize) {
+        if(!segment.file) {
+            segment.file = std::make_unique<QFile>(segmentPath(entry.segment));
+            if(!segment.file->open(QIODevice::ReadOnly)) {
+                segment.file.reset();
+                return nullptr;
+            }
+        }
+        if(segment.map) {
+            segment.file->unmap(segment.map);
+        }
+
+        // Map everything written so far so reads of neighbouring records don't remap
+        segment.mappedSize = segment.size;
+        segment.map        = segment.file->map(0, segment.mappedSize);
+        if(!segment.map) {
+            qCDebug(THUMB_STORE) << "Unable to map thumbnail segment" << segment.file->fileName()
+                                 << segment.file->errorString();
+            segment.mappedSize = 0;
+            return nullptr;
+        }
+    }
+
+    return end <= segment.mappedSize ? segment.map + entry.offset : nullptr;
+}
+
+std::optional<Payload> ThumbnailStorePrivate::readPayload(const Entry& entry)
+{
+    const uchar* record = mapped(entry);
+    if(!record) {
+        return {};
+    }
+
+    Payload payload;
+    std::memcpy(&payload.header, record, sizeof(RecordHeader));
+
+    const auto& header = payload.header;
+    if(header.magic != RecordMagic || header.encoding == Encoding::Tombstone
+       || sizeof(RecordHeader) + header.keySize + header.payloadSize != entry.recordSize) {
+        return {};
+    }
+
+    payload.data = QByteArray{reinterpret_cast<const char*>(record + sizeof(RecordHeader) + header.keySize),
+                              static_cast<qsizetype>(header.payloadSize)};
+    return payload;
+}
+
+void ThumbnailStorePrivate::evict()
+{
+    if(m_liveBytes <= m_maxSize) {
+        return;
+    }
+
+    struct Candidate
+    {
+        uint64_t lastAccess;
+        QString key;
+        int sizeClass;
+    };
+
+    std::vector<Candidate> candidates;
+    for(const auto& [key, classes] : m_entries) {
+        for(const auto& [sizeClass, entry] : classes) {
+            candidates.emplace_back(entry.lastAccess, key, sizeClass);
+        }
+    }
+    std::ranges::sort(candidates, {}, &Candidate::lastAccess);
+
+    const auto target = static_cast<uint64_t>(static_cast<double>(m_maxSize) * EvictionTarget);
+
+    for(const auto& candidate : candidates) {
+        if(m_liveBytes <= target) {
+            break;
+        }
+
+        auto& classes = m_entries[candidate.key];
+        markDead(classes.at(candidate.sizeClass));
+        classes.erase(candidate.sizeClass);
+        if(classes.empty()) {
+            m_entries.erase(candidate.key);
+        }
+    }
+
+    // Evicted records aren't tombstoned, so the index must be written for them to stay evicted
+    m_indexDirty = true;
+    writeIndex();
+}
+
+void ThumbnailStorePrivate::compact(bool force)
+{
+    struct Move
+    {
+        QString key;
+        int sizeClass;
+        Entry entry;
+    };
+
+    std::vector<Move> live;
+    std::vector<uint32_t> oldSegments;
+    uint64_t generation{0};
+    uint64_t deadBytes{0};
+
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_compacting) {
+            return;
+        }
+
+        uint64_t totalBytes{0};
+        for(const auto& [id, segment] : m_segments) {
+            deadBytes += segment.deadBytes;
+            totalBytes += static_cast<uint64_t>(segment.size);
+        }
+
+        if(deadBytes == 0 || (!force && (deadBytes < totalBytes / 2 || deadBytes < SegmentSize / 4))) {
+            return;
+        }
+
+        for(const auto& [key, classes] : m_entries) {
+            for(const auto& [sizeClass, entry] : classes) {
+                live.emplace_back(key, sizeClass, entry);
+            }
+        }
+        std::ranges::sort(live, [](const Move& lhs, const Move& rhs) {
+            return std::tie(lhs.entry.segment, lhs.entry.offset) < std::tie(rhs.entry.segment, rhs.entry.offset);
+        });
+
+        for(const auto& [id, segment] : m_segments) {
+            oldSegments.push_back(id);
+        }
+
+        // Inserts made while records are being moved go to the new segment too
+        m_writer.reset();
+        if(!startSegment()) {
+            return;
+        }
+
+        m_compacting = true;
+        generation   = m_generation;
+    }
+
+    const auto isOld = [&oldSegments](const Entry& entry) {
+        return std::ranges::find(oldSegments, entry.segment) != oldSegments.cend();
+    };
+
+    for(const Move& move : live) {
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_generation != generation) {
+            return;
+        }
+
+        // Skip records which were replaced, removed or evicted since the copy started
+        const auto keyIt = m_entries.find(move.key);
+        if(keyIt == m_entries.end()) {
+            continue;
+        }
+        const auto classIt = keyIt->second.find(move.sizeClass);
+        if(classIt == keyIt->second.end() || !isOld(classIt->second)) {
+            continue;
+        }
+
+        Entry& entry        = classIt->second;
+        const uchar* record = mapped(entry);
+        if(!record) {
+            continue;
+        }
+
+        const QByteArray data{reinterpret_cast<const char*>(record), static_cast<qsizetype>(entry.recordSize)};
+        const auto moved = append(data);
+        if(!moved) {
+            // Moved records are accounted to their new segment, so the old segments are simply kept
+            m_compacting = false;
+            return;
+        }
+
+        markDead(entry);
+        entry.segment = moved->segment;
+        entry.offset  = moved->offset;
+        m_liveBytes += entry.recordSize;
+    }
+
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_generation != generation) {
+            return;
+        }
+
+        m_compacting = false;
+
+        // Entries which couldn't be read are lost with their segment
+        for(auto it = m_entries.begin(); it != m_entries.end();) {
+            std::erase_if(it->second, [this, &isOld](const auto& item) {
+                if(!isOld(item.second)) {
+                    return false;
+                }
+                markDead(item.second);
+                return true;
+            });
+            it = it->second.empty() ? m_entries.erase(it) : std::next(it);
+        }
+
+        for(const uint32_t id : oldSegments) {
+            auto& segment = m_segments.at(id);
+            if(segment.map) {
+                segment.file->unmap(segment.map);
+            }
+            m_segments.erase(id);
+        }
+
+        // The index must point at the new segments before the old ones are removed
+        m_indexDirty = true;
+        writeIndex();
+    }
+
+    for(const uint32_t id : oldSegments) {
+        QFile::remove(segmentPath(id));
+    }
+
+    qCDebug(THUMB_STORE) << "Compacted thumbnail store, reclaimed" << deadBytes << "bytes";
+}
+
+void ThumbnailStorePrivate::writeIndex()
+{
+    if(!m_indexDirty) {
+        return;
+    }
+
+    QSaveFile file{indexPath()};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qCWarning(THUMB_STORE) << "Unable to write thumbnail index" << file.errorString();
+        return;
+    }
+
+    QDataStream stream{&file};
+    stream << IndexMagic << IndexVersion << static_cast<quint64>(m_accessCounter);
+
+    stream << static_cast<quint32>(m_segments.size());
+    for(const auto& [id, segment] : m_segments) {
+        stream << id << segment.size;
+    }
+
+    quint32 entryCount{0};
+    for(const auto& [key, classes] : m_entries) {
+        entryCount += static_cast<quint32>(classes.size());
+    }
+
+    stream << entryCount;
+    for(const auto& [key, classes] : m_entries) {
+        for(const auto& [sizeClass, entry] : classes) {
+            stream << key << static_cast<qint32>(sizeClass) << entry.segment << static_cast<quint64>(entry.offset)
+                   << entry.recordSize << static_cast<quint64>(entry.lastAccess);
+        }
+    }
+
+    if(!file.commit()) {
+        qCWarning(THUMB_STORE) << "Unable to write thumbnail index" << file.errorString();
+        return;
+    }
+
+    m_unflushed  = 0;
+    m_indexDirty = false;
+}
+
+ThumbnailStore::ThumbnailStore(QString directory, uint64_t maxSize)
+    : p{std::make_unique<ThumbnailStorePrivate>(std::move(directory), maxSize)}
+{
+    p->open();
+}
+
+ThumbnailStore::~ThumbnailStore()
+{
+    const std::scoped_lock lock{p->m_mutex};
+    p->writeIndex();
+    p->closeSegments();
+}
+
+QString ThumbnailStore::directory() const
+{
+    return p->m_directory;
+}
+
+uint64_t ThumbnailStore::maxSize() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return p->m_maxSize;
+}
+
+void ThumbnailStore::setMaxSize(uint64_t bytes)
+{
+    {
+        const std::scoped_lock lock{p->m_mutex};
+        p->m_maxSize = bytes;
+        p->evict();
+    }
+
+    p->compact(false);
+}
+
+uint64_t ThumbnailStore::size() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+    return p->m_liveBytes;
+}
+
+uint64_t ThumbnailStore::diskSize() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    uint64_t size{0};
+    for(const auto& [id, segment] : p->m_segments) {
+        size += static_cast<uint64_t>(segment.size);
+    }
+    return size;
+}
+
+int ThumbnailStore::count() const
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    size_t count{0};
+    for(const auto& [key, classes] : p->m_entries) {
+        count += classes.size();
+    }
+    return static_cast<int>(count);
+}
+
+bool ThumbnailStore::contains(const QString& key, int sizeClass) const
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    const auto it = p->m_entries.find(key);
+    return it != p->m_entries.cend() && it->second.contains(sizeClass);
+}
+
+QImage ThumbnailStore::image(const QString& key, int sizeClass) const
+{
+    return images({{key, sizeClass}}).front();
+}
+
+std::vector<QImage> ThumbnailStore::images(const std::vector<Lookup>& lookups) const
+{
+    std::vector<std::optional<Payload>> payloads(lookups.size());
+
+    {
+        const std::scoped_lock lock{p->m_mutex};
+
+        std::vector<std::pair<size_t, Entry*>> found;
+        for(size_t i{0}; i < lookups.size(); ++i) {
+            const auto it = p->m_entries.find(lookups.at(i).key);
+            if(it == p->m_entries.end()) {
+                continue;
+            }
+            if(const auto classIt = it->second.find(lookups.at(i).sizeClass); classIt != it->second.end()) {
+                found.emplace_back(i, &classIt->second);
+            }
+        }
+
+        std::ranges::sort(found, [](const auto& lhs, const auto& rhs) {
+            return std::tie(lhs.second->segment, lhs.second->offset)
+                 < std::tie(rhs.second->segment, rhs.second->offset);
+        });
+
+        for(const auto& [i, entry] : found) {
+            entry->lastAccess = ++p->m_accessCounter;
+            payloads[i]       = p->readPayload(*entry);
+        }
+
+        if(!found.empty()) {
+            p->m_indexDirty = true;
+        }
+    }
+
+    std::vector<QImage> result(lookups.size());
+    for(size_t i{0}; i < payloads.size(); ++i) {
+        if(payloads.at(i)) {
+            result[i] = decodeImage(*payloads.at(i));
+        }
+    }
+
+    return result;
+}
+
+bool ThumbnailStore::insert(const QString& key, int sizeClass, const QImage& image)
+{
+    if(key.isEmpty() || sizeClass < 0 || sizeClass > UINT16_MAX) {
+        return false;
+    }
+
+    const auto encoded = encodeImage(image);
+    if(!encoded) {
+        return false;
+    }
+
+    const QByteArray keyData = key.toUtf8();
+
+    RecordHeader header;
+    header.payloadSize = static_cast<uint32_t>(encoded->data.size());
+    header.keySize     = static_cast<uint16_t>(keyData.size());
+    header.sizeClass   = static_cast<uint16_t>(sizeClass);
+    header.width       = encoded->width;
+    header.height      = encoded->height;
+    header.encoding    = encoded->encoding;
+
+    QByteArray record;
+    record.reserve(static_cast<qsizetype>(sizeof(header)) + keyData.size() + encoded->data.size());
+    record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    record.append(keyData);
+    record.append(encoded->data);
+
+    bool evicted{false};
+
+    {
+        const std::scoped_lock lock{p->m_mutex};
+
+        const auto entry = p->append(record);
+        if(!entry) {
+            return false;
+        }
+
+        p->setEntry(key, sizeClass, *entry);
+
+        if(p->m_liveBytes > p->m_maxSize) {
+            p->evict();
+            evicted = true;
+        }
+        else if(++p->m_unflushed >= FlushInterval) {
+            p->writeIndex();
+        }
+    }
+
+    if(evicted) {
+        p->compact(false);
+    }
+
+    return true;
+}
+
+void ThumbnailStore::remove(const QString& key)
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    if(!p->m_entries.contains(key)) {
+        return;
+    }
+
+    p->removeKey(key);
+
+    const QByteArray keyData = key.toUtf8();
+
+    RecordHeader header;
+    header.keySize  = static_cast<uint16_t>(keyData.size());
+    header.encoding = Encoding::Tombstone;
+
+    QByteArray record;
+    record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    record.append(keyData);
+
+    if(const auto tombstone = p->append(record)) {
+        p->m_segments[tombstone->segment].deadBytes += tombstone->recordSize;
+    }
+}
+
+void ThumbnailStore::clear()
+{
+    const std::scoped_lock lock{p->m_mutex};
+
+    p->closeSegments();
+
+    for(const auto& [id, segment] : p->m_segments) {
+        QFile::remove(p->segmentPath(id));
+    }
+    QFile::remove(p->indexPath());
+
+    p->reset();
+}
+
+void ThumbnailStore::flush()
+{
+    const std::scoped_lock lock{p->m_mutex};
+    p->writeIndex();
+}
+
+void ThumbnailStore::compact(bool force)
+{
+    p->compact(force);
+}
+} // namespace Fooyin
@@ -0,0 +1,104 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fygui_export.h"
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+class QImage;
+
+namespace Fooyin {
+class ThumbnailStorePrivate;
+
+/*!
+ * Packed on-disk store for cover thumbnails.
+ *
+ * Thumbnails are appended as records to a small number of data segments which are
+ * memory-mapped for reading, while an in-memory index maps each key and size class
+ * to its record. Small size classes are stored as raw pixels so they can be used
+ * without decoding; larger ones are stored as JPEG.
+ *
+ * Removals are written as tombstone records, so the index file is only a snapshot
+ * and any records appended after it are replayed on open. Space held by replaced,
+ * removed or evicted records is reclaimed by compaction.
+ *
+ * @note all methods are thread-safe. Images are decoded outside of the store lock, and
+ * compaction moves one record at a time so lookups and inserts carry on alongside it.
+ * Opening, eviction and compaction all touch the disk, so avoid them on the main thread.
+ */
+class FYGUI_EXPORT ThumbnailStore
+{
+public:
+    struct Lookup
+    {
+        QString key;
+        int sizeClass{0};
+    };
+
+    //! Size class used for the source image that other size classes are scaled from.
+    static constexpr int SourceClass = 0;
+
+    explicit ThumbnailStore(QString directory, uint64_t maxSize = 512ULL * 1024 * 1024);
+    ~ThumbnailStore();
+
+    ThumbnailStore(const ThumbnailStore&)            = delete;
+    ThumbnailStore& operator=(const ThumbnailStore&) = delete;
+
+    [[nodiscard]] QString directory() const;
+
+    [[nodiscard]] uint64_t maxSize() const;
+    //! Sets the cap on live bytes, evicting the least recently used thumbnails if exceeded.
+    void setMaxSize(uint64_t bytes);
+
+    //! Returns the size of all live records.
+    [[nodiscard]] uint64_t size() const;
+    //! Returns the size of all segments, including space awaiting compaction.
+    [[nodiscard]] uint64_t diskSize() const;
+    [[nodiscard]] int count() const;
+
+    [[nodiscard]] bool contains(const QString& key, int sizeClass) const;
+    //! Returns the thumbnail for @p key at @p sizeClass, or a null image if not stored.
+    [[nodiscard]] QImage image(const QString& key, int sizeClass) const;
+    /*!
+     * Returns the thumbnails for all @p lookups in the same order, reading the records in
+     * on-disk order. Thumbnails which aren't stored are returned as null images.
+     */
+    [[nodiscard]] std::vector<QImage> images(const std::vector<Lookup>& lookups) const;
+
+    //! Stores @p image for @p key at @p sizeClass, replacing any existing thumbnail.
+    bool insert(const QString& key, int sizeClass, const QImage& image);
+    //! Removes all size classes of @p key.
+    void remove(const QString& key);
+    //! Removes all thumbnails and segments.
+    void clear();
+
+    //! Writes the index so records don't need to be replayed on the next open.
+    void flush();
+    //! Rewrites live records into new segments if enough space is held by dead records.
+    void compact(bool force = false);
+
+private:
+    std::unique_ptr<ThumbnailStorePrivate> p;
+};
+} // namespace Fooyin
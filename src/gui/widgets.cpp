@@ -442,6 +442,13 @@ void Widgets::registerAdvancedSettings()
          .editor      = AdvancedSettingSpinBox{.minimum = 0, .maximum = 300000, .singleStep = 100, .suffix = u" ms"_s},
          .normalise   = {},
          .validate    = {}});
+    advancedSettingsRegistry->add<Settings::Core::Internal::LibraryScanThreads>(
+        {.category    = {tr("Library"), tr("Scanning")},
+         .label       = tr("Metadata reader threads"),
+         .description = tr("Number of threads used to read file metadata when scanning libraries."),
+         .editor      = AdvancedSettingSpinBox{.minimum = 1, .maximum = 32, .singleStep = 1, .suffix = {}},
+         .normalise   = {},
+         .validate    = {}});
     advancedSettingsRegistry->add<Settings::Core::PreserveTimestamps>(
         {.category    = {tr("Tagging")},
          .label       = tr("Preserve timestamps"),
@@ -35,6 +35,7 @@
 #include <QWheelEvent>
 
 #include <set>
+#include <utility>
 
 using namespace Qt::StringLiterals;
 
@@ -1410,18 +1411,23 @@ int TreeView::indexSizeHint(const QModelIndex& index, bool span) const
 void TreeView::ensureItemOffsetCache() const
 {
     const int count = itemCount();
-    if(!m_p->m_itemOffsetsDirty && static_cast<int>(m_p->m_itemOffsets.size()) == count + 1) {
+    // Structural changes lay out every view item again, so the index is rebuilt alongside them in O(n)
+    if(m_p->m_itemOffsetsDirty || m_p->m_itemOffsets.size() != count) {
+        std::vector<int> extents(count);
+        for(int i{0}; i < count; ++i) {
+            extents[i] = itemHeight(i) + itemPadding(i);
+        }
+
+        m_p->m_itemOffsets.assign(std::move(extents));
+        m_p->m_staleItemOffsets.clear();
+        m_p->m_itemOffsetsDirty = false;
         return;
     }
 
-    m_p->m_itemOffsets.resize(count + 1);
-    m_p->m_itemOffsets[0] = 0;
-
-    for(int i{0}; i < count; ++i) {
-        m_p->m_itemOffsets[i + 1] = m_p->m_itemOffsets[i] + itemHeight(i) + itemPadding(i);
+    for(const int item : m_p->m_staleItemOffsets) {
+        m_p->m_itemOffsets.setExtent(item, itemHeight(item) + itemPadding(item));
     }
-
-    m_p->m_itemOffsetsDirty = false;
+    m_p->m_staleItemOffsets.clear();
 }
 
 int TreeView::itemOffset(int item) const
@@ -1431,11 +1437,7 @@ int TreeView::itemOffset(int item) const
     }
 
     ensureItemOffsetCache();
-    if(std::cmp_greater_equal(item, m_p->m_itemOffsets.size())) {
-        return m_p->m_itemOffsets.empty() ? 0 : m_p->m_itemOffsets.back();
-    }
-
-    return m_p->m_itemOffsets.at(item);
+    return m_p->m_itemOffsets.offset(item);
 }
 
 int TreeView::itemAtOffset(int offset, bool includePadding) const
@@ -1446,15 +1448,12 @@ int TreeView::itemAtOffset(int offset, bool includePadding) const
 
     ensureItemOffsetCache();
 
-    const auto begin = m_p->m_itemOffsets.cbegin();
-    const auto end   = m_p->m_itemOffsets.cend();
-    const auto it    = std::ranges::upper_bound(begin, end, offset);
-    if(it == begin || it == end) {
+    const int item = m_p->m_itemOffsets.itemAt(offset);
+    if(item < 0) {
         return -1;
     }
 
-    const int item = static_cast<int>(std::ranges::distance(begin, it)) - 1;
-    if(includePadding && offset >= m_p->m_itemOffsets.at(item) + itemHeight(item)) {
+    if(includePadding && offset >= m_p->m_itemOffsets.offset(item) + itemHeight(item)) {
         return -1;
     }
 
@@ -1480,31 +1479,34 @@ void TreeView::recalculatePadding()
     }
 
     int rowHeight{0};
-    auto& items = viewItems();
-
-    for(auto& item : items) {
-        item.padding = 0;
-
-        if(item.hasChildren || item.parentItem == -1) {
-            continue;
-        }
+    auto& items     = viewItems();
+    const int count = itemCount();
 
-        const QModelIndex parent = m_p->modelIndex(item.parentItem);
-        const int rowCount       = model()->rowCount(parent);
-        const int row            = item.index.row();
+    for(int i{0}; i < count; ++i) {
+        auto& item           = items[i];
+        const int oldPadding = std::exchange(item.padding, 0);
+
+        if(!item.hasChildren && item.parentItem != -1) {
+            const QModelIndex parent = m_p->modelIndex(item.parentItem);
+            const int rowCount       = model()->rowCount(parent);
+            const int row            = item.index.row();
+
+            if(row == rowCount - 1) {
+                if(rowHeight == 0) {
+                    // Assume all track rows have the same height
+                    rowHeight = indexRowSizeHint(item.index);
+                }
 
-        if(row == rowCount - 1) {
-            if(rowHeight == 0) {
-                // Assume all track rows have the same height
-                rowHeight = indexRowSizeHint(item.index);
+                const int sectionHeight = rowCount * rowHeight;
+                item.padding            = (max > sectionHeight) ? max - sectionHeight : 0;
             }
+        }
 
-            const int sectionHeight = rowCount * rowHeight;
-            item.padding            = (max > sectionHeight) ? max - sectionHeight : 0;
+        // Only the last row of each group carries padding, so patch those rather than rebuilding every offset
+        if(item.padding != oldPadding) {
+            m_p->invalidateItemOffset(i);
         }
     }
-
-    m_p->m_itemOffsetsDirty = true;
 }
 
 void TreeView::drawAndClipSpans(QPainter* painter, const QStyleOptionViewItem& option, int firstVisibleItem,
@@ -2657,7 +2659,23 @@ bool ExpandedTreeViewPrivate::itemHasChildren(int i) const
 void ExpandedTreeViewPrivate::invalidateHeightCache(int item) const
 {
     m_viewItems[item].height = 0;
-    m_itemOffsetsDirty       = true;
+    invalidateItemOffset(item);
+}
+
+void ExpandedTreeViewPrivate::invalidateItemOffset(int item) const
+{
+    if(m_itemOffsetsDirty) {
+        return;
+    }
+
+    // Patching the offset index is O(log n) per item, so fall back to a rebuild for large batches
+    if(m_staleItemOffsets.size() * 4 >= m_viewItems.size()) {
+        m_staleItemOffsets.clear();
+        m_itemOffsetsDirty = true;
+        return;
+    }
+
+    m_staleItemOffsets.push_back(item);
 }
 
 int ExpandedTreeViewPrivate::itemForHomeKey() const
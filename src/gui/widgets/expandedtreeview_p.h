@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "itemoffsetindex.h"
+
 #include <gui/widgets/expandedtreeview.h>
 
 #include <QBasicTimer>
@@ -99,6 +101,7 @@ public:
     bool isItemDisabled(int i) const;
     bool itemHasChildren(int i) const;
     void invalidateHeightCache(int item) const;
+    void invalidateItemOffset(int item) const;
     int itemForHomeKey() const;
     int itemForEndKey() const;
     void setHoverIndex(const QPersistentModelIndex& index);
@@ -143,7 +146,8 @@ public:
     bool m_layingOutItems{false};
 
     mutable std::vector<ExpandedTreeViewItem> m_viewItems;
-    mutable std::vector<int> m_itemOffsets;
+    mutable ItemOffsetIndex m_itemOffsets;
+    mutable std::vector<int> m_staleItemOffsets;
     mutable bool m_itemOffsetsDirty{true};
     mutable int m_lastViewedItem{0};
     int m_defaultItemHeight{20};
@@ -0,0 +1,185 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "itemoffsetindex.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace Fooyin {
+ItemOffsetIndex::ItemOffsetIndex(std::vector<int> extents)
+{
+    assign(std::move(extents));
+}
+
+bool ItemOffsetIndex::empty() const
+{
+    return m_extents.empty();
+}
+
+int ItemOffsetIndex::size() const
+{
+    return static_cast<int>(m_extents.size());
+}
+
+void ItemOffsetIndex::clear()
+{
+    m_extents.clear();
+    m_tree.clear();
+    m_total = 0;
+}
+
+void ItemOffsetIndex::assign(std::vector<int> extents)
+{
+    m_extents = std::move(extents);
+    rebuild();
+}
+
+int ItemOffsetIndex::extent(int item) const
+{
+    if(item < 0 || item >= size()) {
+        return 0;
+    }
+
+    return m_extents[item];
+}
+
+void ItemOffsetIndex::setExtent(int item, int extent)
+{
+    if(item < 0 || item >= size()) {
+        return;
+    }
+
+    const int delta = extent - m_extents[item];
+    if(delta == 0) {
+        return;
+    }
+
+    m_extents[item] = extent;
+    add(item, delta);
+}
+
+void ItemOffsetIndex::insert(int pos, int count, int extent)
+{
+    if(count <= 0) {
+        return;
+    }
+
+    pos = std::clamp(pos, 0, size());
+
+    if(pos == size()) {
+        if(m_tree.empty()) {
+            m_tree.push_back(0);
+        }
+        // Appending only needs the new nodes, each of which covers a range ending at itself
+        for(int i{0}; i < count; ++i) {
+            const int node = size() + 1;
+            int sum        = extent;
+            for(int child = node - 1; child > node - (node & -node); child -= (child & -child)) {
+                sum += m_tree[child];
+            }
+            m_extents.push_back(extent);
+            m_tree.push_back(sum);
+            m_total += extent;
+        }
+        return;
+    }
+
+    m_extents.insert(m_extents.begin() + pos, count, extent);
+    rebuild();
+}
+
+void ItemOffsetIndex::remove(int pos, int count)
+{
+    if(pos < 0 || pos >= size() || count <= 0) {
+        return;
+    }
+
+    count = std::min(count, size() - pos);
+    m_extents.erase(m_extents.begin() + pos, m_extents.begin() + pos + count);
+    rebuild();
+}
+
+int ItemOffsetIndex::offset(int item) const
+{
+    item = std::clamp(item, 0, size());
+
+    int sum{0};
+    for(; item > 0; item -= (item & -item)) {
+        sum += m_tree[item];
+    }
+    return sum;
+}
+
+int ItemOffsetIndex::totalExtent() const
+{
+    return m_total;
+}
+
+int ItemOffsetIndex::itemAt(int offset) const
+{
+    if(offset < 0 || offset >= m_total) {
+        return -1;
+    }
+
+    const auto count = static_cast<unsigned>(size());
+
+    int pos{0};
+    int remaining{offset};
+    for(unsigned step = std::bit_floor(count); step > 0; step >>= 1) {
+        const auto next = static_cast<int>(pos + step);
+        if(std::cmp_less_equal(next, count) && m_tree[next] <= remaining) {
+            pos = next;
+            remaining -= m_tree[next];
+        }
+    }
+
+    return pos < size() ? pos : -1;
+}
+
+void ItemOffsetIndex::add(int item, int delta)
+{
+    m_total += delta;
+
+    const int count = size();
+    for(int node = item + 1; node <= count; node += (node & -node)) {
+        m_tree[node] += delta;
+    }
+}
+
+void ItemOffsetIndex::rebuild()
+{
+    const int count = size();
+
+    // Index 0 is unused so that parent/child links are simple bit operations
+    m_tree.assign(count + 1, 0);
+    m_total = 0;
+
+    for(int node{1}; node <= count; ++node) {
+        m_tree[node] += m_extents[node - 1];
+        m_total += m_extents[node - 1];
+
+        const int parent = node + (node & -node);
+        if(parent <= count) {
+            m_tree[parent] += m_tree[node];
+        }
+    }
+}
+} // namespace Fooyin
@@ -0,0 +1,71 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fygui_export.h"
+
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * Fenwick tree over the vertical extent (height + padding) of each view item.
+ * Changing a single extent, mapping an item to its offset and mapping an offset
+ * back to an item are O(log n), so updating one row no longer requires the
+ * whole prefix-sum array to be rebuilt.
+ */
+class FYGUI_EXPORT ItemOffsetIndex
+{
+public:
+    ItemOffsetIndex() = default;
+    explicit ItemOffsetIndex(std::vector<int> extents);
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] int size() const;
+
+    void clear();
+    //! Replaces all extents, building the index in O(n).
+    void assign(std::vector<int> extents);
+
+    [[nodiscard]] int extent(int item) const;
+    //! Sets the extent of @p item in O(log n).
+    void setExtent(int item, int extent);
+
+    //! Inserts @p count items of @p extent before @p pos. Appending is O(count log n).
+    void insert(int pos, int count, int extent);
+    void remove(int pos, int count);
+
+    //! Returns the sum of the extents of all items before @p item.
+    [[nodiscard]] int offset(int item) const;
+    [[nodiscard]] int totalExtent() const;
+    /*!
+     * Returns the item covering @p offset, skipping zero-extent items,
+     * or -1 if @p offset lies outside of the index.
+     */
+    [[nodiscard]] int itemAt(int offset) const;
+
+private:
+    void add(int item, int delta);
+    void rebuild();
+
+    std::vector<int> m_extents;
+    std::vector<int> m_tree;
+    int m_total{0};
+};
+} // namespace Fooyin
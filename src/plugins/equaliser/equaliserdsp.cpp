@@ -105,7 +105,7 @@ void EqualiserDsp::process(ProcessingBufferList& chunks)
         return;
     }
 
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_outputChunks;
     output.clear();
 
     const size_t count = chunks.count();
@@ -139,15 +139,8 @@ void EqualiserDsp::process(ProcessingBufferList& chunks)
         emitOutputChunk(output, producedFrames, sourceFrameDurationNs);
     }
 
-    chunks.clear();
-
-    const size_t outCount = output.count();
-    for(size_t i{0}; i < outCount; ++i) {
-        const auto* buffer = output.item(i);
-        if(buffer && buffer->isValid()) {
-            chunks.addChunk(*buffer);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 
 void EqualiserDsp::reset()
@@ -78,6 +78,7 @@ private:
     SuperEq::Processor m_processor;
 
     std::vector<double> m_outputScratch;
+    ProcessingBufferList m_outputChunks;
 
     Settings m_settings;
     Settings m_appliedSettings;
@@ -21,6 +21,7 @@
 
 #include "filtercolumnregistry.h"
 #include "filtercontextmenu.h"
+#include "filterfacetindex.h"
 #include "filtermanager.h"
 #include "filterpipeline.h"
 #include "filterrows.h"
@@ -100,6 +101,12 @@ bool containsSummaryKey(const std::vector<RowKey>& keys)
 {
     return std::ranges::any_of(keys, [](const RowKey& key) { return key.isEmpty(); });
 }
+
+struct StageRows
+{
+    std::shared_ptr<const FilterFacetIndex> index;
+    FilterRowList rows;
+};
 } // namespace
 
 class FilterControllerPrivate
@@ -121,6 +128,8 @@ public:
 
         FilterRowList rows;
         std::optional<FilterRowList> searchedRows;
+        // Built over the group's source tracks and shared with in-flight row builds, so only replaced by updated copies
+        std::shared_ptr<const FilterFacetIndex> index;
 
         std::vector<RowKey> selectedKeys;
         QString searchText;
@@ -644,8 +653,18 @@ bool FilterControllerPrivate::patchGroup(const Id& groupId, const TrackList& sou
         const FilterColumnList columns      = stage.widget ? stage.widget->columns() : FilterColumnList{};
 
         stage.inputTracks = currentTracks;
-        stage.rows     = patchFilterRows(m_libraryManager, columns, stage.rows, previousInputTracks, stage.inputTracks,
-                                         changedTrackIds, context);
+
+        if(stage.index && stage.index->isCompatible(columns, context)) {
+            // Shares the untouched facets with the current index, which in-flight row builds may still be reading
+            auto index  = stage.index->updated(group.sourceTracks, changedTrackIds);
+            stage.rows  = index->rows(stage.inputTracks);
+            stage.index = std::move(index);
+        }
+        else {
+            stage.index.reset();
+            stage.rows = patchFilterRows(m_libraryManager, columns, stage.rows, previousInputTracks,
+                                         stage.inputTracks, changedTrackIds, context);
+        }
         stage.revision = group.revision;
 
         const FilterSelectionResolution selection
@@ -683,6 +702,11 @@ void FilterControllerPrivate::recomputeGroup(const Id& groupId)
     ++group.revision;
 
     syncStages(group);
+
+    for(auto& stage : group.stages) {
+        stage.index.reset();
+    }
+
     recomputeStage(groupId, 0, group.revision, group.sourceTracks, false);
 }
 
@@ -716,11 +740,30 @@ void FilterControllerPrivate::recomputeStage(const Id& groupId, int stageIndex,
     const FilterColumnList columns = stage.widget ? stage.widget->columns() : FilterColumnList{};
     const auto context             = rowBuildContext();
 
-    Utils::asyncExec([libraryManager = m_libraryManager, columns, tracks = stage.inputTracks, context]() {
-        return buildFilterRows(libraryManager, columns, tracks, context);
+    std::shared_ptr<const FilterFacetIndex> index;
+    if(stage.index && stage.index->isCompatible(columns, context)) {
+        index = stage.index;
+    }
+
+    Utils::asyncExec([libraryManager = m_libraryManager, columns, sourceTracks = group.sourceTracks,
+                      tracks = stage.inputTracks, context, index]() {
+        StageRows result{.index = index, .rows = {}};
+
+        if(columns.empty()) {
+            return result;
+        }
+
+        if(!result.index) {
+            auto builtIndex = std::make_shared<FilterFacetIndex>(libraryManager, columns, context);
+            builtIndex->build(sourceTracks);
+            result.index = std::move(builtIndex);
+        }
+
+        result.rows = result.index->rows(tracks);
+        return result;
     })
         .then(m_self, [this, groupId, stageIndex, revision, currentTracks = std::move(currentTracks),
-                       constrained](const FilterRowList& rows) mutable {
+                       constrained](const StageRows& result) mutable {
             if(!m_groups.contains(groupId)) {
                 return;
             }
@@ -735,7 +778,8 @@ void FilterControllerPrivate::recomputeStage(const Id& groupId, int stageIndex,
                 return;
             }
 
-            currentStage.rows = rows;
+            currentStage.rows  = result.rows;
+            currentStage.index = result.index;
 
             const FilterSelectionResolution selection
                 = resolveFilterSelection(currentStage.rows, currentStage.inputTracks, currentStage.selectedKeys);
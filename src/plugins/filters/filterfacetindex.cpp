@@ -0,0 +1,512 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filterfacetindex.h"
+
+#include <core/constants.h>
+#include <core/scripting/scriptenvironmenthelpers.h>
+#include <core/scripting/scriptparser.h>
+#include <gui/scripting/richtextutils.h>
+#include <gui/scripting/scriptformatter.h>
+
+#include <bit>
+#include <numeric>
+#include <ranges>
+#include <unordered_set>
+#include <utility>
+
+using namespace Qt::StringLiterals;
+
+namespace Fooyin::Filters {
+namespace {
+constexpr int WordBits = 64;
+
+struct ColumnData
+{
+    QStringList plainColumns;
+    std::vector<RichText> richColumns;
+};
+
+RichText placeholderRichText()
+{
+    RichText richText;
+    richText.blocks.push_back({.text = u"?"_s, .format = {}});
+    return richText;
+}
+
+ColumnData buildColumnData(const QStringList& columns, ScriptFormatter& formatter)
+{
+    ColumnData data;
+    data.plainColumns.reserve(columns.size());
+    data.richColumns.reserve(columns.size());
+
+    for(const QString& column : columns) {
+        RichText richColumn = trimRichText(formatter.evaluate(column));
+        QString plainColumn = richColumn.joinedText();
+
+        if(plainColumn.isEmpty()) {
+            RichText placeholder = trimRichText(formatter.evaluate(column + u"?"_s));
+            if(!placeholder.empty()) {
+                richColumn = std::move(placeholder);
+            }
+            else {
+                richColumn = placeholderRichText();
+            }
+            plainColumn = richColumn.joinedText();
+        }
+
+        data.plainColumns.push_back(plainColumn);
+        data.richColumns.push_back(std::move(richColumn));
+    }
+
+    return data;
+}
+
+// 64-bit FNV-1a over the plain column text, separated so that column boundaries are significant
+RowKey rowKey(const QStringList& columns)
+{
+    uint64_t hash{14695981039346656037ULL};
+
+    const auto mix = [&hash](char16_t unit) {
+        hash ^= unit;
+        hash *= 1099511628211ULL;
+    };
+
+    for(const QString& column : columns) {
+        for(const QChar ch : column) {
+            mix(ch.unicode());
+        }
+        mix(u'\036');
+    }
+
+    return {reinterpret_cast<const char*>(&hash), sizeof(hash)};
+}
+
+bool sameSymbols(const RatingStarSymbols& left, const RatingStarSymbols& right)
+{
+    return left.fullStarSymbol == right.fullStarSymbol && left.halfStarSymbol == right.halfStarSymbol
+        && left.emptyStarSymbol == right.emptyStarSymbol;
+}
+} // namespace
+
+TrackIdSet::TrackIdSet(TrackIds ids)
+{
+    std::erase_if(ids, [](int id) { return id < 0; });
+    std::ranges::sort(ids);
+
+    for(const int id : ids) {
+        const auto block   = static_cast<uint32_t>(id / WordBits);
+        const uint64_t bit = uint64_t{1} << (id % WordBits);
+
+        if(m_blocks.empty() || m_blocks.back() != block) {
+            m_blocks.push_back(block);
+            m_words.push_back(bit);
+        }
+        else {
+            m_words.back() |= bit;
+        }
+    }
+}
+
+TrackIdSet::TrackIdSet(const TrackList& tracks)
+    : TrackIdSet{[&tracks]() {
+        TrackIds ids;
+        ids.reserve(tracks.size());
+        std::ranges::transform(tracks, std::back_inserter(ids), &Track::id);
+        return ids;
+    }()}
+{ }
+
+bool TrackIdSet::empty() const
+{
+    return m_words.empty();
+}
+
+size_t TrackIdSet::count() const
+{
+    return std::accumulate(m_words.cbegin(), m_words.cend(), size_t{0},
+                           [](size_t total, uint64_t word) { return total + std::popcount(word); });
+}
+
+bool TrackIdSet::contains(int id) const
+{
+    if(id < 0) {
+        return false;
+    }
+
+    const auto block = static_cast<uint32_t>(id / WordBits);
+    const auto it    = std::ranges::lower_bound(m_blocks, block);
+    if(it == m_blocks.cend() || *it != block) {
+        return false;
+    }
+
+    const auto word = m_words.at(std::distance(m_blocks.cbegin(), it));
+    return (word >> (id % WordBits)) & 1;
+}
+
+TrackIds TrackIdSet::ids() const
+{
+    TrackIds ids;
+    ids.reserve(count());
+
+    for(size_t i{0}; i < m_blocks.size(); ++i) {
+        uint64_t word = m_words[i];
+        while(word != 0) {
+            const int bit = std::countr_zero(word);
+            ids.push_back(static_cast<int>(m_blocks[i]) * WordBits + bit);
+            word &= word - 1;
+        }
+    }
+
+    return ids;
+}
+
+void TrackIdSet::insert(int id)
+{
+    if(id < 0) {
+        return;
+    }
+
+    const auto block   = static_cast<uint32_t>(id / WordBits);
+    const uint64_t bit = uint64_t{1} << (id % WordBits);
+    const auto it      = std::ranges::lower_bound(m_blocks, block);
+    const auto pos     = std::distance(m_blocks.begin(), it);
+
+    if(it == m_blocks.end() || *it != block) {
+        m_blocks.insert(it, block);
+        m_words.insert(m_words.begin() + pos, bit);
+    }
+    else {
+        m_words[pos] |= bit;
+    }
+}
+
+void TrackIdSet::remove(int id)
+{
+    if(id < 0) {
+        return;
+    }
+
+    const auto block = static_cast<uint32_t>(id / WordBits);
+    const auto it    = std::ranges::lower_bound(m_blocks, block);
+    if(it == m_blocks.end() || *it != block) {
+        return;
+    }
+
+    const auto pos = std::distance(m_blocks.begin(), it);
+    m_words[pos] &= ~(uint64_t{1} << (id % WordBits));
+
+    if(m_words[pos] == 0) {
+        m_blocks.erase(it);
+        m_words.erase(m_words.begin() + pos);
+    }
+}
+
+TrackIdSet TrackIdSet::intersected(const TrackIdSet& other) const
+{
+    // Walk the smaller set and search forward through the larger one
+    const TrackIdSet& small = m_blocks.size() <= other.m_blocks.size() ? *this : other;
+    const TrackIdSet& large = &small == this ? other : *this;
+
+    TrackIdSet result;
+    auto searchFrom = large.m_blocks.cbegin();
+
+    for(size_t i{0}; i < small.m_blocks.size(); ++i) {
+        const uint32_t block = small.m_blocks[i];
+
+        searchFrom = std::lower_bound(searchFrom, large.m_blocks.cend(), block);
+        if(searchFrom == large.m_blocks.cend()) {
+            break;
+        }
+        if(*searchFrom != block) {
+            continue;
+        }
+
+        const uint64_t word = small.m_words[i] & large.m_words[std::distance(large.m_blocks.cbegin(), searchFrom)];
+        if(word != 0) {
+            result.m_blocks.push_back(block);
+            result.m_words.push_back(word);
+        }
+    }
+
+    return result;
+}
+
+void TrackIdSet::unite(const TrackIdSet& other)
+{
+    if(other.empty()) {
+        return;
+    }
+    if(empty()) {
+        *this = other;
+        return;
+    }
+
+    std::vector<uint32_t> blocks;
+    std::vector<uint64_t> words;
+    blocks.reserve(m_blocks.size() + other.m_blocks.size());
+    words.reserve(m_words.size() + other.m_words.size());
+
+    size_t left{0};
+    size_t right{0};
+
+    while(left < m_blocks.size() || right < other.m_blocks.size()) {
+        if(right == other.m_blocks.size()
+           || (left < m_blocks.size() && m_blocks[left] < other.m_blocks[right])) {
+            blocks.push_back(m_blocks[left]);
+            words.push_back(m_words[left++]);
+        }
+        else if(left == m_blocks.size() || other.m_blocks[right] < m_blocks[left]) {
+            blocks.push_back(other.m_blocks[right]);
+            words.push_back(other.m_words[right++]);
+        }
+        else {
+            blocks.push_back(m_blocks[left]);
+            words.push_back(m_words[left++] | other.m_words[right++]);
+        }
+    }
+
+    m_blocks = std::move(blocks);
+    m_words  = std::move(words);
+}
+
+FilterFacetIndex::FilterFacetIndex(LibraryManager* libraryManager, FilterColumnList columns,
+                                   FilterRowBuildContext context)
+    : m_libraryManager{libraryManager}
+    , m_columns{std::move(columns)}
+    , m_context{std::move(context)}
+    , m_tracks{std::make_shared<TrackFacets>()}
+{ }
+
+bool FilterFacetIndex::isCompatible(const FilterColumnList& columns, const FilterRowBuildContext& context) const
+{
+    return m_columns == columns && m_context.font == context.font
+        && sameSymbols(m_context.ratingSymbols, context.ratingSymbols) && m_context.useVarious == context.useVarious;
+}
+
+void FilterFacetIndex::build(const TrackList& tracks)
+{
+    m_facets.clear();
+    m_tracks = std::make_shared<TrackFacets>();
+
+    indexTracks(tracks);
+}
+
+void FilterFacetIndex::update(const TrackList& tracks, const TrackIds& changedTrackIds)
+{
+    if(changedTrackIds.empty()) {
+        return;
+    }
+
+    const std::unordered_set<int> changedIds{changedTrackIds.cbegin(), changedTrackIds.cend()};
+    std::unordered_set<RowKey> removedFacets;
+    for(const int id : changedIds) {
+        removeTrack(id, removedFacets);
+    }
+
+    if(!removedFacets.empty()) {
+        // Cached values pointing at a removed facet would otherwise be reused without recreating it
+        std::erase_if(m_tracks->valueFacets, [&removedFacets](const auto& value) {
+            return std::ranges::any_of(value.second, [&removedFacets](const RowKey& key) {
+                return removedFacets.contains(key);
+            });
+        });
+    }
+
+    TrackList changedTracks;
+    for(const Track& track : tracks) {
+        if(changedIds.contains(track.id())) {
+            changedTracks.push_back(track);
+        }
+    }
+
+    indexTracks(changedTracks);
+}
+
+std::shared_ptr<FilterFacetIndex> FilterFacetIndex::updated(const TrackList& tracks,
+                                                            const TrackIds& changedTrackIds) const
+{
+    auto index = std::make_shared<FilterFacetIndex>(*this);
+    index->update(tracks, changedTrackIds);
+    return index;
+}
+
+FilterRowList FilterFacetIndex::rows(const TrackList& tracks) const
+{
+    const TrackIdSet input{tracks};
+    if(input.empty()) {
+        return {};
+    }
+
+    std::unordered_map<int, int> trackPositions;
+    trackPositions.reserve(tracks.size());
+    for(int index{0}; std::cmp_less(index, tracks.size()); ++index) {
+        trackPositions.emplace(tracks.at(index).id(), index);
+    }
+
+    FilterRowList rows;
+
+    for(const auto& [key, facet] : m_facets) {
+        const TrackIdSet members = facet->tracks.intersected(input);
+        if(members.empty()) {
+            continue;
+        }
+
+        FilterRow& row  = rows.emplace_back();
+        row.key         = key;
+        row.columns     = facet->columns;
+        row.richColumns = facet->richColumns;
+        row.trackIds    = members.ids();
+
+        std::ranges::sort(row.trackIds, [&trackPositions](int left, int right) {
+            return trackPositions.at(left) < trackPositions.at(right);
+        });
+    }
+
+    std::ranges::sort(rows, {}, &FilterRow::key);
+
+    return rows;
+}
+
+TrackIdSet FilterFacetIndex::tracksFor(const std::vector<RowKey>& keys) const
+{
+    TrackIdSet tracks;
+
+    for(const RowKey& key : keys) {
+        if(const auto facetIt = m_facets.find(key); facetIt != m_facets.cend()) {
+            tracks.unite(facetIt->second->tracks);
+        }
+    }
+
+    return tracks;
+}
+
+FilterFacetIndex::Facet& FilterFacetIndex::mutableFacet(std::shared_ptr<Facet>& facet)
+{
+    // Facets are only shared with copies made by updated(), so one held by this index alone is safe to modify
+    if(facet.use_count() > 1) {
+        facet = std::make_shared<Facet>(*facet);
+    }
+    return *facet;
+}
+
+void FilterFacetIndex::indexTracks(const TrackList& tracks)
+{
+    if(m_columns.empty() || tracks.empty()) {
+        return;
+    }
+
+    QStringList fields;
+    fields.reserve(m_columns.size());
+    std::ranges::transform(m_columns, std::back_inserter(fields),
+                           [](const FilterColumn& column) { return column.field; });
+
+    ScriptParser parser;
+    ScriptFormatter formatter;
+    formatter.setBaseFont(m_context.font);
+
+    LibraryScriptEnvironment scriptEnvironment{m_libraryManager};
+    scriptEnvironment.setRatingStarSymbols(m_context.ratingSymbols);
+    scriptEnvironment.setEvaluationPolicy(TrackListContextPolicy::Unresolved, {}, false, m_context.useVarious);
+
+    const ParsedScript script = parser.parse(fields.join("\036"_L1));
+    ScriptContext scriptContext;
+    scriptContext.environment = &scriptEnvironment;
+
+    const auto addColumns = [this, &formatter](const QStringList& columnValues, std::vector<RowKey>& keys) {
+        ColumnData columnData = buildColumnData(columnValues, formatter);
+        const RowKey key      = rowKey(columnData.plainColumns);
+
+        if(!m_facets.contains(key)) {
+            auto facet         = std::make_shared<Facet>();
+            facet->columns     = std::move(columnData.plainColumns);
+            facet->richColumns = std::move(columnData.richColumns);
+            m_facets.emplace(key, std::move(facet));
+        }
+
+        if(std::ranges::find(keys, key) == keys.cend()) {
+            keys.push_back(key);
+        }
+    };
+
+    // Ids are gathered per facet first, as inserting them one at a time in library order is slow for large facets
+    std::unordered_map<RowKey, TrackIds> facetTracks;
+
+    for(const Track& track : tracks) {
+        if(!track.isInLibrary()) {
+            continue;
+        }
+
+        const QString evaluated = parser.evaluate(script, track, scriptContext);
+
+        auto valueIt = m_tracks->valueFacets.find(evaluated);
+        if(valueIt == m_tracks->valueFacets.end()) {
+            std::vector<RowKey> keys;
+
+            if(evaluated.contains(QLatin1String{Constants::UnitSeparator})) {
+                const QStringList values = evaluated.split(QLatin1String{Constants::UnitSeparator});
+                for(const QString& value : values) {
+                    addColumns(value.split(QLatin1String{Constants::RecordSeparator}), keys);
+                }
+            }
+            else {
+                addColumns(evaluated.split(QLatin1String{Constants::RecordSeparator}), keys);
+            }
+
+            valueIt = m_tracks->valueFacets.emplace(evaluated, std::move(keys)).first;
+        }
+
+        const std::vector<RowKey>& keys = valueIt->second;
+        for(const RowKey& key : keys) {
+            facetTracks[key].push_back(track.id());
+        }
+        m_tracks->trackFacets.insert_or_assign(track.id(), keys);
+    }
+
+    for(auto& [key, ids] : facetTracks) {
+        mutableFacet(m_facets.at(key)).tracks.unite(TrackIdSet{std::move(ids)});
+    }
+}
+
+void FilterFacetIndex::removeTrack(int id, std::unordered_set<RowKey>& removedFacets)
+{
+    const auto trackIt = m_tracks->trackFacets.find(id);
+    if(trackIt == m_tracks->trackFacets.end()) {
+        return;
+    }
+
+    for(const RowKey& key : trackIt->second) {
+        const auto facetIt = m_facets.find(key);
+        if(facetIt == m_facets.end()) {
+            continue;
+        }
+
+        // Dropping the pointer leaves a facet shared with the source of updated() untouched
+        if(facetIt->second->tracks.count() == 1 && facetIt->second->tracks.contains(id)) {
+            m_facets.erase(facetIt);
+            removedFacets.emplace(key);
+        }
+        else {
+            mutableFacet(facetIt->second).tracks.remove(id);
+        }
+    }
+
+    m_tracks->trackFacets.erase(trackIt);
+}
+} // namespace Fooyin::Filters
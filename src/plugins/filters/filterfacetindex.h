@@ -0,0 +1,123 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "filterrows.h"
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Fooyin {
+class LibraryManager;
+
+namespace Filters {
+/*!
+ * A set of track ids stored as a compressed bitset.
+ * Only non-zero 64-bit words are kept, alongside their word index, so
+ * sparse sets stay small while dense sets still intersect word by word.
+ */
+class TrackIdSet
+{
+public:
+    TrackIdSet() = default;
+    explicit TrackIdSet(TrackIds ids);
+    explicit TrackIdSet(const TrackList& tracks);
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t count() const;
+    [[nodiscard]] bool contains(int id) const;
+    [[nodiscard]] TrackIds ids() const;
+
+    void insert(int id);
+    void remove(int id);
+
+    [[nodiscard]] TrackIdSet intersected(const TrackIdSet& other) const;
+    void unite(const TrackIdSet& other);
+
+private:
+    std::vector<uint32_t> m_blocks;
+    std::vector<uint64_t> m_words;
+};
+
+/*!
+ * Inverted index from filter rows (facets) to the tracks they contain, for one set of columns.
+ * Every distinct evaluated value is formatted and keyed only once. Rows for any subset of the
+ * indexed tracks are then produced by intersecting each facet with that subset, so cascading
+ * filter stages don't have to re-evaluate the columns of every track they receive.
+ */
+class FilterFacetIndex
+{
+public:
+    FilterFacetIndex(LibraryManager* libraryManager, FilterColumnList columns, FilterRowBuildContext context);
+
+    //! Returns true if this index was built for @p columns using @p context.
+    [[nodiscard]] bool isCompatible(const FilterColumnList& columns, const FilterRowBuildContext& context) const;
+
+    //! Replaces the contents of the index with @p tracks.
+    void build(const TrackList& tracks);
+    /*!
+     * Re-indexes the tracks in @p changedTrackIds.
+     * Changed tracks which aren't present in @p tracks are removed from the index.
+     */
+    void update(const TrackList& tracks, const TrackIds& changedTrackIds);
+    /*!
+     * Returns a copy of this index with the tracks in @p changedTrackIds re-indexed, as for update().
+     * Only the facets those tracks touch are copied; the rest are shared with this index, which can
+     * still be read from other threads but must not be updated afterwards.
+     */
+    [[nodiscard]] std::shared_ptr<FilterFacetIndex> updated(const TrackList& tracks,
+                                                            const TrackIds& changedTrackIds) const;
+
+    //! Returns the rows for @p tracks, with the track ids of each row in the order of @p tracks.
+    [[nodiscard]] FilterRowList rows(const TrackList& tracks) const;
+    //! Returns the ids of all indexed tracks belonging to any of the rows in @p keys.
+    [[nodiscard]] TrackIdSet tracksFor(const std::vector<RowKey>& keys) const;
+
+private:
+    struct Facet
+    {
+        QStringList columns;
+        std::vector<RichText> richColumns;
+        TrackIdSet tracks;
+    };
+
+    struct TrackFacets
+    {
+        std::unordered_map<int, std::vector<RowKey>> trackFacets;
+        std::unordered_map<QString, std::vector<RowKey>> valueFacets;
+    };
+
+    Facet& mutableFacet(std::shared_ptr<Facet>& facet);
+    void indexTracks(const TrackList& tracks);
+    //! Removes @p id from its facets, erasing any left empty and adding their keys to @p removedFacets.
+    void removeTrack(int id, std::unordered_set<RowKey>& removedFacets);
+
+    LibraryManager* m_libraryManager;
+    FilterColumnList m_columns;
+    FilterRowBuildContext m_context;
+
+    // Facets are shared between copies made by updated(), and only copied when modified
+    std::unordered_map<RowKey, std::shared_ptr<Facet>> m_facets;
+    // Only read when updating, so handed on to the copy made by updated() rather than duplicated
+    std::shared_ptr<TrackFacets> m_tracks;
+};
+} // namespace Filters
+} // namespace Fooyin
@@ -591,6 +591,24 @@ QModelIndexList FilterModel::indexesForKeys(const std::vector<Md5Hash>& keys) co
     return indexes;
 }
 
+void FilterModel::prefetchCovers(const QModelIndexList& indexes) const
+{
+    if(!p->m_showDecoration) {
+        return;
+    }
+
+    TrackList tracks;
+    tracks.reserve(indexes.size());
+
+    for(const QModelIndex& index : indexes) {
+        if(const int trackId = itemForIndex(index)->firstTrackId(); trackId >= 0) {
+            tracks.push_back(p->trackForId(trackId));
+        }
+    }
+
+    p->m_coverProvider->prefetchThumbnails(tracks, p->m_decorationSize, p->m_coverType);
+}
+
 bool FilterModel::removeColumn(int column)
 {
     if(column < 0 || std::cmp_greater_equal(column, p->m_columns.size())) {
@@ -90,6 +90,13 @@ public:
     void resetColumnAlignments();
 
     [[nodiscard]] QModelIndexList indexesForKeys(const std::vector<Md5Hash>& keys) const;
+    /*!
+     * Reads the stored covers of @p indexes in one batch and queues the rest to be decoded
+     * one by one, in the order given. @p indexes should be ordered by distance from the
+     * viewport; covers queued earlier which are no longer in @p indexes are cancelled if
+     * they haven't started.
+     */
+    void prefetchCovers(const QModelIndexList& indexes) const;
 
     bool removeColumn(int column);
 
@@ -19,11 +19,28 @@
 
 #include "filterpipeline.h"
 
+#include "filterfacetindex.h"
+
 #include <ranges>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace Fooyin::Filters {
+namespace {
+// Intersects the input with the selected ids, keeping the order of the input
+TrackList tracksInSet(const TrackList& tracks, const TrackIdSet& ids)
+{
+    TrackList result;
+    if(ids.empty()) {
+        return result;
+    }
+
+    result.reserve(ids.count());
+    std::ranges::copy_if(tracks, std::back_inserter(result),
+                         [&ids](const Track& track) { return ids.contains(track.id()); });
+    return result;
+}
+} // namespace
+
 FilterSelectionResolution resolveFilterSelection(const FilterRowList& rows, const TrackList& inputTracks,
                                                  const std::vector<RowKey>& selectedKeys)
 {
@@ -42,62 +59,40 @@ FilterSelectionResolution resolveFilterSelection(const FilterRowList& rows, cons
                 return resolution;
             }
 
-            std::unordered_set<int> selectedTrackIds;
-            selectedTrackIds.reserve(inputTracks.size());
-
+            TrackIds selectedTrackIds;
             for(const FilterRow& row : rows) {
-                for(const int trackId : row.trackIds) {
-                    selectedTrackIds.emplace(trackId);
-                }
-            }
-
-            resolution.selectedTracks.reserve(selectedTrackIds.size());
-            for(const Track& track : inputTracks) {
-                if(selectedTrackIds.contains(track.id())) {
-                    resolution.selectedTracks.push_back(track);
-                }
+                std::ranges::copy(row.trackIds, std::back_inserter(selectedTrackIds));
             }
 
+            resolution.selectedTracks = tracksInSet(inputTracks, TrackIdSet{std::move(selectedTrackIds)});
             return resolution;
         }
     }
 
-    std::unordered_map<int, Track> tracksById;
-    tracksById.reserve(inputTracks.size());
-    for(const Track& track : inputTracks) {
-        tracksById.emplace(track.id(), track);
-    }
-
-    std::unordered_set<RowKey> validKeys;
-    validKeys.reserve(rows.size());
+    std::unordered_map<RowKey, const FilterRow*> rowsByKey;
+    rowsByKey.reserve(rows.size());
     for(const FilterRow& row : rows) {
-        validKeys.emplace(row.key);
+        rowsByKey.emplace(row.key, &row);
     }
 
     std::vector<RowKey> prunedKeys;
     prunedKeys.reserve(resolution.selectedKeys.size());
 
+    TrackIds selectedTrackIds;
+
     for(const RowKey& key : resolution.selectedKeys) {
-        if(!validKeys.contains(key)) {
+        const auto rowIt = rowsByKey.find(key);
+        if(rowIt == rowsByKey.cend()) {
             continue;
         }
 
         prunedKeys.push_back(key);
-
-        auto rowIt = std::ranges::find_if(rows, [&key](const FilterRow& row) { return row.key == key; });
-        if(rowIt == rows.cend()) {
-            continue;
-        }
-
-        for(const int trackId : rowIt->trackIds) {
-            if(tracksById.contains(trackId)) {
-                resolution.selectedTracks.push_back(tracksById.at(trackId));
-            }
-        }
+        std::ranges::copy(rowIt->second->trackIds, std::back_inserter(selectedTrackIds));
     }
 
-    resolution.selectedKeys = std::move(prunedKeys);
-    resolution.isActive     = !resolution.selectedKeys.empty();
+    resolution.selectedKeys   = std::move(prunedKeys);
+    resolution.selectedTracks = tracksInSet(inputTracks, TrackIdSet{std::move(selectedTrackIds)});
+    resolution.isActive       = !resolution.selectedKeys.empty();
     return resolution;
 }
 
@@ -19,12 +19,9 @@
 
 #include "filterrows.h"
 
-#include <core/constants.h>
-#include <core/scripting/scriptenvironmenthelpers.h>
+#include "filterfacetindex.h"
+
 #include <core/scripting/scriptparser.h>
-#include <gui/scripting/richtextutils.h>
-#include <gui/scripting/scriptformatter.h>
-#include <utils/crypto.h>
 
 #include <map>
 #include <ranges>
@@ -32,119 +29,17 @@
 #include <unordered_set>
 #include <utility>
 
-using namespace Qt::StringLiterals;
-
 namespace Fooyin::Filters {
-namespace {
-struct ColumnData
-{
-    QStringList plainColumns;
-    std::vector<RichText> richColumns;
-};
-
-RichText placeholderRichText()
-{
-    RichText richText;
-    richText.blocks.push_back({.text = u"?"_s, .format = {}});
-    return richText;
-}
-
-ColumnData buildColumnData(const QStringList& columns, ScriptFormatter& formatter)
-{
-    ColumnData data;
-    data.plainColumns.reserve(columns.size());
-    data.richColumns.reserve(columns.size());
-
-    for(const QString& column : columns) {
-        RichText richColumn = trimRichText(formatter.evaluate(column));
-        QString plainColumn = richColumn.joinedText();
-
-        if(plainColumn.isEmpty()) {
-            RichText placeholder = trimRichText(formatter.evaluate(column + u"?"_s));
-            if(!placeholder.empty()) {
-                richColumn = std::move(placeholder);
-            }
-            else {
-                richColumn = placeholderRichText();
-            }
-            plainColumn = richColumn.joinedText();
-        }
-
-        data.plainColumns.push_back(plainColumn);
-        data.richColumns.push_back(std::move(richColumn));
-    }
-
-    return data;
-}
-} // namespace
-
 FilterRowList buildFilterRows(LibraryManager* libraryManager, const FilterColumnList& columns, const TrackList& tracks,
                               const FilterRowBuildContext& context)
 {
-    FilterRowList rows;
     if(columns.empty() || tracks.empty()) {
-        return rows;
-    }
-
-    QStringList fields;
-    fields.reserve(columns.size());
-    std::ranges::transform(columns, std::back_inserter(fields),
-                           [](const FilterColumn& column) { return column.field; });
-
-    ScriptParser parser;
-    ScriptFormatter formatter;
-    formatter.setBaseFont(context.font);
-
-    LibraryScriptEnvironment scriptEnvironment{libraryManager};
-    scriptEnvironment.setRatingStarSymbols(context.ratingSymbols);
-    scriptEnvironment.setEvaluationPolicy(TrackListContextPolicy::Unresolved, {}, false, context.useVarious);
-
-    const ParsedScript script = parser.parse(fields.join("\036"_L1));
-    ScriptContext scriptContext;
-    scriptContext.environment = &scriptEnvironment;
-
-    std::map<RowKey, FilterRow> items;
-
-    for(const Track& track : tracks) {
-        if(!track.isInLibrary()) {
-            continue;
-        }
-
-        const QString evaluated = parser.evaluate(script, track, scriptContext);
-
-        auto addColumns = [&items, &formatter, &track](const QStringList& columnValues) {
-            const ColumnData columnData = buildColumnData(columnValues, formatter);
-            const RowKey key            = Utils::generateMd5Hash(columnData.plainColumns.join(QString{}));
-
-            auto [it, inserted] = items.try_emplace(key);
-            FilterRow& row      = it->second;
-
-            if(inserted) {
-                row.key         = key;
-                row.columns     = columnData.plainColumns;
-                row.richColumns = columnData.richColumns;
-            }
-
-            row.trackIds.push_back(track.id());
-        };
-
-        if(evaluated.contains(QLatin1String{Constants::UnitSeparator})) {
-            const QStringList values = evaluated.split(QLatin1String{Constants::UnitSeparator});
-            for(const QString& value : values) {
-                addColumns(value.split(QLatin1String{Constants::RecordSeparator}));
-            }
-        }
-        else {
-            addColumns(evaluated.split(QLatin1String{Constants::RecordSeparator}));
-        }
-    }
-
-    rows.reserve(items.size());
-    for(auto& row : items | std::views::values) {
-        rows.push_back(std::move(row));
+        return {};
     }
 
-    return rows;
+    FilterFacetIndex index{libraryManager, columns, context};
+    index.build(tracks);
+    return index.rows(tracks);
 }
 
 FilterRowList patchFilterRows(LibraryManager* libraryManager, const FilterColumnList& columns,
@@ -24,7 +24,6 @@
 #include <core/ratingsymbols.h>
 #include <core/track.h>
 #include <gui/scripting/richtext.h>
-#include <utils/crypto.h>
 
 #include <QFont>
 
@@ -32,7 +31,8 @@ namespace Fooyin {
 class LibraryManager;
 
 namespace Filters {
-using RowKey = Md5Hash;
+//! Identifies a row by a 64-bit hash of its column text. An empty key refers to the summary row.
+using RowKey = QByteArray;
 
 struct FilterRow
 {
@@ -43,6 +43,7 @@
 #include <QHeaderView>
 #include <QJsonObject>
 #include <QMenu>
+#include <QScrollBar>
 #include <QSignalBlocker>
 
 #include <algorithm>
@@ -106,6 +107,7 @@ FilterWidget::FilterWidget(ActionManager* actionManager, FilterColumnRegistry* c
           this, Context{IdList{Constants::Context::TrackSelection, Id{"Fooyin.Context.FilterWidget."}.append(id())}},
           this)}
     , m_applyingViewState{false}
+    , m_prefetchQueued{false}
     , m_showHeader{true}
     , m_showScrollbar{true}
     , m_alternatingColours{false}
@@ -744,17 +746,68 @@ void FilterWidget::setupConnections()
                      &FilterWidget::handleSelectionChanged);
     QObject::connect(m_view, &ExpandedTreeView::viewModeChanged, this, [this](ExpandedTreeView::ViewMode mode) {
         m_model->setShowDecoration(mode == ExpandedTreeView::ViewMode::Icon);
+        schedulePrefetch();
     });
     QObject::connect(m_view, &QAbstractItemView::iconSizeChanged, this, [this](const QSize& size) {
         if(size.isValid() && m_config.iconSize != size) {
             m_config.iconSize = size;
             m_model->setIconSize(size);
         }
+        schedulePrefetch();
     });
+    QObject::connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &FilterWidget::schedulePrefetch);
+    QObject::connect(m_sortProxy, &QAbstractItemModel::modelReset, this, &FilterWidget::schedulePrefetch);
+    QObject::connect(m_sortProxy, &QAbstractItemModel::layoutChanged, this, &FilterWidget::schedulePrefetch);
+    QObject::connect(m_sortProxy, &QAbstractItemModel::rowsInserted, this, &FilterWidget::schedulePrefetch);
     QObject::connect(m_view, &ExpandedTreeView::doubleClicked, this, &FilterWidget::doubleClicked);
     QObject::connect(m_view, &ExpandedTreeView::middleClicked, this, &FilterWidget::middleClicked);
 }
 
+void FilterWidget::schedulePrefetch()
+{
+    // Coalesce bursts of scrolling and model changes into a single batch
+    if(!m_prefetchQueued && m_view->viewMode() == ExpandedTreeView::ViewMode::Icon) {
+        m_prefetchQueued = true;
+        QMetaObject::invokeMethod(this, &FilterWidget::prefetchVisibleCovers, Qt::QueuedConnection);
+    }
+}
+
+void FilterWidget::prefetchVisibleCovers()
+{
+    m_prefetchQueued = false;
+
+    const int rowCount = m_sortProxy->rowCount();
+    if(rowCount == 0 || m_view->viewMode() != ExpandedTreeView::ViewMode::Icon) {
+        return;
+    }
+
+    const QRect area           = m_view->viewport()->rect();
+    const QModelIndex topIndex = m_view->indexAt(area.topLeft());
+
+    QModelIndexList indexes;
+    int visibleRows{0};
+    int row = topIndex.isValid() ? topIndex.row() : 0;
+
+    for(; row < rowCount; ++row) {
+        const QModelIndex index = m_sortProxy->index(row, 0);
+        const QRect rect        = m_view->visualRect(index);
+        if(rect.top() > area.bottom()) {
+            break;
+        }
+        if(rect.bottom() >= area.top()) {
+            indexes.append(m_sortProxy->mapToSource(index));
+            ++visibleRows;
+        }
+    }
+
+    // Read ahead by a page so covers are ready when scrolling down
+    for(int ahead{0}; row < rowCount && ahead < visibleRows; ++row, ++ahead) {
+        indexes.append(m_sortProxy->mapToSource(m_sortProxy->index(row, 0)));
+    }
+
+    m_model->prefetchCovers(indexes);
+}
+
 void FilterWidget::handleSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
 {
     if(m_applyingViewState) {
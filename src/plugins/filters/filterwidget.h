@@ -139,6 +139,8 @@ private:
     void updateViewMode(ExpandedTreeView::ViewMode mode);
     void updateCaptions(ExpandedTreeView::CaptionDisplay captions);
     void updateAppearance();
+    void schedulePrefetch();
+    void prefetchVisibleCovers();
 
     void addDisplayMenu(QMenu* menu);
     void filterHeaderMenu(const QPoint& pos);
@@ -168,6 +170,7 @@ private:
 
     QString m_searchStr;
     bool m_applyingViewState;
+    bool m_prefetchQueued;
 
     QByteArray m_headerState;
 
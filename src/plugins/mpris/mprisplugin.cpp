@@ -419,7 +419,8 @@ QString MprisPlugin::currentCoverPath() const
         return {};
     }
 
-    return Gui::coverPath() + m_currCoverKey + u".jpg"_s;
+    // Prefixed so it's never mistaken for a legacy cover thumbnail, which were named by key alone
+    return Gui::coverPath() + u"mpris-"_s + m_currCoverKey + u".jpg"_s;
 }
 
 void MprisPlugin::notify(const QString& name, const QVariant& value)
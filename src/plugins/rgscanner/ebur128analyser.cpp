@@ -0,0 +1,81 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ebur128analyser.h"
+
+#include <core/constants.h>
+#include <core/engine/audiobuffer.h>
+
+constexpr auto ReferenceLUFS = -18;
+
+namespace Fooyin::RGScanner {
+Ebur128Analyser::Ebur128Analyser(bool truePeak)
+    : m_truePeak{truePeak}
+    , m_channels{0}
+{ }
+
+SampleFormat Ebur128Analyser::sampleFormat() const
+{
+    return SampleFormat::F64;
+}
+
+bool Ebur128Analyser::start(const Track& /*track*/, const AudioFormat& format)
+{
+    m_channels = static_cast<unsigned int>(format.channelCount());
+    m_state.reset(ebur128_init(m_channels, static_cast<unsigned long>(format.sampleRate()),
+                               EBUR128_MODE_I | (m_truePeak ? EBUR128_MODE_TRUE_PEAK : EBUR128_MODE_SAMPLE_PEAK)));
+    return m_state != nullptr;
+}
+
+bool Ebur128Analyser::process(const AudioBuffer& buffer)
+{
+    return ebur128_add_frames_double(m_state.get(), reinterpret_cast<const double*>(buffer.data()),
+                                     static_cast<size_t>(buffer.frameCount()))
+        == EBUR128_SUCCESS;
+}
+
+void Ebur128Analyser::finish(Track& track)
+{
+    double trackGain{Constants::InvalidGain};
+    if(ebur128_loudness_global(m_state.get(), &trackGain) == EBUR128_SUCCESS) {
+        trackGain = ReferenceLUFS - trackGain;
+        track.setRGTrackGain(static_cast<float>(trackGain));
+    }
+
+    double trackPeak{Constants::InvalidPeak};
+    for(unsigned i{0}; i < m_channels; ++i) {
+        double channelPeak{Constants::InvalidPeak};
+        const int result = m_truePeak ? ebur128_true_peak(m_state.get(), i, &channelPeak)
+                                      : ebur128_sample_peak(m_state.get(), i, &channelPeak);
+        if(result == EBUR128_SUCCESS) {
+            trackPeak = std::max(trackPeak, channelPeak);
+        }
+    }
+
+    // Opus has no ReplayGain peak tags
+    if(!track.isOpus()) {
+        track.setRGTrackPeak(static_cast<float>(trackPeak));
+    }
+}
+
+Ebur128Analyser::StatePtr Ebur128Analyser::takeState()
+{
+    return std::move(m_state);
+}
+} // namespace Fooyin::RGScanner
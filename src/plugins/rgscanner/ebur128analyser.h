@@ -0,0 +1,65 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/trackanalysis.h>
+
+#include <ebur128.h>
+
+#include <memory>
+
+namespace Fooyin::RGScanner {
+/*!
+ * Measures integrated loudness and sample/true peak of a track with libebur128.
+ *
+ * The track's ReplayGain gain and peak are written on finish(); the loudness state is kept
+ * so album gain can be calculated across several tracks.
+ */
+class Ebur128Analyser : public TrackAnalyser
+{
+public:
+    struct StateDeleter
+    {
+        void operator()(ebur128_state* state) const
+        {
+            if(state) {
+                ebur128_destroy(&state);
+            }
+        }
+    };
+    using StatePtr = std::unique_ptr<ebur128_state, StateDeleter>;
+
+    explicit Ebur128Analyser(bool truePeak);
+
+    [[nodiscard]] SampleFormat sampleFormat() const override;
+
+    bool start(const Track& track, const AudioFormat& format) override;
+    bool process(const AudioBuffer& buffer) override;
+    void finish(Track& track) override;
+
+    //! Releases the loudness state for album calculations.
+    [[nodiscard]] StatePtr takeState();
+
+private:
+    bool m_truePeak;
+    unsigned int m_channels;
+    StatePtr m_state;
+};
+} // namespace Fooyin::RGScanner
@@ -20,7 +20,6 @@
 #include "ebur128scanner.h"
 
 #include <core/constants.h>
-#include <core/engine/audioconverter.h>
 
 #include <QFile>
 #include <QFuture>
@@ -34,7 +33,6 @@ Q_LOGGING_CATEGORY(EBUR128, "fy.ebur128")
 using namespace Qt::StringLiterals;
 
 constexpr auto ReferenceLUFS  = -18;
-constexpr auto BufferSize     = 10240;
 constexpr auto SingleAlbumKey = "Album";
 
 namespace Fooyin::RGScanner {
@@ -52,11 +50,10 @@ void clearReplayGain(TrackList& tracks)
 }
 } // namespace
 
-Ebur128Scanner::Ebur128Scanner(std::shared_ptr<AudioLoader> audioLoader, QObject* parent)
+Ebur128Scanner::Ebur128Scanner(std::shared_ptr<TrackAnalysisPipeline> pipeline, QObject* parent)
     : RGWorker{parent}
-    , m_audioLoader{std::move(audioLoader)}
+    , m_pipeline{std::move(pipeline)}
     , m_watcher{nullptr}
-    , m_decoder{nullptr}
     , m_runningWatchers{0}
 { }
 
@@ -87,9 +84,10 @@ void Ebur128Scanner::calculatePerTrack(const TrackList& tracks, bool truePeak)
 
     qCDebug(EBUR128) << "Calculating RG using ebur128 for" << tracks.size() << "tracks";
 
-    m_watcher       = new QFutureWatcher<void>(this);
-    m_tracks        = tracks;
-    m_scannedTracks = tracks;
+    m_watcher = new QFutureWatcher<void>(this);
+    m_tracks  = tracks;
+    TrackAnalysisPipeline::sortForLocality(m_tracks);
+    m_scannedTracks = m_tracks;
     clearReplayGain(m_scannedTracks);
 
     QObject::connect(m_watcher, &QFutureWatcher<void>::progressValueChanged, this, [this](const int val) {
@@ -121,9 +119,10 @@ void Ebur128Scanner::calculateAsAlbum(const TrackList& tracks, bool truePeak)
 
     qCDebug(EBUR128) << "Calculating RG using ebur128 for" << tracks.size() << "tracks";
 
-    m_watcher       = new QFutureWatcher<void>(this);
-    m_tracks        = tracks;
-    m_scannedTracks = tracks;
+    m_watcher = new QFutureWatcher<void>(this);
+    m_tracks  = tracks;
+    TrackAnalysisPipeline::sortForLocality(m_tracks);
+    m_scannedTracks = m_tracks;
     clearReplayGain(m_scannedTracks);
 
     QObject::connect(m_watcher, &QFutureWatcher<void>::progressValueChanged, this, [this](const int val) {
@@ -187,6 +186,10 @@ void Ebur128Scanner::calculateByAlbumTags(const TrackList& tracks, const QString
         m_albums[album].push_back(std::move(scannedTrack));
     }
 
+    for(auto& [_, albumTracks] : m_albums) {
+        TrackAnalysisPipeline::sortForLocality(albumTracks);
+    }
+
     m_currentAlbum = m_albums.begin();
     scanAlbum(truePeak);
 }
@@ -197,72 +200,24 @@ void Ebur128Scanner::scanTrack(Track& track, bool truePeak, const QString& album
         return;
     }
 
-    const auto loadedDecoder
-        = m_audioLoader->loadDecoderForTrack(track, AudioDecoder::NoSeeking | AudioDecoder::NoInfiniteLooping);
-    if(!loadedDecoder.decoder) {
-        qCWarning(EBUR128) << "No decoder available for" << track.filepath();
-        return;
-    }
-
-    AudioDecoder* decoder = loadedDecoder.decoder.get();
-    AudioFormat format    = loadedDecoder.format.value();
-
-    format.setSampleFormat(SampleFormat::F64);
-    decoder->start();
+    // Any analysers registered by other plugins share this decode
+    Ebur128Analyser loudness{truePeak};
+    const auto registered = m_pipeline->createRegisteredAnalysers();
 
-    EburStatePtr state{ebur128_init(format.channelCount(), format.sampleRate(),
-                                    EBUR128_MODE_I | (truePeak ? EBUR128_MODE_TRUE_PEAK : EBUR128_MODE_SAMPLE_PEAK))};
-
-    AudioBuffer buffer;
-    while((buffer = decoder->readBuffer(BufferSize)).isValid()) {
-        if(!mayRun()) {
-            return;
-        }
-
-        buffer = Audio::convert(buffer, format);
-        if(ebur128_add_frames_double(state.get(), reinterpret_cast<double*>(buffer.data()), buffer.frameCount())
-           != EBUR128_SUCCESS) {
-            break;
-        }
+    std::vector<TrackAnalyser*> analysers{&loudness};
+    for(const auto& analyser : registered) {
+        analysers.push_back(analyser.get());
     }
 
-    if(!mayRun()) {
+    if(!m_pipeline->analyse(track, analysers, [this]() { return mayRun(); })) {
         return;
     }
 
-    double trackGain{Constants::InvalidGain};
-    if(ebur128_loudness_global(state.get(), &trackGain) == EBUR128_SUCCESS) {
-        trackGain = ReferenceLUFS - trackGain;
-        track.setRGTrackGain(static_cast<float>(trackGain));
-    }
-
-    double trackPeak{Constants::InvalidPeak};
-    const auto channels = static_cast<unsigned int>(format.channelCount());
-
-    if(truePeak) {
-        for(unsigned i{0}; i < channels; ++i) {
-            double channelPeak{Constants::InvalidPeak};
-            if(ebur128_true_peak(state.get(), i, &channelPeak) == EBUR128_SUCCESS) {
-                trackPeak = std::max(trackPeak, channelPeak);
-            }
-        }
-    }
-    else {
-        for(unsigned i{0}; i < channels; ++i) {
-            double channelPeak{Constants::InvalidPeak};
-            if(ebur128_sample_peak(state.get(), i, &channelPeak) == EBUR128_SUCCESS) {
-                trackPeak = std::max(trackPeak, channelPeak);
-            }
-        }
-    }
-
-    if(storesReplayGainPeak(track)) {
-        track.setRGTrackPeak(static_cast<float>(trackPeak));
-    }
-
     if(!album.isEmpty()) {
-        const std::scoped_lock lock{m_mutex};
-        m_albumStates[album].emplace_back(std::move(state));
+        if(auto state = loudness.takeState()) {
+            const std::scoped_lock lock{m_mutex};
+            m_albumStates[album].emplace_back(std::move(state));
+        }
     }
 }
 
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "ebur128analyser.h"
 #include "rgscanner.h"
 
 #include <core/scripting/scriptparser.h>
@@ -26,15 +27,13 @@
 #include <QFile>
 #include <QFutureWatcher>
 
-#include <ebur128.h>
-
 namespace Fooyin::RGScanner {
 class Ebur128Scanner : public RGWorker
 {
     Q_OBJECT
 
 public:
-    explicit Ebur128Scanner(std::shared_ptr<AudioLoader> audioLoader, QObject* parent = nullptr);
+    explicit Ebur128Scanner(std::shared_ptr<TrackAnalysisPipeline> pipeline, QObject* parent = nullptr);
 
     void closeThread() override;
 
@@ -43,25 +42,14 @@ public:
     void calculateByAlbumTags(const TrackList& tracks, const QString& groupScript, bool truePeak) override;
 
 private:
-    struct EburStateDeleter
-    {
-        void operator()(ebur128_state* state) const
-        {
-            if(state) {
-                ebur128_destroy(&state);
-            }
-        }
-    };
-    using EburStatePtr = std::unique_ptr<ebur128_state, EburStateDeleter>;
-
     using Albums        = std::unordered_map<QString, TrackList>;
     using AlbumWatchers = std::unordered_map<QString, QFutureWatcher<void>*>;
-    using AlbumStates   = std::unordered_map<QString, std::vector<EburStatePtr>>;
+    using AlbumStates   = std::unordered_map<QString, std::vector<Ebur128Analyser::StatePtr>>;
 
     void scanTrack(Track& track, bool truePeak, const QString& album = {});
     void scanAlbum(bool truePeak);
 
-    std::shared_ptr<AudioLoader> m_audioLoader;
+    std::shared_ptr<TrackAnalysisPipeline> m_pipeline;
     ScriptParser m_parser;
 
     TrackList m_tracks;
@@ -73,8 +61,6 @@ private:
     AlbumStates m_albumStates;
 
     QFutureWatcher<void>* m_watcher;
-    AudioDecoder* m_decoder;
-    AudioFormat m_format;
 
     std::mutex m_mutex;
     std::atomic_int m_runningWatchers;
@@ -35,7 +35,7 @@ RGWorker::RGWorker(QObject* parent)
     : Worker{parent}
 { }
 
-RGScanner::RGScanner(const std::shared_ptr<AudioLoader>& audioLoader, QObject* parent)
+RGScanner::RGScanner(const std::shared_ptr<TrackAnalysisPipeline>& pipeline, QObject* parent)
     : QObject{parent}
 {
     const FySettings settings;
@@ -43,7 +43,7 @@ RGScanner::RGScanner(const std::shared_ptr<AudioLoader>& audioLoader, QObject* p
 
 #ifdef HAVE_EBUR128
     if(scanner == "libebur128"_L1) {
-        m_worker = std::make_unique<Ebur128Scanner>(audioLoader);
+        m_worker = std::make_unique<Ebur128Scanner>(pipeline);
     }
     else {
         m_worker = std::make_unique<FFmpegScanner>();
@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include <core/engine/audioloader.h>
+#include <core/engine/trackanalysis.h>
 #include <core/track.h>
 #include <utils/worker.h>
 
@@ -49,7 +49,7 @@ class RGScanner : public QObject
     Q_OBJECT
 
 public:
-    explicit RGScanner(const std::shared_ptr<AudioLoader>& audioLoader, QObject* parent = nullptr);
+    explicit RGScanner(const std::shared_ptr<TrackAnalysisPipeline>& pipeline, QObject* parent = nullptr);
     ~RGScanner() override;
 
     void close();
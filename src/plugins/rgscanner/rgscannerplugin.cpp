@@ -45,9 +45,10 @@ using namespace Qt::StringLiterals;
 namespace Fooyin::RGScanner {
 void RGScannerPlugin::initialise(const CorePluginContext& context)
 {
-    m_audioLoader = context.audioLoader;
-    m_library     = context.library;
-    m_settings    = context.settingsManager;
+    m_audioLoader      = context.audioLoader;
+    m_analysisPipeline = context.analysisPipeline;
+    m_library          = context.library;
+    m_settings         = context.settingsManager;
 }
 
 void RGScannerPlugin::initialise(const GuiPluginContext& context)
@@ -73,7 +74,7 @@ void RGScannerPlugin::calculateReplayGain(RGScanType type)
     progress->setValue(0);
     progress->setWindowTitle(tr("ReplayGain Scan Progress"));
 
-    auto* scanner = new RGScanner(m_audioLoader, this);
+    auto* scanner = new RGScanner(m_analysisPipeline, this);
     QObject::connect(scanner, &RGScanner::calculationFinished, this,
                      [this, scanner, progress, tracksToScan, type](const TrackList& tracks) {
                          const auto finishTime = progress->elapsedTime();
@@ -47,6 +47,7 @@ private:
     static QDialog* createRemoveDialog();
 
     std::shared_ptr<AudioLoader> m_audioLoader;
+    std::shared_ptr<TrackAnalysisPipeline> m_analysisPipeline;
     MusicLibrary* m_library;
     SettingsManager* m_settings;
     ActionManager* m_actionManager;
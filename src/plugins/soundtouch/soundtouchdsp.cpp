@@ -95,7 +95,7 @@ void SoundTouchDsp::prepare(const AudioFormat& format)
 
 void SoundTouchDsp::process(ProcessingBufferList& chunks)
 {
-    ProcessingBufferList output;
+    ProcessingBufferList& output = m_outputChunks;
     output.clear();
 
     if(!m_processor || !m_format.isValid()) {
@@ -114,15 +114,8 @@ void SoundTouchDsp::process(ProcessingBufferList& chunks)
         processBuffer(*buffer, output);
     }
 
-    chunks.clear();
-
-    const size_t outCount = output.count();
-    for(size_t i{0}; i < outCount; ++i) {
-        const auto* buffer = output.item(i);
-        if(buffer && buffer->isValid()) {
-            chunks.addChunk(*buffer);
-        }
-    }
+    chunks.swap(output);
+    chunks.removeInvalid();
 }
 
 void SoundTouchDsp::reset()
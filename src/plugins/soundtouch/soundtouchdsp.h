@@ -86,6 +86,7 @@ private:
 
     std::vector<float> m_inputBuffer;
     std::vector<float> m_outputBuffer;
+    ProcessingBufferList m_outputChunks;
 
     bool m_hasOutputCursor;
     uint64_t m_outputCursorNs;
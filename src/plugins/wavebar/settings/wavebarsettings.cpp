@@ -33,5 +33,9 @@ WaveBarSettings::WaveBarSettings(SettingsManager* settingsManager)
 
     qRegisterMetaType<Fooyin::WaveBar::Colours>("Fooyin::WaveBar::Colours");
     m_settings->createSetting<NumSamples>(2048, u"WaveBar/NumSamples"_s);
+    m_settings->createSetting<PregenerateThreads>(2, u"WaveBar/PregenerateThreads"_s);
+    m_settings->createSetting<PregenerateReadLimit>(32, u"WaveBar/PregenerateReadLimit"_s);
+    m_settings->createSetting<PregenerateUpcoming>(true, u"WaveBar/PregenerateUpcoming"_s);
+    m_settings->createSetting<AnalyseDuringScans>(false, u"WaveBar/AnalyseDuringScans"_s);
 }
 } // namespace Fooyin::WaveBar
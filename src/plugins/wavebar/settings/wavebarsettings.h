@@ -29,7 +29,11 @@ Q_NAMESPACE
 
 enum WaveBarSettings : uint32_t
 {
-    NumSamples = 11 | Type::Int,
+    NumSamples           = 11 | Type::Int,
+    PregenerateThreads   = 12 | Type::Int,
+    PregenerateReadLimit = 13 | Type::Int,
+    PregenerateUpcoming  = 14 | Type::Bool,
+    AnalyseDuringScans   = 15 | Type::Bool,
 };
 Q_ENUM_NS(WaveBarSettings)
 } // namespace Settings::WaveBar
@@ -148,51 +148,60 @@ bool WaveBarDatabase::storeInCache(const QString& key, const WaveformData<int16_
 {
     const auto statement = u"INSERT OR REPLACE INTO WaveCache (TrackKey, Data) VALUES (:trackKey, :data);"_s;
 
-    DbQuery query{db(), statement};
+    const QByteArray serialised = serialiseData(data);
 
-    query.bindValue(u":trackKey"_s, key);
-    query.bindValue(u":data"_s, serialiseData(data));
+    return runWrite([this, &statement, &key, &serialised]() {
+        DbQuery query{db(), statement};
+
+        query.bindValue(u":trackKey"_s, key);
+        query.bindValue(u":data"_s, serialised);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool WaveBarDatabase::removeFromCache(const QString& key) const
 {
     const auto statement = u"DELETE FROM WaveCache WHERE TrackKey = :trackKey;"_s;
 
-    DbQuery query{db(), statement};
-    query.bindValue(u":trackKey"_s, key);
+    return runWrite([this, &statement, &key]() {
+        DbQuery query{db(), statement};
+        query.bindValue(u":trackKey"_s, key);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool WaveBarDatabase::removeFromCache(const QStringList& keys) const
 {
     const QString statement = u"DELETE FROM WaveCache WHERE TrackKey IN (:keys);"_s;
 
-    DbQuery query{db(), statement};
-    query.bindValue(u":keys"_s, keys);
+    return runWrite([this, &statement, &keys]() {
+        DbQuery query{db(), statement};
+        query.bindValue(u":keys"_s, keys);
 
-    return query.exec();
+        return query.exec();
+    });
 }
 
 bool WaveBarDatabase::clearCache() const
 {
     const auto statement = u"DELETE FROM WaveCache;"_s;
 
-    DbQuery query{db(), statement};
-    DbQuery cleanQuery{db(), u"VACUUM"_s};
+    const bool cleared = runWrite([this, &statement]() {
+        DbQuery query{db(), statement};
+        return query.exec();
+    });
 
-    return query.exec() && cleanQuery.exec();
-}
+    // VACUUM can't run inside the writer's transaction
+    DbQuery cleanQuery{db(), u"VACUUM"_s};
 
-QString WaveBarDatabase::cacheKey(const Track& track)
-{
-    return cacheKey(track, track.channels());
+    return cleared && cleanQuery.exec();
 }
 
-QString WaveBarDatabase::cacheKey(const Track& track, int channels)
+QString WaveBarDatabase::cacheKey(const Track& track, int decodedChannels)
 {
+    const int channels = track.channels() > 0 ? track.channels() : decodedChannels;
     return Utils::generateHash(track.hash(), QString::number(track.duration()), QString::number(track.sampleRate()),
                                QString::number(channels));
 }
@@ -39,8 +39,13 @@ public:
     [[nodiscard]] bool removeFromCache(const QStringList& keys) const;
     [[nodiscard]] bool clearCache() const;
 
-    static QString cacheKey(const Track& track);
-    static QString cacheKey(const Track& track, int channels);
+    /*!
+     * Returns the cache key for @p track's waveform.
+     *
+     * Keys use the track's stored channel count so the cache can be checked without opening a
+     * decoder; @p decodedChannels is only used for tracks which have no stored count.
+     */
+    static QString cacheKey(const Track& track, int decodedChannels = 0);
 };
 } // namespace WaveBar
 } // namespace Fooyin
@@ -23,13 +23,20 @@
 #include "wavebarconstants.h"
 #include "wavebarwidget.h"
 #include "waveformbuilder.h"
+#include "waveformgenerator.h"
+#include "waveformpregenerator.h"
 
 #include <core/engine/enginecontroller.h>
+#include <core/engine/trackanalysis.h>
+#include <core/library/musiclibrary.h>
+#include <core/player/playbackqueue.h>
 #include <core/player/playercontroller.h>
 #include <gui/guiconstants.h>
+#include <gui/statusevent.h>
 #include <gui/trackselectioncontroller.h>
 #include <gui/widgetprovider.h>
 #include <gui/widgets/elapsedprogressdialog.h>
+#include <utils/actions/actioncontainer.h>
 #include <utils/actions/actionmanager.h>
 #include <utils/async.h>
 #include <utils/utils.h>
@@ -37,10 +44,16 @@
 #include <QMainWindow>
 #include <QMenu>
 
+#include <ranges>
+
 using namespace std::chrono_literals;
 using namespace Qt::StringLiterals;
 
 namespace {
+// Number of queued tracks to generate ahead of playback
+constexpr auto UpcomingQueueTracks = 3;
+constexpr auto WaveformAnalyserId  = "WaveBar.Waveform";
+
 Fooyin::DbConnection::DbParams dbConnectionParams()
 {
     Fooyin::DbConnection::DbParams params;
@@ -54,10 +67,18 @@ Fooyin::DbConnection::DbParams dbConnectionParams()
 
 namespace Fooyin::WaveBar {
 WaveBarPlugin::WaveBarPlugin()
-    : m_dbPool{DbConnectionPool::create(dbConnectionParams(), u"wavebar"_s)}
+    : m_library{nullptr}
+    , m_dbPool{DbConnectionPool::create(dbConnectionParams(), u"wavebar"_s)}
+    , m_pregenerator{nullptr}
+    , m_libraryPass{false}
 { }
 
-WaveBarPlugin::~WaveBarPlugin() = default;
+WaveBarPlugin::~WaveBarPlugin()
+{
+    if(m_analysisPipeline) {
+        m_analysisPipeline->unregisterAnalyser(QString::fromLatin1(WaveformAnalyserId));
+    }
+}
 
 void WaveBarPlugin::initialise(const CorePluginContext& context)
 {
@@ -65,6 +86,21 @@ void WaveBarPlugin::initialise(const CorePluginContext& context)
     m_engine           = context.engine;
     m_audioLoader      = context.audioLoader;
     m_settings         = context.settingsManager;
+    m_library          = context.library;
+
+    m_analysisPipeline = context.analysisPipeline;
+
+    m_pregenerator = new WaveformPregenerator(m_audioLoader, m_dbPool, m_settings, this);
+
+    if(m_analysisPipeline) {
+        m_analysisPipeline->registerAnalyser(
+            QString::fromLatin1(WaveformAnalyserId), [dbPool = m_dbPool, settings = m_settings]() -> TrackAnalyserPtr {
+                if(!settings->value<Settings::WaveBar::AnalyseDuringScans>()) {
+                    return {};
+                }
+                return std::make_unique<WaveformAnalyser>(dbPool, settings->value<Settings::WaveBar::NumSamples>());
+            });
+    }
 
     QObject::connect(m_playerController, &PlayerController::currentTrackChanged, this,
                      [this](const Track& track) { m_playingTrack = track; });
@@ -73,6 +109,14 @@ void WaveBarPlugin::initialise(const CorePluginContext& context)
             removeTrack(m_playingTrack);
         }
     });
+
+    QObject::connect(m_engine, &EngineController::bufferUnderrunChanged, m_pregenerator,
+                     &WaveformPregenerator::setPaused);
+    QObject::connect(m_playerController, &PlayerController::upcomingTrackChanged, this,
+                     &WaveBarPlugin::prioritiseUpcoming);
+    QObject::connect(m_playerController, &PlayerController::tracksQueued, this, &WaveBarPlugin::prioritiseUpcoming);
+    QObject::connect(m_playerController, &PlayerController::trackQueueChanged, this,
+                     &WaveBarPlugin::prioritiseUpcoming);
 }
 
 void WaveBarPlugin::initialise(const GuiPluginContext& context)
@@ -113,6 +157,31 @@ void WaveBarPlugin::initialise(const GuiPluginContext& context)
     m_trackSelection->registerTrackContextAction(
         this, TrackContextMenuArea::Track, ::Fooyin::Constants::Menus::Context::Utilities, "WaveBar.RemoveData",
         removeData->text(), [removeData](QMenu* menu, const TrackSelection&) { menu->addAction(removeData); });
+
+    auto* libraryMenu = m_actionManager->actionContainer(::Fooyin::Constants::Menus::Library);
+
+    auto* generateLibrary = new QAction(tr("Generate waveform data"), window);
+    generateLibrary->setStatusTip(tr("Generate missing waveform data for all tracks in the library in the background"));
+    QObject::connect(generateLibrary, &QAction::triggered, this, &WaveBarPlugin::generateLibrary);
+    libraryMenu->addAction(generateLibrary);
+
+    auto* cancelGeneration = new QAction(tr("Stop generating waveform data"), window);
+    cancelGeneration->setStatusTip(tr("Stop generating waveform data in the background"));
+    cancelGeneration->setEnabled(false);
+    QObject::connect(cancelGeneration, &QAction::triggered, m_pregenerator, &WaveformPregenerator::cancel);
+    libraryMenu->addAction(cancelGeneration);
+
+    QObject::connect(m_pregenerator, &WaveformPregenerator::progressChanged, this,
+                     [this, cancelGeneration](int completed, int total) {
+                         cancelGeneration->setEnabled(m_libraryPass);
+                         updatePregenerationStatus(completed, total);
+                     });
+    QObject::connect(m_pregenerator, &WaveformPregenerator::finished, this, [this, cancelGeneration]() {
+        cancelGeneration->setEnabled(false);
+        if(std::exchange(m_libraryPass, false)) {
+            StatusEvent::post(tr("Finished generating waveform data"), 5000);
+        }
+    });
 }
 
 FyWidget* WaveBarPlugin::createWavebar()
@@ -257,6 +326,44 @@ void WaveBarPlugin::clearCache()
 
     refreshWaveBars(m_playerController->currentTrack(), true);
 }
+
+void WaveBarPlugin::generateLibrary()
+{
+    if(!m_library) {
+        return;
+    }
+
+    m_libraryPass = true;
+    m_pregenerator->enqueue(m_library->tracks());
+}
+
+void WaveBarPlugin::prioritiseUpcoming()
+{
+    if(!m_settings->value<Settings::WaveBar::PregenerateUpcoming>()) {
+        return;
+    }
+
+    TrackList tracks;
+
+    if(const Track upcoming = m_playerController->upcomingTrack(); upcoming.isValid()) {
+        tracks.push_back(upcoming);
+    }
+    for(const auto& queueTrack : m_playerController->playbackQueue().tracks() | std::views::take(UpcomingQueueTracks)) {
+        tracks.push_back(queueTrack.track);
+    }
+
+    m_pregenerator->prioritise(tracks);
+}
+
+void WaveBarPlugin::updatePregenerationStatus(int completed, int total)
+{
+    // Upcoming tracks are generated silently
+    if(!m_libraryPass || total <= 0) {
+        return;
+    }
+
+    StatusEvent::post(tr("Generating waveform data: %1 of %2").arg(completed).arg(total));
+}
 } // namespace Fooyin::WaveBar
 
 #include "moc_wavebarplugin.cpp"
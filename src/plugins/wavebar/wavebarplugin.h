@@ -31,10 +31,12 @@
 
 namespace Fooyin {
 class FyWidget;
+class MusicLibrary;
 
 namespace WaveBar {
 class WaveBarSettings;
 class WaveformBuilder;
+class WaveformPregenerator;
 class WaveBarWidget;
 
 class WaveBarPlugin : public QObject,
@@ -65,19 +67,27 @@ private:
     void removeSelection();
     void clearCache();
 
+    void generateLibrary();
+    void prioritiseUpcoming();
+    void updatePregenerationStatus(int completed, int total);
+
     ActionManager* m_actionManager;
     PlayerController* m_playerController;
     EngineController* m_engine;
     std::shared_ptr<AudioLoader> m_audioLoader;
+    std::shared_ptr<TrackAnalysisPipeline> m_analysisPipeline;
     TrackSelectionController* m_trackSelection;
     WidgetProvider* m_widgetProvider;
     SettingsManager* m_settings;
+    MusicLibrary* m_library;
 
     Track m_playingTrack;
     DbConnectionPoolPtr m_dbPool;
     std::vector<QPointer<WaveBarWidget>> m_waveBars;
 
     std::unique_ptr<WaveBarSettings> m_waveBarSettings;
+    WaveformPregenerator* m_pregenerator;
+    bool m_libraryPass;
 };
 } // namespace WaveBar
 } // namespace Fooyin
@@ -30,6 +30,7 @@
 #include <cfenv>
 #include <cstring>
 #include <limits>
+#include <optional>
 #include <utility>
 
 Q_LOGGING_CATEGORY(WAVEBAR, "fy.wavebar")
@@ -107,6 +108,7 @@ WaveformGenerator::WaveformGenerator(std::shared_ptr<AudioLoader> audioLoader, D
     : Worker{parent}
     , m_audioLoader{std::move(audioLoader)}
     , m_dbPool{std::move(dbPool)}
+    , m_decodedFraction{0.0}
 {
     m_requiredFormat.setSampleFormat(SampleFormat::F32);
 }
@@ -122,6 +124,8 @@ void WaveformGenerator::initialiseThread()
 
 void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool render, bool update)
 {
+    m_decodedFraction = 0.0;
+
     if(closing()) {
         return;
     }
@@ -198,6 +202,9 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
 
     while(true) {
         if(!mayRun()) {
+            if(endBytes > 0) {
+                m_decodedFraction = std::min(1.0, static_cast<double>(processedBytes) / static_cast<double>(endBytes));
+            }
             m_loadedDecoder.decoder->stop();
             return;
         }
@@ -243,6 +250,7 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
         }
     }
 
+    m_decodedFraction = 1.0;
     m_loadedDecoder.decoder->stop();
 
     if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
@@ -256,6 +264,17 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
     Q_EMIT waveformGenerated(track, m_data);
 }
 
+double WaveformGenerator::decodedFraction() const
+{
+    return m_decodedFraction;
+}
+
+bool WaveformGenerator::hasCachedWaveform(const Track& track) const
+{
+    // Without a stored channel count the key depends on the decoder, so leave the check to generate()
+    return track.isValid() && track.channels() > 0 && m_waveDb.existsInCache(WaveBarDatabase::cacheKey(track));
+}
+
 QString WaveformGenerator::setup(const Track& track, int samplesPerChannel)
 {
     if(m_loadedDecoder.decoder) {
@@ -340,4 +359,115 @@ void WaveformGenerator::processBuffer(const AudioBuffer& buffer)
         cRms.emplace_back(std::sqrt(channelRms[static_cast<size_t>(ch)] * normalise));
     }
 }
+
+WaveformAnalyser::WaveformAnalyser(DbConnectionPoolPtr dbPool, int samplesPerChannel)
+    : m_dbPool{std::move(dbPool)}
+    , m_samplesPerChannel{std::max(1, samplesPerChannel)}
+    , m_framesPerBin{1}
+    , m_binFrameCount{0}
+{ }
+
+WaveformAnalyser::~WaveformAnalyser() = default;
+
+SampleFormat WaveformAnalyser::sampleFormat() const
+{
+    return SampleFormat::F32;
+}
+
+bool WaveformAnalyser::start(const Track& track, const AudioFormat& format)
+{
+    if(!track.isValid() || format.channelCount() <= 0) {
+        return false;
+    }
+
+    m_waveDb.initialise(DbConnectionProvider{m_dbPool});
+
+    // Analysers run on pool threads which go on to analyse other tracks, so keep each thread's connection open
+    thread_local std::optional<DbConnectionHandler> dbHandler;
+    if(!m_dbPool->hasThreadConnection()) {
+        dbHandler.emplace(m_dbPool);
+        m_waveDb.initialiseDatabase();
+    }
+
+    m_trackKey = WaveBarDatabase::cacheKey(track, format.channelCount());
+    if(m_waveDb.existsInCache(m_trackKey)) {
+        return false;
+    }
+
+    AudioFormat dataFormat{format};
+    dataFormat.setSampleFormat(SampleFormat::F32);
+
+    m_data                   = {};
+    m_data.format            = dataFormat;
+    m_data.duration          = track.duration();
+    m_data.channels          = format.channelCount();
+    m_data.samplesPerChannel = m_samplesPerChannel;
+    m_data.channelData.resize(m_data.channels);
+
+    const auto totalFrames = static_cast<uint64_t>(std::max(0, format.framesForDuration(track.duration())));
+    m_framesPerBin         = std::max<uint64_t>(1, totalFrames / static_cast<uint64_t>(m_samplesPerChannel));
+    m_binFrameCount        = 0;
+    m_bin.assign(static_cast<size_t>(m_data.channels), {});
+
+    return true;
+}
+
+bool WaveformAnalyser::process(const AudioBuffer& buffer)
+{
+    const int channels = m_data.channels;
+    if(buffer.format().channelCount() != channels) {
+        qCWarning(WAVEBAR) << "Unexpected channel count while analysing waveform:" << buffer.format().prettyFormat();
+        return false;
+    }
+
+    const auto* samples  = reinterpret_cast<const float*>(buffer.data());
+    const int frameCount = buffer.frameCount();
+
+    for(int frame{0}; frame < frameCount; ++frame) {
+        const int frameOffset = frame * channels;
+        for(int ch{0}; ch < channels; ++ch) {
+            const float sample = samples[frameOffset + ch];
+            auto& bin          = m_bin[static_cast<size_t>(ch)];
+            bin.max            = std::max(bin.max, sample);
+            bin.min            = std::min(bin.min, sample);
+            bin.rms += sample * sample;
+        }
+
+        if(++m_binFrameCount == m_framesPerBin) {
+            flushBin();
+        }
+    }
+
+    return true;
+}
+
+void WaveformAnalyser::finish(Track& track)
+{
+    flushBin();
+    m_data.complete = true;
+
+    if(!m_waveDb.storeInCache(m_trackKey, convertCache<int16_t>(m_data))) {
+        qCWarning(WAVEBAR) << "Unable to store waveform for track:" << track.filepath();
+    }
+}
+
+void WaveformAnalyser::flushBin()
+{
+    if(m_binFrameCount == 0) {
+        return;
+    }
+
+    // Matches WaveformGenerator::processBuffer, which summarises one read per sample
+    const float normalise = 1.0F / static_cast<float>(m_binFrameCount);
+    for(int ch{0}; ch < m_data.channels; ++ch) {
+        auto& bin                = m_bin[static_cast<size_t>(ch)];
+        auto& [cMax, cMin, cRms] = m_data.channelData.at(ch);
+        cMax.emplace_back(bin.max);
+        cMin.emplace_back(bin.min);
+        cRms.emplace_back(std::sqrt(bin.rms * normalise));
+        bin = {};
+    }
+
+    m_binFrameCount = 0;
+}
 } // namespace Fooyin::WaveBar
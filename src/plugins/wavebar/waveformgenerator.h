@@ -23,6 +23,7 @@
 
 #include <core/engine/audioinput.h>
 #include <core/engine/audioloader.h>
+#include <core/engine/trackanalysis.h>
 #include <core/track.h>
 #include <utils/database/dbconnectionhandler.h>
 #include <utils/database/dbconnectionpool.h>
@@ -52,6 +53,12 @@ public Q_SLOTS:
     void initialiseThread() override;
     void generate(const Fooyin::Track& track, int samplesPerChannel, bool render, bool update = false);
 
+public:
+    //! Cheap cache lookup which doesn't open a decoder; must be called on the worker thread.
+    [[nodiscard]] bool hasCachedWaveform(const Track& track) const;
+    //! Portion (0-1) of the track passed to the last generate() call which was decoded; 0 if it was cached.
+    [[nodiscard]] double decodedFraction() const;
+
 private:
     QString setup(const Track& track, int samplesPerChannel);
     void processBuffer(const AudioBuffer& buffer);
@@ -67,6 +74,40 @@ private:
     AudioFormat m_requiredFormat;
     int m_samplesPerChannel;
     WaveformData<float> m_data;
+    double m_decodedFraction;
+};
+
+/*!
+ * Builds and caches a track's waveform from a shared analysis pass.
+ *
+ * Registered with the core analysis pipeline so scans such as ReplayGain fill the waveform
+ * cache without decoding files a second time. Tracks which are already cached are skipped.
+ * Only attached to scans while WaveBar/AnalyseDuringScans is enabled.
+ */
+class WaveformAnalyser : public TrackAnalyser
+{
+public:
+    WaveformAnalyser(DbConnectionPoolPtr dbPool, int samplesPerChannel);
+    ~WaveformAnalyser() override;
+
+    [[nodiscard]] SampleFormat sampleFormat() const override;
+
+    bool start(const Track& track, const AudioFormat& format) override;
+    bool process(const AudioBuffer& buffer) override;
+    void finish(Track& track) override;
+
+private:
+    void flushBin();
+
+    DbConnectionPoolPtr m_dbPool;
+    WaveBarDatabase m_waveDb;
+
+    QString m_trackKey;
+    int m_samplesPerChannel;
+    uint64_t m_framesPerBin;
+    uint64_t m_binFrameCount;
+    std::vector<WaveformSample> m_bin;
+    WaveformData<float> m_data;
 };
 } // namespace WaveBar
 } // namespace Fooyin
@@ -0,0 +1,354 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformpregenerator.h"
+
+#include "settings/wavebarsettings.h"
+#include "waveformgenerator.h"
+
+#include <core/engine/audioloader.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QThread>
+
+#include <algorithm>
+#include <ranges>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto MaxWorkers = 8;
+// Give playback time to refill its buffers before decoding again after an underrun
+constexpr auto ResumeDelay = 3s;
+constexpr double BytesPerMiB = 1024.0 * 1024.0;
+} // namespace
+
+namespace Fooyin::WaveBar {
+struct WaveformPregenerator::WorkerSlot
+{
+    WorkerSlot(std::shared_ptr<AudioLoader> audioLoader, DbConnectionPoolPtr dbPool)
+        : generator{std::move(audioLoader), std::move(dbPool)}
+    { }
+
+    QThread thread;
+    WaveformGenerator generator;
+    bool busy{false};
+};
+
+WaveformPregenerator::WaveformPregenerator(std::shared_ptr<AudioLoader> audioLoader, DbConnectionPoolPtr dbPool,
+                                           SettingsManager* settings, QObject* parent)
+    : QObject{parent}
+    , m_audioLoader{std::move(audioLoader)}
+    , m_dbPool{std::move(dbPool)}
+    , m_settings{settings}
+    , m_paused{false}
+    , m_completed{0}
+    , m_total{0}
+{
+    m_dispatchTimer.setSingleShot(true);
+    QObject::connect(&m_dispatchTimer, &QTimer::timeout, this, &WaveformPregenerator::dispatch);
+}
+
+WaveformPregenerator::~WaveformPregenerator()
+{
+    m_dispatchTimer.stop();
+    releaseWorkers();
+}
+
+void WaveformPregenerator::enqueue(const TrackList& tracks)
+{
+    int added{0};
+
+    for(const Track& track : tracks) {
+        if(track.isValid() && m_pendingKeys.emplace(track.uniqueFilepath()).second) {
+            m_pending.push_back(track);
+            ++added;
+        }
+    }
+
+    if(added > 0) {
+        m_total += added;
+        Q_EMIT progressChanged(m_completed, m_total);
+        scheduleDispatch();
+    }
+}
+
+void WaveformPregenerator::prioritise(const TrackList& tracks)
+{
+    bool changed{false};
+
+    for(const Track& track : tracks | std::views::reverse) {
+        if(!track.isValid()) {
+            continue;
+        }
+
+        const QString key = track.uniqueFilepath();
+        if(!m_pendingKeys.emplace(key).second) {
+            // Already pending; move it to the front
+            const auto it = std::ranges::find_if(
+                m_pending, [&key](const Track& pending) { return pending.uniqueFilepath() == key; });
+            if(it != m_pending.end()) {
+                m_pending.erase(it);
+            }
+        }
+        else {
+            ++m_total;
+        }
+
+        m_pending.push_front(track);
+        changed = true;
+    }
+
+    if(changed) {
+        Q_EMIT progressChanged(m_completed, m_total);
+        scheduleDispatch();
+    }
+}
+
+void WaveformPregenerator::cancel()
+{
+    m_dispatchTimer.stop();
+    m_pending.clear();
+    m_pendingKeys.clear();
+
+    int inFlight{0};
+    for(const auto& worker : m_workers) {
+        if(worker->busy) {
+            worker->generator.stopThread();
+            ++inFlight;
+        }
+    }
+
+    m_total = m_completed + inFlight;
+    Q_EMIT progressChanged(m_completed, m_total);
+
+    checkFinished();
+}
+
+void WaveformPregenerator::setPaused(bool paused)
+{
+    if(std::exchange(m_paused, paused) == paused) {
+        return;
+    }
+
+    if(paused) {
+        m_dispatchTimer.stop();
+    }
+    else {
+        scheduleDispatch(ResumeDelay);
+    }
+}
+
+bool WaveformPregenerator::isPaused() const
+{
+    return m_paused;
+}
+
+bool WaveformPregenerator::isActive() const
+{
+    return !m_pending.empty() || hasBusyWorker();
+}
+
+int WaveformPregenerator::completedCount() const
+{
+    return m_completed;
+}
+
+int WaveformPregenerator::totalCount() const
+{
+    return m_total;
+}
+
+void WaveformPregenerator::ensureWorkers()
+{
+    if(!m_workers.empty()) {
+        return;
+    }
+
+    const int count = std::clamp(m_settings->value<Settings::WaveBar::PregenerateThreads>(), 1, MaxWorkers);
+
+    for(int i{0}; i < count; ++i) {
+        auto& worker = m_workers.emplace_back(std::make_unique<WorkerSlot>(m_audioLoader, m_dbPool));
+        worker->generator.moveToThread(&worker->thread);
+        worker->thread.start(QThread::LowestPriority);
+        QMetaObject::invokeMethod(&worker->generator, &Worker::initialiseThread);
+    }
+}
+
+void WaveformPregenerator::releaseWorkers()
+{
+    for(const auto& worker : m_workers) {
+        worker->generator.closeThread();
+        worker->thread.quit();
+    }
+    for(const auto& worker : m_workers) {
+        worker->thread.wait();
+    }
+
+    m_workers.clear();
+}
+
+void WaveformPregenerator::scheduleDispatch(std::chrono::milliseconds delay)
+{
+    if(m_dispatchTimer.isActive() && m_dispatchTimer.remainingTimeAsDuration() <= delay) {
+        return;
+    }
+
+    m_dispatchTimer.start(delay);
+}
+
+void WaveformPregenerator::dispatch()
+{
+    if(m_paused) {
+        return;
+    }
+
+    if(m_pending.empty()) {
+        checkFinished();
+        return;
+    }
+
+    if(const auto delay = throttleDelay(); delay > 0ms) {
+        scheduleDispatch(delay);
+        return;
+    }
+
+    ensureWorkers();
+
+    for(size_t i{0}; i < m_workers.size() && !m_pending.empty(); ++i) {
+        if(m_workers[i]->busy) {
+            continue;
+        }
+
+        // Each track charges its whole file up front, so later idle workers may have to wait
+        if(const auto delay = throttleDelay(); delay > 0ms) {
+            scheduleDispatch(delay);
+            return;
+        }
+
+        const Track track = m_pending.front();
+        m_pending.pop_front();
+        m_pendingKeys.erase(track.uniqueFilepath());
+
+        startTrack(i, track);
+    }
+}
+
+void WaveformPregenerator::startTrack(size_t slotIndex, const Track& track)
+{
+    auto& worker = m_workers.at(slotIndex);
+    worker->busy = true;
+
+    // Charge the whole file now so workers starting together stay within the limit, and refund what wasn't read
+    const auto fileSize = static_cast<int64_t>(track.fileSize());
+    chargeReadBudget(fileSize);
+
+    const int samplesPerChannel = m_settings->value<Settings::WaveBar::NumSamples>();
+    auto* generator             = &worker->generator;
+
+    QMetaObject::invokeMethod(generator, [this, generator, track, samplesPerChannel, slotIndex, fileSize]() {
+        int64_t unreadBytes{fileSize};
+
+        if(!generator->hasCachedWaveform(track)) {
+            generator->generate(track, samplesPerChannel, false);
+            // A cancelled decode only got through part of the file
+            unreadBytes -= static_cast<int64_t>(static_cast<double>(fileSize) * generator->decodedFraction());
+        }
+
+        QMetaObject::invokeMethod(
+            this, [this, slotIndex, unreadBytes]() { trackFinished(slotIndex, unreadBytes); }, Qt::QueuedConnection);
+    });
+}
+
+void WaveformPregenerator::trackFinished(size_t slotIndex, int64_t unreadBytes)
+{
+    if(slotIndex >= m_workers.size()) {
+        return;
+    }
+
+    m_workers[slotIndex]->busy = false;
+    ++m_completed;
+    chargeReadBudget(-unreadBytes);
+
+    Q_EMIT progressChanged(m_completed, m_total);
+
+    if(m_pending.empty()) {
+        checkFinished();
+    }
+    else {
+        scheduleDispatch();
+    }
+}
+
+void WaveformPregenerator::checkFinished()
+{
+    if(!m_pending.empty() || hasBusyWorker()) {
+        return;
+    }
+
+    releaseWorkers();
+
+    if(m_total > 0) {
+        m_completed = 0;
+        m_total     = 0;
+        Q_EMIT finished();
+    }
+}
+
+bool WaveformPregenerator::hasBusyWorker() const
+{
+    return std::ranges::any_of(m_workers, [](const auto& worker) { return worker->busy; });
+}
+
+std::chrono::milliseconds WaveformPregenerator::throttleDelay() const
+{
+    if(m_settings->value<Settings::WaveBar::PregenerateReadLimit>() <= 0) {
+        return 0ms;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if(now >= m_readAvailableAt) {
+        return 0ms;
+    }
+
+    return std::chrono::ceil<std::chrono::milliseconds>(m_readAvailableAt - now);
+}
+
+void WaveformPregenerator::chargeReadBudget(int64_t bytes)
+{
+    const int limitMiB = m_settings->value<Settings::WaveBar::PregenerateReadLimit>();
+    if(limitMiB <= 0 || bytes == 0) {
+        return;
+    }
+
+    // Spread reads so the average rate stays under the limit
+    const std::chrono::duration<double> cost{static_cast<double>(bytes) / (limitMiB * BytesPerMiB)};
+    const auto costDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(cost);
+
+    if(bytes < 0) {
+        // Bring the next read forward; if that lands in the past there's simply no wait
+        m_readAvailableAt += costDuration;
+        return;
+    }
+
+    m_readAvailableAt = std::max(std::chrono::steady_clock::now(), m_readAvailableAt) + costDuration;
+}
+} // namespace Fooyin::WaveBar
+
+#include "moc_waveformpregenerator.cpp"
@@ -0,0 +1,117 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/track.h>
+#include <utils/database/dbconnectionpool.h>
+
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+class QThread;
+
+namespace Fooyin {
+class AudioLoader;
+class SettingsManager;
+
+namespace WaveBar {
+class WaveformGenerator;
+
+/*!
+ * Fills the waveform cache ahead of playback using a small pool of low-priority
+ * decoder threads.
+ *
+ * Tracks are taken from a single queue; `prioritise` puts tracks (such as the next
+ * track or the playback queue) ahead of a library-wide pass. Tracks which already have
+ * cached data are skipped without decoding. Reads are throttled to the
+ * PregenerateReadLimit setting: each track reserves its file size when it starts, and
+ * whatever wasn't decoded is refunded when it finishes. `setPaused` holds back new tracks
+ * (e.g. while playback is underrunning) without cancelling the ones in flight.
+ *
+ * Worker threads are created when work arrives and released once the queue drains.
+ */
+class WaveformPregenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    WaveformPregenerator(std::shared_ptr<AudioLoader> audioLoader, DbConnectionPoolPtr dbPool,
+                         SettingsManager* settings, QObject* parent = nullptr);
+    ~WaveformPregenerator() override;
+
+    WaveformPregenerator(const WaveformPregenerator&)            = delete;
+    WaveformPregenerator& operator=(const WaveformPregenerator&) = delete;
+
+    //! Queue @p tracks after any pending work.
+    void enqueue(const TrackList& tracks);
+    //! Queue @p tracks ahead of pending work, preserving their order.
+    void prioritise(const TrackList& tracks);
+    //! Drop pending work and stop tracks in flight.
+    void cancel();
+
+    void setPaused(bool paused);
+    [[nodiscard]] bool isPaused() const;
+
+    [[nodiscard]] bool isActive() const;
+    [[nodiscard]] int completedCount() const;
+    [[nodiscard]] int totalCount() const;
+
+Q_SIGNALS:
+    void progressChanged(int completed, int total);
+    void finished();
+
+private:
+    struct WorkerSlot;
+
+    void ensureWorkers();
+    void releaseWorkers();
+    void scheduleDispatch(std::chrono::milliseconds delay = {});
+    void dispatch();
+    void startTrack(size_t slotIndex, const Track& track);
+    void trackFinished(size_t slotIndex, int64_t unreadBytes);
+    void checkFinished();
+
+    [[nodiscard]] bool hasBusyWorker() const;
+    [[nodiscard]] std::chrono::milliseconds throttleDelay() const;
+    //! Reserves read budget for @p bytes; a negative value refunds budget reserved for bytes which weren't read.
+    void chargeReadBudget(int64_t bytes);
+
+    std::shared_ptr<AudioLoader> m_audioLoader;
+    DbConnectionPoolPtr m_dbPool;
+    SettingsManager* m_settings;
+
+    std::vector<std::unique_ptr<WorkerSlot>> m_workers;
+    std::deque<Track> m_pending;
+    std::unordered_set<QString> m_pendingKeys;
+
+    QTimer m_dispatchTimer;
+    std::chrono::steady_clock::time_point m_readAvailableAt;
+    bool m_paused;
+    int m_completed;
+    int m_total;
+};
+} // namespace WaveBar
+} // namespace Fooyin
@@ -19,9 +19,12 @@
 
 #include <utils/database/dbconnection.h>
 
+#include <utils/database/dbquery.h>
+
 #include <QDebug>
 #include <QLoggingCategory>
 #include <QSqlError>
+#include <QSqlQuery>
 
 Q_LOGGING_CATEGORY(DB_CON, "fy.db")
 
@@ -78,6 +81,8 @@ bool DbConnection::open()
 
 void DbConnection::close()
 {
+    clearCachedQueries();
+
     auto db = this->db();
     if(db.isOpen()) {
         if(db.rollback()) {
@@ -96,4 +101,47 @@ QSqlDatabase DbConnection::db() const
 {
     return QSqlDatabase::database(m_name);
 }
+
+std::shared_ptr<QSqlQuery> DbConnection::cachedQuery(const QString& statement)
+{
+    if(const auto it = m_cachedQueries.find(statement); it != m_cachedQueries.end()) {
+        m_cachedQueryOrder.splice(m_cachedQueryOrder.begin(), m_cachedQueryOrder, it->second.orderIt);
+
+        auto& query = it->second.query;
+        if(query.use_count() > 1) {
+            // Still held by an outer query using the same statement
+            return {};
+        }
+
+        query->finish();
+        return query;
+    }
+
+    auto prepared = std::make_shared<QSqlQuery>(db());
+    if(!DbQuery::prepareQuery(*prepared, statement)) {
+        return {};
+    }
+
+    if(m_cachedQueries.size() >= CachedQueryLimit) {
+        // Any query still in use keeps its own reference, so it's only released once finished with
+        m_cachedQueries.erase(m_cachedQueryOrder.back());
+        m_cachedQueryOrder.pop_back();
+    }
+
+    m_cachedQueryOrder.push_front(statement);
+    m_cachedQueries.emplace(statement, CachedQuery{.query = prepared, .orderIt = m_cachedQueryOrder.begin()});
+
+    return prepared;
+}
+
+size_t DbConnection::cachedQueryCount() const
+{
+    return m_cachedQueries.size();
+}
+
+void DbConnection::clearCachedQueries()
+{
+    m_cachedQueries.clear();
+    m_cachedQueryOrder.clear();
+}
 } // namespace Fooyin
@@ -19,6 +19,8 @@
 
 #include <utils/database/dbconnectionpool.h>
 
+#include <utils/database/dbwriter.h>
+
 #include <QLoggingCategory>
 #include <QSqlQuery>
 
@@ -34,6 +36,19 @@ bool updatePragmas(Fooyin::DbConnection* connection)
         return false;
     }
 
+    // WAL lets readers continue while the writer commits. The remaining pragmas trade
+    // a little durability on power loss (never corruption) for far fewer fsyncs.
+    static const QStringList tuningPragmas = {u"PRAGMA journal_mode = WAL;"_s,   u"PRAGMA synchronous = NORMAL;"_s,
+                                              u"PRAGMA busy_timeout = 5000;"_s,  u"PRAGMA cache_size = -16384;"_s,
+                                              u"PRAGMA mmap_size = 268435456;"_s, u"PRAGMA temp_store = MEMORY;"_s};
+
+    for(const QString& pragma : tuningPragmas) {
+        QSqlQuery query{connection->db()};
+        if(!query.exec(pragma)) {
+            qCInfo(DB_POOL) << "Failed to apply" << pragma << "on" << connection->name();
+        }
+    }
+
     return true;
 }
 } // namespace
@@ -51,6 +66,11 @@ DbConnectionPool::DbConnectionPool(PrivateKey /*key*/, const DbConnection::DbPar
     , m_prototype{params, connectionName}
 { }
 
+DbConnectionPool::~DbConnectionPool()
+{
+    m_writer.reset();
+}
+
 DbConnectionPoolPtr DbConnectionPool::create(const DbConnection::DbParams& params, const QString& connectionName)
 {
     return std::make_shared<DbConnectionPool>(PrivateKey{}, params, connectionName);
@@ -61,6 +81,17 @@ bool DbConnectionPool::hasThreadConnection() const
     return m_threadConnections.hasLocalData();
 }
 
+DbWriter* DbConnectionPool::writer()
+{
+    const std::scoped_lock lock{m_writerMutex};
+
+    if(!m_writer) {
+        m_writer = std::make_unique<DbWriter>(this);
+    }
+
+    return m_writer.get();
+}
+
 bool DbConnectionPool::createThreadConnection()
 {
     if(m_threadConnections.hasLocalData()) {
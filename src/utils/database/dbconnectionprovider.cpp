@@ -34,24 +34,38 @@ DbConnectionProvider::DbConnectionProvider(DbConnectionPoolPtr pool)
 { }
 
 QSqlDatabase DbConnectionProvider::db() const
+{
+    if(const DbConnection* dbConnection = connection()) {
+        return dbConnection->db();
+    }
+
+    return {};
+}
+
+DbConnection* DbConnectionProvider::connection() const
 {
     if(!m_connectionPool) {
         qCWarning(DB_CONPROV) << "No connection pool";
-        return {};
+        return nullptr;
     }
 
-    const DbConnection* connection = m_connectionPool->threadConnection();
+    DbConnection* connection = m_connectionPool->threadConnection();
 
     if(!connection) {
         qCWarning(DB_CONPROV) << "Thread connection not found";
-        return {};
+        return nullptr;
     }
 
     if(!connection->isOpen() && !connection->db().open()) {
         qCWarning(DB_CONPROV) << "Thread connection could not be opened";
-        return {};
+        return nullptr;
     }
 
-    return connection->db();
+    return connection;
+}
+
+DbWriter* DbConnectionProvider::writer() const
+{
+    return m_connectionPool ? m_connectionPool->writer() : nullptr;
 }
 } // namespace Fooyin
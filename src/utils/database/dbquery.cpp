@@ -19,26 +19,19 @@
 
 #include <utils/database/dbquery.h>
 
+#include <utils/database/dbconnection.h>
+
 #include <QLoggingCategory>
 #include <QRegularExpression>
 #include <QSqlError>
 
+#include <utility>
+
 Q_LOGGING_CATEGORY(DB_QRY, "fy.db")
 
 using namespace Qt::StringLiterals;
 
 namespace {
-bool prepareQuery(QSqlQuery& query, const QString& statement)
-{
-    if(query.isActive()) {
-        return false;
-    }
-
-    query.setForwardOnly(true);
-
-    return query.prepare(statement);
-}
-
 QString lastExecutedQuery(const QSqlQuery& query)
 {
     QString sql            = query.executedQuery();
@@ -67,26 +60,62 @@ QString lastExecutedQuery(const QSqlQuery& query)
 
 namespace Fooyin {
 DbQuery::DbQuery()
-    : m_status{Status::None}
+    : m_query{std::make_shared<QSqlQuery>()}
+    , m_cached{false}
+    , m_status{Status::None}
 { }
 
 DbQuery::DbQuery(const QSqlDatabase& database, const QString& statement)
-    : m_query{database}
+    : m_cached{false}
+    , m_status{Status::None}
+{
+    prepare(database, statement);
+}
+
+DbQuery::DbQuery(DbConnection* connection, const QString& statement)
+    : m_cached{false}
     , m_status{Status::None}
 {
-    if(prepareQuery(m_query, statement)) {
+    if(!connection) {
+        m_query = std::make_shared<QSqlQuery>();
+        return;
+    }
+
+    if(auto query = connection->cachedQuery(statement)) {
+        m_query  = std::move(query);
+        m_cached = true;
         m_status = Status::Prepared;
+        return;
     }
-    else if(lastError().isValid() && lastError().type() != QSqlError::NoError) {
-        if(lastError().databaseText().startsWith(u"duplicate column name: "_s)) {
-            // Re-applying previous migration
-            m_status = Status::Ignored;
-        }
-        else {
-            qCWarning(DB_QRY) << "Failed to prepare" << statement << ":" << lastError();
-            m_status = Status::Error;
+
+    prepare(connection->db(), statement);
+}
+
+DbQuery::~DbQuery()
+{
+    if(m_cached && m_query) {
+        // Reset the statement so it doesn't hold locks while sitting in the cache
+        m_query->finish();
+    }
+}
+
+DbQuery::DbQuery(DbQuery&& other) noexcept
+    : m_query{std::move(other.m_query)}
+    , m_cached{std::exchange(other.m_cached, false)}
+    , m_status{other.m_status}
+{ }
+
+DbQuery& DbQuery::operator=(DbQuery&& other) noexcept
+{
+    if(this != &other) {
+        if(m_cached && m_query) {
+            m_query->finish();
         }
+        m_query  = std::move(other.m_query);
+        m_cached = std::exchange(other.m_cached, false);
+        m_status = other.m_status;
     }
+    return *this;
 }
 
 DbQuery::Status DbQuery::status() const
@@ -96,48 +125,83 @@ DbQuery::Status DbQuery::status() const
 
 QSqlError DbQuery::lastError() const
 {
-    return m_query.lastError();
+    return m_query->lastError();
 }
 
 void DbQuery::bindValue(const QString& placeholder, const QVariant& value)
 {
-    m_query.bindValue(placeholder, value);
+    m_query->bindValue(placeholder, value);
+}
+
+void DbQuery::bindValue(int pos, const QVariant& value)
+{
+    m_query->bindValue(pos, value);
 }
 
 QString DbQuery::executedQuery() const
 {
-    return m_query.executedQuery();
+    return m_query->executedQuery();
 }
 
 bool DbQuery::exec()
 {
-    if(m_query.exec()) {
+    if(m_query->exec()) {
         m_status = Status::Success;
         return true;
     }
 
-    qCWarning(DB_QRY) << "Failed to execute" << lastExecutedQuery(m_query) << ":" << lastError();
+    qCWarning(DB_QRY) << "Failed to execute" << lastExecutedQuery(*m_query) << ":" << lastError();
     m_status = Status::Error;
     return false;
 }
 
 int DbQuery::numRowsAffected() const
 {
-    return m_query.numRowsAffected();
+    return m_query->numRowsAffected();
 }
 
 QVariant DbQuery::lastInsertId() const
 {
-    return m_query.lastInsertId();
+    return m_query->lastInsertId();
 }
 
 bool DbQuery::next()
 {
-    return m_query.next();
+    return m_query->next();
 }
 
 QVariant DbQuery::value(int index) const
 {
-    return m_query.value(index);
+    return m_query->value(index);
+}
+
+bool DbQuery::prepareQuery(QSqlQuery& query, const QString& statement)
+{
+    if(query.isActive()) {
+        return false;
+    }
+
+    query.setForwardOnly(true);
+
+    return query.prepare(statement);
+}
+
+void DbQuery::prepare(const QSqlDatabase& database, const QString& statement)
+{
+    m_query = std::make_shared<QSqlQuery>(database);
+
+    if(prepareQuery(*m_query, statement)) {
+        m_status = Status::Prepared;
+    }
+    else if(lastError().isValid() && lastError().type() != QSqlError::NoError) {
+        if(lastError().databaseText().startsWith(u"duplicate column name: "_s)) {
+            // Re-applying previous migration
+            m_status = Status::Ignored;
+        }
+        else {
+            qCWarning(DB_QRY) << "Failed to prepare" << statement << ":" << lastError();
+            m_status = Status::Error;
+        }
+    }
 }
 } // namespace Fooyin
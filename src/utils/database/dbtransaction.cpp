@@ -21,22 +21,55 @@
 
 #include <QDebug>
 #include <QLoggingCategory>
+#include <QSqlQuery>
+
+#include <algorithm>
+#include <unordered_map>
 
 Q_LOGGING_CATEGORY(DB_TR, "fy.db")
 
+using namespace Qt::StringLiterals;
+
 namespace {
-bool beginTransaction(QSqlDatabase& database)
+// Open transactions per connection in the calling thread
+int& transactionDepth(const QString& connectionName)
+{
+    thread_local std::unordered_map<QString, int> depths;
+    return depths[connectionName];
+}
+
+bool execSavepointStatement(const QSqlDatabase& database, const QString& statement)
+{
+    QSqlQuery query{database};
+    if(!query.exec(statement)) {
+        qCWarning(DB_TR) << "Failed to execute" << statement << "on" << database.connectionName();
+        return false;
+    }
+    return true;
+}
+
+bool beginTransaction(QSqlDatabase& database, QString& savepoint)
 {
     if(!database.isOpen()) {
         qCWarning(DB_TR) << "Failed to begin transaction on" << database.connectionName() << ": No open connection";
         return false;
     }
 
-    if(!database.transaction()) {
+    int& depth = transactionDepth(database.connectionName());
+
+    if(depth > 0) {
+        savepoint = u"fy_savepoint_%1"_s.arg(depth);
+        if(!execSavepointStatement(database, u"SAVEPOINT %1;"_s.arg(savepoint))) {
+            savepoint.clear();
+            return false;
+        }
+    }
+    else if(!database.transaction()) {
         qCWarning(DB_TR) << "Failed to begin transaction on" << database.connectionName();
         return false;
     }
 
+    ++depth;
     return true;
 }
 } // namespace
@@ -44,7 +77,7 @@ bool beginTransaction(QSqlDatabase& database)
 namespace Fooyin {
 DbTransaction::DbTransaction(const QSqlDatabase& database)
     : m_database(database)
-    , m_isActive(beginTransaction(m_database))
+    , m_isActive(beginTransaction(m_database, m_savepoint))
 { }
 
 DbTransaction::~DbTransaction()
@@ -56,6 +89,7 @@ DbTransaction::~DbTransaction()
 
 DbTransaction::DbTransaction(DbTransaction&& other) noexcept
     : m_database(other.m_database)
+    , m_savepoint(other.m_savepoint)
     , m_isActive(other.m_isActive)
 {
     other.release();
@@ -73,12 +107,17 @@ bool DbTransaction::commit()
         return false;
     }
 
-    if(!m_database.commit()) {
+    if(!m_savepoint.isEmpty()) {
+        if(!execSavepointStatement(m_database, u"RELEASE SAVEPOINT %1;"_s.arg(m_savepoint))) {
+            return false;
+        }
+    }
+    else if(!m_database.commit()) {
         qCWarning(DB_TR) << "Failed to commit transaction on" << m_database.connectionName();
         return false;
     }
 
-    release();
+    finish();
     return true;
 }
 
@@ -90,12 +129,19 @@ bool DbTransaction::rollback()
         return false;
     }
 
-    if(!m_database.rollback()) {
+    if(!m_savepoint.isEmpty()) {
+        // Rolling back to a savepoint leaves it open, so release it as well
+        if(!execSavepointStatement(m_database, u"ROLLBACK TO SAVEPOINT %1;"_s.arg(m_savepoint))
+           || !execSavepointStatement(m_database, u"RELEASE SAVEPOINT %1;"_s.arg(m_savepoint))) {
+            return false;
+        }
+    }
+    else if(!m_database.rollback()) {
         qCWarning(DB_TR) << "Failed to rollback transaction on" << m_database.connectionName();
         return false;
     }
 
-    release();
+    finish();
     return false;
 }
 
@@ -103,4 +149,16 @@ void DbTransaction::release()
 {
     m_isActive = false;
 }
+
+void DbTransaction::finish()
+{
+    if(!m_isActive) {
+        return;
+    }
+
+    int& depth = transactionDepth(m_database.connectionName());
+    depth      = std::max(0, depth - 1);
+
+    release();
+}
 } // namespace Fooyin
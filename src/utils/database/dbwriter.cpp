@@ -0,0 +1,182 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/database/dbwriter.h>
+
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbtransaction.h>
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <iterator>
+
+Q_LOGGING_CATEGORY(DB_WRITER, "fy.db")
+
+namespace Fooyin {
+DbWriter::DbWriter(DbConnectionPool* pool, size_t maxBatchSize)
+    : m_pool{pool}
+    , m_maxBatchSize{std::max<size_t>(1, maxBatchSize)}
+    , m_thread{[this](const std::stop_token& stopToken) { run(stopToken); }}
+{ }
+
+DbWriter::~DbWriter()
+{
+    m_thread.request_stop();
+    m_queueCv.notify_all();
+
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    const Metrics stats = metrics();
+    qCDebug(DB_WRITER) << "Writer stopped:" << stats.writes << "writes in" << stats.commits << "commits,"
+                       << stats.failedWrites << "failed, max queue depth" << stats.maxQueueDepth
+                       << ", max commit latency" << stats.maxCommitLatency.count() << "us";
+}
+
+std::future<bool> DbWriter::submit(WriteFunc write, Priority priority)
+{
+    Request request{.write = std::move(write), .result = {}, .queued = std::chrono::steady_clock::now()};
+    auto result = request.result.get_future();
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        if(priority == Priority::High) {
+            m_queue.insert(m_queue.begin() + static_cast<std::ptrdiff_t>(m_priorityCount), std::move(request));
+            ++m_priorityCount;
+        }
+        else {
+            m_queue.push_back(std::move(request));
+        }
+        m_metrics.queueDepth    = m_queue.size();
+        m_metrics.maxQueueDepth = std::max(m_metrics.maxQueueDepth, m_metrics.queueDepth);
+    }
+
+    m_queueCv.notify_one();
+    return result;
+}
+
+bool DbWriter::write(const WriteFunc& write, Priority priority)
+{
+    if(std::this_thread::get_id() == m_thread.get_id()) {
+        // Already part of a batch, so just nest in its transaction
+        const DbConnection* connection = m_pool->threadConnection();
+        return connection && write(connection->db());
+    }
+
+    return submit(write, priority).get();
+}
+
+DbWriter::Metrics DbWriter::metrics() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_metrics;
+}
+
+void DbWriter::run(const std::stop_token& stopToken)
+{
+    if(!m_pool->createThreadConnection()) {
+        qCWarning(DB_WRITER) << "Failed to create writer connection";
+    }
+
+    while(true) {
+        std::vector<Request> batch;
+
+        {
+            std::unique_lock lock{m_mutex};
+            m_queueCv.wait(lock, stopToken, [this]() { return !m_queue.empty(); });
+
+            if(m_queue.empty()) {
+                // Only reached once stopped and fully drained
+                break;
+            }
+
+            // High priority writes don't wait on a full batch of normal ones
+            const size_t available = m_priorityCount > 0 ? m_priorityCount : m_queue.size();
+            const size_t count     = std::min(available, m_maxBatchSize);
+            m_priorityCount -= std::min(m_priorityCount, count);
+
+            batch.reserve(count);
+            std::move(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(count),
+                      std::back_inserter(batch));
+            m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(count));
+
+            m_metrics.queueDepth = m_queue.size();
+        }
+
+        commitBatch(batch);
+    }
+
+    if(m_pool->hasThreadConnection()) {
+        m_pool->destroyThreadConnection();
+    }
+}
+
+void DbWriter::commitBatch(std::vector<Request>& batch)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<char> results(batch.size(), 0);
+    bool committed{false};
+
+    if(const DbConnection* connection = m_pool->threadConnection()) {
+        const QSqlDatabase db = connection->db();
+
+        DbTransaction transaction{db};
+        if(transaction) {
+            for(size_t i{0}; i < batch.size(); ++i) {
+                DbTransaction savepoint{db};
+                if(savepoint && batch[i].write(db)) {
+                    results[i] = savepoint.commit();
+                }
+                else if(savepoint) {
+                    savepoint.rollback();
+                }
+            }
+            committed = transaction.commit();
+        }
+    }
+
+    const auto end     = std::chrono::steady_clock::now();
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        m_metrics.commits += committed ? 1 : 0;
+        m_metrics.writes += batch.size();
+        m_metrics.lastCommitLatency = latency;
+        m_metrics.maxCommitLatency  = std::max(m_metrics.maxCommitLatency, latency);
+        m_metrics.totalCommitLatency += latency;
+
+        for(size_t i{0}; i < batch.size(); ++i) {
+            if(!committed || !results[i]) {
+                ++m_metrics.failedWrites;
+            }
+            const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(start - batch[i].queued);
+            m_metrics.maxQueueWait = std::max(m_metrics.maxQueueWait, wait);
+        }
+    }
+
+    for(size_t i{0}; i < batch.size(); ++i) {
+        batch[i].result.set_value(committed && results[i]);
+    }
+}
+} // namespace Fooyin
@@ -24,6 +24,8 @@
 #include <QLocale>
 #include <QLoggingCategory>
 
+#include <algorithm>
+
 Q_LOGGING_CATEGORY(COLLATOR, "fy.collator")
 
 using namespace Qt::StringLiterals;
@@ -102,6 +104,11 @@ StringCollator::~StringCollator()
     p->cleanup();
 }
 
+QLocale StringCollator::locale() const
+{
+    return p->m_locale;
+}
+
 Qt::CaseSensitivity StringCollator::caseSensitivity() const
 {
     return p->m_caseSensitivity;
@@ -148,4 +155,45 @@ int StringCollator::compare(QStringView s1, QStringView s2) const
     return ucol_strcoll(p->m_collator, reinterpret_cast<const UChar*>(s1.data()), s1.size(),
                         reinterpret_cast<const UChar*>(s2.data()), s2.size());
 }
+
+QByteArray StringCollator::sortKey(QStringView str) const
+{
+    // Empty strings sort before everything else, as in compare()
+    if(str.isEmpty()) {
+        return {};
+    }
+
+    if(p->m_dirty) {
+        p->init();
+    }
+
+    if(!p->m_collator) {
+        // Fallback: big-endian UTF-16 code units, matching the simple string comparison
+        const QString folded = p->m_caseSensitivity == Qt::CaseSensitive ? str.toString() : str.toCaseFolded();
+
+        QByteArray key;
+        key.reserve(folded.size() * 2);
+        for(const QChar ch : folded) {
+            key.append(static_cast<char>(ch.unicode() >> 8));
+            key.append(static_cast<char>(ch.unicode() & 0xFF));
+        }
+        return key;
+    }
+
+    const auto* chars = reinterpret_cast<const UChar*>(str.data());
+    const auto length = static_cast<int32_t>(str.size());
+    QByteArray key(64, Qt::Uninitialized);
+
+    int32_t keyLength = ucol_getSortKey(p->m_collator, chars, length, reinterpret_cast<uint8_t*>(key.data()),
+                                        static_cast<int32_t>(key.size()));
+    if(keyLength > key.size()) {
+        key.resize(keyLength);
+        keyLength = ucol_getSortKey(p->m_collator, chars, length, reinterpret_cast<uint8_t*>(key.data()),
+                                    static_cast<int32_t>(key.size()));
+    }
+
+    // Drop the terminating null byte
+    key.resize(std::max(keyLength - 1, 0));
+    return key;
+}
 } // namespace Fooyin
@@ -30,6 +30,7 @@
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <random>
 #include <vector>
 
 constexpr auto SampleRate = 48000;
@@ -116,6 +117,47 @@ AudioBuffer makeBuffer(SampleFormat format, int channels = Channels, int frames
     return AudioBuffer{std::span<const std::byte>{raw.data(), raw.size()}, audioFormat, 0};
 }
 
+// Random samples across (and beyond) the full range, plus values at the clamp and rounding edges
+AudioBuffer makeEdgeCaseBuffer(SampleFormat format, int frames)
+{
+    const AudioFormat audioFormat{format, SampleRate, Channels};
+    std::vector<std::byte> raw(static_cast<size_t>(audioFormat.bytesForFrames(frames)));
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<double> dist{-1.5, 1.5};
+
+    constexpr std::array<double, 9> edges
+        = {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+           -std::numeric_limits<double>::infinity(), 1.0, -1.0, 32767.0 / 32768.0, 0.5 / 32768.0, -1.5 / 32768.0, 0.0};
+
+    const int bps          = audioFormat.bytesPerSample();
+    const auto sampleCount = static_cast<size_t>(frames * Channels);
+
+    for(size_t i{0}; i < sampleCount; ++i) {
+        std::byte* dst = raw.data() + (i * static_cast<size_t>(bps));
+
+        switch(format) {
+            case SampleFormat::F32: {
+                const auto value = static_cast<float>(i % 7 == 0 ? edges[(i / 7) % edges.size()] : dist(rng));
+                std::memcpy(dst, &value, sizeof(value));
+                break;
+            }
+            case SampleFormat::F64: {
+                const double value = i % 7 == 0 ? edges[(i / 7) % edges.size()] : dist(rng);
+                std::memcpy(dst, &value, sizeof(value));
+                break;
+            }
+            default: {
+                const auto value = static_cast<uint32_t>(rng());
+                std::memcpy(dst, &value, static_cast<size_t>(bps));
+                break;
+            }
+        }
+    }
+
+    return AudioBuffer{std::span<const std::byte>{raw.data(), raw.size()}, audioFormat, 0};
+}
+
 bool equalBytes(const AudioBuffer& lhs, const AudioBuffer& rhs)
 {
     if(!lhs.isValid() || !rhs.isValid()) {
@@ -213,4 +255,58 @@ TEST(AudioConverterTest, ConvertsFloatToS16WithDitherEnabled)
         EXPECT_EQ(converted.frameCount(), input.frameCount());
     }
 }
+TEST(AudioConverterTest, VectorKernelsMatchScalarConversion)
+{
+    const Audio::SimdLevel supported = Audio::supportedSimdLevel();
+    const Audio::SimdLevel original  = Audio::simdLevel();
+
+    // Odd frame count so every kernel also runs its scalar tail
+    constexpr int EdgeFrames = 1027;
+
+    for(const auto inputFormat : Formats) {
+        SCOPED_TRACE(static_cast<int>(inputFormat));
+        const AudioBuffer input = makeEdgeCaseBuffer(inputFormat, EdgeFrames);
+        ASSERT_TRUE(input.isValid());
+
+        for(const auto outputFormat : Formats) {
+            SCOPED_TRACE(static_cast<int>(outputFormat));
+            const AudioFormat outFmt{outputFormat, SampleRate, Channels};
+
+            Audio::setSimdLevel(Audio::SimdLevel::Scalar);
+            const auto expected = Audio::convert(input, outFmt);
+            ASSERT_TRUE(expected.isValid());
+
+            for(auto level{Audio::SimdLevel::SSE2}; level <= supported;
+                level = static_cast<Audio::SimdLevel>(static_cast<int>(level) + 1)) {
+                SCOPED_TRACE(static_cast<int>(level));
+                Audio::setSimdLevel(level);
+                EXPECT_TRUE(equalBytes(expected, Audio::convert(input, outFmt)));
+            }
+        }
+    }
+
+    Audio::setSimdLevel(original);
+}
+
+TEST(AudioConverterTest, DitheredConversionStaysWithinOneStep)
+{
+    const AudioFormat outFormat{SampleFormat::S16, SampleRate, Channels};
+    const AudioBuffer input = makeBuffer(SampleFormat::F64, Channels, 4096);
+    ASSERT_TRUE(input.isValid());
+
+    const auto plain    = Audio::convert(input, outFormat);
+    const auto dithered = Audio::convert(input, outFormat, true);
+    ASSERT_TRUE(plain.isValid());
+    ASSERT_TRUE(dithered.isValid());
+    ASSERT_EQ(plain.byteCount(), dithered.byteCount());
+
+    const auto sampleCount = static_cast<size_t>(plain.byteCount()) / sizeof(int16_t);
+    for(size_t i{0}; i < sampleCount; ++i) {
+        int16_t plainSample{0};
+        int16_t ditheredSample{0};
+        std::memcpy(&plainSample, plain.constData().data() + (i * sizeof(int16_t)), sizeof(int16_t));
+        std::memcpy(&ditheredSample, dithered.constData().data() + (i * sizeof(int16_t)), sizeof(int16_t));
+        EXPECT_LE(std::abs(plainSample - ditheredSample), 1) << "sample " << i;
+    }
+}
 } // namespace Fooyin::Testing
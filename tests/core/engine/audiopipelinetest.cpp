@@ -18,21 +18,47 @@
  */
 
 #include "core/engine/pipeline/audiopipeline.h"
+#include "core/engine/dsp/downmixtomonodsp.h"
 #include "core/engine/dsp/dspregistry.h"
+#include "core/engine/dsp/monotostereodsp.h"
+
+#include <utils/allocationcounter.h>
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <functional>
 #include <mutex>
+#include <new>
 #include <thread>
 #include <vector>
 
 using namespace std::chrono_literals;
 using namespace Qt::StringLiterals;
 
+// Route every allocation through the counter so the pipeline can report per-cycle allocations
+void* operator new(std::size_t size)
+{
+    Fooyin::AllocationCounter::recordAllocation();
+    if(void* ptr = std::malloc(size > 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
 constexpr auto SampleRate = 100;
 constexpr auto Channels   = 1;
 
@@ -633,6 +659,104 @@ TEST(AudioPipelineTest, MappedPositionIsMonotonicDuringSteadyDrain)
     pipeline.stop();
 }
 
+TEST(AudioPipelineTest, SteadyStateRenderDoesNotAllocate)
+{
+    constexpr size_t StreamBufferSamples = 8192;
+    constexpr size_t StreamSamples       = 6000;
+
+    AudioPipeline pipeline;
+    auto output   = std::make_unique<FakeAudioOutput>(64);
+    auto* backend = output.get();
+    backend->setFreeFrames(64);
+
+    pipeline.setOutput(std::move(output));
+    pipeline.start();
+    ASSERT_TRUE(pipeline.init(testFormat()));
+
+    auto stream = StreamFactory::createStream(testFormat(), StreamBufferSamples);
+    auto writer = stream->writer();
+
+    const std::vector<double> samples(StreamSamples, 0.25);
+    ASSERT_EQ(writer.write(samples.data(), samples.size()), samples.size());
+    stream->applyCommand(AudioStream::Command::Play);
+
+    const auto streamId = pipeline.registerStream(stream);
+    pipeline.addStream(streamId);
+    pipeline.play();
+
+    // Let buffers and chunk slots grow to their working size before measuring
+    ASSERT_TRUE(backend->waitForFramesWrittenAtLeast(512, 5000ms));
+    pipeline.resetRenderAllocationStats();
+
+    // Stop measuring well before the stream runs dry so underrun handling is excluded
+    ASSERT_TRUE(backend->waitForFramesWrittenAtLeast(3072, 5000ms));
+    const auto stats = pipeline.renderAllocationStats();
+
+    pipeline.stop();
+
+    EXPECT_GT(stats.renderCycles, 0U);
+    EXPECT_EQ(stats.maxCycleAllocations, 0U);
+    EXPECT_EQ(stats.totalAllocations, 0U);
+}
+
+TEST(AudioPipelineTest, SteadyStateRenderWithDspsDoesNotAllocate)
+{
+    constexpr size_t StreamBufferSamples = 8192;
+    constexpr size_t StreamSamples       = 6000;
+
+    AudioPipeline pipeline;
+    auto output   = std::make_unique<FakeAudioOutput>(64);
+    auto* backend = output.get();
+    backend->setFreeFrames(64);
+
+    DspRegistry registry;
+    registry.registerDsp({.id      = u"test.dsp.mono_to_stereo"_s,
+                          .name    = u"MonoToStereo"_s,
+                          .factory = []() { return std::make_unique<MonoToStereoDsp>(); }});
+
+    pipeline.setDspRegistry(&registry);
+    pipeline.setOutput(std::move(output));
+    pipeline.start();
+    ASSERT_TRUE(pipeline.init(testFormat()));
+
+    // Per-track nodes widen to stereo and the master chain folds back to mono, so both chains swap new chunks in
+    Engine::DspDefinition monoToStereo;
+    monoToStereo.id   = u"test.dsp.mono_to_stereo"_s;
+    monoToStereo.name = u"MonoToStereo"_s;
+
+    Engine::DspChain perTrack;
+    perTrack.push_back(monoToStereo);
+
+    std::vector<DspNodePtr> masterNodes;
+    masterNodes.push_back(std::make_unique<DownmixToMonoDsp>());
+    pipeline.setDspChain(std::move(masterNodes), perTrack, testFormat());
+
+    auto stream = StreamFactory::createStream(testFormat(), StreamBufferSamples);
+    auto writer = stream->writer();
+
+    const std::vector<double> samples(StreamSamples, 0.25);
+    ASSERT_EQ(writer.write(samples.data(), samples.size()), samples.size());
+    stream->applyCommand(AudioStream::Command::Play);
+
+    const auto streamId = pipeline.registerStream(stream);
+    pipeline.addStream(streamId);
+    pipeline.play();
+
+    // Let buffers and chunk slots grow to their working size before measuring
+    ASSERT_TRUE(backend->waitForFramesWrittenAtLeast(512, 5000ms));
+    pipeline.resetRenderAllocationStats();
+
+    // Stop measuring well before the stream runs dry so underrun handling is excluded
+    ASSERT_TRUE(backend->waitForFramesWrittenAtLeast(3072, 5000ms));
+    const auto stats = pipeline.renderAllocationStats();
+
+    pipeline.stop();
+
+    EXPECT_GT(stats.renderCycles, 0U);
+    EXPECT_EQ(stats.maxCycleAllocations, 0U);
+    EXPECT_EQ(stats.totalAllocations, 0U);
+}
+
 TEST(AudioPipelineTest, StartsOutputOnlyAfterFirstSuccessfulWrite)
 {
     AudioPipeline pipeline;
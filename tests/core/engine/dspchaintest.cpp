@@ -495,4 +495,70 @@ TEST(DSPChainTest, SkipSilencePrepareClearsPendingStateOnFormatChange)
     dsp->process(secondChunks);
     EXPECT_EQ(totalFrames(secondChunks), 100);
 }
+
+TEST(DSPChainTest, ProcessingBufferListReusesChunkStorage)
+{
+    const AudioFormat format{SampleFormat::F64, 48000, 2};
+
+    ProcessingBufferList chunks;
+    chunks.reserve(2, 512);
+
+    auto* first = chunks.addItem(format, 0, 512);
+    ASSERT_TRUE(first);
+    const double* firstData = first->data().data();
+    ASSERT_TRUE(chunks.addItem(format, 100, 256));
+
+    chunks.clear();
+    EXPECT_EQ(chunks.count(), 0U);
+    EXPECT_FALSE(chunks.item(0));
+
+    // Cleared slots keep their storage for the next cycle
+    auto* reused = chunks.addItem(format, 200, 512);
+    ASSERT_TRUE(reused);
+    EXPECT_EQ(reused->data().data(), firstData);
+    EXPECT_EQ(reused->startTimeNs(), 200U);
+    EXPECT_EQ(reused->sourceFrameDurationNs(), 0U);
+
+    ProcessingBuffer source{format, 300};
+    source.resizeSamples(64);
+    chunks.addChunk(source);
+    chunks.insertItem(0, format, 100, 2);
+    ASSERT_EQ(chunks.count(), 3U);
+    EXPECT_EQ(chunks.item(0)->startTimeNs(), 100U);
+    EXPECT_EQ(chunks.item(1)->startTimeNs(), 200U);
+    EXPECT_EQ(chunks.item(2)->startTimeNs(), 300U);
+    EXPECT_EQ(chunks.item(2)->sampleCount(), 64);
+
+    chunks.removeByIdx(1);
+    ASSERT_EQ(chunks.count(), 2U);
+    EXPECT_EQ(chunks.item(0)->startTimeNs(), 100U);
+    EXPECT_EQ(chunks.item(1)->startTimeNs(), 300U);
+
+    chunks.insertItem(1, AudioFormat{}, 150, 0);
+    ASSERT_EQ(chunks.count(), 3U);
+    chunks.removeInvalid();
+    ASSERT_EQ(chunks.count(), 2U);
+    EXPECT_EQ(chunks.item(0)->startTimeNs(), 100U);
+    EXPECT_EQ(chunks.item(1)->startTimeNs(), 300U);
+
+    ProcessingBufferList other;
+    other.setToSingle(*chunks.item(1));
+    chunks.swap(other);
+    ASSERT_EQ(chunks.count(), 1U);
+    ASSERT_EQ(other.count(), 2U);
+    EXPECT_EQ(chunks.item(0)->startTimeNs(), 300U);
+    EXPECT_EQ(other.item(0)->startTimeNs(), 100U);
+
+    // Moving a chunk in leaves the argument empty, holding only the spare slot's capacity
+    chunks.clear();
+    ProcessingBuffer moved{format, 400};
+    moved.resizeSamples(32);
+    chunks.addChunk(std::move(moved));
+    ASSERT_EQ(chunks.count(), 1U);
+    EXPECT_EQ(chunks.item(0)->startTimeNs(), 400U);
+    EXPECT_EQ(chunks.item(0)->sampleCount(), 32);
+    EXPECT_FALSE(moved.isValid()); // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(moved.sampleCount(), 0);
+    EXPECT_EQ(moved.startTimeNs(), 0U);
+}
 } // namespace Fooyin::Testing
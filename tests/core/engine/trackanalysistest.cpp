@@ -0,0 +1,344 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioloader.h>
+#include <core/engine/trackanalysis.h>
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <memory>
+#include <vector>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+QCoreApplication* ensureCoreApplication()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    if(auto* app = QCoreApplication::instance()) {
+        return app;
+    }
+
+    static int argc{1};
+    static char appName[] = "fooyin-trackanalysis-test";
+    static char* argv[]   = {appName, nullptr};
+    static QCoreApplication app{argc, argv};
+    QCoreApplication::setApplicationName(QString::fromLatin1(appName));
+    return &app;
+}
+
+// 1 kHz so one frame is one millisecond
+Fooyin::AudioFormat testFormat()
+{
+    return {Fooyin::SampleFormat::S16, 1000, 2};
+}
+
+struct DecoderState
+{
+    int totalFrames{0};
+    int position{0};
+
+    int creatorCalls{0};
+    int seekCalls{0};
+    int readBufferCalls{0};
+};
+
+// Produces stereo frames whose samples hold the frame index
+class RampDecoder : public Fooyin::AudioDecoder
+{
+public:
+    explicit RampDecoder(std::shared_ptr<DecoderState> state)
+        : m_state{std::move(state)}
+    { }
+
+    QStringList extensions() const override
+    {
+        return {u"ramp"_s};
+    }
+
+    bool isSeekable() const override
+    {
+        return true;
+    }
+
+    std::optional<Fooyin::AudioFormat> init(const Fooyin::AudioSource& /*source*/, const Fooyin::Track& /*track*/,
+                                            DecoderOptions /*options*/) override
+    {
+        m_state->position = 0;
+        return testFormat();
+    }
+
+    void stop() override { }
+
+    void seek(uint64_t pos) override
+    {
+        ++m_state->seekCalls;
+        m_state->position = static_cast<int>(pos);
+    }
+
+    Fooyin::AudioBuffer readBuffer(size_t bytes) override
+    {
+        ++m_state->readBufferCalls;
+
+        const Fooyin::AudioFormat format = testFormat();
+        const int frames = std::min(static_cast<int>(bytes) / format.bytesPerFrame(),
+                                    m_state->totalFrames - m_state->position);
+        if(frames <= 0) {
+            return {};
+        }
+
+        std::vector<int16_t> samples;
+        samples.reserve(static_cast<size_t>(frames) * 2);
+        for(int frame{0}; frame < frames; ++frame) {
+            const auto value = static_cast<int16_t>(m_state->position + frame);
+            samples.push_back(value);
+            samples.push_back(value);
+        }
+        m_state->position += frames;
+
+        return {reinterpret_cast<const uint8_t*>(samples.data()), samples.size() * sizeof(int16_t), format, 0};
+    }
+
+private:
+    std::shared_ptr<DecoderState> m_state;
+};
+
+class RecordingAnalyser : public Fooyin::TrackAnalyser
+{
+public:
+    explicit RecordingAnalyser(Fooyin::SampleFormat format, bool accept = true, int maxBuffers = -1)
+        : m_format{format}
+        , m_accept{accept}
+        , m_maxBuffers{maxBuffers}
+    { }
+
+    Fooyin::SampleFormat sampleFormat() const override
+    {
+        return m_format;
+    }
+
+    bool start(const Fooyin::Track& /*track*/, const Fooyin::AudioFormat& /*format*/) override
+    {
+        started = true;
+        return m_accept;
+    }
+
+    bool process(const Fooyin::AudioBuffer& buffer) override
+    {
+        EXPECT_EQ(buffer.format().sampleFormat(), m_format);
+
+        if(buffers == 0 && m_format == Fooyin::SampleFormat::S16) {
+            firstSample = *reinterpret_cast<const int16_t*>(buffer.data());
+        }
+
+        ++buffers;
+        frames += buffer.frameCount();
+        return m_maxBuffers < 0 || buffers < m_maxBuffers;
+    }
+
+    void finish(Fooyin::Track& /*track*/) override
+    {
+        finished = true;
+    }
+
+    bool started{false};
+    bool finished{false};
+    int buffers{0};
+    int frames{0};
+    int firstSample{-1};
+
+private:
+    Fooyin::SampleFormat m_format;
+    bool m_accept;
+    int m_maxBuffers;
+};
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackAnalysisPipelineTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        ensureCoreApplication();
+    }
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_tempDir.isValid());
+
+        m_decoderState = std::make_shared<DecoderState>();
+        m_loader       = std::make_shared<AudioLoader>();
+        m_loader->addDecoder(u"Ramp"_s, [state = m_decoderState]() {
+            ++state->creatorCalls;
+            return std::make_unique<RampDecoder>(state);
+        });
+
+        m_pipeline = std::make_unique<TrackAnalysisPipeline>(m_loader);
+    }
+
+    Track createTrack(int frames)
+    {
+        const QString path = m_tempDir.filePath(u"track.ramp"_s);
+        QFile file{path};
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("ramp");
+        file.close();
+
+        m_decoderState->totalFrames = frames;
+
+        Track track{path};
+        track.setDuration(static_cast<uint64_t>(frames));
+        return track;
+    }
+
+    QTemporaryDir m_tempDir;
+    std::shared_ptr<DecoderState> m_decoderState;
+    std::shared_ptr<AudioLoader> m_loader;
+    std::unique_ptr<TrackAnalysisPipeline> m_pipeline;
+};
+
+TEST_F(TrackAnalysisPipelineTest, FeedsEveryAnalyserFromOneDecode)
+{
+    Track track = createTrack(50000);
+
+    RecordingAnalyser native{SampleFormat::S16};
+    RecordingAnalyser single{SampleFormat::F32};
+    RecordingAnalyser doubles{SampleFormat::F64};
+
+    EXPECT_TRUE(m_pipeline->analyse(track, {&native, &single, &doubles}));
+
+    EXPECT_EQ(1, m_decoderState->creatorCalls);
+    for(const auto* analyser : {&native, &single, &doubles}) {
+        EXPECT_TRUE(analyser->finished);
+        EXPECT_EQ(50000, analyser->frames);
+        EXPECT_EQ(native.buffers, analyser->buffers);
+    }
+    // One read per buffer, plus the read which reports the end of the stream
+    EXPECT_EQ(native.buffers + 1, m_decoderState->readBufferCalls);
+}
+
+TEST_F(TrackAnalysisPipelineTest, SkipsAnalysersWhichDecline)
+{
+    Track track = createTrack(1000);
+
+    RecordingAnalyser declined{SampleFormat::F32, false};
+    RecordingAnalyser accepted{SampleFormat::S16};
+
+    EXPECT_TRUE(m_pipeline->analyse(track, {&declined, &accepted}));
+
+    EXPECT_TRUE(declined.started);
+    EXPECT_FALSE(declined.finished);
+    EXPECT_EQ(0, declined.frames);
+    EXPECT_TRUE(accepted.finished);
+    EXPECT_EQ(1000, accepted.frames);
+}
+
+TEST_F(TrackAnalysisPipelineTest, DoesNotDecodeWhenEveryAnalyserDeclines)
+{
+    Track track = createTrack(1000);
+
+    RecordingAnalyser declined{SampleFormat::F32, false};
+
+    EXPECT_TRUE(m_pipeline->analyse(track, {&declined}));
+    EXPECT_EQ(0, m_decoderState->readBufferCalls);
+}
+
+TEST_F(TrackAnalysisPipelineTest, StopsFeedingAnalysersWhichAreDone)
+{
+    Track track = createTrack(50000);
+
+    RecordingAnalyser once{SampleFormat::S16, true, 1};
+    RecordingAnalyser full{SampleFormat::S16};
+
+    EXPECT_TRUE(m_pipeline->analyse(track, {&once, &full}));
+
+    EXPECT_EQ(1, once.buffers);
+    EXPECT_TRUE(once.finished);
+    EXPECT_EQ(50000, full.frames);
+}
+
+TEST_F(TrackAnalysisPipelineTest, AbandonsTrackWhenCancelled)
+{
+    Track track = createTrack(50000);
+
+    RecordingAnalyser analyser{SampleFormat::F32};
+
+    EXPECT_FALSE(m_pipeline->analyse(track, {&analyser}, []() { return false; }));
+    EXPECT_FALSE(analyser.finished);
+    EXPECT_EQ(0, analyser.frames);
+}
+
+TEST_F(TrackAnalysisPipelineTest, BoundsCueTracksToTheirRange)
+{
+    Track track = createTrack(5000);
+    track.setCuePath(m_tempDir.filePath(u"album.cue"_s));
+    track.setOffset(1000);
+    track.setDuration(2000);
+
+    RecordingAnalyser analyser{SampleFormat::S16};
+
+    EXPECT_TRUE(m_pipeline->analyse(track, {&analyser}));
+
+    EXPECT_EQ(1, m_decoderState->seekCalls);
+    EXPECT_EQ(1000, analyser.firstSample);
+    EXPECT_EQ(2000, analyser.frames);
+}
+
+TEST_F(TrackAnalysisPipelineTest, RunsRegisteredAnalysers)
+{
+    int created{0};
+    m_pipeline->registerAnalyser(u"Test"_s, [&created]() {
+        ++created;
+        return std::make_unique<RecordingAnalyser>(SampleFormat::F32);
+    });
+
+    EXPECT_EQ(QStringList{u"Test"_s}, m_pipeline->registeredAnalysers());
+    EXPECT_EQ(1U, m_pipeline->createRegisteredAnalysers().size());
+    EXPECT_EQ(1, created);
+
+    m_pipeline->unregisterAnalyser(u"Test"_s);
+    EXPECT_TRUE(m_pipeline->createRegisteredAnalysers().empty());
+}
+
+TEST_F(TrackAnalysisPipelineTest, SortsTracksByFileThenOffset)
+{
+    Track second{u"/music/b.flac"_s};
+    Track cueLate{u"/music/a.flac"_s};
+    cueLate.setOffset(60000);
+    Track cueEarly{u"/music/a.flac"_s};
+    cueEarly.setOffset(0);
+
+    TrackList tracks{second, cueLate, cueEarly};
+    TrackAnalysisPipeline::sortForLocality(tracks);
+
+    ASSERT_EQ(3U, tracks.size());
+    EXPECT_EQ(u"/music/a.flac"_s, tracks.at(0).filepath());
+    EXPECT_EQ(0U, tracks.at(0).offset());
+    EXPECT_EQ(60000U, tracks.at(1).offset());
+    EXPECT_EQ(u"/music/b.flac"_s, tracks.at(2).filepath());
+}
+} // namespace Fooyin::Testing
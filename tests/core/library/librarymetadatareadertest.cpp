@@ -0,0 +1,115 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/librarymetadatareader.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
+
+namespace Fooyin::Testing {
+TEST(LibraryMetadataReaderTest, ReturnsResultsInSubmissionOrder)
+{
+    LibraryMetadataReader reader{4, [](const QString& filepath) {
+                                     // Later files finish first
+                                     const int index = filepath.toInt();
+                                     std::this_thread::sleep_for(std::chrono::milliseconds{(16 - index) % 5});
+                                     Track track{filepath};
+                                     track.setTitle(filepath);
+                                     return TrackList{track};
+                                 }};
+
+    for(int i{0}; i < 16; ++i) {
+        reader.submit(QString::number(i));
+    }
+
+    EXPECT_EQ(16, reader.outstanding());
+
+    for(int i{0}; i < 16; ++i) {
+        const auto result = reader.takeNext(true);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(static_cast<uint64_t>(i), result->sequence);
+        EXPECT_EQ(QString::number(i), result->filepath);
+        ASSERT_EQ(1, result->tracks.size());
+        EXPECT_EQ(QString::number(i), result->tracks.front().title());
+    }
+
+    EXPECT_EQ(0, reader.outstanding());
+    EXPECT_FALSE(reader.takeNext(true).has_value());
+}
+
+TEST(LibraryMetadataReaderTest, ReadsConcurrently)
+{
+    std::mutex mutex;
+    std::condition_variable allReading;
+    int active{0};
+    int peak{0};
+
+    // Reads hold until every worker is reading at once, so the peak doesn't depend on timing
+    LibraryMetadataReader reader{4, [&mutex, &allReading, &active, &peak](const QString& /*filepath*/) {
+                                     std::unique_lock lock{mutex};
+                                     peak = std::max(peak, ++active);
+                                     allReading.notify_all();
+                                     allReading.wait_for(lock, 10s, [&peak]() { return peak == 4; });
+                                     --active;
+                                     return TrackList{};
+                                 }};
+
+    for(int i{0}; i < 8; ++i) {
+        reader.submit(QString::number(i));
+    }
+    while(reader.takeNext(true)) { }
+
+    EXPECT_EQ(4, peak);
+}
+
+TEST(LibraryMetadataReaderTest, CancelDropsQueuedReads)
+{
+    std::atomic<int> reads{0};
+
+    LibraryMetadataReader reader{1, [&reads](const QString& /*filepath*/) {
+                                     ++reads;
+                                     std::this_thread::sleep_for(10ms);
+                                     return TrackList{};
+                                 }};
+
+    for(int i{0}; i < 32; ++i) {
+        reader.submit(QString::number(i));
+    }
+
+    reader.cancel();
+
+    EXPECT_EQ(0, reader.outstanding());
+    EXPECT_LT(reads.load(), 32);
+    EXPECT_FALSE(reader.takeNext(true).has_value());
+
+    reader.submit(u"after"_s);
+    const auto result = reader.takeNext(true);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(u"after"_s, result->filepath);
+}
+} // namespace Fooyin::Testing
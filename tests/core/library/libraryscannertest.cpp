@@ -17,6 +17,9 @@
  *
  */
 
+#include "core/database/dbschema.h"
+#include "core/database/trackdatabase.h"
+#include "core/library/libraryscanner.h"
 #include "core/library/libraryscansession.h"
 #include "core/library/libraryscanstate.h"
 #include "core/library/libraryscanutils.h"
@@ -26,7 +29,11 @@
 #include "core/playlist/playlistloader.h"
 
 #include <core/engine/audioloader.h>
+#include <core/library/libraryinfo.h>
 #include <core/trackmetadatastore.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
 
 #include <QCoreApplication>
 #include <QFile>
@@ -37,9 +44,16 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
 
 namespace {
+constexpr auto CurrentSchemaVersion = 18;
+
 QCoreApplication* ensureCoreApplication()
 {
     QStandardPaths::setTestModeEnabled(true);
@@ -116,6 +130,110 @@ private:
     std::shared_ptr<State> m_state;
 };
 
+class CollectingScanHost : public DummyScanHost
+{
+public:
+    void reportScanUpdate(const Fooyin::ScanResult& result) override
+    {
+        addedTracks.insert(addedTracks.end(), result.addedTracks.cbegin(), result.addedTracks.cend());
+    }
+
+    Fooyin::TrackList addedTracks;
+};
+
+class FakeConcurrentReader : public Fooyin::AudioReader
+{
+public:
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable overlapping;
+        int active{0};
+        int peak{0};
+        //! Holds each read until another is running alongside it, so overlap doesn't depend on timing.
+        bool awaitOverlap{false};
+    };
+
+    explicit FakeConcurrentReader(std::shared_ptr<State> state)
+        : m_state{std::move(state)}
+    { }
+
+    QStringList extensions() const override
+    {
+        return {u"flac"_s};
+    }
+
+    bool canReadCover() const override
+    {
+        return false;
+    }
+
+    bool canWriteMetaData() const override
+    {
+        return false;
+    }
+
+    bool readTrack(const Fooyin::AudioSource& source, Fooyin::Track& track) override
+    {
+        track.setTitle(QFileInfo{source.filepath}.completeBaseName());
+
+        std::unique_lock lock{m_state->mutex};
+        m_state->peak = std::max(m_state->peak, ++m_state->active);
+        m_state->overlapping.notify_all();
+
+        if(m_state->awaitOverlap) {
+            m_state->overlapping.wait_for(lock, 10s, [this]() { return m_state->peak > 1; });
+        }
+
+        --m_state->active;
+        return true;
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+Fooyin::TrackList scanLibraryWithThreads(const QString& libraryPath, Fooyin::AudioLoader* audioLoader,
+                                         int readThreads)
+{
+    const QTemporaryDir dbDir;
+    EXPECT_TRUE(dbDir.isValid());
+
+    Fooyin::DbConnection::DbParams params;
+    params.type           = u"QSQLITE"_s;
+    params.connectOptions = u"QSQLITE_OPEN_URI"_s;
+    params.filePath       = dbDir.filePath(u"library.db"_s);
+
+    const auto dbPool
+        = Fooyin::DbConnectionPool::create(params, u"fooyin-libraryscanner-test-%1"_s.arg(readThreads));
+    const Fooyin::DbConnectionHandler handler{dbPool};
+    const Fooyin::DbConnectionProvider provider{dbPool};
+
+    Fooyin::DbSchema schema{provider};
+    EXPECT_EQ(Fooyin::DbSchema::UpgradeResult::Success,
+              schema.upgradeDatabase(CurrentSchemaVersion, u"://dbschema.xml"_s));
+
+    auto metadataStore = std::make_shared<Fooyin::TrackMetadataStore>();
+    Fooyin::TrackDatabase trackDatabase;
+    trackDatabase.initialise(provider);
+    trackDatabase.setMetadataStore(metadataStore);
+
+    Fooyin::PlaylistLoader playlistLoader;
+    Fooyin::LibraryScanConfig config;
+    config.readThreads = readThreads;
+
+    Fooyin::LibraryInfo library;
+    library.name = u"Library"_s;
+    library.path = libraryPath;
+    library.id   = 1;
+
+    CollectingScanHost host;
+    Fooyin::LibraryScanSession session{&trackDatabase, &playlistLoader, audioLoader, metadataStore, config, &host};
+    EXPECT_TRUE(session.scanLibrary(library, {}, false));
+
+    return host.addedTracks;
+}
+
 void writeFile(const QString& path, const QByteArray& data)
 {
     QFile file{path};
@@ -412,4 +530,39 @@ FILE "album.flac" FLAC
     EXPECT_EQ(u"Embedded One"_s, scannedTracks.at(0).title());
     EXPECT_EQ(u"Embedded Two"_s, scannedTracks.at(1).title());
 }
+
+TEST(LibraryScannerTest, ParallelLibraryScanMatchesSerialScan)
+{
+    ensureCoreApplication();
+
+    const QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    for(int i{0}; i < 24; ++i) {
+        writeFile(dir.filePath(u"track%1.flac"_s.arg(i, 2, 10, QChar{u'0'})), "flac");
+    }
+
+    AudioLoader audioLoader;
+    const auto readerState = std::make_shared<FakeConcurrentReader::State>();
+    audioLoader.addReader(
+        u"fake-concurrent"_s, [readerState]() { return std::make_unique<FakeConcurrentReader>(readerState); }, 0);
+
+    const TrackList serialTracks = scanLibraryWithThreads(dir.path(), &audioLoader, 1);
+    EXPECT_EQ(1, readerState->peak);
+
+    readerState->peak         = 0;
+    readerState->awaitOverlap = true;
+    const TrackList parallelTracks = scanLibraryWithThreads(dir.path(), &audioLoader, 4);
+    EXPECT_GT(readerState->peak, 1);
+    EXPECT_LE(readerState->peak, 4);
+
+    // Reads finish out of order, but results are merged in the order the files were found
+    ASSERT_EQ(24, serialTracks.size());
+    ASSERT_EQ(serialTracks.size(), parallelTracks.size());
+    for(size_t i{0}; i < serialTracks.size(); ++i) {
+        EXPECT_EQ(serialTracks.at(i).filepath(), parallelTracks.at(i).filepath());
+        EXPECT_EQ(serialTracks.at(i).title(), parallelTracks.at(i).title());
+        EXPECT_GE(parallelTracks.at(i).id(), 0);
+    }
+}
 } // namespace Fooyin::Testing
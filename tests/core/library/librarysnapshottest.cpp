@@ -0,0 +1,145 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/librarysnapshot.h"
+
+#include <core/trackmetadatastore.h>
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+Fooyin::TrackList makeTracks(const std::shared_ptr<Fooyin::TrackMetadataStore>& store)
+{
+    Fooyin::TrackList tracks;
+
+    for(int i{0}; i < 3; ++i) {
+        Fooyin::Track track{store};
+        track.setId(i + 1);
+        track.setFilePath(u"/music/album/%1.flac"_s.arg(i));
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.setArtists({u"Artist"_s, u"Guest %1"_s.arg(i)});
+        track.setAlbumArtists({u"Artist"_s});
+        track.setAlbum(u"Album"_s);
+        track.setTrackNumber(QString::number(i + 1));
+        track.setGenres({u"Rock"_s});
+        track.setDate(u"2024"_s);
+        track.setCodec(u"FLAC"_s);
+        track.setDuration(180000 + i);
+        track.setFileSize(1000000);
+        track.setSampleRate(44100);
+        track.setBitDepth(16);
+        track.setChannels(2);
+        track.setLibraryId(1);
+        track.setRGTrackGain(-6.5F);
+        track.setPlayCount(i);
+        track.setRating(0.6F);
+        track.addExtraTag(u"MOOD"_s, u"Calm"_s);
+        track.setMetadataWasRead(true);
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(LibrarySnapshotTest, RoundTripsTracks)
+{
+    const QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const auto store        = std::make_shared<TrackMetadataStore>();
+    const TrackList tracks  = makeTracks(store);
+    const LibrarySnapshot snapshot{dir.filePath(u"library.snapshot"_s)};
+
+    ASSERT_TRUE(snapshot.save(tracks, 42));
+
+    const auto loadStore = std::make_shared<TrackMetadataStore>();
+    const auto loaded    = snapshot.load(42, static_cast<int>(tracks.size()), loadStore);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(tracks.size(), loaded->size());
+
+    for(size_t i{0}; i < tracks.size(); ++i) {
+        const Track& expected = tracks.at(i);
+        const Track& actual   = loaded->at(i);
+
+        EXPECT_EQ(expected.id(), actual.id());
+        EXPECT_EQ(expected.filepath(), actual.filepath());
+        EXPECT_EQ(expected.title(), actual.title());
+        EXPECT_EQ(expected.artists(), actual.artists());
+        EXPECT_EQ(expected.albumArtists(), actual.albumArtists());
+        EXPECT_EQ(expected.album(), actual.album());
+        EXPECT_EQ(expected.genres(), actual.genres());
+        EXPECT_EQ(expected.duration(), actual.duration());
+        EXPECT_EQ(expected.playCount(), actual.playCount());
+        EXPECT_FLOAT_EQ(expected.rating(), actual.rating());
+        EXPECT_FLOAT_EQ(expected.rgTrackGain(), actual.rgTrackGain());
+        EXPECT_FALSE(actual.hasAlbumGain());
+        EXPECT_EQ(expected.extraTag(u"MOOD"_s), actual.extraTag(u"MOOD"_s));
+        EXPECT_EQ(expected.hash(), actual.hash());
+        EXPECT_TRUE(actual.metadataWasRead());
+        EXPECT_EQ(loadStore, actual.metadataStore());
+    }
+}
+
+TEST(LibrarySnapshotTest, RejectsStaleSnapshot)
+{
+    const QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const auto store       = std::make_shared<TrackMetadataStore>();
+    const TrackList tracks = makeTracks(store);
+    const LibrarySnapshot snapshot{dir.filePath(u"library.snapshot"_s)};
+
+    ASSERT_TRUE(snapshot.save(tracks, 7));
+
+    EXPECT_FALSE(snapshot.load(8, static_cast<int>(tracks.size()), store).has_value());
+    EXPECT_FALSE(snapshot.load(7, static_cast<int>(tracks.size()) + 1, store).has_value());
+    EXPECT_TRUE(snapshot.load(7, static_cast<int>(tracks.size()), store).has_value());
+
+    snapshot.remove();
+    EXPECT_FALSE(snapshot.load(7, static_cast<int>(tracks.size()), store).has_value());
+}
+
+TEST(LibrarySnapshotTest, RejectsTruncatedSnapshot)
+{
+    const QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const auto store       = std::make_shared<TrackMetadataStore>();
+    const TrackList tracks = makeTracks(store);
+    const QString path     = dir.filePath(u"library.snapshot"_s);
+    const LibrarySnapshot snapshot{path};
+
+    ASSERT_TRUE(snapshot.save(tracks, 1));
+
+    QFile file{path};
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.resize(file.size() - 3));
+    file.close();
+
+    EXPECT_FALSE(snapshot.load(1, static_cast<int>(tracks.size()), store).has_value());
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,320 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/database/dbschema.h"
+#include "core/database/trackdatabase.h"
+#include "core/library/librarysnapshot.h"
+
+#include <core/trackmetadatastore.h>
+#include <utils/database/dbconnection.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+#include <utils/database/dbwriter.h>
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto CurrentSchemaVersion = 18;
+
+void ensureCoreApplication()
+{
+    if(QCoreApplication::instance()) {
+        return;
+    }
+
+    static int argc{1};
+    static char appName[] = "fooyin-trackdatabase-test";
+    static char* argv[]   = {appName, nullptr};
+    static QCoreApplication app{argc, argv};
+}
+
+Fooyin::TrackList makeTracks(int count, int first = 0)
+{
+    Fooyin::TrackList tracks;
+
+    for(int i{first}; i < first + count; ++i) {
+        Fooyin::Track track{u"/music/album/%1.flac"_s.arg(i)};
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.setArtists({u"Artist"_s, u"Guest %1"_s.arg(i)});
+        track.setAlbumArtists({u"Artist"_s});
+        track.setAlbum(u"Album"_s);
+        track.setTrackNumber(QString::number(i + 1));
+        track.setGenres({u"Rock"_s});
+        track.setDate(u"2024"_s);
+        track.setCodec(u"FLAC"_s);
+        track.setDuration(180000 + i);
+        track.setSampleRate(44100);
+        track.setBitDepth(16);
+        track.setChannels(2);
+        track.setRGTrackGain(-6.5F);
+        track.addExtraTag(u"MOOD"_s, u"Calm"_s);
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackDatabaseTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ensureCoreApplication();
+        ASSERT_TRUE(m_dir.isValid());
+
+        DbConnection::DbParams params;
+        params.type           = u"QSQLITE"_s;
+        params.connectOptions = u"QSQLITE_OPEN_URI"_s;
+        params.filePath       = m_dir.filePath(u"tracks.db"_s);
+
+        m_dbPool  = DbConnectionPool::create(params, u"fooyin-trackdatabase-test"_s);
+        m_handler = DbConnectionHandler{m_dbPool};
+        ASSERT_TRUE(m_handler.hasConnection());
+
+        const DbConnectionProvider provider{m_dbPool};
+        DbSchema schema{provider};
+        ASSERT_EQ(DbSchema::UpgradeResult::Success, schema.upgradeDatabase(CurrentSchemaVersion, u"://dbschema.xml"_s));
+
+        m_trackDb.initialise(provider);
+        m_trackDb.setMetadataStore(std::make_shared<TrackMetadataStore>());
+    }
+
+    QTemporaryDir m_dir;
+    DbConnectionPoolPtr m_dbPool;
+    DbConnectionHandler m_handler;
+    TrackDatabase m_trackDb;
+};
+
+TEST_F(TrackDatabaseTest, StoresAndUpdatesTracksThroughCachedStatements)
+{
+    TrackList tracks = makeTracks(25);
+    ASSERT_TRUE(m_trackDb.storeTracks(tracks));
+    ASSERT_TRUE(std::ranges::all_of(tracks, [](const Track& track) { return track.id() >= 0; }));
+
+    // Storing again must resolve the existing ids rather than inserting duplicates
+    TrackList duplicates = makeTracks(25);
+    ASSERT_TRUE(m_trackDb.storeTracks(duplicates));
+    EXPECT_EQ(25, m_trackDb.trackCount());
+    EXPECT_EQ(tracks.at(7).id(), duplicates.at(7).id());
+
+    tracks.at(3).setTitle(u"Renamed"_s);
+    tracks.at(3).setAlbum(u"Other Album"_s);
+    ASSERT_TRUE(m_trackDb.updateTracks(tracks));
+
+    Track reloaded{tracks.at(3)};
+    ASSERT_TRUE(m_trackDb.reloadTrack(reloaded));
+    EXPECT_EQ(tracks.at(3).id(), reloaded.id());
+    EXPECT_EQ(u"/music/album/3.flac"_s, reloaded.filepath());
+    EXPECT_EQ(u"Renamed"_s, reloaded.title());
+    EXPECT_EQ(u"Other Album"_s, reloaded.album());
+    EXPECT_EQ(tracks.at(3).artists(), reloaded.artists());
+    EXPECT_EQ(u"4"_s, reloaded.trackNumber());
+    EXPECT_EQ(180003U, reloaded.duration());
+    EXPECT_EQ(44100, reloaded.sampleRate());
+    EXPECT_FLOAT_EQ(-6.5F, reloaded.rgTrackGain());
+    EXPECT_EQ(u"Calm"_s, reloaded.extraTag(u"MOOD"_s).value(0));
+}
+
+TEST_F(TrackDatabaseTest, UpdatesOnlyDirtyColumns)
+{
+    TrackList tracks = makeTracks(3);
+    ASSERT_TRUE(m_trackDb.storeTracks(tracks));
+    EXPECT_TRUE(std::ranges::all_of(tracks, [](const Track& track) { return track.dirtyFields().none(); }));
+
+    TrackList loaded = m_trackDb.getAllTracks();
+    ASSERT_EQ(3U, loaded.size());
+    EXPECT_TRUE(std::ranges::all_of(loaded, [](const Track& track) { return track.dirtyFields().none(); }));
+
+    // Change a column behind the loaded copies' backs; narrow updates must leave it alone
+    {
+        const DbConnectionProvider provider{m_dbPool};
+        QSqlQuery query{provider.db()};
+        ASSERT_TRUE(query.exec(u"UPDATE Tracks SET Comment = 'External';"_s));
+    }
+
+    for(Track& track : loaded) {
+        track.setRGTrackGain(-9.0F);
+    }
+    loaded.at(1).setComment(u"Edited"_s);
+    ASSERT_TRUE(m_trackDb.updateTracks(loaded));
+    EXPECT_TRUE(std::ranges::all_of(loaded, [](const Track& track) { return track.dirtyFields().none(); }));
+
+    for(const Track& track : loaded) {
+        Track reloaded{track};
+        ASSERT_TRUE(m_trackDb.reloadTrack(reloaded));
+        EXPECT_FLOAT_EQ(-9.0F, reloaded.rgTrackGain());
+        EXPECT_EQ(track.title(), reloaded.title());
+        EXPECT_EQ(u"Calm"_s, reloaded.extraTag(u"MOOD"_s).value(0));
+        EXPECT_EQ(track.id() == loaded.at(1).id() ? u"Edited"_s : u"External"_s, reloaded.comment());
+    }
+
+    // Clean tracks are a no-op
+    EXPECT_TRUE(m_trackDb.updateTrack(loaded.at(0)));
+
+    // Tracks loaded from a snapshot start clean too
+    const LibrarySnapshot snapshot{m_dir.filePath(u"library.snapshot"_s)};
+    ASSERT_TRUE(snapshot.save(m_trackDb.getAllTracks(), 1));
+
+    auto snapshotTracks = snapshot.load(1, 3, std::make_shared<TrackMetadataStore>());
+    ASSERT_TRUE(snapshotTracks.has_value());
+    ASSERT_EQ(3U, snapshotTracks->size());
+    EXPECT_TRUE(std::ranges::all_of(*snapshotTracks, [](const Track& track) { return track.dirtyFields().none(); }));
+
+    {
+        const DbConnectionProvider provider{m_dbPool};
+        QSqlQuery query{provider.db()};
+        ASSERT_TRUE(query.exec(u"UPDATE Tracks SET Comment = 'Outside';"_s));
+    }
+
+    snapshotTracks->at(2).setRGTrackGain(-3.0F);
+    ASSERT_TRUE(m_trackDb.updateTracks(*snapshotTracks));
+
+    for(const Track& track : *snapshotTracks) {
+        Track reloaded{track};
+        ASSERT_TRUE(m_trackDb.reloadTrack(reloaded));
+        EXPECT_FLOAT_EQ(track.id() == snapshotTracks->at(2).id() ? -3.0F : -9.0F, reloaded.rgTrackGain());
+        EXPECT_EQ(u"Outside"_s, reloaded.comment());
+    }
+}
+
+TEST_F(TrackDatabaseTest, BoundsCachedStatementsPerConnection)
+{
+    const DbConnectionProvider provider{m_dbPool};
+    DbConnection* connection = provider.connection();
+    ASSERT_NE(nullptr, connection);
+    connection->clearCachedQueries();
+
+    const QString first = u"SELECT TrackID FROM Tracks WHERE TrackID = 0;"_s;
+    ASSERT_NE(nullptr, connection->cachedQuery(first));
+
+    for(size_t i{1}; i < 2 * DbConnection::CachedQueryLimit; ++i) {
+        // Keep the first statement recently used so only the others are evicted
+        ASSERT_NE(nullptr, connection->cachedQuery(first));
+        ASSERT_NE(nullptr, connection->cachedQuery(u"SELECT TrackID FROM Tracks WHERE TrackID = %1;"_s.arg(i)));
+        EXPECT_LE(connection->cachedQueryCount(), DbConnection::CachedQueryLimit);
+    }
+
+    // A statement still in use isn't handed out twice
+    const auto held = connection->cachedQuery(first);
+    ASSERT_NE(nullptr, held);
+    EXPECT_EQ(nullptr, connection->cachedQuery(first));
+}
+
+TEST_F(TrackDatabaseTest, GroupsConcurrentWritesIntoSharedCommits)
+{
+    constexpr int ThreadCount = 8;
+    constexpr int BatchSize   = 20;
+
+    std::vector<TrackList> batches;
+    for(int i{0}; i < ThreadCount; ++i) {
+        batches.push_back(makeTracks(BatchSize, i * BatchSize));
+    }
+
+    std::vector<char> results(ThreadCount, 0);
+    {
+        std::vector<std::jthread> threads;
+        for(int i{0}; i < ThreadCount; ++i) {
+            threads.emplace_back([this, &batches, &results, i]() { results[i] = m_trackDb.storeTracks(batches[i]); });
+        }
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(results, [](char result) { return result != 0; }));
+    EXPECT_EQ(ThreadCount * BatchSize, m_trackDb.trackCount());
+
+    const DbWriter::Metrics metrics = m_dbPool->writer()->metrics();
+    EXPECT_EQ(static_cast<uint64_t>(ThreadCount), metrics.writes);
+    EXPECT_LE(metrics.commits, metrics.writes);
+    EXPECT_EQ(0U, metrics.failedWrites);
+    EXPECT_EQ(0U, metrics.queueDepth);
+}
+
+TEST_F(TrackDatabaseTest, RollsBackOnlyTheFailedWriteInABatch)
+{
+    DbWriter* writer = m_dbPool->writer();
+
+    auto failed = writer->submit([this](const QSqlDatabase& /*db*/) {
+        TrackList tracks = makeTracks(1, 100);
+        m_trackDb.storeTracks(tracks);
+        return false;
+    });
+    auto stored = writer->submit([this](const QSqlDatabase& /*db*/) {
+        TrackList tracks = makeTracks(1, 200);
+        return m_trackDb.storeTracks(tracks);
+    });
+
+    EXPECT_FALSE(failed.get());
+    EXPECT_TRUE(stored.get());
+    EXPECT_EQ(1, m_trackDb.trackCount());
+}
+
+TEST_F(TrackDatabaseTest, RunsHighPriorityWritesAheadOfQueuedWrites)
+{
+    DbWriter* writer = m_dbPool->writer();
+
+    std::promise<void> started;
+    std::promise<void> release;
+    const std::shared_future<void> released = release.get_future().share();
+
+    auto blocking = writer->submit([&started, released](const QSqlDatabase& /*db*/) {
+        started.set_value();
+        released.wait();
+        return true;
+    });
+    // Writer is now busy, so everything below is queued together
+    started.get_future().wait();
+
+    std::vector<int> order;
+    std::vector<std::future<bool>> results;
+    for(int i{0}; i < 3; ++i) {
+        results.push_back(writer->submit([&order, i](const QSqlDatabase& /*db*/) {
+            order.push_back(i);
+            return true;
+        }));
+    }
+    results.push_back(writer->submit(
+        [&order](const QSqlDatabase& /*db*/) {
+            order.push_back(-1);
+            return true;
+        },
+        DbWriter::Priority::High));
+
+    release.set_value();
+    EXPECT_TRUE(blocking.get());
+    for(auto& result : results) {
+        EXPECT_TRUE(result.get());
+    }
+
+    const std::vector<int> expected{-1, 0, 1, 2};
+    EXPECT_EQ(expected, order);
+}
+} // namespace Fooyin::Testing
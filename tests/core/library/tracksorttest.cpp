@@ -0,0 +1,214 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/tracksort.h>
+
+#include <utils/stringcollator.h>
+
+#include <QLocale>
+#include <QThreadPool>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto SortScript = "%albumartist% - %album% - %title%";
+
+Fooyin::TrackList makeTracks(int count)
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        Fooyin::Track track{u"/music/%1.flac"_s.arg(i), 0};
+        track.setId(i);
+        // Small key spaces so many tracks compare equal and stability matters
+        track.setAlbumArtists({u"Artist %1"_s.arg((i * 7919) % 97)});
+        track.setAlbum(u"Album %1"_s.arg((i * 104729) % 13));
+        track.setTitle(u"Title %1"_s.arg((i * 31) % 211));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+std::vector<int> trackIds(const Fooyin::TrackList& tracks)
+{
+    std::vector<int> ids;
+    ids.reserve(tracks.size());
+    for(const auto& track : tracks) {
+        ids.push_back(track.id());
+    }
+    return ids;
+}
+
+class ThreadCountGuard
+{
+public:
+    explicit ThreadCountGuard(int count)
+        : m_previous{QThreadPool::globalInstance()->maxThreadCount()}
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(count);
+    }
+
+    ~ThreadCountGuard()
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(m_previous);
+    }
+
+    ThreadCountGuard(const ThreadCountGuard&)            = delete;
+    ThreadCountGuard& operator=(const ThreadCountGuard&) = delete;
+
+private:
+    int m_previous;
+};
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(TrackSorterTest, CollationKeysMatchCompare)
+{
+    const QStringList strings{u""_s,      u"a"_s,     u"A"_s,     u"b"_s,      u"track 2"_s, u"track 10"_s,
+                              u"Track 3"_s, u"äpfel"_s, u"apfel"_s, u"zebra"_s,  u"Zebra"_s,   u"1"_s,
+                              u"01"_s,    u"1a"_s,    u" space"_s, u"-dash"_s, u"日本"_s,    u"naïve"_s};
+
+    for(const auto sensitivity : {Qt::CaseSensitive, Qt::CaseInsensitive}) {
+        for(const bool numeric : {true, false}) {
+            StringCollator collator;
+            collator.setCaseSensitivity(sensitivity);
+            collator.setNumericMode(numeric);
+
+            for(const QString& lhs : strings) {
+                for(const QString& rhs : strings) {
+                    const int cmp       = collator.compare(lhs, rhs);
+                    const int keyCmp    = collator.sortKey(lhs).compare(collator.sortKey(rhs));
+                    const auto expected = (cmp > 0) - (cmp < 0);
+                    EXPECT_EQ(expected, (keyCmp > 0) - (keyCmp < 0))
+                        << lhs.toStdString() << " vs " << rhs.toStdString();
+                }
+            }
+        }
+    }
+}
+
+TEST(TrackSorterTest, ResortReusesCachedKeys)
+{
+    TrackList tracks = makeTracks(5000);
+
+    TrackSorter sorter;
+    const TrackList first = sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks);
+
+    // Changing a track's metadata must be reflected despite cached keys
+    tracks[0].setAlbumArtists({u"AAA"_s});
+    const TrackList second = sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks);
+
+    ASSERT_EQ(first.size(), second.size());
+    EXPECT_EQ(0, second.front().id());
+
+    TrackSorter freshSorter;
+    EXPECT_EQ(trackIds(freshSorter.calcSortTracks(QString::fromLatin1(SortScript), tracks)), trackIds(second));
+}
+
+TEST(TrackSorterTest, LocaleChangeDropsCachedKeys)
+{
+    const QLocale previous;
+
+    TrackList tracks;
+    for(const QString& title : {u"zebra"_s, u"äpple"_s, u"apple"_s}) {
+        Track track{u"/music/%1.flac"_s.arg(tracks.size()), 0};
+        track.setId(static_cast<int>(tracks.size()));
+        track.setTitle(title);
+        tracks.push_back(track);
+    }
+
+    // German sorts "ä" with "a", Swedish sorts it after "z"
+    QLocale::setDefault(QLocale{QLocale::German, QLocale::Germany});
+    TrackSorter sorter;
+    EXPECT_EQ((std::vector<int>{2, 1, 0}), trackIds(sorter.calcSortTracks(u"%title%"_s, tracks)));
+
+    QLocale::setDefault(QLocale{QLocale::Swedish, QLocale::Sweden});
+    EXPECT_EQ((std::vector<int>{2, 0, 1}), trackIds(sorter.calcSortTracks(u"%title%"_s, tracks)));
+
+    QLocale::setDefault(previous);
+}
+
+TEST(TrackSorterTest, CollationSettingChangeDropsCachedKeys)
+{
+    TrackList tracks;
+    for(const QString& title : {u"Track 10"_s, u"track 2"_s, u"Track 1"_s}) {
+        Track track{u"/music/%1.flac"_s.arg(tracks.size()), 0};
+        track.setId(static_cast<int>(tracks.size()));
+        track.setTitle(title);
+        tracks.push_back(track);
+    }
+
+    TrackSorter sorter;
+    EXPECT_EQ((std::vector<int>{2, 1, 0}), trackIds(sorter.calcSortTracks(u"%title%"_s, tracks)));
+
+    sorter.setNumericMode(false);
+    EXPECT_EQ((std::vector<int>{2, 0, 1}), trackIds(sorter.calcSortTracks(u"%title%"_s, tracks)));
+
+    sorter.setNumericMode(true);
+    EXPECT_EQ((std::vector<int>{2, 1, 0}), trackIds(sorter.calcSortTracks(u"%title%"_s, tracks)));
+}
+
+TEST(TrackSorterTest, ParallelSortMatchesSerialOrder)
+{
+    const TrackList tracks = makeTracks(50000);
+
+    for(const auto order : {Qt::AscendingOrder, Qt::DescendingOrder}) {
+        std::vector<int> serialIds;
+        {
+            const ThreadCountGuard threads{1};
+            TrackSorter sorter;
+            serialIds = trackIds(sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks, order));
+        }
+
+        for(const int threadCount : {2, 3, 8}) {
+            const ThreadCountGuard threads{threadCount};
+            TrackSorter sorter;
+            EXPECT_EQ(serialIds, trackIds(sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks, order)))
+                << "threads: " << threadCount;
+        }
+    }
+}
+
+TEST(TrackSorterTest, ParallelSubsetSortMatchesSerialOrder)
+{
+    const TrackList tracks = makeTracks(30000);
+
+    std::vector<int> indexes;
+    for(int i{0}; i < static_cast<int>(tracks.size()); i += 2) {
+        indexes.push_back(i);
+    }
+
+    std::vector<int> serialIds;
+    {
+        const ThreadCountGuard threads{1};
+        TrackSorter sorter;
+        serialIds = trackIds(sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks, indexes));
+    }
+
+    const ThreadCountGuard threads{4};
+    TrackSorter sorter;
+    EXPECT_EQ(serialIds, trackIds(sorter.calcSortTracks(QString::fromLatin1(SortScript), tracks, indexes)));
+}
+} // namespace Fooyin::Testing
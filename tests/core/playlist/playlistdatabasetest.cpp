@@ -0,0 +1,236 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/database/playlistdatabase.h"
+
+#include <core/track.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+#include <utils/database/dbquery.h>
+#include <utils/database/dbtransaction.h>
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+namespace Fooyin::Testing {
+namespace {
+constexpr int PlaylistId = 1;
+
+QCoreApplication* ensureCoreApplication()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    if(auto* app = QCoreApplication::instance()) {
+        return app;
+    }
+
+    static int argc{1};
+    static char appName[]        = "fooyin-playlistdatabase-test";
+    static char* argv[]          = {appName, nullptr};
+    static QCoreApplication* app = []() {
+        auto* instance = new QCoreApplication(argc, argv);
+        QCoreApplication::setApplicationName(QString::fromLatin1(appName));
+        return instance;
+    }();
+    return app;
+}
+
+Track makeTrack(int id)
+{
+    Track track{u"/music/%1.flac"_s.arg(id), 0};
+    track.setId(id);
+    return track;
+}
+
+TrackList makeTracks(int first, int count)
+{
+    TrackList tracks;
+    tracks.reserve(count);
+    for(int i{0}; i < count; ++i) {
+        tracks.push_back(makeTrack(first + i));
+    }
+    return tracks;
+}
+
+struct PlaylistDatabaseHarness
+{
+    PlaylistDatabaseHarness()
+        : dbPool{[this]() {
+            EXPECT_TRUE(dbDir.isValid());
+
+            DbConnection::DbParams params;
+            params.type     = u"QSQLITE"_s;
+            params.filePath = dbDir.filePath(u"playlistdatabase.sqlite"_s);
+
+            auto pool = DbConnectionPool::create(params, u"playlistdatabase_test"_s);
+            EXPECT_TRUE(pool);
+            return pool;
+        }()}
+        , dbConnectionHandler{dbPool}
+        , dbProvider{dbPool}
+    {
+        DbQuery create{dbProvider.db(), u"CREATE TABLE IF NOT EXISTS PlaylistTracks ("
+                                        "PlaylistID INTEGER NOT NULL, "
+                                        "TrackID INTEGER NOT NULL, "
+                                        "TrackIndex INTEGER NOT NULL);"_s};
+        dbInitialised = dbConnectionHandler.hasConnection() && create.exec();
+
+        playlistDb.initialise(dbProvider);
+    }
+
+    [[nodiscard]] std::vector<std::pair<int, int>> rows() const
+    {
+        DbQuery query{dbProvider.db(), u"SELECT TrackID, TrackIndex FROM PlaylistTracks WHERE PlaylistID = "
+                                       ":playlistId ORDER BY TrackIndex;"_s};
+        query.bindValue(u":playlistId"_s, PlaylistId);
+
+        std::vector<std::pair<int, int>> result;
+        if(query.exec()) {
+            while(query.next()) {
+                result.emplace_back(query.value(0).toInt(), query.value(1).toInt());
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::vector<std::pair<int, int>> expectedRows(const TrackList& tracks) const
+    {
+        std::vector<std::pair<int, int>> result;
+        for(const auto& track : tracks) {
+            result.emplace_back(track.id(), static_cast<int>(result.size()));
+        }
+        return result;
+    }
+
+    QTemporaryDir dbDir;
+    DbConnectionPoolPtr dbPool;
+    DbConnectionHandler dbConnectionHandler;
+    DbConnectionProvider dbProvider;
+    bool dbInitialised{false};
+    PlaylistDatabase playlistDb;
+};
+} // namespace
+
+TEST(PlaylistDatabaseTest, SavesEditsAsContiguousRows)
+{
+    ensureCoreApplication();
+    PlaylistDatabaseHarness harness;
+    ASSERT_TRUE(harness.dbInitialised);
+
+    TrackList tracks = makeTracks(1, 10);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    // Append
+    tracks.push_back(makeTrack(100));
+    tracks.push_back(makeTrack(101));
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    // Remove from the middle
+    tracks.erase(tracks.begin() + 3, tracks.begin() + 6);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    // Insert at the front
+    tracks.insert(tracks.begin(), makeTrack(200));
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    // Move
+    std::rotate(tracks.begin() + 2, tracks.begin() + 5, tracks.begin() + 7);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    // Duplicates and tracks not in the database
+    tracks.push_back(tracks.front());
+    tracks.insert(tracks.begin() + 1, Track{u"/music/unsaved.flac"_s, 0});
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    tracks.erase(tracks.begin() + 1);
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+
+    tracks.clear();
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_TRUE(harness.rows().empty());
+}
+
+TEST(PlaylistDatabaseTest, MovesBlocksWithoutRewritingRows)
+{
+    ensureCoreApplication();
+    PlaylistDatabaseHarness harness;
+    ASSERT_TRUE(harness.dbInitialised);
+
+    const auto rowIds = [&harness]() {
+        DbQuery query{harness.dbProvider.db(), u"SELECT rowid FROM PlaylistTracks ORDER BY rowid;"_s};
+
+        std::vector<qint64> result;
+        if(query.exec()) {
+            while(query.next()) {
+                result.push_back(query.value(0).toLongLong());
+            }
+        }
+        return result;
+    };
+
+    TrackList tracks = makeTracks(1, 10);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    const std::vector<qint64> savedRowIds = rowIds();
+
+    // Move a block forwards
+    std::rotate(tracks.begin() + 1, tracks.begin() + 4, tracks.begin() + 8);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+    EXPECT_EQ(savedRowIds, rowIds());
+
+    // Move a single track backwards, with a duplicate of it inside the window
+    tracks[3] = tracks.at(8);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    const std::vector<qint64> editedRowIds = rowIds();
+
+    std::rotate(tracks.begin() + 2, tracks.begin() + 8, tracks.begin() + 9);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+    EXPECT_EQ(editedRowIds, rowIds());
+}
+
+TEST(PlaylistDatabaseTest, RewritesRowsWithGaps)
+{
+    ensureCoreApplication();
+    PlaylistDatabaseHarness harness;
+    ASSERT_TRUE(harness.dbInitialised);
+
+    const TrackList tracks = makeTracks(1, 5);
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+
+    // Simulate a track removed from the library by cascade
+    DbQuery remove{harness.dbProvider.db(), u"DELETE FROM PlaylistTracks WHERE TrackID = 3;"_s};
+    ASSERT_TRUE(remove.exec());
+
+    ASSERT_TRUE(harness.playlistDb.savePlaylistTracks(PlaylistId, tracks));
+    EXPECT_EQ(harness.expectedRows(tracks), harness.rows());
+}
+} // namespace Fooyin::Testing
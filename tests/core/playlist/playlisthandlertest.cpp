@@ -402,4 +402,53 @@ TEST(PlaylistHandlerTest, TracksMetadataChangedUpdatesAutoPlaylistTrackCustomTag
     EXPECT_EQ(playlistTrack->track.metaValue(u"custom"_s), u"After"_s);
     EXPECT_EQ(changeSet.updatedEntries.front(), playlistTrack->entryId);
 }
+
+TEST(PlaylistHandlerTest, AutoPlaylistPatchesChangedTracksInLibraryOrder)
+{
+    ensureCoreApplication();
+    SettingsManager settings{QDir::tempPath() + u"/fooyin_playlisthandler_auto_incremental_test.ini"_s};
+    registerCoreSettings(settings);
+    PlaylistHandlerHarness harness{settings};
+    ASSERT_TRUE(harness.dbInitialised);
+
+    const auto withGenre = [](Track track, const QString& genre) {
+        track.setGenres({genre});
+        return track;
+    };
+
+    const Track first  = withGenre(makeTrack(u"/tmp/first.flac"_s, 1), u"Rock"_s);
+    const Track second = makeTrack(u"/tmp/second.flac"_s, 2);
+    const Track third  = withGenre(makeTrack(u"/tmp/third.flac"_s, 3), u"Jazz"_s);
+    harness.library.setTracks({first, second, third});
+
+    auto* playlist = harness.handler.createNewAutoPlaylist(u"Genre Auto"_s, u"genre PRESENT"_s);
+    ASSERT_NE(playlist, nullptr);
+
+    const auto playlistIds = [playlist]() {
+        std::vector<int> ids;
+        for(const Track& track : playlist->tracks()) {
+            ids.push_back(track.id());
+        }
+        return ids;
+    };
+
+    ASSERT_EQ(playlistIds(), std::vector<int>({1, 3}));
+
+    // A newly matching track is placed at its library position
+    const Track taggedSecond = withGenre(second, u"Pop"_s);
+    harness.library.setTracks({first, taggedSecond, third});
+    Q_EMIT harness.library.tracksUpdated({taggedSecond});
+    EXPECT_EQ(playlistIds(), std::vector<int>({1, 2, 3}));
+
+    // A track which no longer matches is dropped
+    Track untaggedFirst{first};
+    untaggedFirst.setGenres({});
+    harness.library.setTracks({untaggedFirst, taggedSecond, third});
+    Q_EMIT harness.library.tracksMetadataChanged({untaggedFirst});
+    EXPECT_EQ(playlistIds(), std::vector<int>({2, 3}));
+
+    harness.library.setTracks({untaggedFirst, taggedSecond});
+    harness.handler.handleTracksDeleted({third});
+    EXPECT_EQ(playlistIds(), std::vector<int>({2}));
+}
 } // namespace Fooyin::Testing
@@ -23,6 +23,7 @@
 #include <core/scripting/scriptproviders.h>
 #include <core/scripting/scripttrackwriter.h>
 #include <core/track.h>
+#include <core/trackmetadatastore.h>
 
 #include <gtest/gtest.h>
 
@@ -449,6 +450,62 @@ TEST_F(ScriptParserTest, MathTest)
     EXPECT_EQ(100, m_parser.evaluate(u"$max(3,2,3,9,23,100,4)"_s).toInt());
 }
 
+TEST_F(ScriptParserTest, CompiledScriptsMatchInterpreter)
+{
+    Track track;
+    track.setTitle(u"A Test"_s);
+    track.setGenres({u"Pop"_s, u"Rock"_s});
+    track.setTrackNumber(u"7"_s);
+    track.setYear(1999);
+    track.setPlayCount(12);
+    track.setDuration(215250);
+    track.setFileSize(8388608);
+
+    const QStringList scripts{
+        u"%title% - %year%"_s,
+        u"[%album% - ]%title%"_s,
+        u"[%genre% - %title%]"_s,
+        u"%<genre>% - [%playcount%]"_s,
+        u"$add(%playcount%,%year%)"_s,
+        u"$div(%duration_s%,7)"_s,
+        u"$mul(%filesize%,1000)"_s,
+        u"$sub(%title%,1)"_s,
+        u"$add(1,2,x,%playcount%)"_s,
+        u"$mod(%year%,7,3)"_s,
+        u"$num(%track%,3)"_s,
+        u"$num(%title%,3)"_s,
+        u"$pad(%playcount%,5,0)"_s,
+        u"$padright(%year%,%playcount%,-)"_s,
+        u"$pad(a,%title%,$put(x,1))$get(x)"_s,
+        u"$if(%album%,yes,no)"_s,
+        u"$if2(%album%,%title%)"_s,
+        u"$if3(%album%,%comment%,%year%,none)"_s,
+        u"$ifequal(%playcount%,12.0,yes,no)"_s,
+        u"$ifgreater(%duration_s%,%year%,long,short)"_s,
+        u"$iflonger(%title%,%playcount%,long,short)"_s,
+        u"$iflonger(%title%,%album%,long,short)"_s,
+        u"$put(count,%playcount%)-$get(count)-$puts(x,1)$get(X)"_s,
+        u"$upper(%title%)$lower(ABC)"_s,
+        u"[$add(1,2)]"_s,
+        u"[%playcount% plays ][%album%]"_s,
+        u"$if($strcmp(%year%,1999),%title%,)"_s,
+        u"$add($div(%duration_s%,60),0.5)"_s,
+        u"%duration_s%:%playcount%:%subsong%"_s,
+    };
+
+    for(const QString& script : scripts) {
+        m_parser.setCompilationEnabled(false);
+        const QString interpreted = m_parser.evaluate(script, track);
+        m_parser.setCompilationEnabled(true);
+        EXPECT_EQ(interpreted, m_parser.evaluate(script, track)) << script.toStdString();
+    }
+
+    EXPECT_EQ(u"2011", m_parser.evaluate(u"$add(%playcount%,%year%)"_s, track));
+    EXPECT_EQ(u"12000", m_parser.evaluate(u"$pad(%playcount%,5,0)"_s, track));
+    EXPECT_EQ(u"30.7143", m_parser.evaluate(u"$div(%duration_s%,7)"_s, track));
+    EXPECT_EQ(u"8.38861e+09", m_parser.evaluate(u"$mul(%filesize%,1000)"_s, track));
+}
+
 TEST_F(ScriptParserTest, TimeDateFunctionTest)
 {
     EXPECT_EQ(u"2024", m_parser.evaluate(u"$year(\"2024-03-09 08:07:06\")"_s));
@@ -1094,4 +1151,59 @@ TEST_F(ScriptParserTest, QueryAndLiteralCachesStaySeparate)
     EXPECT_EQ(1, m_parser.filter(u"playcount>1"_s, tracks).size());
     EXPECT_EQ(u"playcount>1", m_parser.evaluate(u"playcount>1"_s, track));
 }
+
+TEST_F(ScriptParserTest, QueryPlannerUsesFieldIndexes)
+{
+    auto store = std::make_shared<TrackMetadataStore>();
+
+    TrackList tracks;
+    for(int i{0}; i < 20; ++i) {
+        Track track{store};
+        track.setId(i);
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.setArtists({i % 2 == 0 ? u"Even Artist"_s : u"Odd Artist"_s});
+        track.setPlayCount(i);
+        track.setLastPlayed(QDateTime(QDate(2024, 1, 1 + i), QTime(12, 0, 0)).toMSecsSinceEpoch());
+        tracks.push_back(track);
+    }
+
+    // Without a library-maintained store every track is evaluated
+    EXPECT_EQ(10, m_parser.filter(u"artist=even artist"_s, tracks).size());
+
+    store->markChanged();
+
+    EXPECT_EQ(10, m_parser.filter(u"artist=even artist"_s, tracks).size());
+    EXPECT_EQ(5, m_parser.filter(u"artist=odd artist AND playcount>10"_s, tracks).size());
+    EXPECT_EQ(6, m_parser.filter(u"playcount>=14"_s, tracks).size());
+    EXPECT_EQ(0, m_parser.filter(u"playcount>=A"_s, tracks).size());
+    EXPECT_EQ(3, m_parser.filter(u"playcount<3 AND title:title"_s, tracks).size());
+    EXPECT_EQ(1, m_parser.filter(u"(artist=even artist AND playcount<=1) AND title:\"title 0\""_s, tracks).size());
+    EXPECT_EQ(11, m_parser.filter(u"artist=even artist OR playcount=1"_s, tracks).size());
+    EXPECT_EQ(4, m_parser.filter(u"lastplayed BEFORE 2024-01-05"_s, tracks).size());
+
+    const QString plan = m_parser.explainQuery(u"artist=even artist AND playcount>10 AND title:title"_s);
+    EXPECT_TRUE(plan.contains(u"INDEX ARTIST = \"even artist\""_s)) << plan.toStdString();
+    EXPECT_TRUE(plan.contains(u"INDEX RANGE PLAYCOUNT > 10"_s)) << plan.toStdString();
+    EXPECT_TRUE(plan.contains(u"SCAN TITLE contains"_s)) << plan.toStdString();
+
+    // Tracks the index hasn't seen are indexed on demand
+    Track extra{store};
+    extra.setId(40);
+    extra.setArtists({u"Even Artist"_s});
+    tracks.push_back(extra);
+    EXPECT_EQ(11, m_parser.filter(u"artist=even artist"_s, tracks).size());
+
+    // Edited copies with an indexed id are evaluated rather than answered from the index
+    TrackList edited{tracks.at(1), tracks.at(2)};
+    edited.front().setArtists({u"Even Artist"_s});
+    edited.back().setPlayCount(100);
+    EXPECT_EQ(2, m_parser.filter(u"artist=even artist"_s, edited).size());
+    EXPECT_EQ(1, m_parser.filter(u"playcount>50"_s, edited).size());
+    EXPECT_EQ(0, m_parser.filter(u"playcount>50"_s, tracks).size());
+
+    // Indexes are rebuilt once the store changes
+    tracks.front().setArtists({u"Another Artist"_s});
+    store->markChanged();
+    EXPECT_EQ(10, m_parser.filter(u"artist=even artist"_s, tracks).size());
+}
 } // namespace Fooyin::Testing
@@ -23,6 +23,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace Qt::StringLiterals;
 
 namespace Fooyin::Testing {
@@ -85,4 +89,39 @@ TEST(StringPoolTest, InternsExtraTagKeysInUpperCase)
     const QStringList values = track.metadataStore()->values(StringPool::Domain::ExtraTagKey);
     EXPECT_EQ(std::count(values.cbegin(), values.cend(), u"CUSTOM"_s), 1);
 }
+
+TEST(StringPoolTest, ResolvesWhileInterning)
+{
+    StringPool pool;
+
+    const auto firstRef = pool.internList(StringPool::Domain::Genre, {u"Rock"_s, u"Jazz"_s});
+
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+
+    std::vector<std::jthread> readers;
+    for(int i{0}; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            while(!done.load()) {
+                if(pool.valueAt(StringPool::Domain::Genre, firstRef, 1) != u"Jazz"_s
+                   || !pool.contains(StringPool::Domain::Genre, firstRef, u"Rock"_s)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+
+    std::vector<StringPool::StringId> ids;
+    for(int i{0}; i < 5000; ++i) {
+        ids.push_back(pool.internId(StringPool::Domain::Genre, u"Genre %1"_s.arg(i)));
+    }
+
+    done = true;
+    readers.clear();
+
+    EXPECT_EQ(mismatches.load(), 0);
+    for(int i{0}; i < 5000; ++i) {
+        EXPECT_EQ(pool.resolve(StringPool::Domain::Genre, ids.at(i)), u"Genre %1"_s.arg(i));
+    }
+}
 } // namespace Fooyin::Testing
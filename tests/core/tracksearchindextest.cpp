@@ -0,0 +1,171 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/scripting/scriptparser.h>
+#include <core/track.h>
+#include <core/trackmetadatastore.h>
+#include <core/tracksearchindex.h>
+
+#include <gtest/gtest.h>
+
+using namespace Qt::StringLiterals;
+
+namespace Fooyin::Testing {
+namespace {
+Track makeTrack(const std::shared_ptr<TrackMetadataStore>& store, int id, const QString& title, const QString& artist,
+                const QString& album)
+{
+    Track track{u"/music/%1/%2.flac"_s.arg(artist, title), store};
+    track.setId(id);
+    track.setTitle(title);
+    track.setArtists({artist});
+    track.setAlbum(album);
+    return track;
+}
+
+TrackList makeTracks(const std::shared_ptr<TrackMetadataStore>& store)
+{
+    return {makeTrack(store, 1, u"Café del Mar"_s, u"Energy 52"_s, u"Trance Classics"_s),
+            makeTrack(store, 2, u"Ocean Drive"_s, u"Duke Dumont"_s, u"Blasé Boys Club"_s),
+            makeTrack(store, 3, u"Sea of Love"_s, u"Cat Power"_s, u"The Covers Record"_s)};
+}
+} // namespace
+
+TEST(TrackSearchIndexTest, MatchesFoldedTerms)
+{
+    auto store           = std::make_shared<TrackMetadataStore>();
+    const TrackList list = makeTracks(store);
+
+    TrackSearchIndex index;
+    index.rebuild(list);
+    EXPECT_EQ(index.size(), 3);
+
+    const auto query = index.prepare({u"CAFE"_s});
+    EXPECT_EQ(query.matches(list.at(0)), true);
+    EXPECT_EQ(query.matches(list.at(1)), false);
+
+    // Substrings within a token and terms spanning tokens
+    const auto partial = index.prepare({u"umon"_s});
+    EXPECT_EQ(partial.matches(list.at(1)), true);
+    const auto spanning = index.prepare({u"ocean dr"_s});
+    EXPECT_EQ(spanning.matches(list.at(1)), true);
+    EXPECT_EQ(spanning.matches(list.at(2)), false);
+
+    // All terms must match, but may come from different fields
+    const auto multiple = index.prepare({u"sea"_s, u"power"_s});
+    EXPECT_EQ(multiple.matches(list.at(2)), true);
+    EXPECT_EQ(multiple.matches(list.at(0)), false);
+
+    // Terms can't match across fields
+    const auto acrossFields = index.prepare({u"love cat"_s});
+    EXPECT_EQ(acrossFields.matches(list.at(2)), false);
+
+    Track unindexed{u"/music/other.flac"_s, store};
+    unindexed.setTitle(u"Café"_s);
+    EXPECT_EQ(query.matches(unindexed), std::nullopt);
+}
+
+TEST(TrackSearchIndexTest, AgreesWithTrackMatching)
+{
+    auto store           = std::make_shared<TrackMetadataStore>();
+    const TrackList list = makeTracks(store);
+
+    TrackSearchIndex index;
+    index.rebuild(list);
+
+    const QStringList terms{u"a"_s,       u"se"_s,     u"blase"_s,       u"BLASÉ"_s, u"music"_s,
+                            u"flac"_s,    u"52 tr"_s,  u"the covers"_s,  u"zzz"_s,   u"/music/cat"_s,
+                            u"drive"_s,   u"é"_s,      u"classics"_s,    u"mar"_s,   u"power/sea"_s};
+
+    for(const QString& term : terms) {
+        const auto query = index.prepare({term});
+        for(const Track& track : list) {
+            EXPECT_EQ(query.matches(track), track.hasMatch(term)) << term.toStdString();
+        }
+    }
+}
+
+TEST(TrackSearchIndexTest, UpdatesAndRemovesTracks)
+{
+    auto store     = std::make_shared<TrackMetadataStore>();
+    TrackList list = makeTracks(store);
+
+    TrackSearchIndex index;
+    index.rebuild(list);
+
+    list[0].setTitle(u"Sunrise"_s);
+    index.update({list.at(0)});
+
+    EXPECT_EQ(index.prepare({u"cafe"_s}).matches(list.at(0)), false);
+    EXPECT_EQ(index.prepare({u"sunrise"_s}).matches(list.at(0)), true);
+    EXPECT_EQ(index.prepare({u"energy"_s}).matches(list.at(0)), true);
+
+    // Queries prepared before an update still see the current text
+    const auto query = index.prepare({u"ocean"_s});
+    list[2].setTitle(u"Ocean of Love"_s);
+    index.update({list.at(2)});
+    EXPECT_EQ(query.matches(list.at(2)), true);
+
+    index.remove({list.at(1)});
+    EXPECT_EQ(index.size(), 2);
+    EXPECT_EQ(index.prepare({u"ocean"_s}).matches(list.at(1)), std::nullopt);
+
+    index.clear();
+    EXPECT_TRUE(index.isEmpty());
+}
+
+TEST(TrackSearchIndexTest, IgnoresEditsNotYetIndexed)
+{
+    auto store     = std::make_shared<TrackMetadataStore>();
+    TrackList list = makeTracks(store);
+    store->searchIndex().rebuild(list);
+
+    // The library publishes edited tracks before their index update lands
+    list[0].setTitle(u"Sunrise"_s);
+
+    EXPECT_EQ(store->searchIndex().prepare({u"cafe"_s}).matches(list.at(0)), std::nullopt);
+    EXPECT_EQ(store->searchIndex().prepare({u"sunrise"_s}).matches(list.at(0)), std::nullopt);
+    EXPECT_EQ(store->searchIndex().prepare({u"ocean"_s}).matches(list.at(1)), true);
+
+    ScriptParser parser;
+    EXPECT_EQ(parser.filter(u"sunrise"_s, list).size(), 1);
+    EXPECT_EQ(parser.filter(u"cafe"_s, list).size(), 0);
+
+    store->searchIndex().update({list.at(0)});
+    EXPECT_EQ(store->searchIndex().prepare({u"sunrise"_s}).matches(list.at(0)), true);
+}
+
+TEST(TrackSearchIndexTest, ParserUsesStoreIndex)
+{
+    auto store           = std::make_shared<TrackMetadataStore>();
+    const TrackList list = makeTracks(store);
+    store->searchIndex().rebuild(list);
+
+    ScriptParser parser;
+    EXPECT_EQ(parser.filter(u"cafe"_s, list).size(), 1);
+    EXPECT_EQ(parser.filter(u"sea power"_s, list).size(), 1);
+    EXPECT_EQ(parser.filter(u"\"sea power\""_s, list).size(), 0);
+    EXPECT_EQ(parser.filter(u"music"_s, list).size(), 3);
+
+    // Tracks missing from the index are still matched
+    TrackList withUnindexed{list};
+    withUnindexed.push_back(makeTrack(store, -1, u"Café Society"_s, u"Unknown"_s, u"Unknown"_s));
+    EXPECT_EQ(parser.filter(u"cafe"_s, withUnindexed).size(), 2);
+}
+} // namespace Fooyin::Testing
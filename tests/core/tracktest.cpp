@@ -305,4 +305,35 @@ TEST(TrackTest, CalculatesEffectiveReplayGainForOpusHeaderGain)
     EXPECT_FLOAT_EQ(track.rgTrackPeak(), 0.255842F);
     EXPECT_FLOAT_EQ(track.rgAlbumPeak(), 0.255842F);
 }
+
+TEST(TrackTest, TracksDirtyFieldsSinceLastSync)
+{
+    Track track{u"/music/track.flac"_s};
+    EXPECT_TRUE(track.dirtyFields().all());
+
+    track.clearDirtyFields();
+    EXPECT_TRUE(track.dirtyFields().none());
+
+    track.setRGTrackGain(-3.0F);
+    track.setTrackNumber(u"3/12"_s);
+    track.normaliseExtraProperties();
+
+    EXPECT_TRUE(track.isDirty(Track::Field::RGTrackGain));
+    EXPECT_TRUE(track.isDirty(Track::Field::TrackNumber));
+    EXPECT_TRUE(track.isDirty(Track::Field::TrackTotal));
+    EXPECT_FALSE(track.isDirty(Track::Field::ExtraTags));
+    EXPECT_FALSE(track.isDirty(Track::Field::ExtraProperties));
+    EXPECT_EQ(3U, track.dirtyFields().count());
+
+    // Copies detach, so changes stay local to the modified instance
+    Track copy{track};
+    copy.clearDirtyFields();
+    copy.replaceExtraTag(u"MOOD"_s, u"Calm"_s);
+    EXPECT_EQ(1U, copy.dirtyFields().count());
+    EXPECT_TRUE(copy.isDirty(Track::Field::ExtraTags));
+    EXPECT_EQ(3U, track.dirtyFields().count());
+
+    copy.markAllDirty();
+    EXPECT_TRUE(copy.dirtyFields().all());
+}
 } // namespace Fooyin::Testing
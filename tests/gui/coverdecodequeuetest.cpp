@@ -0,0 +1,189 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gui/coverdecodequeue.h>
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace Qt::StringLiterals;
+
+namespace Fooyin::Testing {
+class CoverDecodeQueueTest : public ::testing::Test
+{
+protected:
+    CoverDecodeQueue::Job record(const QString& key)
+    {
+        return [this, key]() {
+            const std::scoped_lock lock{m_mutex};
+            m_order.push_back(key);
+        };
+    }
+
+    // Occupies the only worker until release() is called
+    void block(CoverDecodeQueue& queue)
+    {
+        queue.enqueue(u"blocker"_s, 0, [gate = m_gate.get_future().share()]() { gate.wait(); });
+        while(!queue.isRunning(u"blocker"_s)) {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    void release()
+    {
+        m_gate.set_value();
+    }
+
+    std::vector<QString> order()
+    {
+        const std::scoped_lock lock{m_mutex};
+        return m_order;
+    }
+
+    std::promise<void> m_gate;
+    std::mutex m_mutex;
+    std::vector<QString> m_order;
+};
+
+TEST_F(CoverDecodeQueueTest, RunsLowestPriorityFirst)
+{
+    CoverDecodeQueue queue{1};
+    block(queue);
+
+    EXPECT_TRUE(queue.enqueue(u"far"_s, 5, record(u"far"_s)));
+    EXPECT_TRUE(queue.enqueue(u"visible"_s, 0, record(u"visible"_s)));
+    EXPECT_TRUE(queue.enqueue(u"near"_s, 2, record(u"near"_s)));
+    EXPECT_TRUE(queue.enqueue(u"visible2"_s, 0, record(u"visible2"_s)));
+
+    release();
+    queue.waitForDone();
+
+    const std::vector<QString> expected{u"visible"_s, u"visible2"_s, u"near"_s, u"far"_s};
+    EXPECT_EQ(expected, order());
+}
+
+TEST_F(CoverDecodeQueueTest, CoalescesRequestsForQueuedCovers)
+{
+    CoverDecodeQueue queue{1};
+    block(queue);
+
+    EXPECT_TRUE(queue.enqueue(u"near"_s, 2, record(u"near"_s)));
+    EXPECT_TRUE(queue.enqueue(u"cover"_s, 5, record(u"cover"_s)));
+    // Now visible, so it should overtake the other job
+    EXPECT_FALSE(queue.enqueue(u"cover"_s, 0, record(u"duplicate"_s)));
+    EXPECT_TRUE(queue.coalesce(u"cover"_s, 1));
+    EXPECT_FALSE(queue.coalesce(u"missing"_s, 0));
+    EXPECT_EQ(2, queue.queuedCount());
+
+    release();
+    queue.waitForDone();
+
+    const std::vector<QString> expected{u"cover"_s, u"near"_s};
+    EXPECT_EQ(expected, order());
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(3U, stats.queued);
+    EXPECT_EQ(2U, stats.coalesced);
+    EXPECT_EQ(3U, stats.decoded);
+}
+
+TEST_F(CoverDecodeQueueTest, CoalescesIntoRunningJobs)
+{
+    CoverDecodeQueue queue{1};
+    block(queue);
+
+    EXPECT_TRUE(queue.coalesce(u"blocker"_s, 0));
+    // A new request once a job has started is queued again, as the result may already be on its way
+    EXPECT_TRUE(queue.enqueue(u"blocker"_s, 0, record(u"blocker"_s)));
+
+    release();
+    queue.waitForDone();
+
+    const std::vector<QString> expected{u"blocker"_s};
+    EXPECT_EQ(expected, order());
+}
+
+TEST_F(CoverDecodeQueueTest, CancelsJobsWhichHaveNotStarted)
+{
+    CoverDecodeQueue queue{1};
+    block(queue);
+
+    EXPECT_TRUE(queue.enqueue(u"stale"_s, 0, record(u"stale"_s)));
+    EXPECT_TRUE(queue.enqueue(u"current"_s, 1, record(u"current"_s)));
+
+    EXPECT_TRUE(queue.cancel(u"stale"_s));
+    EXPECT_FALSE(queue.cancel(u"stale"_s));
+    EXPECT_FALSE(queue.cancel(u"blocker"_s));
+    EXPECT_FALSE(queue.isQueued(u"stale"_s));
+
+    release();
+    queue.waitForDone();
+
+    const std::vector<QString> expected{u"current"_s};
+    EXPECT_EQ(expected, order());
+    EXPECT_EQ(1U, queue.stats().cancelled);
+}
+
+TEST_F(CoverDecodeQueueTest, LimitsConcurrentJobs)
+{
+    CoverDecodeQueue queue{2};
+
+    std::atomic_int running{0};
+    std::atomic_int maxRunning{0};
+
+    for(int i{0}; i < 8; ++i) {
+        queue.enqueue(QString::number(i), i, [&running, &maxRunning]() {
+            const int now = ++running;
+            int seen      = maxRunning.load();
+            while(now > seen && !maxRunning.compare_exchange_weak(seen, now)) { }
+            QThread::msleep(5);
+            --running;
+        });
+    }
+
+    queue.waitForDone();
+
+    EXPECT_LE(maxRunning.load(), 2);
+    EXPECT_EQ(8U, queue.stats().decoded);
+}
+
+TEST_F(CoverDecodeQueueTest, ReportsHitRate)
+{
+    CoverDecodeQueue queue{1};
+
+    EXPECT_DOUBLE_EQ(0.0, queue.stats().hitRate());
+
+    queue.recordHit();
+    queue.recordHit();
+    queue.recordHit();
+    queue.enqueue(u"miss"_s, 0, {});
+    queue.waitForDone();
+
+    EXPECT_DOUBLE_EQ(0.75, queue.stats().hitRate());
+
+    queue.resetStats();
+    EXPECT_EQ(0U, queue.stats().hits);
+}
+} // namespace Fooyin::Testing
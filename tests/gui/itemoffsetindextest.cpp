@@ -0,0 +1,110 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gui/widgets/itemoffsetindex.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace Fooyin::Testing {
+namespace {
+std::vector<int> prefixSums(const std::vector<int>& extents)
+{
+    std::vector<int> offsets(extents.size() + 1, 0);
+    for(size_t i{0}; i < extents.size(); ++i) {
+        offsets[i + 1] = offsets[i] + extents[i];
+    }
+    return offsets;
+}
+
+void expectMatchesPrefixSums(const ItemOffsetIndex& index, const std::vector<int>& extents)
+{
+    const std::vector<int> offsets = prefixSums(extents);
+
+    ASSERT_EQ(static_cast<int>(extents.size()), index.size());
+    EXPECT_EQ(offsets.back(), index.totalExtent());
+
+    for(size_t item{0}; item < offsets.size(); ++item) {
+        EXPECT_EQ(offsets[item], index.offset(static_cast<int>(item)));
+    }
+
+    for(int offset{-1}; offset <= offsets.back(); ++offset) {
+        const auto it    = std::ranges::upper_bound(offsets, offset);
+        const int expect = (it == offsets.cbegin() || it == offsets.cend())
+                             ? -1
+                             : static_cast<int>(std::ranges::distance(offsets.cbegin(), it)) - 1;
+        EXPECT_EQ(expect, index.itemAt(offset)) << "offset " << offset;
+    }
+}
+} // namespace
+
+TEST(ItemOffsetIndexTest, MapsOffsetsToItemsSkippingEmptyRows)
+{
+    const ItemOffsetIndex index{{20, 0, 0, 30, 10}};
+
+    EXPECT_EQ(0, index.itemAt(0));
+    EXPECT_EQ(0, index.itemAt(19));
+    EXPECT_EQ(3, index.itemAt(20));
+    EXPECT_EQ(3, index.itemAt(49));
+    EXPECT_EQ(4, index.itemAt(50));
+    EXPECT_EQ(-1, index.itemAt(60));
+    EXPECT_EQ(-1, index.itemAt(-1));
+
+    EXPECT_EQ(20, index.offset(3));
+    EXPECT_EQ(60, index.offset(10));
+}
+
+TEST(ItemOffsetIndexTest, UpdatesMatchRebuiltPrefixSums)
+{
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> extentDist{0, 40};
+
+    std::vector<int> extents(257);
+    std::ranges::generate(extents, [&]() { return extentDist(rng); });
+
+    ItemOffsetIndex index{extents};
+    expectMatchesPrefixSums(index, extents);
+
+    for(int i{0}; i < 50; ++i) {
+        const int item   = static_cast<int>(rng() % extents.size());
+        const int extent = extentDist(rng);
+        extents[item]    = extent;
+        index.setExtent(item, extent);
+    }
+    expectMatchesPrefixSums(index, extents);
+
+    index.insert(10, 5, 12);
+    extents.insert(extents.begin() + 10, 5, 12);
+    expectMatchesPrefixSums(index, extents);
+
+    index.insert(index.size(), 7, 3);
+    extents.insert(extents.end(), 7, 3);
+    expectMatchesPrefixSums(index, extents);
+
+    index.remove(100, 20);
+    extents.erase(extents.begin() + 100, extents.begin() + 120);
+    expectMatchesPrefixSums(index, extents);
+
+    index.clear();
+    index.insert(0, 3, 5);
+    expectMatchesPrefixSums(index, {5, 5, 5});
+}
+} // namespace Fooyin::Testing
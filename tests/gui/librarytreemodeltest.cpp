@@ -0,0 +1,187 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/librarytree/librarytreemodel.h"
+
+#include "core/internalcoresettings.h"
+#include "gui/internalguisettings.h"
+
+#include <core/coresettings.h>
+#include <core/engine/audioloader.h>
+#include <core/track.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QApplication>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& album, const QString& date)
+{
+    Fooyin::Track track{u"/tmp/librarytree/%1.flac"_s.arg(id), 0};
+    track.setId(id);
+    track.setAlbum(album);
+    track.setDate(date);
+    track.generateHash();
+    return track;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibraryTreeModelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_NE(nullptr, qApp);
+        ASSERT_TRUE(m_settingsDir.isValid());
+
+        m_settings     = std::make_unique<SettingsManager>(m_settingsDir.filePath(u"settings.ini"_s));
+        m_coreSettings = std::make_unique<CoreSettings>(m_settings.get());
+        m_guiSettings  = std::make_unique<GuiSettings>(m_settings.get());
+        m_model        = std::make_unique<LibraryTreeModel>(nullptr, std::make_shared<AudioLoader>(), m_settings.get());
+
+        m_model->setSummaryNodeConfig(false, {});
+        m_model->changeGrouping(
+            {.id = 0, .index = 0, .name = u"Album"_s, .script = u"%album%"_s, .sortScript = u"%date%"_s});
+    }
+
+    void reset(const TrackList& tracks)
+    {
+        QSignalSpy loadedSpy{m_model.get(), &LibraryTreeModel::modelLoaded};
+        m_model->reset(tracks);
+        ASSERT_TRUE(loadedSpy.wait(5000));
+    }
+
+    void update(const TrackList& tracks)
+    {
+        QSignalSpy updatedSpy{m_model.get(), &LibraryTreeModel::modelUpdated};
+        m_model->updateTracks(tracks);
+        ASSERT_TRUE(updatedSpy.count() > 0 || updatedSpy.wait(5000));
+    }
+
+    LibraryTreeItem* node(const QString& title) const
+    {
+        for(int row{0}; row < m_model->rowCount({}); ++row) {
+            auto* item = m_model->itemForIndex(m_model->index(row, 0, {}));
+            if(item && item->title() == title) {
+                return item;
+            }
+        }
+        return nullptr;
+    }
+
+    QTemporaryDir m_settingsDir;
+    std::unique_ptr<SettingsManager> m_settings;
+    std::unique_ptr<CoreSettings> m_coreSettings;
+    std::unique_ptr<GuiSettings> m_guiSettings;
+    std::unique_ptr<LibraryTreeModel> m_model;
+};
+
+TEST_F(LibraryTreeModelTest, KeptTracksStayInPlaceAndUpdateSortTitle)
+{
+    const Track first  = makeTrack(1, u"A"_s, u"2000"_s);
+    const Track second = makeTrack(2, u"A"_s, u"2000"_s);
+    reset({first, second});
+
+    LibraryTreeItem* album = node(u"A"_s);
+    ASSERT_NE(nullptr, album);
+    EXPECT_EQ(u"2000"_s, album->sortTitle());
+
+    Track editedFirst{first};
+    editedFirst.setDate(u"1990"_s);
+    Track editedSecond{second};
+    editedSecond.setDate(u"1990"_s);
+    update({editedFirst, editedSecond});
+
+    // Same node, no tracks added twice, but the new sort field is applied
+    EXPECT_EQ(album, node(u"A"_s));
+    EXPECT_EQ(2, album->trackCount());
+    EXPECT_EQ(u"1990"_s, album->sortTitle());
+    EXPECT_EQ(1, m_model->rowCount({}));
+}
+
+TEST_F(LibraryTreeModelTest, MovedTrackPrunesEmptyNode)
+{
+    const Track first  = makeTrack(1, u"A"_s, u"2000"_s);
+    const Track second = makeTrack(2, u"B"_s, u"2000"_s);
+    reset({first, second});
+    ASSERT_NE(nullptr, node(u"B"_s));
+
+    Track moved{second};
+    moved.setAlbum(u"A"_s);
+    update({moved});
+
+    EXPECT_EQ(nullptr, node(u"B"_s));
+    LibraryTreeItem* album = node(u"A"_s);
+    ASSERT_NE(nullptr, album);
+    EXPECT_EQ(2, album->trackCount());
+    EXPECT_EQ(1, m_model->rowCount({}));
+}
+
+TEST_F(LibraryTreeModelTest, MovedTrackKeepsNonEmptyNode)
+{
+    const Track first  = makeTrack(1, u"A"_s, u"2000"_s);
+    const Track second = makeTrack(2, u"A"_s, u"2000"_s);
+    reset({first, second});
+
+    Track moved{second};
+    moved.setAlbum(u"B"_s);
+    update({moved});
+
+    LibraryTreeItem* album = node(u"A"_s);
+    ASSERT_NE(nullptr, album);
+    EXPECT_EQ(1, album->trackCount());
+
+    LibraryTreeItem* newAlbum = node(u"B"_s);
+    ASSERT_NE(nullptr, newAlbum);
+    EXPECT_EQ(1, newAlbum->trackCount());
+    EXPECT_EQ(2, m_model->rowCount({}));
+}
+
+TEST_F(LibraryTreeModelTest, UngroupedTrackIsRemovedFromNodes)
+{
+    const Track first  = makeTrack(1, u"A"_s, u"2000"_s);
+    const Track second = makeTrack(2, u"B"_s, u"2000"_s);
+    reset({first, second});
+
+    Track ungrouped{second};
+    ungrouped.setAlbum({});
+    update({ungrouped});
+
+    EXPECT_EQ(nullptr, node(u"B"_s));
+    ASSERT_NE(nullptr, node(u"A"_s));
+    EXPECT_EQ(1, m_model->rowCount({}));
+}
+} // namespace Fooyin::Testing
+
+int main(int argc, char** argv)
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
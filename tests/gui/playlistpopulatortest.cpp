@@ -0,0 +1,176 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/playlist/playlistpopulator.h"
+#include "gui/playlist/playlistpreset.h"
+
+#include <core/coresettings.h>
+#include <core/player/playercontroller.h>
+#include <core/track.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QApplication>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+constexpr auto TrackCount = 250;
+
+void registerControllerSettings(Fooyin::SettingsManager& settings)
+{
+    using namespace Fooyin;
+
+    settings.createSetting<Settings::Core::PlayMode>(0, QString::fromLatin1(Settings::Core::PlayModeKey));
+    settings.createSetting<Settings::Core::StopAfterCurrent>(false, u"Playback/StopAfterCurrent"_s);
+    settings.createSetting<Settings::Core::ResetStopAfterCurrent>(false, u"Playback/ResetStopAfterCurrent"_s);
+    settings.createSetting<Settings::Core::PlayedThreshold>(0.5, u"Playback/PlayedThreshold"_s);
+    settings.createSetting<Settings::Core::RewindPreviousTrack>(false, u"Playlist/RewindPreviousTrack"_s);
+    settings.createSetting<Settings::Core::PlaybackQueueStopWhenFinished>(false,
+                                                                          u"Playback/PlaybackQueueStopWhenFinished"_s);
+    settings.createSetting<Settings::Core::FollowPlaybackQueue>(false, u"Playback/FollowPlaybackQueue"_s);
+    settings.createSetting<Settings::Core::ShuffleAlbumsGroupScript>(u"%album%"_s,
+                                                                     u"Playback/ShuffleAlbumsGroupScript"_s);
+    settings.createSetting<Settings::Core::ShuffleAlbumsSortScript>(u"%track%"_s,
+                                                                    u"Playback/ShuffleAlbumsSortScript"_s);
+    settings.createTempSetting<Settings::Core::ActiveTrack>(QVariant{});
+    settings.createTempSetting<Settings::Core::ActiveTrackId>(-2);
+}
+
+Fooyin::PlaylistTrackList makeTracks()
+{
+    Fooyin::PlaylistTrackList tracks;
+    for(int i{0}; i < TrackCount; ++i) {
+        Fooyin::Track track{u"/tmp/populator/%1.flac"_s.arg(i), 0};
+        track.setId(i + 1);
+        track.setTitle(u"Title %1"_s.arg(i));
+        track.generateHash();
+        tracks.push_back({.track = track, .playlistId = {}, .entryId = Fooyin::UId::create(), .indexInPlaylist = i});
+    }
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class PlaylistPopulatorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_NE(nullptr, qApp);
+        ASSERT_TRUE(m_settingsDir.isValid());
+
+        m_settings = std::make_unique<SettingsManager>(m_settingsDir.filePath(u"settings.ini"_s));
+        registerControllerSettings(*m_settings);
+        m_playerController = std::make_unique<PlayerController>(m_settings.get(), nullptr);
+        m_populator        = std::make_unique<PlaylistPopulator>(m_playerController.get(), m_settings.get());
+
+        m_preset.id              = 0;
+        m_preset.name            = u"Test"_s;
+        m_preset.track.leftText  = {.script = u"%title%"_s, .text = {}};
+        m_preset.track.rightText = {.script = u"%track%"_s, .text = {}};
+    }
+
+    //! Populates all tracks and returns the track rows ordered by playlist index.
+    std::vector<PlaylistItem> populate(const PlaylistTrackList& tracks)
+    {
+        QSignalSpy populatedSpy{m_populator.get(), &PlaylistPopulator::populated};
+        m_populator->run(nullptr, m_preset, {}, tracks);
+
+        std::vector<PlaylistItem> rows(tracks.size());
+        for(const auto& args : populatedSpy) {
+            const auto data = args.constFirst().value<PendingData>();
+            for(const auto& [key, item] : data.items) {
+                if(item.type() == PlaylistItem::Track) {
+                    rows.at(std::get<0>(item.data()).track().indexInPlaylist) = item;
+                }
+            }
+        }
+        return rows;
+    }
+
+    QTemporaryDir m_settingsDir;
+    std::unique_ptr<SettingsManager> m_settings;
+    std::unique_ptr<PlayerController> m_playerController;
+    std::unique_ptr<PlaylistPopulator> m_populator;
+    PlaylistPreset m_preset;
+};
+
+TEST_F(PlaylistPopulatorTest, EvaluatesAllRowsWithoutLazyRows)
+{
+    const auto rows = populate(makeTracks());
+
+    for(const auto& row : rows) {
+        const auto& trackItem = std::get<0>(row.data());
+        EXPECT_FALSE(trackItem.isPending());
+        EXPECT_FALSE(trackItem.left().empty());
+    }
+}
+
+TEST_F(PlaylistPopulatorTest, PendingRowsAreRealisedWithStableSizes)
+{
+    m_populator->setLazyRows(true);
+
+    const auto tracks = makeTracks();
+    const auto rows   = populate(tracks);
+
+    const auto& lastEvaluated = std::get<0>(rows.at(199).data());
+    ASSERT_FALSE(lastEvaluated.isPending());
+    const QSize evaluatedSize = lastEvaluated.size();
+    ASSERT_TRUE(evaluatedSize.isValid());
+
+    TrackItemMap pendingRows;
+    for(size_t i{200}; i < rows.size(); ++i) {
+        const auto& trackItem = std::get<0>(rows.at(i).data());
+        EXPECT_TRUE(trackItem.isPending());
+        EXPECT_TRUE(trackItem.left().empty());
+        // Sized like an evaluated row rather than from empty text
+        EXPECT_EQ(evaluatedSize, trackItem.size());
+        pendingRows.emplace(tracks.at(i), rows.at(i));
+    }
+
+    QSignalSpy updatedSpy{m_populator.get(), &PlaylistPopulator::tracksUpdated};
+    m_populator->updateTracks(nullptr, m_preset, {}, {}, pendingRows);
+    ASSERT_EQ(1, updatedSpy.count());
+
+    const auto updated = updatedSpy.constFirst().constFirst().value<ItemList>();
+    ASSERT_EQ(pendingRows.size(), updated.size());
+
+    for(const auto& row : updated) {
+        const auto& trackItem = std::get<0>(row.data());
+        EXPECT_FALSE(trackItem.isPending());
+        EXPECT_EQ(u"Title %1"_s.arg(trackItem.track().indexInPlaylist), trackItem.left().joinedText());
+        EXPECT_EQ(evaluatedSize.height(), trackItem.size().height());
+    }
+}
+} // namespace Fooyin::Testing
+
+int main(int argc, char** argv)
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,279 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gui/thumbnailstore.h>
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QImageWriter>
+#include <QTemporaryDir>
+
+#include <thread>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+QImage makeImage(int size, QRgb colour)
+{
+    QImage image{size, size, QImage::Format_ARGB32_Premultiplied};
+    image.fill(colour);
+    image.setPixel(0, 0, qRgb(1, 2, 3));
+    return image;
+}
+
+QString segmentPath(const QString& directory)
+{
+    const QStringList segments = QDir{directory}.entryList({u"segment-*.dat"_s}, QDir::Files, QDir::Name);
+    return segments.empty() ? QString{} : directory + u"/"_s + segments.constLast();
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class ThumbnailStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_path = m_tempDir.filePath(u"thumbnails"_s);
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_path;
+};
+
+TEST_F(ThumbnailStoreTest, StoresSmallThumbnailsUndecoded)
+{
+    ThumbnailStore store{m_path};
+
+    const QImage image = makeImage(64, qRgb(200, 100, 50));
+    ASSERT_TRUE(store.insert(u"key"_s, 64, image));
+
+    EXPECT_TRUE(store.contains(u"key"_s, 64));
+    EXPECT_FALSE(store.contains(u"key"_s, 128));
+    EXPECT_EQ(image, store.image(u"key"_s, 64));
+    EXPECT_TRUE(store.image(u"key"_s, 128).isNull());
+}
+
+TEST_F(ThumbnailStoreTest, StoresLargeThumbnailsAsJpeg)
+{
+    if(!QImageWriter::supportedImageFormats().contains("jpg")) {
+        GTEST_SKIP() << "JPEG support is unavailable";
+    }
+
+    ThumbnailStore store{m_path};
+
+    const QImage image = makeImage(512, qRgb(200, 100, 50));
+    ASSERT_TRUE(store.insert(u"key"_s, ThumbnailStore::SourceClass, image));
+
+    const QImage stored = store.image(u"key"_s, ThumbnailStore::SourceClass);
+    EXPECT_EQ(image.size(), stored.size());
+    // Far smaller than the raw pixels
+    EXPECT_LT(store.size(), 512U * 512U);
+}
+
+TEST_F(ThumbnailStoreTest, ReturnsBatchLookupsInRequestOrder)
+{
+    ThumbnailStore store{m_path};
+
+    const QImage first  = makeImage(32, qRgb(255, 0, 0));
+    const QImage second = makeImage(32, qRgb(0, 255, 0));
+    ASSERT_TRUE(store.insert(u"second"_s, 32, second));
+    ASSERT_TRUE(store.insert(u"first"_s, 32, first));
+
+    const auto images = store.images({{u"first"_s, 32}, {u"missing"_s, 32}, {u"second"_s, 32}});
+
+    ASSERT_EQ(3U, images.size());
+    EXPECT_EQ(first, images.at(0));
+    EXPECT_TRUE(images.at(1).isNull());
+    EXPECT_EQ(second, images.at(2));
+}
+
+TEST_F(ThumbnailStoreTest, ReplacesExistingThumbnail)
+{
+    ThumbnailStore store{m_path};
+
+    ASSERT_TRUE(store.insert(u"key"_s, 32, makeImage(32, qRgb(255, 0, 0))));
+    const QImage replacement = makeImage(32, qRgb(0, 0, 255));
+    ASSERT_TRUE(store.insert(u"key"_s, 32, replacement));
+
+    EXPECT_EQ(1, store.count());
+    EXPECT_EQ(replacement, store.image(u"key"_s, 32));
+    EXPECT_GT(store.diskSize(), store.size());
+}
+
+TEST_F(ThumbnailStoreTest, RemovesAllSizeClasses)
+{
+    ThumbnailStore store{m_path};
+
+    ASSERT_TRUE(store.insert(u"key"_s, 32, makeImage(32, qRgb(255, 0, 0))));
+    ASSERT_TRUE(store.insert(u"key"_s, 64, makeImage(64, qRgb(255, 0, 0))));
+    ASSERT_TRUE(store.insert(u"other"_s, 32, makeImage(32, qRgb(0, 255, 0))));
+
+    store.remove(u"key"_s);
+
+    EXPECT_FALSE(store.contains(u"key"_s, 32));
+    EXPECT_FALSE(store.contains(u"key"_s, 64));
+    EXPECT_TRUE(store.contains(u"other"_s, 32));
+    EXPECT_EQ(1, store.count());
+}
+
+TEST_F(ThumbnailStoreTest, PersistsAcrossReopen)
+{
+    const QImage image = makeImage(32, qRgb(10, 20, 30));
+    {
+        ThumbnailStore store{m_path};
+        ASSERT_TRUE(store.insert(u"key"_s, 32, image));
+    }
+
+    const ThumbnailStore store{m_path};
+    EXPECT_EQ(1, store.count());
+    EXPECT_EQ(image, store.image(u"key"_s, 32));
+}
+
+TEST_F(ThumbnailStoreTest, RebuildsIndexFromSegments)
+{
+    const QImage image = makeImage(32, qRgb(10, 20, 30));
+    {
+        ThumbnailStore store{m_path};
+        ASSERT_TRUE(store.insert(u"kept"_s, 32, image));
+        ASSERT_TRUE(store.insert(u"removed"_s, 32, image));
+        store.remove(u"removed"_s);
+    }
+
+    ASSERT_TRUE(QFile::remove(m_path + u"/index.dat"_s));
+
+    const ThumbnailStore store{m_path};
+    EXPECT_EQ(1, store.count());
+    EXPECT_EQ(image, store.image(u"kept"_s, 32));
+    EXPECT_FALSE(store.contains(u"removed"_s, 32));
+}
+
+TEST_F(ThumbnailStoreTest, DiscardsPartiallyWrittenRecords)
+{
+    const QImage image = makeImage(32, qRgb(10, 20, 30));
+    uint64_t diskSize{0};
+    {
+        ThumbnailStore store{m_path};
+        ASSERT_TRUE(store.insert(u"key"_s, 32, image));
+        diskSize = store.diskSize();
+    }
+
+    QFile segment{segmentPath(m_path)};
+    ASSERT_TRUE(segment.open(QIODevice::Append));
+    segment.write("FYTH-truncated");
+    segment.close();
+    ASSERT_TRUE(QFile::remove(m_path + u"/index.dat"_s));
+
+    ThumbnailStore store{m_path};
+    EXPECT_EQ(diskSize, store.diskSize());
+    EXPECT_EQ(image, store.image(u"key"_s, 32));
+
+    ASSERT_TRUE(store.insert(u"next"_s, 32, image));
+    EXPECT_EQ(image, store.image(u"next"_s, 32));
+}
+
+TEST_F(ThumbnailStoreTest, EvictsLeastRecentlyUsed)
+{
+    const QImage image = makeImage(32, qRgb(10, 20, 30));
+
+    ThumbnailStore store{m_path};
+    ASSERT_TRUE(store.insert(u"first"_s, 32, image));
+    ASSERT_TRUE(store.insert(u"second"_s, 32, image));
+
+    // Touch the older thumbnail so the newer one is least recently used
+    EXPECT_FALSE(store.image(u"first"_s, 32).isNull());
+
+    // Room for two thumbnails, so the third evicts one
+    store.setMaxSize(store.size() * 7 / 5);
+    ASSERT_TRUE(store.insert(u"third"_s, 32, image));
+
+    EXPECT_TRUE(store.contains(u"first"_s, 32));
+    EXPECT_FALSE(store.contains(u"second"_s, 32));
+    EXPECT_TRUE(store.contains(u"third"_s, 32));
+    EXPECT_LE(store.size(), store.maxSize());
+}
+
+TEST_F(ThumbnailStoreTest, CompactionReclaimsDeadRecords)
+{
+    {
+        ThumbnailStore store{m_path};
+        for(int i{0}; i < 8; ++i) {
+            ASSERT_TRUE(store.insert(u"replaced"_s, 32, makeImage(32, qRgb(i, i, i))));
+        }
+        ASSERT_TRUE(store.insert(u"removed"_s, 32, makeImage(32, qRgb(0, 0, 0))));
+        store.remove(u"removed"_s);
+
+        store.compact(true);
+
+        EXPECT_EQ(store.size(), store.diskSize());
+        EXPECT_EQ(1, store.count());
+    }
+
+    const ThumbnailStore store{m_path};
+    EXPECT_EQ(store.size(), store.diskSize());
+    EXPECT_EQ(makeImage(32, qRgb(7, 7, 7)), store.image(u"replaced"_s, 32));
+    EXPECT_FALSE(store.contains(u"removed"_s, 32));
+}
+
+TEST_F(ThumbnailStoreTest, KeepsInsertsMadeDuringCompaction)
+{
+    ThumbnailStore store{m_path};
+    for(int i{0}; i < 64; ++i) {
+        ASSERT_TRUE(store.insert(u"replaced"_s, 32, makeImage(32, qRgb(i, i, i))));
+        ASSERT_TRUE(store.insert(u"old%1"_s.arg(i), 32, makeImage(32, qRgb(0, 0, i))));
+    }
+
+    std::thread inserter{[&store]() {
+        for(int i{0}; i < 64; ++i) {
+            store.insert(u"new%1"_s.arg(i), 32, makeImage(32, qRgb(i, 0, 0)));
+        }
+    }};
+    store.compact(true);
+    inserter.join();
+
+    EXPECT_EQ(129, store.count());
+    for(int i{0}; i < 64; ++i) {
+        EXPECT_EQ(makeImage(32, qRgb(0, 0, i)), store.image(u"old%1"_s.arg(i), 32));
+        EXPECT_EQ(makeImage(32, qRgb(i, 0, 0)), store.image(u"new%1"_s.arg(i), 32));
+    }
+
+    // Nothing live is counted as dead, so a second pass leaves only live records
+    store.compact(true);
+    EXPECT_EQ(store.size(), store.diskSize());
+}
+
+TEST_F(ThumbnailStoreTest, ClearRemovesEverything)
+{
+    ThumbnailStore store{m_path};
+    ASSERT_TRUE(store.insert(u"key"_s, 32, makeImage(32, qRgb(10, 20, 30))));
+
+    store.clear();
+
+    EXPECT_EQ(0, store.count());
+    EXPECT_EQ(0U, store.diskSize());
+    EXPECT_TRUE(segmentPath(m_path).isEmpty());
+
+    ASSERT_TRUE(store.insert(u"key"_s, 32, makeImage(32, qRgb(10, 20, 30))));
+    EXPECT_EQ(1, store.count());
+}
+} // namespace Fooyin::Testing
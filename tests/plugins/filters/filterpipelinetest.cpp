@@ -17,6 +17,7 @@
  *
  */
 
+#include "plugins/filters/filterfacetindex.h"
 #include "plugins/filters/filterpipeline.h"
 #include "plugins/filters/filterrows.h"
 
@@ -428,4 +429,185 @@ TEST(FilterPipelineTest, RunFilterPipelineChainsMultipleActiveStagesLeftToRight)
     ASSERT_EQ(1, result.finalFilteredTracks.size());
     EXPECT_EQ(2, result.finalFilteredTracks.front().id());
 }
+
+TEST(FilterPipelineTest, TrackIdSetIntersectsAndUnitesAcrossWords)
+{
+    Filters::TrackIdSet left{TrackIds{1, 5, 64, 130, 1000}};
+    const Filters::TrackIdSet right{TrackIds{5, 65, 130, 999, 1000}};
+
+    EXPECT_EQ(TrackIds({5, 130, 1000}), left.intersected(right).ids());
+    EXPECT_EQ(TrackIds({5, 130, 1000}), right.intersected(left).ids());
+
+    left.remove(64);
+    left.insert(2);
+    left.unite(right);
+
+    EXPECT_EQ(TrackIds({1, 2, 5, 65, 130, 999, 1000}), left.ids());
+    EXPECT_EQ(7, left.count());
+    EXPECT_TRUE(left.contains(999));
+    EXPECT_FALSE(left.contains(64));
+    EXPECT_FALSE(left.contains(-1));
+}
+
+TEST(FilterPipelineTest, FacetIndexBuildsRowsForSubsetsAndUpdatesIncrementally)
+{
+    const auto makeGenreTrack = [](int id, const QString& genre) {
+        Track track{u"/music/%1.flac"_s.arg(id)};
+        track.setId(id);
+        track.setLibraryId(1);
+        track.setGenres({genre});
+        return track;
+    };
+
+    TrackList tracks{
+        makeGenreTrack(1, u"Rock"_s),
+        makeGenreTrack(2, u"Jazz"_s),
+        makeGenreTrack(3, u"Rock"_s),
+        makeGenreTrack(70, u"Rock"_s),
+    };
+
+    const Filters::FilterColumnList columns{{.id = 0, .name = u"Genre"_s, .field = u"%<genre>%"_s}};
+    const Filters::FilterRowBuildContext context{
+        .font          = {},
+        .ratingSymbols = {u"*"_s, u"/"_s, u"-"_s},
+        .useVarious    = false,
+    };
+
+    Filters::FilterFacetIndex index{nullptr, columns, context};
+    index.build(tracks);
+
+    EXPECT_TRUE(index.isCompatible(columns, context));
+    EXPECT_FALSE(index.isCompatible({{.id = 0, .name = u"Artist"_s, .field = u"%<artist>%"_s}}, context));
+
+    const Filters::FilterRowList builtRows   = Filters::buildFilterRows(nullptr, columns, tracks, context);
+    const Filters::FilterRowList indexedRows = index.rows(tracks);
+    ASSERT_EQ(2, indexedRows.size());
+    ASSERT_EQ(builtRows.size(), indexedRows.size());
+    for(size_t i{0}; i < indexedRows.size(); ++i) {
+        EXPECT_EQ(builtRows.at(i).key, indexedRows.at(i).key);
+        EXPECT_EQ(builtRows.at(i).trackIds, indexedRows.at(i).trackIds);
+    }
+
+    const Filters::FilterRowList subsetRows = index.rows({tracks.at(3), tracks.at(2)});
+    ASSERT_EQ(1, subsetRows.size());
+    EXPECT_EQ(QStringList{u"Rock"_s}, subsetRows.at(0).columns);
+    EXPECT_EQ(TrackIds({70, 3}), subsetRows.at(0).trackIds);
+
+    const Filters::RowKey rockKey = subsetRows.at(0).key;
+    EXPECT_EQ(TrackIds({1, 3, 70}), index.tracksFor({rockKey}).ids());
+
+    tracks[0] = makeGenreTrack(1, u"Jazz"_s);
+    tracks.erase(tracks.begin() + 2);
+    index.update(tracks, {1, 3});
+
+    EXPECT_EQ(TrackIds({70}), index.tracksFor({rockKey}).ids());
+
+    const Filters::FilterRowList rows = index.rows(tracks);
+    ASSERT_EQ(2, rows.size());
+    for(const Filters::FilterRow& row : rows) {
+        if(row.key == rockKey) {
+            EXPECT_EQ(TrackIds({70}), row.trackIds);
+        }
+        else {
+            EXPECT_EQ(QStringList{u"Jazz"_s}, row.columns);
+            EXPECT_EQ(TrackIds({1, 2}), row.trackIds);
+        }
+    }
+}
+
+TEST(FilterPipelineTest, FacetIndexUpdatedCopyLeavesSourceUnchanged)
+{
+    const auto makeGenreTrack = [](int id, const QString& genre) {
+        Track track{u"/music/%1.flac"_s.arg(id)};
+        track.setId(id);
+        track.setLibraryId(1);
+        track.setGenres({genre});
+        return track;
+    };
+
+    TrackList tracks{
+        makeGenreTrack(1, u"Rock"_s),
+        makeGenreTrack(2, u"Jazz"_s),
+        makeGenreTrack(3, u"Pop"_s),
+    };
+
+    const Filters::FilterColumnList columns{{.id = 0, .name = u"Genre"_s, .field = u"%<genre>%"_s}};
+    const Filters::FilterRowBuildContext context{
+        .font          = {},
+        .ratingSymbols = {u"*"_s, u"/"_s, u"-"_s},
+        .useVarious    = false,
+    };
+
+    Filters::FilterFacetIndex index{nullptr, columns, context};
+    index.build(tracks);
+
+    const Filters::FilterRowList sourceRows = index.rows(tracks);
+    ASSERT_EQ(3, sourceRows.size());
+
+    tracks[0] = makeGenreTrack(1, u"Jazz"_s);
+    const auto updated = index.updated(tracks, {1});
+
+    // The source keeps serving its old rows while the copy reflects the change
+    const Filters::FilterRowList unchangedRows = index.rows(tracks);
+    ASSERT_EQ(sourceRows.size(), unchangedRows.size());
+    for(size_t i{0}; i < sourceRows.size(); ++i) {
+        EXPECT_EQ(sourceRows.at(i).key, unchangedRows.at(i).key);
+        EXPECT_EQ(sourceRows.at(i).trackIds, unchangedRows.at(i).trackIds);
+    }
+
+    const Filters::FilterRowList updatedRows = updated->rows(tracks);
+    ASSERT_EQ(2, updatedRows.size());
+    for(const Filters::FilterRow& row : updatedRows) {
+        if(row.columns == QStringList{u"Jazz"_s}) {
+            EXPECT_EQ(TrackIds({1, 2}), row.trackIds);
+        }
+        else {
+            EXPECT_EQ(QStringList{u"Pop"_s}, row.columns);
+            EXPECT_EQ(TrackIds({3}), row.trackIds);
+        }
+    }
+}
+
+TEST(FilterPipelineTest, FacetIndexErasesEmptyFacetsAndRecreatesThem)
+{
+    const auto makeGenreTrack = [](int id, const QString& genre) {
+        Track track{u"/music/%1.flac"_s.arg(id)};
+        track.setId(id);
+        track.setLibraryId(1);
+        track.setGenres({genre});
+        return track;
+    };
+
+    TrackList tracks{
+        makeGenreTrack(1, u"Rock"_s),
+        makeGenreTrack(2, u"Jazz"_s),
+    };
+
+    const Filters::FilterColumnList columns{{.id = 0, .name = u"Genre"_s, .field = u"%<genre>%"_s}};
+    const Filters::FilterRowBuildContext context{
+        .font          = {},
+        .ratingSymbols = {u"*"_s, u"/"_s, u"-"_s},
+        .useVarious    = false,
+    };
+
+    Filters::FilterFacetIndex index{nullptr, columns, context};
+    index.build(tracks);
+
+    const Filters::FilterRowList rockRows = index.rows({tracks.at(0)});
+    ASSERT_EQ(1, rockRows.size());
+    const Filters::RowKey rockKey = rockRows.at(0).key;
+
+    tracks[0] = makeGenreTrack(1, u"Jazz"_s);
+    index.update(tracks, {1});
+
+    EXPECT_TRUE(index.tracksFor({rockKey}).empty());
+    ASSERT_EQ(1, index.rows(tracks).size());
+
+    // The value seen before must not resolve to the erased facet
+    tracks[0] = makeGenreTrack(1, u"Rock"_s);
+    index.update(tracks, {1});
+
+    EXPECT_EQ(TrackIds({1}), index.tracksFor({rockKey}).ids());
+    EXPECT_EQ(2, index.rows(tracks).size());
+}
 } // namespace Fooyin::Testing
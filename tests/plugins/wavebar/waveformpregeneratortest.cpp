@@ -0,0 +1,196 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "settings/wavebarsettings.h"
+#include "wavebardatabase.h"
+#include "waveformpregenerator.h"
+
+#include <core/engine/audioloader.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using namespace Qt::StringLiterals;
+
+namespace {
+QCoreApplication* ensureCoreApplication()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    if(auto* app = QCoreApplication::instance()) {
+        return app;
+    }
+
+    static int argc{1};
+    static char appName[] = "fooyin-waveformpregenerator-test";
+    static char* argv[]   = {appName, nullptr};
+    static QCoreApplication app{argc, argv};
+    QCoreApplication::setApplicationName(QString::fromLatin1(appName));
+    return &app;
+}
+
+Fooyin::Track makeTrack(int id, int channels = 2)
+{
+    // Files don't exist, so any track which isn't skipped as cached fails to open without decoding
+    Fooyin::Track track{u"/music/missing/%1.flac"_s.arg(id), 0};
+    track.setId(id);
+    track.setHash(u"hash%1"_s.arg(id));
+    track.setDuration(180000);
+    track.setSampleRate(44100);
+    track.setChannels(channels);
+    track.setFileSize(1024ULL * 1024ULL * 1024ULL);
+    return track;
+}
+} // namespace
+
+namespace Fooyin::WaveBar::Testing {
+class WaveformPregeneratorTest : public ::testing::Test
+{
+protected:
+    WaveformPregeneratorTest()
+    {
+        ensureCoreApplication();
+    }
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_tempDir.isValid());
+
+        m_settings        = std::make_unique<SettingsManager>(m_tempDir.filePath(u"settings.ini"_s));
+        m_wavebarSettings = std::make_unique<WaveBarSettings>(m_settings.get());
+        m_settings->set<Settings::WaveBar::PregenerateThreads>(1);
+
+        DbConnection::DbParams params;
+        params.type     = u"QSQLITE"_s;
+        params.filePath = m_tempDir.filePath(u"wavebar.sqlite"_s);
+
+        m_dbPool    = DbConnectionPool::create(params, u"waveformpregenerator_test"_s);
+        m_dbHandler = std::make_unique<DbConnectionHandler>(m_dbPool);
+        m_waveDb.initialise(DbConnectionProvider{m_dbPool});
+        m_waveDb.initialiseDatabase();
+
+        m_pregenerator = std::make_unique<WaveformPregenerator>(std::make_shared<AudioLoader>(), m_dbPool,
+                                                                m_settings.get());
+    }
+
+    void TearDown() override
+    {
+        m_pregenerator.reset();
+    }
+
+    void cacheWaveform(const Track& track, int decodedChannels) const
+    {
+        WaveformData<int16_t> data;
+        data.channelData.resize(static_cast<size_t>(decodedChannels));
+        ASSERT_TRUE(m_waveDb.storeInCache(WaveBarDatabase::cacheKey(track, decodedChannels), data));
+    }
+
+    QTemporaryDir m_tempDir;
+    std::unique_ptr<SettingsManager> m_settings;
+    std::unique_ptr<WaveBarSettings> m_wavebarSettings;
+    DbConnectionPoolPtr m_dbPool;
+    std::unique_ptr<DbConnectionHandler> m_dbHandler;
+    WaveBarDatabase m_waveDb;
+    std::unique_ptr<WaveformPregenerator> m_pregenerator;
+};
+
+TEST_F(WaveformPregeneratorTest, CacheKeyPrefersStoredChannelCount)
+{
+    const Track stereo = makeTrack(1, 2);
+    EXPECT_EQ(WaveBarDatabase::cacheKey(stereo), WaveBarDatabase::cacheKey(stereo, 1));
+    EXPECT_EQ(WaveBarDatabase::cacheKey(stereo), WaveBarDatabase::cacheKey(stereo, 6));
+
+    const Track unknown = makeTrack(1, 0);
+    EXPECT_EQ(WaveBarDatabase::cacheKey(stereo), WaveBarDatabase::cacheKey(unknown, 2));
+    EXPECT_NE(WaveBarDatabase::cacheKey(unknown, 1), WaveBarDatabase::cacheKey(unknown, 2));
+}
+
+TEST_F(WaveformPregeneratorTest, QueueDeduplicatesTracks)
+{
+    m_pregenerator->setPaused(true);
+
+    QSignalSpy progressSpy{m_pregenerator.get(), &WaveformPregenerator::progressChanged};
+
+    m_pregenerator->enqueue({makeTrack(1), makeTrack(2), makeTrack(1), Track{}});
+    EXPECT_EQ(2, m_pregenerator->totalCount());
+
+    // Already pending tracks move to the front without being counted again
+    m_pregenerator->prioritise({makeTrack(2), makeTrack(3)});
+    EXPECT_EQ(3, m_pregenerator->totalCount());
+    EXPECT_EQ(0, m_pregenerator->completedCount());
+    EXPECT_TRUE(m_pregenerator->isActive());
+    EXPECT_EQ(2, progressSpy.count());
+
+    m_pregenerator->cancel();
+    EXPECT_EQ(0, m_pregenerator->totalCount());
+    EXPECT_FALSE(m_pregenerator->isActive());
+}
+
+TEST_F(WaveformPregeneratorTest, SkipsCachedTracksWithoutReading)
+{
+    // A read limit of 1 MiB/s makes a 1 GiB read hold back the next track for far longer than the test waits,
+    // so the queue only drains in time if cached tracks give back the budget reserved for them
+    m_settings->set<Settings::WaveBar::PregenerateReadLimit>(1);
+
+    TrackList tracks;
+    for(int id{1}; id <= 4; ++id) {
+        tracks.push_back(makeTrack(id));
+        // Cached under a decoded channel count which differs from the stored one
+        cacheWaveform(tracks.back(), 1);
+    }
+    // The final track isn't cached, but nothing follows it
+    tracks.push_back(makeTrack(5));
+
+    QSignalSpy finishedSpy{m_pregenerator.get(), &WaveformPregenerator::finished};
+    QSignalSpy progressSpy{m_pregenerator.get(), &WaveformPregenerator::progressChanged};
+
+    m_pregenerator->enqueue(tracks);
+    ASSERT_TRUE(finishedSpy.wait(10000));
+
+    ASSERT_FALSE(progressSpy.isEmpty());
+    EXPECT_EQ(5, progressSpy.constLast().at(0).toInt());
+    EXPECT_EQ(5, progressSpy.constLast().at(1).toInt());
+    EXPECT_FALSE(m_pregenerator->isActive());
+}
+
+TEST_F(WaveformPregeneratorTest, ChargesOnlyDecodedBytes)
+{
+    m_settings->set<Settings::WaveBar::PregenerateReadLimit>(1);
+
+    // None of these can be opened, so nothing is decoded and each 1 GiB reservation is refunded in full
+    TrackList tracks;
+    for(int id{1}; id <= 4; ++id) {
+        tracks.push_back(makeTrack(id));
+    }
+
+    QSignalSpy finishedSpy{m_pregenerator.get(), &WaveformPregenerator::finished};
+
+    m_pregenerator->enqueue(tracks);
+    ASSERT_TRUE(finishedSpy.wait(10000));
+    EXPECT_FALSE(m_pregenerator->isActive());
+}
+} // namespace Fooyin::WaveBar::Testing